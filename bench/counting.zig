@@ -0,0 +1,105 @@
+//! Allocator wrapper that counts allocator calls and the peak memory in use.
+
+const std = @import("std");
+
+/// Thread-safe wrapper around a backing allocator, counting the calls that
+/// obtain or grow memory and tracking the bytes in use.
+pub const Counting = struct {
+    backing: std.mem.Allocator,
+    mutex: std.Thread.Mutex = .{},
+    /// Calls that obtained or grew memory since the last `reset`.
+    allocations: usize = 0,
+    /// Bytes in use.
+    current: usize = 0,
+    /// Bytes in use at the last `reset`.
+    base: usize = 0,
+    /// Highest number of bytes in use since the last `reset`.
+    peak: usize = 0,
+
+    pub fn init(backing: std.mem.Allocator) Counting {
+        return .{ .backing = backing };
+    }
+
+    /// Starts a new measurement from the memory currently in use.
+    pub fn reset(self: *Counting) void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        self.allocations = 0;
+        self.base = self.current;
+        self.peak = self.current;
+    }
+
+    /// Highest number of bytes allocated on top of those in use at the last
+    /// `reset`.
+    pub fn peakBytes(self: *Counting) usize {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        return self.peak - self.base;
+    }
+
+    pub fn allocator(self: *Counting) std.mem.Allocator {
+        return .{
+            .ptr = self,
+            .vtable = &.{
+                .alloc = alloc,
+                .resize = resize,
+                .remap = remap,
+                .free = free,
+            },
+        };
+    }
+
+    fn grow(self: *Counting, old_len: usize, new_len: usize) void {
+        if (new_len > old_len)
+            self.allocations += 1;
+
+        self.current = self.current - old_len + new_len;
+        self.peak = @max(self.peak, self.current);
+    }
+
+    fn alloc(context: *anyopaque, len: usize, alignment: std.mem.Alignment, ret_addr: usize) ?[*]u8 {
+        const self: *Counting = @ptrCast(@alignCast(context));
+        const memory: [*]u8 = self.backing.rawAlloc(len, alignment, ret_addr) orelse return null;
+
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        self.grow(0, len);
+        return memory;
+    }
+
+    fn resize(context: *anyopaque, memory: []u8, alignment: std.mem.Alignment, new_len: usize, ret_addr: usize) bool {
+        const self: *Counting = @ptrCast(@alignCast(context));
+        if (!self.backing.rawResize(memory, alignment, new_len, ret_addr))
+            return false;
+
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        self.grow(memory.len, new_len);
+        return true;
+    }
+
+    fn remap(context: *anyopaque, memory: []u8, alignment: std.mem.Alignment, new_len: usize, ret_addr: usize) ?[*]u8 {
+        const self: *Counting = @ptrCast(@alignCast(context));
+        const new_memory: [*]u8 = self.backing.rawRemap(memory, alignment, new_len, ret_addr) orelse return null;
+
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        self.grow(memory.len, new_len);
+        return new_memory;
+    }
+
+    fn free(context: *anyopaque, memory: []u8, alignment: std.mem.Alignment, ret_addr: usize) void {
+        const self: *Counting = @ptrCast(@alignCast(context));
+        self.backing.rawFree(memory, alignment, ret_addr);
+
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        self.current -= memory.len;
+    }
+};
@@ -0,0 +1,114 @@
+//! Crossover points of the `Integer` multiplication and division algorithms.
+//!
+//! For every size the top level of an operation is timed with an algorithm
+//! disabled (its threshold just above the size) and enabled (threshold at the
+//! size), everything below being left as configured. The suggested threshold
+//! is the smallest size from which enabling it is faster for all larger
+//! sizes.
+//!
+//! Run with `zig build bench-integer`.
+
+const std = @import("std");
+
+const zml = @import("zml");
+const nat = zml.integer.nat;
+
+const sizes = [_]usize{ 8, 12, 16, 24, 32, 48, 64, 96, 128, 160, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288, 16384 };
+
+/// Minimum time spent per measurement.
+const min_time: u64 = 20 * std.time.ns_per_ms;
+const trials: usize = 3;
+
+const Algorithm = enum { karatsuba, toom3, ntt, division };
+
+fn random(allocator: std.mem.Allocator, rng: std.Random, n: usize) ![]u32 {
+    const limbs: []u32 = try allocator.alloc(u32, n);
+    rng.bytes(std.mem.sliceAsBytes(limbs));
+    limbs[n - 1] |= 1 << 31;
+
+    return limbs;
+}
+
+fn setThreshold(t: *nat.Thresholds, algorithm: Algorithm, value: usize) void {
+    switch (algorithm) {
+        .karatsuba => t.karatsuba = value,
+        .toom3 => t.toom3 = value,
+        .ntt => t.ntt = value,
+        .division => t.division = value,
+    }
+}
+
+/// Best time per call, in nanoseconds, of `algorithm` on operands of `n`
+/// limbs (a `2n` by `n` division for `.division`), with thresholds `t`.
+fn measure(allocator: std.mem.Allocator, algorithm: Algorithm, t: nat.Thresholds, a: []const u32, b: []const u32, r: []u32, q: []u32) !f64 {
+    var best: f64 = std.math.inf(f64);
+    for (0..trials) |_| {
+        var timer: std.time.Timer = try .start();
+        var calls: u64 = 0;
+        while (timer.read() < min_time) : (calls += 1) {
+            if (algorithm == .division) {
+                try nat.divRem(allocator, q, r[0..b.len], a, b, t);
+            } else {
+                try nat.mul(allocator, r, a[0..b.len], b, t);
+            }
+        }
+
+        best = @min(best, @as(f64, @floatFromInt(timer.read())) / @as(f64, @floatFromInt(calls)));
+    }
+
+    return best;
+}
+
+pub fn main() !void {
+    const allocator: std.mem.Allocator = std.heap.smp_allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    std.debug.print("{s:<10} {s:>7} {s:>14} {s:>14} {s:>7}\n", .{ "algorithm", "limbs", "off (ns)", "on (ns)", "ratio" });
+
+    for ([_]Algorithm{ .karatsuba, .toom3, .ntt, .division }) |algorithm| {
+        var suggested: ?usize = null;
+
+        for (sizes) |n| {
+            const a: []u32 = try random(allocator, rng, 2 * n);
+            defer allocator.free(a);
+            const b: []u32 = try random(allocator, rng, n);
+            defer allocator.free(b);
+            const r: []u32 = try allocator.alloc(u32, 2 * n);
+            defer allocator.free(r);
+            const q: []u32 = try allocator.alloc(u32, n + 1);
+            defer allocator.free(q);
+
+            var t: nat.Thresholds = nat.thresholds;
+            // Keep the faster algorithms out of the way of the one measured.
+            switch (algorithm) {
+                .karatsuba => {
+                    t.toom3 = std.math.maxInt(usize);
+                    t.ntt = std.math.maxInt(usize);
+                },
+                .toom3 => t.ntt = std.math.maxInt(usize),
+                .ntt, .division => {},
+            }
+
+            setThreshold(&t, algorithm, n + 1);
+            const off: f64 = try measure(allocator, algorithm, t, a, b, r, q);
+            setThreshold(&t, algorithm, n);
+            const on: f64 = try measure(allocator, algorithm, t, a, b, r, q);
+
+            if (on < off) {
+                if (suggested == null) suggested = n;
+            } else {
+                suggested = null;
+            }
+
+            std.debug.print("{s:<10} {d:>7} {d:>14.0} {d:>14.0} {d:>7.3}\n", .{ @tagName(algorithm), n, off, on, on / off });
+        }
+
+        if (suggested) |n| {
+            std.debug.print("{s}: suggested threshold {d} limbs\n\n", .{ @tagName(algorithm), n });
+        } else {
+            std.debug.print("{s}: no crossover up to {d} limbs\n\n", .{ @tagName(algorithm), sizes[sizes.len - 1] });
+        }
+    }
+}
@@ -0,0 +1,90 @@
+//! Benchmark suite for the level 3 BLAS routines, the factorizations, the
+//! element-wise array operations, the sparse builders and `Integer`
+//! arithmetic, across sizes and element types.
+//!
+//! Every case reports the fastest call, GFLOPS and bandwidth where they make
+//! sense, and the allocator calls, scratch arena temporaries and peak memory of
+//! one call. The benchmarks always run zml's own kernels; when a system
+//! library is given with `-Dlink_cblas` or `-Dlink_lapacke`, its routines are
+//! measured alongside for comparison.
+//!
+//! Run with `zig build bench`. Arguments after `--` are passed on:
+//! * `--json <path>`: also write the results as JSON to `path`, or to the
+//!   standard output for `-`.
+//! * `--filter <text>`: only run the cases whose `group.case` name contains
+//!   `text`, e.g. `blas.gemm` or `lapack`.
+//! * `--quick`: smaller sizes and shorter measurements.
+
+const std = @import("std");
+
+const zml = @import("zml");
+
+const Counting = @import("counting.zig").Counting;
+const bench = @import("runner.zig");
+const Runner = bench.Runner;
+
+const suites = .{
+    @import("suite/blas.zig"),
+    @import("suite/lapack.zig"),
+    @import("suite/array.zig"),
+    @import("suite/sparse.zig"),
+    @import("suite/integer.zig"),
+};
+
+fn usage() noreturn {
+    std.debug.print("usage: bench [--json <path>] [--filter <text>] [--quick]\n", .{});
+    std.process.exit(2);
+}
+
+pub fn main() !void {
+    var counting: Counting = .init(std.heap.smp_allocator);
+    const allocator: std.mem.Allocator = counting.allocator();
+
+    var arena: zml.Arena = .init(allocator);
+    defer arena.deinit();
+
+    var runner: Runner = .init(&counting, &arena);
+    defer runner.deinit();
+
+    const args: []const [:0]u8 = try std.process.argsAlloc(allocator);
+    defer std.process.argsFree(allocator, args);
+
+    var json: ?[]const u8 = null;
+    var i: usize = 1;
+    while (i < args.len) : (i += 1) {
+        if (std.mem.eql(u8, args[i], "--json")) {
+            if (i + 1 == args.len) usage();
+
+            i += 1;
+            json = args[i];
+        } else if (std.mem.eql(u8, args[i], "--filter")) {
+            if (i + 1 == args.len) usage();
+
+            i += 1;
+            runner.filter = args[i];
+        } else if (std.mem.eql(u8, args[i], "--quick")) {
+            runner.quick = true;
+        } else {
+            usage();
+        }
+    }
+
+    bench.printHeader();
+    inline for (suites) |suite|
+        try suite.run(&runner);
+
+    const path: []const u8 = json orelse return;
+    var buffer: [4096]u8 = undefined;
+    if (std.mem.eql(u8, path, "-")) {
+        var writer = std.fs.File.stdout().writer(&buffer);
+        try runner.writeJson(&writer.interface);
+        try writer.interface.flush();
+    } else {
+        const file: std.fs.File = try std.fs.cwd().createFile(path, .{});
+        defer file.close();
+
+        var writer = file.writer(&buffer);
+        try runner.writeJson(&writer.interface);
+        try writer.interface.flush();
+    }
+}
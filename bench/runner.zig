@@ -0,0 +1,252 @@
+//! Measurement and reporting shared by the benchmark suites.
+
+const std = @import("std");
+const builtin = @import("builtin");
+
+const zml = @import("zml");
+
+const Counting = @import("counting.zig").Counting;
+const system = @import("system.zig");
+
+pub const Backend = enum { zml, system };
+
+/// What is measured, and the work done by one call.
+pub const Info = struct {
+    group: []const u8,
+    case: []const u8,
+    backend: Backend = .zml,
+    type: []const u8,
+    /// Matrix order, vector length, or number of limbs.
+    size: usize,
+    /// Floating point operations of one call, or elements for the element-wise
+    /// operations.
+    flops: ?f64 = null,
+    /// Bytes of the operands read and written by one call.
+    bytes: ?f64 = null,
+};
+
+pub const Result = struct {
+    group: []const u8,
+    case: []const u8,
+    backend: Backend,
+    type: []const u8,
+    size: usize,
+    iterations: usize,
+    /// Fastest call, in nanoseconds.
+    best_ns: u64,
+    /// Mean over all the timed calls, in nanoseconds.
+    mean_ns: f64,
+    /// `Info.flops` per nanosecond of the fastest call.
+    gflops: ?f64,
+    /// `Info.bytes` per nanosecond of the fastest call, in GB/s.
+    bandwidth: ?f64,
+    /// Allocator calls that obtained or grew memory during one call, the
+    /// chunks of the scratch arena included.
+    allocations: usize,
+    /// Temporaries served by the scratch arena during one call.
+    scratch_allocations: usize,
+    /// Peak memory allocated during one call, in bytes.
+    peak_bytes: usize,
+};
+
+/// Timed calls are repeated until both limits are reached.
+const min_iterations: usize = 3;
+const min_time: u64 = 200 * std.time.ns_per_ms;
+const quick_time: u64 = 20 * std.time.ns_per_ms;
+
+pub const Runner = struct {
+    /// Allocator for everything in the suites; counts what the measured calls
+    /// allocate.
+    allocator: std.mem.Allocator,
+    counting: *Counting,
+    /// Arena passed to the routines that accept a `scratch` field in `ctx`.
+    arena: *zml.Arena,
+    results: std.ArrayList(Result) = .empty,
+    /// Only cases whose `group.case` name contains it are run.
+    filter: ?[]const u8 = null,
+    /// Smaller sizes and shorter measurements.
+    quick: bool = false,
+    prng: std.Random.DefaultPrng = .init(0x5eed),
+
+    pub fn init(counting: *Counting, arena: *zml.Arena) Runner {
+        return .{
+            .allocator = counting.allocator(),
+            .counting = counting,
+            .arena = arena,
+        };
+    }
+
+    pub fn deinit(self: *Runner) void {
+        self.results.deinit(self.allocator);
+    }
+
+    pub fn random(self: *Runner) std.Random {
+        return self.prng.random();
+    }
+
+    /// Returns `full`, or its first `quick` entries in quick mode.
+    pub fn sizes(self: *const Runner, full: []const usize, quick: usize) []const usize {
+        return if (self.quick) full[0..@min(quick, full.len)] else full;
+    }
+
+    /// Whether `group.case` passes the filter. Suites check it before setting
+    /// up the operands of a case.
+    pub fn enabled(self: *const Runner, group: []const u8, case: []const u8) bool {
+        const filter: []const u8 = self.filter orelse return true;
+
+        var buffer: [128]u8 = undefined;
+        const name: []const u8 = std.fmt.bufPrint(&buffer, "{s}.{s}", .{ group, case }) catch return true;
+        return std.mem.indexOf(u8, name, filter) != null;
+    }
+
+    /// Measures `case`, a pointer to a struct with a `reset` method restoring
+    /// the operands and a `run` method making the call, given the scratch
+    /// arena.
+    ///
+    /// One call is first made from an empty arena to count its allocations and
+    /// peak memory, then the calls are timed one by one, resetting the
+    /// operands and the arena in between.
+    pub fn measure(self: *Runner, info: Info, case: anytype) !void {
+        case.reset();
+        self.arena.deinit();
+        self.arena.* = .init(self.allocator);
+        self.counting.reset();
+
+        try case.run(self.arena);
+
+        const allocations: usize = self.counting.allocations;
+        const scratch_allocations: usize = self.arena.allocations;
+        const peak_bytes: usize = self.counting.peakBytes();
+
+        const limit: u64 = if (self.quick) quick_time else min_time;
+        var best: u64 = std.math.maxInt(u64);
+        var total: u64 = 0;
+        var iterations: usize = 0;
+        var timer: std.time.Timer = try .start();
+        while (iterations < min_iterations or total < limit) : (iterations += 1) {
+            case.reset();
+            self.arena.reset();
+
+            timer.reset();
+            try case.run(self.arena);
+            const elapsed: u64 = timer.read();
+
+            best = @min(best, elapsed);
+            total += elapsed;
+        }
+
+        const ns: f64 = @floatFromInt(@max(best, 1));
+        const result: Result = .{
+            .group = info.group,
+            .case = info.case,
+            .backend = info.backend,
+            .type = info.type,
+            .size = info.size,
+            .iterations = iterations,
+            .best_ns = best,
+            .mean_ns = @as(f64, @floatFromInt(total)) / @as(f64, @floatFromInt(iterations)),
+            .gflops = if (info.flops) |flops| flops / ns else null,
+            .bandwidth = if (info.bytes) |bytes| bytes / ns else null,
+            .allocations = allocations,
+            .scratch_allocations = scratch_allocations,
+            .peak_bytes = peak_bytes,
+        };
+
+        try self.results.append(self.allocator, result);
+        printRow(result);
+    }
+
+    /// Measures `case` with zml's own routine, then, if `available`, with the
+    /// system library's. `case` must have a `backend` field that its `run`
+    /// method dispatches on.
+    pub fn compare(self: *Runner, info: Info, case: anytype, available: bool) !void {
+        var current: Info = info;
+
+        case.backend = .zml;
+        current.backend = .zml;
+        try self.measure(current, case);
+
+        if (!available)
+            return;
+
+        case.backend = .system;
+        current.backend = .system;
+        try self.measure(current, case);
+    }
+
+    /// Writes the results, with a description of the machine, as JSON.
+    pub fn writeJson(self: *const Runner, writer: *std.Io.Writer) !void {
+        try std.json.Stringify.value(.{
+            .timestamp = std.time.timestamp(),
+            .zig = builtin.zig_version_string,
+            .target = @tagName(builtin.cpu.arch) ++ "-" ++ @tagName(builtin.os.tag),
+            .cpu = builtin.cpu.model.name,
+            .cpus = std.Thread.getCpuCount() catch 1,
+            .system = .{ .cblas = system.cblas, .lapacke = system.lapacke },
+            .results = self.results.items,
+        }, .{ .whitespace = .indent_2 }, writer);
+        try writer.writeByte('\n');
+    }
+};
+
+pub fn printHeader() void {
+    std.debug.print("{s:<24} {s:<7} {s:<9} {s:>8} {s:>12} {s:>9} {s:>9} {s:>7} {s:>7} {s:>10}\n", .{
+        "case", "backend", "type", "size", "best (us)", "GFLOPS", "GB/s", "allocs", "scratch", "peak (KiB)",
+    });
+}
+
+fn printRow(result: Result) void {
+    var name: [64]u8 = undefined;
+    var gflops: [16]u8 = undefined;
+    var bandwidth: [16]u8 = undefined;
+
+    std.debug.print("{s:<24} {s:<7} {s:<9} {d:>8} {d:>12.1} {s:>9} {s:>9} {d:>7} {d:>7} {d:>10.1}\n", .{
+        std.fmt.bufPrint(&name, "{s}.{s}", .{ result.group, result.case }) catch result.case,
+        @tagName(result.backend),
+        result.type,
+        result.size,
+        @as(f64, @floatFromInt(result.best_ns)) / std.time.ns_per_us,
+        column(&gflops, result.gflops),
+        column(&bandwidth, result.bandwidth),
+        result.allocations,
+        result.scratch_allocations,
+        @as(f64, @floatFromInt(result.peak_bytes)) / 1024,
+    });
+}
+
+fn column(buffer: []u8, value: ?f64) []const u8 {
+    const v: f64 = value orelse return "-";
+    return std.fmt.bufPrint(buffer, "{d:.2}", .{v}) catch "?";
+}
+
+/// Fills `data` with values in `[-1, 1)`.
+pub fn fill(comptime T: type, rng: std.Random, data: []T) void {
+    for (data) |*x|
+        x.* = @floatCast(2 * rng.float(f64) - 1);
+}
+
+pub const Kind = enum {
+    general,
+    symmetric,
+    lower,
+};
+
+/// Returns a row major `n`×`n` matrix with entries in `[-1, 1)` plus `n` on
+/// the diagonal, so that it is well conditioned, and positive definite when
+/// symmetric. `.lower` zeros the upper triangle.
+pub fn matrix(comptime T: type, allocator: std.mem.Allocator, rng: std.Random, n: usize, kind: Kind) ![]T {
+    const a: []T = try allocator.alloc(T, n * n);
+    fill(T, rng, a);
+
+    for (0..n) |i| {
+        a[i * n + i] += @floatFromInt(n);
+
+        for (i + 1..n) |j| switch (kind) {
+            .general => {},
+            .symmetric => a[i * n + j] = a[j * n + i],
+            .lower => a[i * n + j] = 0,
+        };
+    }
+
+    return a;
+}
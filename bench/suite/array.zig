@@ -0,0 +1,150 @@
+//! Element-wise array operations: `apply2` through `add` and `add_`, and the
+//! transcendental `apply1` kernels, on dense vectors.
+//!
+//! The rational `add_` has no flops or bandwidth figures; it is there for its
+//! allocation counts, its temporaries coming from the scratch arena.
+
+const std = @import("std");
+
+const zml = @import("zml");
+const Rational = zml.Rational;
+const Dense = zml.array.Dense;
+
+const bench = @import("../runner.zig");
+const Runner = bench.Runner;
+
+const sizes = [_]usize{ 1_000, 10_000, 100_000, 1_000_000 };
+const quick_sizes: usize = 3;
+const rational_sizes = [_]usize{ 1_000, 10_000 };
+
+const Operation = enum { add, add_, exp, sin };
+
+pub fn run(runner: *Runner) !void {
+    inline for (.{ f32, f64 }) |T| {
+        for (runner.sizes(&sizes, quick_sizes)) |n| {
+            inline for (comptime std.enums.values(Operation)) |operation| {
+                if (runner.enabled("array", @tagName(operation)))
+                    try elementwise(T, operation, runner, n);
+            }
+        }
+    }
+
+    if (runner.enabled("array", "add_")) {
+        for (runner.sizes(&rational_sizes, 1)) |n|
+            try rationalAdd(runner, n);
+    }
+}
+
+fn Elementwise(comptime T: type, comptime operation: Operation) type {
+    return struct {
+        allocator: std.mem.Allocator,
+        x: *const Dense(T, .row_major),
+        y: *const Dense(T, .row_major),
+        o: *Dense(T, .row_major),
+
+        pub fn reset(_: *@This()) void {}
+
+        pub fn run(self: *@This(), _: ?*zml.Arena) !void {
+            switch (operation) {
+                .add => {
+                    var result = try zml.array.add(self.allocator, self.x.*, self.y.*, .{});
+                    result.deinit(self.allocator);
+                },
+                .add_ => try zml.array.add_(self.o, self.x.*, self.y.*, .{}),
+                .exp => {
+                    var result = try zml.array.exp(self.allocator, self.x.*, .{});
+                    result.deinit(self.allocator);
+                },
+                .sin => {
+                    var result = try zml.array.sin(self.allocator, self.x.*, .{});
+                    result.deinit(self.allocator);
+                },
+            }
+        }
+    };
+}
+
+fn elementwise(comptime T: type, comptime operation: Operation, runner: *Runner, n: usize) !void {
+    const allocator: std.mem.Allocator = runner.allocator;
+    const shape: [1]u32 = .{@intCast(n)};
+
+    var x: Dense(T, .row_major) = try .init(allocator, &shape);
+    defer x.deinit(allocator);
+    var y: Dense(T, .row_major) = try .init(allocator, &shape);
+    defer y.deinit(allocator);
+    var o: Dense(T, .row_major) = try .init(allocator, &shape);
+    defer o.deinit(allocator);
+
+    bench.fill(T, runner.random(), x.data[0..n]);
+    bench.fill(T, runner.random(), y.data[0..n]);
+
+    var case: Elementwise(T, operation) = .{ .allocator = allocator, .x = &x, .y = &y, .o = &o };
+    const size: f64 = @floatFromInt(n);
+    try runner.measure(.{
+        .group = "array",
+        .case = @tagName(operation),
+        .type = @typeName(T),
+        .size = n,
+        .flops = size,
+        .bytes = switch (operation) {
+            .add, .add_ => 3,
+            .exp, .sin => 2,
+        } * size * @sizeOf(T),
+    }, &case);
+}
+
+const RationalAdd = struct {
+    allocator: std.mem.Allocator,
+    x: *const Dense(Rational, .row_major),
+    y: *const Dense(Rational, .row_major),
+    o: *Dense(Rational, .row_major),
+
+    pub fn reset(_: *RationalAdd) void {}
+
+    pub fn run(self: *RationalAdd, arena: ?*zml.Arena) !void {
+        try zml.array.add_(self.o, self.x.*, self.y.*, .{ .element_allocator = self.allocator, .scratch = arena });
+    }
+};
+
+fn rationalVector(allocator: std.mem.Allocator, n: usize, offset: usize) !Dense(Rational, .row_major) {
+    const shape: [1]u32 = .{@intCast(n)};
+    var v: Dense(Rational, .row_major) = try .init(allocator, &shape);
+    errdefer v.deinit(allocator);
+
+    var initialized: usize = 0;
+    errdefer for (v.data[0..initialized]) |*r| r.deinit(allocator);
+
+    // Small fractions, (i + 1) / (i + offset), that do not reduce to integers.
+    for (v.data[0..n], 0..) |*r, i| {
+        r.* = try .initSet(allocator, i + 1, i + offset);
+        initialized += 1;
+    }
+
+    return v;
+}
+
+fn deinitRationalVector(allocator: std.mem.Allocator, v: *Dense(Rational, .row_major)) void {
+    for (v.data[0..v.size]) |*r|
+        r.deinit(allocator);
+
+    v.deinit(allocator);
+}
+
+fn rationalAdd(runner: *Runner, n: usize) !void {
+    const allocator: std.mem.Allocator = runner.allocator;
+
+    var x = try rationalVector(allocator, n, 2);
+    defer deinitRationalVector(allocator, &x);
+    var y = try rationalVector(allocator, n, 3);
+    defer deinitRationalVector(allocator, &y);
+    var o = try rationalVector(allocator, n, 2);
+    defer deinitRationalVector(allocator, &o);
+
+    var case: RationalAdd = .{ .allocator = allocator, .x = &x, .y = &y, .o = &o };
+    try runner.measure(.{
+        .group = "array",
+        .case = "add_",
+        .type = "Rational",
+        .size = n,
+    }, &case);
+}
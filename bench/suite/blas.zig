@@ -0,0 +1,149 @@
+//! Level 3 BLAS: `gemm`, `trsm` and `syrk` on square row major matrices.
+
+const std = @import("std");
+
+const zml = @import("zml");
+const blas = zml.linalg.blas;
+
+const bench = @import("../runner.zig");
+const Runner = bench.Runner;
+const Backend = bench.Backend;
+const system = @import("../system.zig");
+
+const sizes = [_]usize{ 64, 128, 256, 512, 1024, 2048 };
+const quick_sizes: usize = 3;
+
+pub fn run(runner: *Runner) !void {
+    inline for (.{ f32, f64 }) |T| {
+        for (runner.sizes(&sizes, quick_sizes)) |n| {
+            if (runner.enabled("blas", "gemm")) try gemm(T, runner, n);
+            if (runner.enabled("blas", "trsm")) try trsm(T, runner, n);
+            if (runner.enabled("blas", "syrk")) try syrk(T, runner, n);
+        }
+    }
+}
+
+fn Gemm(comptime T: type) type {
+    return struct {
+        backend: Backend = .zml,
+        n: usize,
+        a: []const T,
+        b: []const T,
+        c: []T,
+
+        pub fn reset(_: *@This()) void {}
+
+        pub fn run(self: *@This(), arena: ?*zml.Arena) !void {
+            const n: i32 = @intCast(self.n);
+            switch (self.backend) {
+                .zml => try blas.gemm(.row_major, .no_trans, .no_trans, n, n, n, @as(T, 1), self.a.ptr, n, self.b.ptr, n, @as(T, 0), self.c.ptr, n, .{ .scratch = arena }),
+                .system => if (comptime system.cblas) system.gemm(T, n, self.a.ptr, self.b.ptr, self.c.ptr) else unreachable,
+            }
+        }
+    };
+}
+
+fn gemm(comptime T: type, runner: *Runner, n: usize) !void {
+    const allocator: std.mem.Allocator = runner.allocator;
+
+    const a: []T = try bench.matrix(T, allocator, runner.random(), n, .general);
+    defer allocator.free(a);
+    const b: []T = try bench.matrix(T, allocator, runner.random(), n, .general);
+    defer allocator.free(b);
+    const c: []T = try allocator.alloc(T, n * n);
+    defer allocator.free(c);
+
+    var case: Gemm(T) = .{ .n = n, .a = a, .b = b, .c = c };
+    const size: f64 = @floatFromInt(n);
+    try runner.compare(.{
+        .group = "blas",
+        .case = "gemm",
+        .type = @typeName(T),
+        .size = n,
+        .flops = 2 * size * size * size,
+        .bytes = 3 * size * size * @sizeOf(T),
+    }, &case, system.cblas);
+}
+
+fn Trsm(comptime T: type) type {
+    return struct {
+        backend: Backend = .zml,
+        n: usize,
+        a: []const T,
+        b: []T,
+        original: []const T,
+
+        pub fn reset(self: *@This()) void {
+            @memcpy(self.b, self.original);
+        }
+
+        pub fn run(self: *@This(), arena: ?*zml.Arena) !void {
+            const n: i32 = @intCast(self.n);
+            switch (self.backend) {
+                .zml => try blas.trsm(.row_major, .left, .lower, .no_trans, .non_unit, n, n, @as(T, 1), self.a.ptr, n, self.b.ptr, n, .{ .scratch = arena }),
+                .system => if (comptime system.cblas) system.trsm(T, n, self.a.ptr, self.b.ptr) else unreachable,
+            }
+        }
+    };
+}
+
+fn trsm(comptime T: type, runner: *Runner, n: usize) !void {
+    const allocator: std.mem.Allocator = runner.allocator;
+
+    const a: []T = try bench.matrix(T, allocator, runner.random(), n, .lower);
+    defer allocator.free(a);
+    const original: []T = try bench.matrix(T, allocator, runner.random(), n, .general);
+    defer allocator.free(original);
+    const b: []T = try allocator.alloc(T, n * n);
+    defer allocator.free(b);
+
+    var case: Trsm(T) = .{ .n = n, .a = a, .b = b, .original = original };
+    const size: f64 = @floatFromInt(n);
+    try runner.compare(.{
+        .group = "blas",
+        .case = "trsm",
+        .type = @typeName(T),
+        .size = n,
+        .flops = size * size * size,
+        .bytes = 2.5 * size * size * @sizeOf(T),
+    }, &case, system.cblas);
+}
+
+fn Syrk(comptime T: type) type {
+    return struct {
+        backend: Backend = .zml,
+        n: usize,
+        a: []const T,
+        c: []T,
+
+        pub fn reset(_: *@This()) void {}
+
+        pub fn run(self: *@This(), arena: ?*zml.Arena) !void {
+            const n: i32 = @intCast(self.n);
+            switch (self.backend) {
+                .zml => try blas.syrk(.row_major, .lower, .no_trans, n, n, @as(T, 1), self.a.ptr, n, @as(T, 0), self.c.ptr, n, .{ .scratch = arena }),
+                .system => if (comptime system.cblas) system.syrk(T, n, self.a.ptr, self.c.ptr) else unreachable,
+            }
+        }
+    };
+}
+
+fn syrk(comptime T: type, runner: *Runner, n: usize) !void {
+    const allocator: std.mem.Allocator = runner.allocator;
+
+    const a: []T = try bench.matrix(T, allocator, runner.random(), n, .general);
+    defer allocator.free(a);
+    const c: []T = try allocator.alloc(T, n * n);
+    defer allocator.free(c);
+
+    var case: Syrk(T) = .{ .n = n, .a = a, .c = c };
+    const size: f64 = @floatFromInt(n);
+    try runner.compare(.{
+        .group = "blas",
+        .case = "syrk",
+        .type = @typeName(T),
+        .size = n,
+        .flops = size * size * size,
+        .bytes = 1.5 * size * size * @sizeOf(T),
+    }, &case, system.cblas);
+}
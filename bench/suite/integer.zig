@@ -0,0 +1,76 @@
+//! `Integer` multiplication and `2n` by `n` limb division. Temporaries come
+//! from the scratch arena, installed around each call.
+//!
+//! See `bench/integer.zig` for the crossover points between the algorithms.
+
+const std = @import("std");
+
+const zml = @import("zml");
+const Integer = zml.Integer;
+
+const bench = @import("../runner.zig");
+const Runner = bench.Runner;
+
+const sizes = [_]usize{ 16, 64, 256, 1024, 4096, 16384 };
+const quick_sizes: usize = 4;
+
+const Operation = enum { mul, div };
+
+pub fn run(runner: *Runner) !void {
+    for (runner.sizes(&sizes, quick_sizes)) |n| {
+        inline for (comptime std.enums.values(Operation)) |operation| {
+            if (runner.enabled("integer", @tagName(operation)))
+                try measure(operation, runner, n);
+        }
+    }
+}
+
+fn Case(comptime operation: Operation) type {
+    return struct {
+        allocator: std.mem.Allocator,
+        x: *const Integer,
+        y: *const Integer,
+        o: *Integer,
+
+        pub fn reset(_: *@This()) void {}
+
+        pub fn run(self: *@This(), arena: ?*zml.Arena) !void {
+            const previous: ?*zml.Arena = zml.scratch.enter(arena);
+            defer zml.scratch.leave(previous);
+
+            switch (operation) {
+                .mul => try zml.integer.mul_(self.allocator, self.o, self.x.*, self.y.*),
+                .div => try zml.integer.div_(self.allocator, self.o, self.x.*, self.y.*),
+            }
+        }
+    };
+}
+
+fn random(allocator: std.mem.Allocator, rng: std.Random, n: usize) !Integer {
+    var result: Integer = try .init(allocator, @intCast(n));
+    rng.bytes(std.mem.sliceAsBytes(result.limbs[0..n]));
+    result.limbs[n - 1] |= 1 << 31;
+    result.size = @intCast(n);
+
+    return result;
+}
+
+fn measure(comptime operation: Operation, runner: *Runner, n: usize) !void {
+    const allocator: std.mem.Allocator = runner.allocator;
+
+    // `x` has `2n` limbs for the division.
+    var x: Integer = try random(allocator, runner.random(), if (operation == .div) 2 * n else n);
+    defer x.deinit(allocator);
+    var y: Integer = try random(allocator, runner.random(), n);
+    defer y.deinit(allocator);
+    var o: Integer = try .init(allocator, @intCast(2 * n + 1));
+    defer o.deinit(allocator);
+
+    var case: Case(operation) = .{ .allocator = allocator, .x = &x, .y = &y, .o = &o };
+    try runner.measure(.{
+        .group = "integer",
+        .case = @tagName(operation),
+        .type = "Integer",
+        .size = n,
+    }, &case);
+}
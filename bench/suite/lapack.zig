@@ -0,0 +1,108 @@
+//! Factorizations: `getrf`, `potrf`, `geqrf` and `sytrf` on square row major
+//! matrices.
+
+const std = @import("std");
+
+const zml = @import("zml");
+const lapack = zml.linalg.lapack;
+
+const bench = @import("../runner.zig");
+const Runner = bench.Runner;
+const Backend = bench.Backend;
+const system = @import("../system.zig");
+
+const sizes = [_]usize{ 64, 128, 256, 512, 1024, 2048 };
+const quick_sizes: usize = 3;
+
+/// Block size assumed for the `work` arrays.
+const nb: usize = 64;
+
+const Routine = enum { getrf, potrf, geqrf, sytrf };
+
+pub fn run(runner: *Runner) !void {
+    inline for (.{ f32, f64 }) |T| {
+        for (runner.sizes(&sizes, quick_sizes)) |n| {
+            inline for (comptime std.enums.values(Routine)) |routine| {
+                if (runner.enabled("lapack", @tagName(routine)))
+                    try factorize(T, routine, runner, n);
+            }
+        }
+    }
+}
+
+fn Factorization(comptime T: type, comptime routine: Routine) type {
+    return struct {
+        backend: Backend = .zml,
+        n: usize,
+        a: []T,
+        original: []const T,
+        ipiv: []i32,
+        tau: []T,
+        work: []T,
+
+        pub fn reset(self: *@This()) void {
+            @memcpy(self.a, self.original);
+        }
+
+        pub fn run(self: *@This(), arena: ?*zml.Arena) !void {
+            const n: i32 = @intCast(self.n);
+            const lwork: i32 = @intCast(self.work.len);
+
+            const info: i32 = switch (self.backend) {
+                .zml => switch (routine) {
+                    .getrf => try lapack.getrf(.row_major, n, n, self.a.ptr, n, self.ipiv.ptr, .{ .scratch = arena }),
+                    .potrf => try lapack.potrf(.row_major, .lower, n, self.a.ptr, n, .{ .scratch = arena }),
+                    .geqrf => blk: {
+                        try lapack.geqrf(.row_major, n, n, self.a.ptr, n, self.tau.ptr, self.work.ptr, lwork, .{ .scratch = arena });
+                        break :blk 0;
+                    },
+                    .sytrf => try lapack.sytrf(.row_major, .lower, n, self.a.ptr, n, self.ipiv.ptr, self.work.ptr, lwork, .{}),
+                },
+                .system => if (comptime system.lapacke) switch (routine) {
+                    .getrf => system.getrf(T, n, self.a.ptr, self.ipiv.ptr),
+                    .potrf => system.potrf(T, n, self.a.ptr),
+                    .geqrf => system.geqrf(T, n, self.a.ptr, self.tau.ptr),
+                    .sytrf => system.sytrf(T, n, self.a.ptr, self.ipiv.ptr),
+                } else unreachable,
+            };
+
+            if (info != 0)
+                return error.FactorizationFailed;
+        }
+    };
+}
+
+fn factorize(comptime T: type, comptime routine: Routine, runner: *Runner, n: usize) !void {
+    const allocator: std.mem.Allocator = runner.allocator;
+
+    const original: []T = try bench.matrix(T, allocator, runner.random(), n, switch (routine) {
+        .getrf, .geqrf => .general,
+        .potrf, .sytrf => .symmetric,
+    });
+    defer allocator.free(original);
+    const a: []T = try allocator.alloc(T, n * n);
+    defer allocator.free(a);
+    const ipiv: []i32 = try allocator.alloc(i32, n);
+    defer allocator.free(ipiv);
+    const tau: []T = try allocator.alloc(T, n);
+    defer allocator.free(tau);
+    const work: []T = try allocator.alloc(T, n * nb);
+    defer allocator.free(work);
+
+    var case: Factorization(T, routine) = .{ .n = n, .a = a, .original = original, .ipiv = ipiv, .tau = tau, .work = work };
+    const size: f64 = @floatFromInt(n);
+    const flops: f64 = switch (routine) {
+        .getrf => 2.0 / 3.0,
+        .potrf, .sytrf => 1.0 / 3.0,
+        .geqrf => 4.0 / 3.0,
+    } * size * size * size;
+
+    try runner.compare(.{
+        .group = "lapack",
+        .case = @tagName(routine),
+        .type = @typeName(T),
+        .size = n,
+        .flops = flops,
+        .bytes = 2 * size * size * @sizeOf(T),
+    }, &case, system.lapacke);
+}
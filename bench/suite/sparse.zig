@@ -0,0 +1,76 @@
+//! Compilation of a sparse builder into a CSR matrix.
+//!
+//! The builder holds a pentadiagonal matrix, filled directly in sorted order:
+//! inserting through `set` is quadratic in the number of nonzeros and would
+//! dominate the setup at these sizes.
+
+const std = @import("std");
+
+const zml = @import("zml");
+const builder = zml.matrix.builder;
+
+const bench = @import("../runner.zig");
+const Runner = bench.Runner;
+
+const sizes = [_]usize{ 10_000, 100_000, 1_000_000 };
+const quick_sizes: usize = 2;
+
+/// Nonzeros per row, centred on the diagonal.
+const band: usize = 5;
+
+pub fn run(runner: *Runner) !void {
+    if (!runner.enabled("sparse", "compile"))
+        return;
+
+    inline for (.{ f32, f64 }) |T| {
+        for (runner.sizes(&sizes, quick_sizes)) |n|
+            try compile(T, runner, n);
+    }
+}
+
+fn Compile(comptime T: type) type {
+    return struct {
+        allocator: std.mem.Allocator,
+        matrix: *builder.Sparse(T, .row_major),
+
+        pub fn reset(_: *@This()) void {}
+
+        pub fn run(self: *@This(), _: ?*zml.Arena) !void {
+            var result = try self.matrix.compileCopy(self.allocator, .{});
+            result.deinit(self.allocator);
+        }
+    };
+}
+
+fn compile(comptime T: type, runner: *Runner, n: usize) !void {
+    const allocator: std.mem.Allocator = runner.allocator;
+    const rows: u32 = @intCast(n);
+
+    var matrix: builder.Sparse(T, .row_major) = try .init(allocator, rows, rows, @intCast(band * n));
+    defer matrix.deinit(allocator);
+
+    var nnz: u32 = 0;
+    for (0..n) |i| {
+        const first: usize = i -| band / 2;
+        const last: usize = @min(i + band / 2 + 1, n);
+        for (first..last) |j| {
+            matrix.row[nnz] = @intCast(i);
+            matrix.col[nnz] = @intCast(j);
+            matrix.data[nnz] = if (i == j) @floatFromInt(band) else -1;
+            nnz += 1;
+        }
+    }
+    matrix.nnz = nnz;
+
+    var case: Compile(T) = .{ .allocator = allocator, .matrix = &matrix };
+    const count: f64 = @floatFromInt(nnz);
+    try runner.measure(.{
+        .group = "sparse",
+        .case = "compile",
+        .type = @typeName(T),
+        .size = n,
+        // Reads the entries and their indices, writes the entries, one index
+        // each and the row pointers.
+        .bytes = count * (2 * @sizeOf(T) + 12) + @as(f64, @floatFromInt(n + 1)) * 4,
+    }, &case);
+}
@@ -0,0 +1,91 @@
+//! The routines of the system BLAS and LAPACK libraries given with
+//! `-Dlink_cblas` and `-Dlink_lapacke`, measured alongside zml's own.
+//!
+//! Only `f32` and `f64` are compared. The functions are declared here rather
+//! than imported from the C headers so that the suite builds without them;
+//! they are only referenced, and so only linked, when the matching library is
+//! given.
+
+const options = @import("bench_options");
+
+/// Whether a CBLAS library is linked.
+pub const cblas: bool = options.cblas;
+/// Whether a LAPACKE library is linked.
+pub const lapacke: bool = options.lapacke;
+
+const row_major: c_int = 101;
+const no_trans: c_int = 111;
+const lower: c_int = 122;
+const non_unit: c_int = 131;
+const left: c_int = 141;
+
+extern fn cblas_sgemm(order: c_int, transa: c_int, transb: c_int, m: c_int, n: c_int, k: c_int, alpha: f32, a: [*]const f32, lda: c_int, b: [*]const f32, ldb: c_int, beta: f32, c: [*]f32, ldc: c_int) void;
+extern fn cblas_dgemm(order: c_int, transa: c_int, transb: c_int, m: c_int, n: c_int, k: c_int, alpha: f64, a: [*]const f64, lda: c_int, b: [*]const f64, ldb: c_int, beta: f64, c: [*]f64, ldc: c_int) void;
+extern fn cblas_strsm(order: c_int, side: c_int, uplo: c_int, transa: c_int, diag: c_int, m: c_int, n: c_int, alpha: f32, a: [*]const f32, lda: c_int, b: [*]f32, ldb: c_int) void;
+extern fn cblas_dtrsm(order: c_int, side: c_int, uplo: c_int, transa: c_int, diag: c_int, m: c_int, n: c_int, alpha: f64, a: [*]const f64, lda: c_int, b: [*]f64, ldb: c_int) void;
+extern fn cblas_ssyrk(order: c_int, uplo: c_int, trans: c_int, n: c_int, k: c_int, alpha: f32, a: [*]const f32, lda: c_int, beta: f32, c: [*]f32, ldc: c_int) void;
+extern fn cblas_dsyrk(order: c_int, uplo: c_int, trans: c_int, n: c_int, k: c_int, alpha: f64, a: [*]const f64, lda: c_int, beta: f64, c: [*]f64, ldc: c_int) void;
+
+extern fn LAPACKE_sgetrf(order: c_int, m: c_int, n: c_int, a: [*]f32, lda: c_int, ipiv: [*]c_int) c_int;
+extern fn LAPACKE_dgetrf(order: c_int, m: c_int, n: c_int, a: [*]f64, lda: c_int, ipiv: [*]c_int) c_int;
+extern fn LAPACKE_spotrf(order: c_int, uplo: u8, n: c_int, a: [*]f32, lda: c_int) c_int;
+extern fn LAPACKE_dpotrf(order: c_int, uplo: u8, n: c_int, a: [*]f64, lda: c_int) c_int;
+extern fn LAPACKE_sgeqrf(order: c_int, m: c_int, n: c_int, a: [*]f32, lda: c_int, tau: [*]f32) c_int;
+extern fn LAPACKE_dgeqrf(order: c_int, m: c_int, n: c_int, a: [*]f64, lda: c_int, tau: [*]f64) c_int;
+extern fn LAPACKE_ssytrf(order: c_int, uplo: u8, n: c_int, a: [*]f32, lda: c_int, ipiv: [*]c_int) c_int;
+extern fn LAPACKE_dsytrf(order: c_int, uplo: u8, n: c_int, a: [*]f64, lda: c_int, ipiv: [*]c_int) c_int;
+
+/// `c = a b` for row major `n`×`n` matrices.
+pub fn gemm(comptime T: type, n: c_int, a: [*]const T, b: [*]const T, c: [*]T) void {
+    if (comptime T == f32) {
+        cblas_sgemm(row_major, no_trans, no_trans, n, n, n, 1, a, n, b, n, 0, c, n);
+    } else {
+        cblas_dgemm(row_major, no_trans, no_trans, n, n, n, 1, a, n, b, n, 0, c, n);
+    }
+}
+
+/// `b = a⁻¹ b` for a row major lower triangular `a`.
+pub fn trsm(comptime T: type, n: c_int, a: [*]const T, b: [*]T) void {
+    if (comptime T == f32) {
+        cblas_strsm(row_major, left, lower, no_trans, non_unit, n, n, 1, a, n, b, n);
+    } else {
+        cblas_dtrsm(row_major, left, lower, no_trans, non_unit, n, n, 1, a, n, b, n);
+    }
+}
+
+/// Lower triangle of `c = a aᵀ` for row major `n`×`n` matrices.
+pub fn syrk(comptime T: type, n: c_int, a: [*]const T, c: [*]T) void {
+    if (comptime T == f32) {
+        cblas_ssyrk(row_major, lower, no_trans, n, n, 1, a, n, 0, c, n);
+    } else {
+        cblas_dsyrk(row_major, lower, no_trans, n, n, 1, a, n, 0, c, n);
+    }
+}
+
+pub fn getrf(comptime T: type, n: c_int, a: [*]T, ipiv: [*]i32) i32 {
+    return if (comptime T == f32)
+        LAPACKE_sgetrf(row_major, n, n, a, n, @ptrCast(ipiv))
+    else
+        LAPACKE_dgetrf(row_major, n, n, a, n, @ptrCast(ipiv));
+}
+
+pub fn potrf(comptime T: type, n: c_int, a: [*]T) i32 {
+    return if (comptime T == f32)
+        LAPACKE_spotrf(row_major, 'L', n, a, n)
+    else
+        LAPACKE_dpotrf(row_major, 'L', n, a, n);
+}
+
+pub fn geqrf(comptime T: type, n: c_int, a: [*]T, tau: [*]T) i32 {
+    return if (comptime T == f32)
+        LAPACKE_sgeqrf(row_major, n, n, a, n, tau)
+    else
+        LAPACKE_dgeqrf(row_major, n, n, a, n, tau);
+}
+
+pub fn sytrf(comptime T: type, n: c_int, a: [*]T, ipiv: [*]i32) i32 {
+    return if (comptime T == f32)
+        LAPACKE_ssytrf(row_major, 'L', n, a, n, @ptrCast(ipiv))
+    else
+        LAPACKE_dsytrf(row_major, 'L', n, a, n, @ptrCast(ipiv));
+}
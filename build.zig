@@ -16,6 +16,8 @@ pub fn build(b: *std.Build) void {
     options.addOption(IntMode, "int_mode", opt_int_mode);
     const opt_max_dimensions = b.option(u32, "max_dimensions", "Maximum number of dimensions for `Array`s") orelse 8;
     options.addOption(u32, "max_dimensions", opt_max_dimensions);
+    const opt_threads = b.option(u32, "threads", "Threads used by parallel kernels when no pool is given (0 = one per CPU, 1 = serial)") orelse 1;
+    options.addOption(u32, "threads", opt_threads);
 
     // Option to provide BLAS and LAPACK implementations
     const opt_link_cblas = b.option([]const u8, "link_cblas", "Link CBLAS implementation");
@@ -77,6 +79,25 @@ pub fn build(b: *std.Build) void {
     const cblas_step = b.step("cblas", "Compile CBLAS library");
     cblas_step.dependOn(&cblas_install.step);
 
+    // Shared library with the C API in `include/`
+    const shared_lib = b.addLibrary(.{
+        .linkage = .dynamic,
+        .name = "zml",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("src/libzml.zig"),
+            .target = target,
+            .optimize = optimize,
+        }),
+    });
+
+    shared_lib.root_module.addImport("zml", module);
+    shared_lib.installHeadersDirectory(b.path("include"), "", .{});
+
+    const shared_lib_install = b.addInstallArtifact(shared_lib, .{});
+
+    const shared_lib_step = b.step("lib", "Compile the zml shared library and install its C headers");
+    shared_lib_step.dependOn(&shared_lib_install.step);
+
     // Tests
     const opt_verbose_tests = b.option(bool, "verbose_tests", "Enable verbose output for tests") orelse false;
     options.addOption(bool, "verbose_tests", opt_verbose_tests);
@@ -105,6 +126,70 @@ pub fn build(b: *std.Build) void {
     const test_step = b.step("test", "Run unit tests");
     test_step.dependOn(&run_lib_unit_tests.step);
 
+    // Benchmarks, always optimized and always on zml's own kernels; the system
+    // libraries, if given, are only linked to be measured alongside
+    const native_options = b.addOptions();
+    native_options.addOption(IntMode, "int_mode", opt_int_mode);
+    native_options.addOption(u32, "max_dimensions", opt_max_dimensions);
+    native_options.addOption(u32, "threads", opt_threads);
+    native_options.addOption(?[]const u8, "link_cblas", null);
+    native_options.addOption(?[]const u8, "link_lapacke", null);
+
+    const bench_module = b.createModule(.{
+        .root_source_file = b.path("src/zml.zig"),
+        .target = target,
+        .optimize = .ReleaseFast,
+    });
+    bench_module.addOptions("options", native_options);
+
+    const bench_options = b.addOptions();
+    bench_options.addOption(bool, "cblas", opt_link_cblas != null);
+    bench_options.addOption(bool, "lapacke", opt_link_lapacke != null);
+
+    const bench = b.addExecutable(.{
+        .name = "bench",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("bench/main.zig"),
+            .target = target,
+            .optimize = .ReleaseFast,
+        }),
+    });
+
+    bench.root_module.addImport("zml", bench_module);
+    bench.root_module.addOptions("bench_options", bench_options);
+
+    if (opt_link_cblas != null or opt_link_lapacke != null) {
+        bench.linkLibC();
+    }
+    if (opt_link_cblas != null) {
+        bench.root_module.linkSystemLibrary(opt_link_cblas.?, .{});
+    }
+    if (opt_link_lapacke != null) {
+        bench.root_module.linkSystemLibrary(opt_link_lapacke.?, .{});
+    }
+
+    const run_bench = b.addRunArtifact(bench);
+    if (b.args) |args| {
+        run_bench.addArgs(args);
+    }
+    const bench_step = b.step("bench", "Run the benchmark suite (`-- --json <path>` to also write JSON)");
+    bench_step.dependOn(&run_bench.step);
+
+    const bench_integer = b.addExecutable(.{
+        .name = "bench-integer",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("bench/integer.zig"),
+            .target = target,
+            .optimize = .ReleaseFast,
+        }),
+    });
+
+    bench_integer.root_module.addImport("zml", bench_module);
+
+    const run_bench_integer = b.addRunArtifact(bench_integer);
+    const bench_integer_step = b.step("bench-integer", "Measure the crossover points of Integer multiplication and division");
+    bench_integer_step.dependOn(&run_bench_integer.step);
+
     // Documentation
     const lib = b.addLibrary(.{
         .name = "zml",
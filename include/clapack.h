@@ -1,10 +1,125 @@
 #ifndef CLAPACK_H
 #define CLAPACK_H
 
+#include <stddef.h>
+
+#include "cblas.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+/*
+ * The functions return info, or -1 if an argument is invalid. Complex arrays
+ * are passed as void *.
+ *
+ * Batched functions work on count matrices of the same size at once, and
+ * return 0, or -1 if an argument is invalid; the info of each matrix is
+ * stored in info[i]. Batches are laid out as:
+ * - _batch_strided: matrix i starts at a + i * stride_a.
+ * - _batch: matrix i starts at a[i].
+ * - _batch_interleaved: element k of matrix i is at a[k * stride + i], with
+ *   stride >= count. Real types only.
+ */
+
+/* Linear equations, general matrices */
+int clapack_sgetrf(const CBLAS_ORDER order, const int m, const int n, float *a, const int lda, int *ipiv);
+int clapack_dgetrf(const CBLAS_ORDER order, const int m, const int n, double *a, const int lda, int *ipiv);
+int clapack_cgetrf(const CBLAS_ORDER order, const int m, const int n, void *a, const int lda, int *ipiv);
+int clapack_zgetrf(const CBLAS_ORDER order, const int m, const int n, void *a, const int lda, int *ipiv);
+
+int clapack_sgetrs(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const float *a, const int lda, const int *ipiv, float *b, const int ldb);
+int clapack_dgetrs(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const double *a, const int lda, const int *ipiv, double *b, const int ldb);
+int clapack_cgetrs(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const void *a, const int lda, const int *ipiv, void *b, const int ldb);
+int clapack_zgetrs(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const void *a, const int lda, const int *ipiv, void *b, const int ldb);
+
+int clapack_sgesv(const CBLAS_ORDER order, const int n, const int nrhs, float *a, const int lda, int *ipiv, float *b, const int ldb);
+int clapack_dgesv(const CBLAS_ORDER order, const int n, const int nrhs, double *a, const int lda, int *ipiv, double *b, const int ldb);
+int clapack_cgesv(const CBLAS_ORDER order, const int n, const int nrhs, void *a, const int lda, int *ipiv, void *b, const int ldb);
+int clapack_zgesv(const CBLAS_ORDER order, const int n, const int nrhs, void *a, const int lda, int *ipiv, void *b, const int ldb);
+
+/* Linear equations, positive definite matrices */
+int clapack_spotrf(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, float *a, const int lda);
+int clapack_dpotrf(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, double *a, const int lda);
+int clapack_cpotrf(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, void *a, const int lda);
+int clapack_zpotrf(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, void *a, const int lda);
+
+int clapack_spotrs(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const float *a, const int lda, float *b, const int ldb);
+int clapack_dpotrs(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const double *a, const int lda, double *b, const int ldb);
+int clapack_cpotrs(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const void *a, const int lda, void *b, const int ldb);
+int clapack_zpotrs(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const void *a, const int lda, void *b, const int ldb);
+
+int clapack_sposv(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, float *a, const int lda, float *b, const int ldb);
+int clapack_dposv(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, double *a, const int lda, double *b, const int ldb);
+int clapack_cposv(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, void *a, const int lda, void *b, const int ldb);
+int clapack_zposv(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, void *a, const int lda, void *b, const int ldb);
+
+/* Batches of small matrices */
+int clapack_sgetrf_batch_strided(const CBLAS_ORDER order, const int n, float *a, const int lda, const size_t stride_a, int *ipiv, const size_t stride_ipiv, int *info, const size_t count);
+int clapack_dgetrf_batch_strided(const CBLAS_ORDER order, const int n, double *a, const int lda, const size_t stride_a, int *ipiv, const size_t stride_ipiv, int *info, const size_t count);
+int clapack_cgetrf_batch_strided(const CBLAS_ORDER order, const int n, void *a, const int lda, const size_t stride_a, int *ipiv, const size_t stride_ipiv, int *info, const size_t count);
+int clapack_zgetrf_batch_strided(const CBLAS_ORDER order, const int n, void *a, const int lda, const size_t stride_a, int *ipiv, const size_t stride_ipiv, int *info, const size_t count);
+
+int clapack_sgetrf_batch(const CBLAS_ORDER order, const int n, float *const *a, const int lda, int *const *ipiv, int *info, const size_t count);
+int clapack_dgetrf_batch(const CBLAS_ORDER order, const int n, double *const *a, const int lda, int *const *ipiv, int *info, const size_t count);
+int clapack_cgetrf_batch(const CBLAS_ORDER order, const int n, void *const *a, const int lda, int *const *ipiv, int *info, const size_t count);
+int clapack_zgetrf_batch(const CBLAS_ORDER order, const int n, void *const *a, const int lda, int *const *ipiv, int *info, const size_t count);
+
+int clapack_sgetrf_batch_interleaved(const CBLAS_ORDER order, const int n, float *a, const int lda, int *ipiv, int *info, const size_t stride, const size_t count);
+int clapack_dgetrf_batch_interleaved(const CBLAS_ORDER order, const int n, double *a, const int lda, int *ipiv, int *info, const size_t stride, const size_t count);
+
+int clapack_sgetrs_batch_strided(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const float *a, const int lda, const size_t stride_a, const int *ipiv, const size_t stride_ipiv, float *b, const int ldb, const size_t stride_b, const size_t count);
+int clapack_dgetrs_batch_strided(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const double *a, const int lda, const size_t stride_a, const int *ipiv, const size_t stride_ipiv, double *b, const int ldb, const size_t stride_b, const size_t count);
+int clapack_cgetrs_batch_strided(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const void *a, const int lda, const size_t stride_a, const int *ipiv, const size_t stride_ipiv, void *b, const int ldb, const size_t stride_b, const size_t count);
+int clapack_zgetrs_batch_strided(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const void *a, const int lda, const size_t stride_a, const int *ipiv, const size_t stride_ipiv, void *b, const int ldb, const size_t stride_b, const size_t count);
+
+int clapack_sgetrs_batch(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const float *const *a, const int lda, const int *const *ipiv, float *const *b, const int ldb, const size_t count);
+int clapack_dgetrs_batch(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const double *const *a, const int lda, const int *const *ipiv, double *const *b, const int ldb, const size_t count);
+int clapack_cgetrs_batch(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const void *const *a, const int lda, const int *const *ipiv, void *const *b, const int ldb, const size_t count);
+int clapack_zgetrs_batch(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const void *const *a, const int lda, const int *const *ipiv, void *const *b, const int ldb, const size_t count);
+
+int clapack_sgetrs_batch_interleaved(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const float *a, const int lda, const int *ipiv, float *b, const int ldb, const size_t stride, const size_t count);
+int clapack_dgetrs_batch_interleaved(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans, const int n, const int nrhs, const double *a, const int lda, const int *ipiv, double *b, const int ldb, const size_t stride, const size_t count);
+
+int clapack_spotrf_batch_strided(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, float *a, const int lda, const size_t stride_a, int *info, const size_t count);
+int clapack_dpotrf_batch_strided(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, double *a, const int lda, const size_t stride_a, int *info, const size_t count);
+int clapack_cpotrf_batch_strided(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, void *a, const int lda, const size_t stride_a, int *info, const size_t count);
+int clapack_zpotrf_batch_strided(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, void *a, const int lda, const size_t stride_a, int *info, const size_t count);
+
+int clapack_spotrf_batch(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, float *const *a, const int lda, int *info, const size_t count);
+int clapack_dpotrf_batch(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, double *const *a, const int lda, int *info, const size_t count);
+int clapack_cpotrf_batch(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, void *const *a, const int lda, int *info, const size_t count);
+int clapack_zpotrf_batch(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, void *const *a, const int lda, int *info, const size_t count);
+
+int clapack_spotrf_batch_interleaved(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, float *a, const int lda, int *info, const size_t stride, const size_t count);
+int clapack_dpotrf_batch_interleaved(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, double *a, const int lda, int *info, const size_t stride, const size_t count);
+
+int clapack_spotrs_batch_strided(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const float *a, const int lda, const size_t stride_a, float *b, const int ldb, const size_t stride_b, const size_t count);
+int clapack_dpotrs_batch_strided(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const double *a, const int lda, const size_t stride_a, double *b, const int ldb, const size_t stride_b, const size_t count);
+int clapack_cpotrs_batch_strided(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const void *a, const int lda, const size_t stride_a, void *b, const int ldb, const size_t stride_b, const size_t count);
+int clapack_zpotrs_batch_strided(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const void *a, const int lda, const size_t stride_a, void *b, const int ldb, const size_t stride_b, const size_t count);
+
+int clapack_spotrs_batch(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const float *const *a, const int lda, float *const *b, const int ldb, const size_t count);
+int clapack_dpotrs_batch(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const double *const *a, const int lda, double *const *b, const int ldb, const size_t count);
+int clapack_cpotrs_batch(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const void *const *a, const int lda, void *const *b, const int ldb, const size_t count);
+int clapack_zpotrs_batch(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const void *const *a, const int lda, void *const *b, const int ldb, const size_t count);
+
+int clapack_spotrs_batch_interleaved(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const float *a, const int lda, float *b, const int ldb, const size_t stride, const size_t count);
+int clapack_dpotrs_batch_interleaved(const CBLAS_ORDER order, const CBLAS_UPLO uplo, const int n, const int nrhs, const double *a, const int lda, double *b, const int ldb, const size_t stride, const size_t count);
+
+int clapack_sgeqrf_batch_strided(const CBLAS_ORDER order, const int m, const int n, float *a, const int lda, const size_t stride_a, float *tau, const size_t stride_tau, const size_t count);
+int clapack_dgeqrf_batch_strided(const CBLAS_ORDER order, const int m, const int n, double *a, const int lda, const size_t stride_a, double *tau, const size_t stride_tau, const size_t count);
+int clapack_cgeqrf_batch_strided(const CBLAS_ORDER order, const int m, const int n, void *a, const int lda, const size_t stride_a, void *tau, const size_t stride_tau, const size_t count);
+int clapack_zgeqrf_batch_strided(const CBLAS_ORDER order, const int m, const int n, void *a, const int lda, const size_t stride_a, void *tau, const size_t stride_tau, const size_t count);
+
+int clapack_sgeqrf_batch(const CBLAS_ORDER order, const int m, const int n, float *const *a, const int lda, float *const *tau, const size_t count);
+int clapack_dgeqrf_batch(const CBLAS_ORDER order, const int m, const int n, double *const *a, const int lda, double *const *tau, const size_t count);
+int clapack_cgeqrf_batch(const CBLAS_ORDER order, const int m, const int n, void *const *a, const int lda, void *const *tau, const size_t count);
+int clapack_zgeqrf_batch(const CBLAS_ORDER order, const int m, const int n, void *const *a, const int lda, void *const *tau, const size_t count);
+
+int clapack_sgeqrf_batch_interleaved(const CBLAS_ORDER order, const int m, const int n, float *a, const int lda, float *tau, const size_t stride, const size_t count);
+int clapack_dgeqrf_batch_interleaved(const CBLAS_ORDER order, const int m, const int n, double *a, const int lda, double *tau, const size_t stride, const size_t count);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
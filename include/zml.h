@@ -1,10 +1,35 @@
 #ifndef ZML_H
 #define ZML_H
 
+#include <stddef.h>
+
+#include "cblas.h"
+#include "clapack.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+/*
+ * Batched matrix-matrix products C[i] = alpha * op(A[i]) * op(B[i]) + beta *
+ * C[i] of count matrices of the same size. The batches are laid out as in
+ * clapack.h. They return 0, or -1 if an argument is invalid.
+ */
+
+/* Batches of small matrices */
+int zml_sgemm_batch_strided(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const float alpha, const float *a, const int lda, const size_t stride_a, const float *b, const int ldb, const size_t stride_b, const float beta, float *c, const int ldc, const size_t stride_c, const size_t count);
+int zml_dgemm_batch_strided(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const double alpha, const double *a, const int lda, const size_t stride_a, const double *b, const int ldb, const size_t stride_b, const double beta, double *c, const int ldc, const size_t stride_c, const size_t count);
+int zml_cgemm_batch_strided(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const void *alpha, const void *a, const int lda, const size_t stride_a, const void *b, const int ldb, const size_t stride_b, const void *beta, void *c, const int ldc, const size_t stride_c, const size_t count);
+int zml_zgemm_batch_strided(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const void *alpha, const void *a, const int lda, const size_t stride_a, const void *b, const int ldb, const size_t stride_b, const void *beta, void *c, const int ldc, const size_t stride_c, const size_t count);
+
+int zml_sgemm_batch(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const float alpha, const float *const *a, const int lda, const float *const *b, const int ldb, const float beta, float *const *c, const int ldc, const size_t count);
+int zml_dgemm_batch(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const double alpha, const double *const *a, const int lda, const double *const *b, const int ldb, const double beta, double *const *c, const int ldc, const size_t count);
+int zml_cgemm_batch(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const void *alpha, const void *const *a, const int lda, const void *const *b, const int ldb, const void *beta, void *const *c, const int ldc, const size_t count);
+int zml_zgemm_batch(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const void *alpha, const void *const *a, const int lda, const void *const *b, const int ldb, const void *beta, void *const *c, const int ldc, const size_t count);
+
+int zml_sgemm_batch_interleaved(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const float alpha, const float *a, const int lda, const float *b, const int ldb, const float beta, float *c, const int ldc, const size_t stride, const size_t count);
+int zml_dgemm_batch_interleaved(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa, const CBLAS_TRANSPOSE transb, const int m, const int n, const int k, const double alpha, const double *a, const int lda, const double *b, const int ldb, const double beta, double *c, const int ldc, const size_t stride, const size_t count);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
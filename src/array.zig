@@ -36,6 +36,8 @@ pub const apply1_ = arrops.apply1_;
 pub const apply2 = arrops.apply2;
 pub const apply2_ = arrops.apply2_;
 
+pub const lazy = @import("array/lazy.zig");
+
 pub const add = arrops.add;
 pub const add_ = arrops.add_;
 pub const sub = arrops.sub;
@@ -139,6 +141,39 @@ pub const lgamma_ = arrops.lgamma_;
 pub const ceil = arrops.ceil;
 pub const ceil_ = arrops.ceil_;
 
+// Reductions
+const reduce = @import("array/reduce.zig");
+pub const sum = reduce.sum;
+pub const sumAxes = reduce.sumAxes;
+pub const sumAxes_ = reduce.sumAxes_;
+pub const prod = reduce.prod;
+pub const prodAxes = reduce.prodAxes;
+pub const prodAxes_ = reduce.prodAxes_;
+pub const amin = reduce.amin;
+pub const aminAxes = reduce.aminAxes;
+pub const aminAxes_ = reduce.aminAxes_;
+pub const amax = reduce.amax;
+pub const amaxAxes = reduce.amaxAxes;
+pub const amaxAxes_ = reduce.amaxAxes_;
+pub const argmin = reduce.argmin;
+pub const argminAxes = reduce.argminAxes;
+pub const argminAxes_ = reduce.argminAxes_;
+pub const argmax = reduce.argmax;
+pub const argmaxAxes = reduce.argmaxAxes;
+pub const argmaxAxes_ = reduce.argmaxAxes_;
+pub const mean = reduce.mean;
+pub const meanAxes = reduce.meanAxes;
+pub const meanAxes_ = reduce.meanAxes_;
+pub const variance = reduce.variance;
+pub const varianceAxes = reduce.varianceAxes;
+pub const varianceAxes_ = reduce.varianceAxes_;
+pub const norm = reduce.norm;
+pub const normAxes = reduce.normAxes;
+pub const normAxes_ = reduce.normAxes_;
+pub const dot = reduce.dot;
+pub const dotAxes = reduce.dotAxes;
+pub const dotAxes_ = reduce.dotAxes_;
+
 pub const Broadcast = struct {
     ndim: u32,
     shape: [max_dimensions]u32,
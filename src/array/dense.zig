@@ -16,6 +16,7 @@ const Coerce = types.Coerce;
 
 const ops = @import("../ops.zig");
 const int = @import("../int.zig");
+const float = @import("../float.zig");
 
 const array = @import("../array.zig");
 const Order = types.Layout;
@@ -42,6 +43,7 @@ pub fn Dense(T: type, order: Order) type {
         /// Type signatures
         pub const is_array = {};
         pub const is_dense = {};
+        pub const storage_layout = order;
 
         /// Numeric type
         pub const Numeric = T;
@@ -1136,6 +1138,38 @@ fn loop1(
     }
 }
 
+/// Returns the `float.batch` kernel computing `op` element-wise from `X` to
+/// `R`, or `null` if there is none. `op` may be the allocating or the in-place
+/// version of the operation, or the scalar function of `float`.
+pub fn batchKernel(comptime op: anytype, comptime X: type, comptime R: type) ?float.batch.Kernel {
+    if (X != R or !float.batch.supports(X))
+        return null;
+
+    const table = .{
+        .{ .exp, ops.exp, ops.exp_, float.exp },
+        .{ .exp2, ops.exp2, ops.exp2_, float.exp2 },
+        .{ .log, ops.log, ops.log_, float.log },
+        .{ .log2, ops.log2, ops.log2_, float.log2 },
+        .{ .log10, ops.log10, ops.log10_, float.log10 },
+        .{ .sqrt, ops.sqrt, ops.sqrt_, float.sqrt },
+        .{ .sin, ops.sin, ops.sin_, float.sin },
+        .{ .cos, ops.cos, ops.cos_, float.cos },
+        .{ .tanh, ops.tanh, ops.tanh_, float.tanh },
+        .{ .erf, ops.erf, ops.erf_, float.erf },
+    };
+
+    inline for (table) |entry| {
+        if (sameFn(op, entry[1]) or sameFn(op, entry[2]) or sameFn(op, entry[3]))
+            return entry[0];
+    }
+
+    return null;
+}
+
+inline fn sameFn(comptime a: anytype, comptime b: anytype) bool {
+    return @TypeOf(a) == @TypeOf(b) and a == b;
+}
+
 pub fn apply1(
     allocator: std.mem.Allocator,
     x: anytype,
@@ -1151,13 +1185,19 @@ pub fn apply1(
         // Trivial loop
         //errdefer cleanup(ReturnType1(op, X), allocator, result.data[0..j]);
 
-        const opinfo = @typeInfo(@TypeOf(op));
-        var i: u32 = 0;
-        while (i < result.size) : (i += 1) {
-            if (comptime opinfo.@"fn".params.len == 1) {
-                result.data[i] = op(x.data[i]);
-            } else if (comptime opinfo.@"fn".params.len == 2) {
-                result.data[i] = try op(x.data[i], ctx);
+        if (comptime batchKernel(op, X, ReturnType1(op, X))) |kernel| {
+            comptime types.validateContext(@TypeOf(ctx), .{});
+
+            float.batch.map(kernel, X, result.data, x.data, types.scast(usize, result.size));
+        } else {
+            const opinfo = @typeInfo(@TypeOf(op));
+            var i: u32 = 0;
+            while (i < result.size) : (i += 1) {
+                if (comptime opinfo.@"fn".params.len == 1) {
+                    result.data[i] = op(x.data[i]);
+                } else if (comptime opinfo.@"fn".params.len == 2) {
+                    result.data[i] = try op(x.data[i], ctx);
+                }
             }
         }
     } else {
@@ -1189,6 +1229,13 @@ pub fn apply1_(
     if (std.mem.eql(u32, o.shape[0..o.ndim], x.shape[0..x.ndim])) {
         if (std.mem.eql(u32, o.strides[0..o.ndim], x.strides[0..x.ndim])) {
             // Trivial loop
+            if (comptime batchKernel(op_, X, Numeric(@TypeOf(o.*)))) |kernel| {
+                comptime types.validateContext(@TypeOf(ctx), .{});
+
+                float.batch.map(kernel, X, o.data, x.data, types.scast(usize, o.size));
+                return;
+            }
+
             const opinfo = @typeInfo(@TypeOf(op_));
             for (0..o.size) |i| {
                 if (comptime opinfo.@"fn".params.len == 2) {
@@ -0,0 +1,811 @@
+//! Lazy element-wise expressions over arrays.
+//!
+//! The functions in this namespace mirror the element-wise operations of
+//! `array` (`add`, `mul`, `exp`, ...), but instead of computing a result they
+//! return a small value whose type records the whole expression:
+//!
+//! ```zig
+//! const lazy = zml.array.lazy;
+//!
+//! const e = lazy.add(lazy.mul(a, b), lazy.exp(c)); // nothing computed yet
+//! try lazy.eval_(&o, e, .{}); // one pass over memory
+//! ```
+//!
+//! Operands may be dense or strided arrays, numeric values or other
+//! expressions, and are broadcast together as with `array.broadcastShapes`.
+//! Evaluating an expression computes every element of the destination from
+//! the operands directly, so no temporary array is allocated however deep the
+//! expression is. Before the loop, the dimensions are ordered by the strides of
+//! the destination and the ones that are contiguous for every operand are
+//! merged, so most expressions run as a single flat loop. The innermost loop
+//! uses `@Vector` when every node of the expression supports it (`f32` and
+//! `f64` arithmetic and the `float.batch` kernels), and large destinations are
+//! split over the current pool.
+//!
+//! Only fixed precision element types are supported. The element operations
+//! are the ones of `ops`, called with an empty context; their errors (for
+//! example `error.NegativeExponent` from an integer `pow`) are returned by
+//! `eval` and `eval_`.
+
+const std = @import("std");
+
+const types = @import("../types.zig");
+const ops = @import("../ops.zig");
+const float = @import("../float.zig");
+
+const pool = @import("../pool.zig");
+const Pool = pool.Pool;
+
+const array = @import("../array.zig");
+const max_dimensions = array.max_dimensions;
+
+const dense = @import("dense.zig");
+const Dense = dense.Dense;
+
+const loop = @import("loop.zig");
+const offset = loop.offset;
+
+/// Parts per thread, so that uneven parts balance themselves.
+const parts_per_thread: usize = 4;
+/// Minimum length of a part when a single line is split.
+const min_part: usize = 1 << 12;
+/// Maximum number of parts, so their errors fit in a fixed buffer.
+const max_parts: usize = pool.max_lanes * parts_per_thread;
+
+const eval_context = .{
+    .pool = .{
+        .type = ?*Pool,
+        .required = false,
+        .default = null,
+        .description = "The pool to run on. If not provided, the current pool is used (see `zml.pool.current`).",
+    },
+};
+
+// Every expression type has the declarations `is_lazy`, `Numeric` (the
+// element type), `Error` (the errors of its element operations) and `leaves`
+// (the number of array operands), and the methods below, which forward to the
+// operands:
+// - `vectorizable(T)`: whether `load` is available for elements of type `T`.
+// - `shapes`, `bind`, `strideSets`: collect the operand shapes, compute the
+//   broadcast strides of the arrays and expose them for reordering.
+// - `seek(index)`: positions the arrays at the start of a line.
+// - `unitInner()`: whether every array is contiguous or broadcast along the
+//   line.
+// - `get(j)` and `load(T, n, j)`: element `j` of the line, or elements
+//   `j..j + n` as a vector.
+
+/// Checks if `T` is a lazy expression type.
+pub fn isExpression(comptime T: type) bool {
+    return @typeInfo(T) == .@"struct" and @hasDecl(T, "is_lazy");
+}
+
+/// The expression type a value of type `X` becomes when used as an operand.
+pub fn Wrap(comptime X: type) type {
+    if (comptime isExpression(X))
+        return X;
+
+    if (comptime types.isDenseArray(X) or types.isStridedArray(X))
+        return Leaf(X);
+
+    if (comptime X == comptime_int or X == comptime_float)
+        @compileError("zml.array.lazy: numeric operands must have a runtime type, use @as to give " ++ @typeName(X) ++ " one");
+
+    if (comptime types.isNumeric(X))
+        return Scalar(X);
+
+    @compileError("zml.array.lazy: operands must be dense or strided arrays, numeric values or lazy expressions, got " ++ @typeName(X));
+}
+
+fn wrap(x: anytype) Wrap(@TypeOf(x)) {
+    const X: type = @TypeOf(x);
+
+    if (comptime isExpression(X))
+        return x;
+
+    if (comptime types.isDenseArray(X) or types.isStridedArray(X))
+        return .{ .array = x };
+
+    return .{ .value = x };
+}
+
+fn checkNumeric(comptime T: type) void {
+    switch (comptime types.numericType(T)) {
+        .bool, .int, .float, .cfloat => {},
+        else => @compileError("zml.array.lazy: only fixed precision types are supported, got " ++ @typeName(T)),
+    }
+}
+
+fn Payload(comptime R: type) type {
+    return switch (@typeInfo(R)) {
+        .error_union => |info| info.payload,
+        else => R,
+    };
+}
+
+fn Return1(comptime op: anytype, comptime X: type) type {
+    return Payload(@TypeOf(op(@as(X, undefined), .{})));
+}
+
+fn Return2(comptime op: anytype, comptime X: type, comptime Y: type) type {
+    return Payload(@TypeOf(op(@as(X, undefined), @as(Y, undefined), .{})));
+}
+
+fn ErrorOf(comptime R: type) type {
+    return switch (@typeInfo(R)) {
+        .error_union => |info| info.error_set,
+        else => error{},
+    };
+}
+
+fn Error1(comptime op: anytype, comptime X: type) type {
+    return ErrorOf(@TypeOf(op(@as(X, undefined), .{})));
+}
+
+fn Error2(comptime op: anytype, comptime X: type, comptime Y: type) type {
+    return ErrorOf(@TypeOf(op(@as(X, undefined), @as(Y, undefined), .{})));
+}
+
+inline fn sameFn(comptime a: anytype, comptime b: anytype) bool {
+    return @TypeOf(a) == @TypeOf(b) and a == b;
+}
+
+fn vectorUnary(comptime op: anytype, comptime T: type) bool {
+    return sameFn(op, ops.neg) or sameFn(op, ops.abs) or dense.batchKernel(op, T, T) != null;
+}
+
+inline fn applyUnary(comptime op: anytype, comptime T: type, v: anytype) @TypeOf(v) {
+    if (comptime sameFn(op, ops.neg))
+        return -v;
+
+    if (comptime sameFn(op, ops.abs))
+        return @abs(v);
+
+    return float.batch.apply(comptime dense.batchKernel(op, T, T).?, v);
+}
+
+fn vectorBinary(comptime op: anytype) bool {
+    return sameFn(op, ops.add) or sameFn(op, ops.sub) or sameFn(op, ops.mul) or sameFn(op, ops.div);
+}
+
+inline fn applyBinary(comptime op: anytype, a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    if (comptime sameFn(op, ops.add))
+        return a + b;
+
+    if (comptime sameFn(op, ops.sub))
+        return a - b;
+
+    if (comptime sameFn(op, ops.mul))
+        return a * b;
+
+    return a / b;
+}
+
+/// An array operand.
+pub fn Leaf(comptime A: type) type {
+    return struct {
+        array: A,
+        /// Strides against the broadcast shape, in loop order once bound.
+        strides: [max_dimensions]isize = .{0} ** max_dimensions,
+        /// Start and stride of the current line.
+        cursor: isize = 0,
+        step: isize = 0,
+
+        pub const is_lazy = {};
+        pub const Numeric = types.Numeric(A);
+        pub const Error = error{};
+        pub const leaves = 1;
+
+        const Self = @This();
+
+        comptime {
+            checkNumeric(Numeric);
+        }
+
+        fn vectorizable(comptime T: type) bool {
+            return Numeric == T;
+        }
+
+        fn shapes(self: *const Self, list: [][]const u32, k: *usize) void {
+            list[k.*] = self.array.shape[0..self.array.ndim];
+            k.* += 1;
+        }
+
+        fn bind(self: *Self, shape: []const u32) void {
+            const diff: usize = shape.len - self.array.ndim;
+            for (shape, 0..) |n, d| {
+                if (d < diff or (self.array.shape[d - diff] == 1 and n != 1))
+                    self.strides[d] = 0 // Broadcast dimension
+                else
+                    self.strides[d] = @intCast(self.array.strides[d - diff]);
+            }
+        }
+
+        fn strideSets(self: *Self, list: []*[max_dimensions]isize, k: *usize) void {
+            list[k.*] = &self.strides;
+            k.* += 1;
+        }
+
+        fn seek(self: *Self, index: []const u32) void {
+            var c: isize = if (comptime types.isStridedArray(A)) @intCast(self.array.offset) else 0;
+            for (index, 0..) |i, d|
+                c += @as(isize, i) * self.strides[d];
+
+            self.cursor = c;
+            self.step = self.strides[index.len];
+        }
+
+        fn unitInner(self: *const Self) bool {
+            return self.step == 0 or self.step == 1;
+        }
+
+        inline fn get(self: *const Self, j: usize) Error!Numeric {
+            return self.array.data[offset(self.cursor, j, self.step)];
+        }
+
+        inline fn load(self: *const Self, comptime T: type, comptime n: usize, j: usize) @Vector(n, T) {
+            if (self.step == 0)
+                return @splat(self.array.data[offset(self.cursor, 0, 0)]);
+
+            return self.array.data[offset(self.cursor, j, 1)..][0..n].*;
+        }
+    };
+}
+
+/// A numeric operand, broadcast to every element.
+pub fn Scalar(comptime S: type) type {
+    return struct {
+        value: S,
+
+        pub const is_lazy = {};
+        pub const Numeric = S;
+        pub const Error = error{};
+        pub const leaves = 0;
+
+        const Self = @This();
+
+        comptime {
+            checkNumeric(Numeric);
+        }
+
+        fn vectorizable(comptime T: type) bool {
+            return switch (comptime types.numericType(S)) {
+                .bool, .int, .float => types.numericType(T) == .float,
+                else => false,
+            };
+        }
+
+        fn shapes(_: *const Self, _: [][]const u32, _: *usize) void {}
+
+        fn bind(_: *Self, _: []const u32) void {}
+
+        fn strideSets(_: *Self, _: []*[max_dimensions]isize, _: *usize) void {}
+
+        fn seek(_: *Self, _: []const u32) void {}
+
+        fn unitInner(_: *const Self) bool {
+            return true;
+        }
+
+        inline fn get(self: *const Self, _: usize) Error!Numeric {
+            return self.value;
+        }
+
+        inline fn load(self: *const Self, comptime T: type, comptime n: usize, _: usize) @Vector(n, T) {
+            return @splat(types.scast(T, self.value));
+        }
+    };
+}
+
+/// `op(x)` element-wise, where `op` is a unary function of `ops`.
+pub fn Unary(comptime op: anytype, comptime X: type) type {
+    return struct {
+        x: X,
+
+        pub const is_lazy = {};
+        pub const Numeric = Return1(op, X.Numeric);
+        pub const Error = X.Error || Error1(op, X.Numeric);
+        pub const leaves = X.leaves;
+
+        const Self = @This();
+
+        comptime {
+            checkNumeric(Numeric);
+        }
+
+        fn vectorizable(comptime T: type) bool {
+            return Numeric == T and vectorUnary(op, T) and X.vectorizable(T);
+        }
+
+        fn shapes(self: *const Self, list: [][]const u32, k: *usize) void {
+            self.x.shapes(list, k);
+        }
+
+        fn bind(self: *Self, shape: []const u32) void {
+            self.x.bind(shape);
+        }
+
+        fn strideSets(self: *Self, list: []*[max_dimensions]isize, k: *usize) void {
+            self.x.strideSets(list, k);
+        }
+
+        fn seek(self: *Self, index: []const u32) void {
+            self.x.seek(index);
+        }
+
+        fn unitInner(self: *const Self) bool {
+            return self.x.unitInner();
+        }
+
+        inline fn get(self: *const Self, j: usize) Error!Numeric {
+            return op(try self.x.get(j), .{});
+        }
+
+        inline fn load(self: *const Self, comptime T: type, comptime n: usize, j: usize) @Vector(n, T) {
+            return applyUnary(op, T, self.x.load(T, n, j));
+        }
+    };
+}
+
+/// `op(x, y)` element-wise, where `op` is a binary function of `ops`.
+pub fn Binary(comptime op: anytype, comptime X: type, comptime Y: type) type {
+    return struct {
+        x: X,
+        y: Y,
+
+        pub const is_lazy = {};
+        pub const Numeric = Return2(op, X.Numeric, Y.Numeric);
+        pub const Error = X.Error || Y.Error || Error2(op, X.Numeric, Y.Numeric);
+        pub const leaves = X.leaves + Y.leaves;
+
+        const Self = @This();
+
+        comptime {
+            checkNumeric(Numeric);
+        }
+
+        fn vectorizable(comptime T: type) bool {
+            return Numeric == T and vectorBinary(op) and X.vectorizable(T) and Y.vectorizable(T);
+        }
+
+        fn shapes(self: *const Self, list: [][]const u32, k: *usize) void {
+            self.x.shapes(list, k);
+            self.y.shapes(list, k);
+        }
+
+        fn bind(self: *Self, shape: []const u32) void {
+            self.x.bind(shape);
+            self.y.bind(shape);
+        }
+
+        fn strideSets(self: *Self, list: []*[max_dimensions]isize, k: *usize) void {
+            self.x.strideSets(list, k);
+            self.y.strideSets(list, k);
+        }
+
+        fn seek(self: *Self, index: []const u32) void {
+            self.x.seek(index);
+            self.y.seek(index);
+        }
+
+        fn unitInner(self: *const Self) bool {
+            return self.x.unitInner() and self.y.unitInner();
+        }
+
+        inline fn get(self: *const Self, j: usize) Error!Numeric {
+            return op(try self.x.get(j), try self.y.get(j), .{});
+        }
+
+        inline fn load(self: *const Self, comptime T: type, comptime n: usize, j: usize) @Vector(n, T) {
+            return applyBinary(op, self.x.load(T, n, j), self.y.load(T, n, j));
+        }
+    };
+}
+
+fn Unary1(comptime op: anytype, comptime X: type) type {
+    return Unary(op, Wrap(X));
+}
+
+fn Binary2(comptime op: anytype, comptime X: type, comptime Y: type) type {
+    return Binary(op, Wrap(X), Wrap(Y));
+}
+
+// Basic operations
+pub fn add(x: anytype, y: anytype) Binary2(ops.add, @TypeOf(x), @TypeOf(y)) {
+    return .{ .x = wrap(x), .y = wrap(y) };
+}
+
+pub fn sub(x: anytype, y: anytype) Binary2(ops.sub, @TypeOf(x), @TypeOf(y)) {
+    return .{ .x = wrap(x), .y = wrap(y) };
+}
+
+pub fn mul(x: anytype, y: anytype) Binary2(ops.mul, @TypeOf(x), @TypeOf(y)) {
+    return .{ .x = wrap(x), .y = wrap(y) };
+}
+
+pub fn div(x: anytype, y: anytype) Binary2(ops.div, @TypeOf(x), @TypeOf(y)) {
+    return .{ .x = wrap(x), .y = wrap(y) };
+}
+
+pub fn max(x: anytype, y: anytype) Binary2(ops.max, @TypeOf(x), @TypeOf(y)) {
+    return .{ .x = wrap(x), .y = wrap(y) };
+}
+
+pub fn min(x: anytype, y: anytype) Binary2(ops.min, @TypeOf(x), @TypeOf(y)) {
+    return .{ .x = wrap(x), .y = wrap(y) };
+}
+
+pub fn neg(x: anytype) Unary1(ops.neg, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn abs(x: anytype) Unary1(ops.abs, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+// Exponential functions
+pub fn exp(x: anytype) Unary1(ops.exp, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn exp2(x: anytype) Unary1(ops.exp2, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn log(x: anytype) Unary1(ops.log, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn log10(x: anytype) Unary1(ops.log10, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn log2(x: anytype) Unary1(ops.log2, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+// Power functions
+pub fn pow(x: anytype, y: anytype) Binary2(ops.pow, @TypeOf(x), @TypeOf(y)) {
+    return .{ .x = wrap(x), .y = wrap(y) };
+}
+
+pub fn sqrt(x: anytype) Unary1(ops.sqrt, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn cbrt(x: anytype) Unary1(ops.cbrt, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn hypot(x: anytype, y: anytype) Binary2(ops.hypot, @TypeOf(x), @TypeOf(y)) {
+    return .{ .x = wrap(x), .y = wrap(y) };
+}
+
+// Trigonometric functions
+pub fn sin(x: anytype) Unary1(ops.sin, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn cos(x: anytype) Unary1(ops.cos, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn tan(x: anytype) Unary1(ops.tan, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn asin(x: anytype) Unary1(ops.asin, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn acos(x: anytype) Unary1(ops.acos, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn atan(x: anytype) Unary1(ops.atan, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn atan2(x: anytype, y: anytype) Binary2(ops.atan2, @TypeOf(x), @TypeOf(y)) {
+    return .{ .x = wrap(x), .y = wrap(y) };
+}
+
+// Hyperbolic functions
+pub fn sinh(x: anytype) Unary1(ops.sinh, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn cosh(x: anytype) Unary1(ops.cosh, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn tanh(x: anytype) Unary1(ops.tanh, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn asinh(x: anytype) Unary1(ops.asinh, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn acosh(x: anytype) Unary1(ops.acosh, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn atanh(x: anytype) Unary1(ops.atanh, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+// Error and gamma functions
+pub fn erf(x: anytype) Unary1(ops.erf, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn erfc(x: anytype) Unary1(ops.erfc, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn gamma(x: anytype) Unary1(ops.gamma, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+pub fn lgamma(x: anytype) Unary1(ops.lgamma, @TypeOf(x)) {
+    return .{ .x = wrap(x) };
+}
+
+/// Evaluates the expression `expr` into a newly allocated dense array with
+/// the broadcast shape of its operands.
+///
+/// Parameters
+/// ----------
+/// `allocator` (`std.mem.Allocator`):
+/// The allocator to use for the result.
+///
+/// `expr` (`anytype`):
+/// The expression to evaluate. Plain arrays are also accepted.
+///
+/// `ctx` (`anytype`):
+/// A context struct with an optional `pool` field (`?*Pool`), the pool to
+/// run on.
+///
+/// Returns
+/// -------
+/// `array.Dense(Wrap(@TypeOf(expr)).Numeric, types.default_layout)`:
+/// The value of the expression.
+///
+/// Errors
+/// ------
+/// `std.mem.Allocator.Error.OutOfMemory`:
+/// If memory allocation fails.
+///
+/// `array.Error.NotBroadcastable`:
+/// If the shapes of the operands cannot be broadcast together.
+///
+/// `Wrap(@TypeOf(expr)).Error`:
+/// The first error of an element operation, for example
+/// `error.NegativeExponent` from `pow` on integers.
+pub fn eval(
+    allocator: std.mem.Allocator,
+    expr: anytype,
+    ctx: anytype,
+) !Dense(Wrap(@TypeOf(expr)).Numeric, types.default_layout) {
+    const E: type = Wrap(@TypeOf(expr));
+
+    const e: E = wrap(expr);
+    const bct: array.Broadcast = try broadcast(E, &e);
+
+    var result: Dense(E.Numeric, types.default_layout) = try .init(allocator, bct.shape[0..bct.ndim]);
+    errdefer result.deinit(allocator);
+
+    try eval_(&result, e, ctx);
+
+    return result;
+}
+
+/// Evaluates the expression `expr` into `o`, in a single pass and without
+/// allocating.
+///
+/// Parameters
+/// ----------
+/// `o` (`anytype`):
+/// A mutable pointer to a dense or strided array whose shape is the
+/// broadcast shape of the operands. It may be one of the operands, as long as
+/// it is read by every node at the element being written.
+///
+/// `expr` (`anytype`):
+/// The expression to evaluate. Plain arrays are also accepted.
+///
+/// `ctx` (`anytype`):
+/// A context struct with an optional `pool` field (`?*Pool`), the pool to
+/// run on.
+///
+/// Returns
+/// -------
+/// `void`
+///
+/// Errors
+/// ------
+/// `array.Error.NotBroadcastable`:
+/// If the shapes of the operands cannot be broadcast together, or their
+/// broadcast shape is not the shape of `o`.
+///
+/// `Wrap(@TypeOf(expr)).Error`:
+/// The first error of an element operation, for example
+/// `error.NegativeExponent` from `pow` on integers. The elements of `o` are
+/// then only partially written.
+pub fn eval_(
+    o: anytype,
+    expr: anytype,
+    ctx: anytype,
+) !void {
+    comptime var O: type = @TypeOf(o);
+
+    comptime if (!types.isPointer(O) or types.isConstPointer(O))
+        @compileError("zml.array.lazy.eval_ requires the output to be a mutable pointer, got " ++ @typeName(O));
+
+    O = types.Child(O);
+
+    comptime if (!types.isDenseArray(O) and !types.isStridedArray(O))
+        @compileError("zml.array.lazy.eval_ requires the output to be a dense or strided array, got " ++ @typeName(O));
+
+    comptime types.validateContext(@TypeOf(ctx), eval_context);
+
+    const T: type = types.Numeric(O);
+    comptime checkNumeric(T);
+
+    const E: type = Wrap(@TypeOf(expr));
+    var e: E = wrap(expr);
+
+    const bct: array.Broadcast = try broadcast(E, &e);
+    if (!std.mem.eql(u32, bct.shape[0..bct.ndim], o.shape[0..o.ndim]))
+        return array.Error.NotBroadcastable;
+
+    e.bind(bct.shape[0..bct.ndim]);
+
+    var out: Output(T) = .{
+        .data = o.data,
+        .base = if (comptime types.isStridedArray(O)) @intCast(o.offset) else 0,
+    };
+    for (0..o.ndim) |d|
+        out.strides[d] = @intCast(o.strides[d]);
+
+    var sets: [E.leaves + 1]*[max_dimensions]isize = undefined;
+    sets[0] = &out.strides;
+    var k: usize = 1;
+    e.strideSets(&sets, &k);
+
+    var shape: [max_dimensions]u32 = bct.shape;
+    const ndim: u32 = loop.normalize(bct.ndim, &shape, &sets);
+
+    var lines: usize = 1;
+    for (shape[0 .. ndim - 1]) |n|
+        lines *= n;
+
+    const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, eval_context, "pool"));
+    defer pool.leave(previous);
+
+    var job: Job(E, T) = .{
+        .e = e,
+        .out = out,
+        .ndim = ndim,
+        .shape = shape,
+        .lines = lines,
+        .parts = 1,
+        .failures = undefined,
+    };
+
+    const workers: *Pool = loop.team(o.size) orelse return job.part(0);
+
+    const len: usize = shape[ndim - 1];
+    const threads: usize = @min(workers.size() * parts_per_thread, max_parts);
+    job.parts = if (lines == 1)
+        @max(1, @min(len / min_part, threads))
+    else
+        @min(lines, threads);
+
+    // Every part records its own error, and the one of the earliest part is
+    // returned, as a serial evaluation would.
+    var failures: [max_parts]?E.Error = @splat(null);
+    job.failures = &failures;
+
+    workers.parallelFor(job.parts, job, Job(E, T).run);
+
+    for (failures[0..job.parts]) |failure| {
+        if (failure) |err|
+            return err;
+    }
+}
+
+/// Broadcast shape of the array operands of `e`.
+fn broadcast(comptime E: type, e: *const E) !array.Broadcast {
+    comptime if (E.leaves == 0)
+        @compileError("zml.array.lazy: the expression must have at least one array operand");
+
+    var shapes: [E.leaves][]const u32 = undefined;
+    var k: usize = 0;
+    e.shapes(&shapes, &k);
+
+    return array.broadcastShapes(&shapes);
+}
+
+fn Output(comptime T: type) type {
+    return struct {
+        data: [*]T,
+        strides: [max_dimensions]isize = .{0} ** max_dimensions,
+        base: isize,
+    };
+}
+
+fn Job(comptime E: type, comptime T: type) type {
+    return struct {
+        e: E,
+        out: Output(T),
+        ndim: u32,
+        shape: [max_dimensions]u32,
+        lines: usize,
+        parts: usize,
+        /// Error of every part, when split over a pool.
+        failures: [*]?E.Error,
+
+        const Self = @This();
+
+        fn run(job: Self, _: usize, index: usize) void {
+            job.part(index) catch |err| {
+                job.failures[index] = err;
+            };
+        }
+
+        /// Runs part `index` of `parts`: a range of lines, or a range of the
+        /// only line. Every part works on its own copy of the expression, and
+        /// stops at the first error.
+        fn part(job: *const Self, index: usize) E.Error!void {
+            var e: E = job.e;
+            const len: usize = job.shape[job.ndim - 1];
+
+            if (job.lines == 1) {
+                try job.lineRange(&e, 0, 1, loop.split(len, index, job.parts, 64), loop.split(len, index + 1, job.parts, 64));
+            } else {
+                try job.lineRange(&e, loop.split(job.lines, index, job.parts, 1), loop.split(job.lines, index + 1, job.parts, 1), 0, len);
+            }
+        }
+
+        fn lineRange(job: *const Self, e: *E, l0: usize, l1: usize, j0: usize, j1: usize) E.Error!void {
+            const outer: u32 = job.ndim - 1;
+            var index: [max_dimensions]u32 = undefined;
+
+            var l: usize = l0;
+            while (l < l1) : (l += 1) {
+                var rest: usize = l;
+                var d: u32 = outer;
+                while (d > 0) {
+                    d -= 1;
+                    index[d] = @intCast(rest % job.shape[d]);
+                    rest /= job.shape[d];
+                }
+
+                e.seek(index[0..outer]);
+
+                var c: isize = job.out.base;
+                for (index[0..outer], 0..) |i, dd|
+                    c += @as(isize, i) * job.out.strides[dd];
+
+                try line(E, T, e, job.out.data, c, job.out.strides[outer], j0, j1);
+            }
+        }
+    };
+}
+
+/// Elements `j0..j1` of the current line of `e`, written to the line of
+/// `data` starting at `cursor` with stride `step`.
+fn line(comptime E: type, comptime T: type, e: *const E, data: [*]T, cursor: isize, step: isize, j0: usize, j1: usize) E.Error!void {
+    var j: usize = j0;
+
+    if (comptime float.batch.supports(T) and E.vectorizable(T)) {
+        if (step == 1 and e.unitInner()) {
+            const n: comptime_int = comptime std.simd.suggestVectorLength(T).?;
+            while (j + n <= j1) : (j += n)
+                data[offset(cursor, j, 1)..][0..n].* = e.load(T, n, j);
+        }
+    }
+
+    while (j < j1) : (j += 1)
+        data[offset(cursor, j, step)] = types.scast(T, try e.get(j));
+}
@@ -0,0 +1,105 @@
+//! Loop nest helpers shared by `lazy` expressions and reductions: reordering
+//! and merging the dimensions of a loop nest, and splitting it over the pool.
+
+const pool = @import("../pool.zig");
+const Pool = pool.Pool;
+
+const array = @import("../array.zig");
+const max_dimensions = array.max_dimensions;
+
+/// Number of elements from which a loop nest is split over the pool.
+const parallel_threshold: u64 = 1 << 16;
+
+/// Index of element `j` of a line starting at `cursor` with stride `step`.
+pub inline fn offset(cursor: isize, j: usize, step: isize) usize {
+    return @intCast(cursor + @as(isize, @intCast(j)) * step);
+}
+
+/// Returns the pool to split `work` elements over, or `null` to run serially.
+pub fn team(work: u64) ?*Pool {
+    if (work < parallel_threshold)
+        return null;
+
+    const current: *Pool = pool.current() orelse return null;
+    return if (current.size() > 1) current else null;
+}
+
+/// Drops the dimensions of length 1, orders the others from outermost to
+/// innermost by the strides of `sets[0]` and merges neighbours that are
+/// contiguous for every stride set. Returns the new number of dimensions; the
+/// last one is the line the inner loop runs along.
+pub fn normalize(ndim: u32, shape: *[max_dimensions]u32, sets: []const *[max_dimensions]isize) u32 {
+    var perm: [max_dimensions]u32 = undefined;
+    var nd: u32 = 0;
+    for (0..ndim) |d| {
+        if (shape[d] != 1) {
+            perm[nd] = @intCast(d);
+            nd += 1;
+        }
+    }
+
+    if (nd == 0) {
+        shape[0] = 1;
+        for (sets) |s|
+            s[0] = 0;
+
+        return 1;
+    }
+
+    // Insertion sort, stable for equal strides
+    var i: u32 = 1;
+    while (i < nd) : (i += 1) {
+        const p: u32 = perm[i];
+        var j: u32 = i;
+        while (j > 0 and @abs(sets[0][perm[j - 1]]) < @abs(sets[0][p])) : (j -= 1)
+            perm[j] = perm[j - 1];
+
+        perm[j] = p;
+    }
+
+    const old_shape: [max_dimensions]u32 = shape.*;
+    for (0..nd) |d|
+        shape[d] = old_shape[perm[d]];
+
+    for (sets) |s| {
+        const old: [max_dimensions]isize = s.*;
+        for (0..nd) |d|
+            s[d] = old[perm[d]];
+    }
+
+    var d: u32 = nd - 1;
+    while (d > 0) : (d -= 1) {
+        const contiguous: bool = for (sets) |s| {
+            if (s[d - 1] != s[d] * @as(isize, shape[d]))
+                break false;
+        } else true;
+
+        if (!contiguous)
+            continue;
+
+        shape[d - 1] *= shape[d];
+        for (sets) |s|
+            s[d - 1] = s[d];
+
+        var m: u32 = d;
+        while (m + 1 < nd) : (m += 1) {
+            shape[m] = shape[m + 1];
+            for (sets) |s|
+                s[m] = s[m + 1];
+        }
+
+        nd -= 1;
+    }
+
+    return nd;
+}
+
+/// Start of part `index` of `parts` over `0..len`, rounded down to a multiple
+/// of `granule`. Parts of a single line use 64 elements, so the vector loops
+/// of different parts stay in phase.
+pub fn split(len: usize, index: usize, parts: usize, granule: usize) usize {
+    if (index >= parts)
+        return len;
+
+    return (len * index / parts) / granule * granule;
+}
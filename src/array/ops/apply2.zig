@@ -10,6 +10,8 @@ const dense = @import("../dense.zig");
 const strided = @import("../strided.zig");
 // const sparse = @import("../sparse.zig");
 
+const scratch = @import("../../scratch.zig");
+
 ///
 pub fn apply2(
     allocator: std.mem.Allocator,
@@ -28,6 +30,25 @@ pub fn apply2(
     comptime if (@typeInfo(@TypeOf(op)) != .@"fn" or (@typeInfo(@TypeOf(op)).@"fn".params.len != 2 and @typeInfo(@TypeOf(op)).@"fn".params.len != 3))
         @compileError("apply2: op must be a function of two arguments, or a function of three arguments with the third argument being a context, got " ++ @typeName(@TypeOf(op)));
 
+    // Temporaries of the element operations come from the arena in the
+    // `scratch` field of `ctx`, if any; the operations never see it.
+    const Ctx: type = @TypeOf(ctx);
+    const previous: ?*scratch.Arena = scratch.enter(if (comptime @typeInfo(Ctx) == .@"struct" and @hasField(Ctx, "scratch")) ctx.scratch else null);
+    defer scratch.leave(previous);
+
+    return dispatch(allocator, x, y, op, if (comptime @typeInfo(Ctx) == .@"struct") types.stripStructFields(ctx, &.{"scratch"}) else ctx);
+}
+
+fn dispatch(
+    allocator: std.mem.Allocator,
+    x: anytype,
+    y: anytype,
+    comptime op: anytype,
+    ctx: anytype,
+) !EnsureArray(Coerce(@TypeOf(x), @TypeOf(y)), ReturnType2(op, Numeric(@TypeOf(x)), Numeric(@TypeOf(y)))) {
+    const X: type = @TypeOf(x);
+    const Y: type = @TypeOf(y);
+
     if (comptime !types.isArray(X)) {
         switch (comptime types.arrayType(Y)) {
             .dense => return dense.apply2(allocator, x, y, op, ctx),
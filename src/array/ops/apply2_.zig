@@ -4,6 +4,8 @@ const dense = @import("../dense.zig");
 const strided = @import("../strided.zig");
 // const sparse = @import("../sparse.zig");
 
+const scratch = @import("../../scratch.zig");
+
 ///
 pub fn apply2_(
     o: anytype,
@@ -30,6 +32,26 @@ pub fn apply2_(
     comptime if (@typeInfo(@TypeOf(op_)) != .@"fn" or (@typeInfo(@TypeOf(op_)).@"fn".params.len != 3 and @typeInfo(@TypeOf(op_)).@"fn".params.len != 4))
         @compileError("apply2_: op must be a function of three arguments, or a function of four arguments with the fourth argument being a context, got " ++ @typeName(@TypeOf(op_)));
 
+    // Temporaries of the element operations come from the arena in the
+    // `scratch` field of `ctx`, if any; the operations never see it.
+    const Ctx: type = @TypeOf(ctx);
+    const previous: ?*scratch.Arena = scratch.enter(if (comptime @typeInfo(Ctx) == .@"struct" and @hasField(Ctx, "scratch")) ctx.scratch else null);
+    defer scratch.leave(previous);
+
+    return dispatch(o, x, y, op_, if (comptime @typeInfo(Ctx) == .@"struct") types.stripStructFields(ctx, &.{"scratch"}) else ctx);
+}
+
+fn dispatch(
+    o: anytype,
+    x: anytype,
+    y: anytype,
+    comptime op_: anytype,
+    ctx: anytype,
+) !void {
+    const O: type = types.Child(@TypeOf(o));
+    const X: type = @TypeOf(x);
+    const Y: type = @TypeOf(y);
+
     if (comptime !types.isArray(X)) {
         switch (comptime types.arrayType(O)) {
             .dense => switch (comptime types.arrayType(Y)) {
@@ -4,6 +4,7 @@ const types = @import("../../types.zig");
 const Coerce = types.Coerce;
 const ops = @import("../../ops.zig");
 const int = @import("../../int.zig");
+const scratch = @import("../../scratch.zig");
 
 const arrops = @import("../ops.zig");
 
@@ -27,6 +28,7 @@ pub inline fn div(
             @TypeOf(ctx),
             .{
                 .element_allocator = .{ .type = std.mem.Allocator, .required = true },
+                .scratch = .{ .type = ?*scratch.Arena, .required = false },
             },
         );
 
@@ -3,6 +3,7 @@ const std = @import("std");
 const types = @import("../../types.zig");
 const int = @import("../../int.zig");
 const ops = @import("../../ops.zig");
+const scratch = @import("../../scratch.zig");
 
 const arrops = @import("../ops.zig");
 
@@ -32,6 +33,7 @@ pub inline fn div_(
             @TypeOf(ctx),
             .{
                 .element_allocator = .{ .type = std.mem.Allocator, .required = true },
+                .scratch = .{ .type = ?*scratch.Arena, .required = false },
             },
         );
 
@@ -48,6 +50,7 @@ pub inline fn div_(
                 @TypeOf(ctx),
                 .{
                     .internal_allocator = .{ .type = std.mem.Allocator, .required = true },
+                    .scratch = .{ .type = ?*scratch.Arena, .required = false },
                 },
             );
         } else {
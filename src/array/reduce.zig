@@ -0,0 +1,1141 @@
+//! Reductions over dense and strided arrays.
+//!
+//! Every reduction comes in three forms: `sum(x, ctx)` reduces over all the
+//! axes and returns a scalar, `sumAxes(allocator, x, axes, ctx)` reduces over
+//! the given axes and returns a dense array with them removed, and
+//! `sumAxes_(o, x, axes, ctx)` writes the same result into `o`, whose shape is
+//! either the one of the result or the one of `x` with the reduced axes set
+//! to 1.
+//!
+//! The axes are split into the kept ones, which index the output, and the
+//! reduced ones. Within each group, dimensions of length 1 are dropped and the
+//! rest are ordered by the strides of `x` and merged where contiguous, as for
+//! `lazy` expressions. Then:
+//! - If the reduced axes are the innermost ones, every output element is
+//!   reduced along its own lines, with a pairwise tree over the lines and
+//!   over blocks of each line, and `@Vector` accumulators on contiguous `f32`
+//!   and `f64` lines.
+//! - Otherwise, the output is processed in tiles of the innermost kept axis:
+//!   for every reduced element a contiguous segment of `x` is added into the
+//!   tile, with Kahan compensation for floating point sums, so memory is read
+//!   in order instead of with the stride of the reduced axis.
+//!
+//! Large reductions are split over the current pool, by output elements or
+//! tiles, or, when there are few outputs, by the lines of each reduction with
+//! the partial results combined pairwise. `variance` makes two passes, the
+//! first computing the mean. `argmin` and `argmax` return row-major flat
+//! indices over the reduced axes and are evaluated in logical order, so the
+//! first extremum wins ties. `amin`, `amax` and their arg versions propagate
+//! NaN (`min` and `max` are the element-wise operations).
+//!
+//! Only fixed precision types are supported.
+
+const std = @import("std");
+
+const types = @import("../types.zig");
+const int = @import("../int.zig");
+
+const pool = @import("../pool.zig");
+const Pool = pool.Pool;
+
+const array = @import("../array.zig");
+const max_dimensions = array.max_dimensions;
+
+const dense = @import("dense.zig");
+const Dense = dense.Dense;
+
+const loop = @import("loop.zig");
+const offset = loop.offset;
+
+/// Parts per thread, so that uneven parts balance themselves.
+const parts_per_thread: usize = 4;
+/// Maximum number of partial results of a single reduction.
+const max_parts: usize = 256;
+/// Minimum length of a part when a single line is split.
+const min_part: usize = 1 << 12;
+/// Elements added directly at the leaves of the pairwise tree.
+const block: usize = 128;
+/// Output elements reduced together when the reduced axes are not innermost.
+const tile: usize = 256;
+
+const reduction_context = .{
+    .pool = .{
+        .type = ?*Pool,
+        .required = false,
+        .default = null,
+        .description = "The pool to run on. If not provided, the current pool is used (see `zml.pool.current`).",
+    },
+};
+
+const variance_context = .{
+    .pool = reduction_context.pool,
+    .ddof = .{
+        .type = u32,
+        .required = false,
+        .default = 0,
+        .description = "Delta degrees of freedom: the sum of squared deviations is divided by `n - ddof`.",
+    },
+};
+
+pub const Kind = enum {
+    sum,
+    prod,
+    amin,
+    amax,
+    argmin,
+    argmax,
+    mean,
+    variance,
+    norm,
+    dot,
+};
+
+/// Result type of the reduction `kind` over elements of type `T`.
+pub fn Result(comptime kind: Kind, comptime T: type) type {
+    return Reducer(kind, T).R;
+}
+
+/// Accumulation type of means and variances: integers are accumulated in
+/// `f64` (or `f128` past 64 bits) whatever the final float type.
+fn Wide(comptime T: type) type {
+    return switch (comptime types.numericType(T)) {
+        .int => if (@typeInfo(T).int.bits <= 64) f64 else f128,
+        else => T,
+    };
+}
+
+fn Indexed(comptime T: type) type {
+    return struct {
+        value: T,
+        index: u64,
+    };
+}
+
+inline fn isNan(x: anytype) bool {
+    return comptime types.numericType(@TypeOf(x)) == .float and x != x;
+}
+
+fn zero(comptime A: type) A {
+    return if (comptime types.numericType(A) == .cfloat) .{ .re = 0, .im = 0 } else 0;
+}
+
+fn one(comptime A: type) A {
+    return if (comptime types.numericType(A) == .cfloat) .{ .re = 1, .im = 0 } else 1;
+}
+
+inline fn add(a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    return switch (comptime types.numericType(@TypeOf(a))) {
+        .int => int.add(a, b),
+        .cfloat => a.add(b),
+        else => a + b,
+    };
+}
+
+inline fn sub(a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    return switch (comptime types.numericType(@TypeOf(a))) {
+        .int => int.sub(a, b),
+        .cfloat => a.sub(b),
+        else => a - b,
+    };
+}
+
+inline fn mul(a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    return switch (comptime types.numericType(@TypeOf(a))) {
+        .int => int.mul(a, b),
+        .cfloat => a.mul(b),
+        else => a * b,
+    };
+}
+
+inline fn abs2(a: anytype) types.Scalar(@TypeOf(a)) {
+    return if (comptime types.numericType(@TypeOf(a)) == .cfloat) a.re * a.re + a.im * a.im else a * a;
+}
+
+inline fn widen(x: anytype) Wide(@TypeOf(x)) {
+    return if (comptime types.numericType(@TypeOf(x)) == .int) @floatFromInt(x) else x;
+}
+
+inline fn narrow(comptime R: type, a: anytype) R {
+    if (comptime types.numericType(R) == .cfloat)
+        return .{ .re = @floatCast(a.re), .im = @floatCast(a.im) };
+
+    return @floatCast(a);
+}
+
+/// `a / n` for a float or cfloat `a`.
+inline fn divide(a: anytype, n: f64) @TypeOf(a) {
+    const A: type = @TypeOf(a);
+
+    if (comptime types.numericType(A) == .cfloat) {
+        const F: type = types.Scalar(A);
+        return .{ .re = a.re / @as(F, @floatCast(n)), .im = a.im / @as(F, @floatCast(n)) };
+    }
+
+    return a / @as(A, @floatCast(n));
+}
+
+inline fn maximum(a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    if (isNan(a)) return a;
+    if (isNan(b)) return b;
+    return @max(a, b);
+}
+
+inline fn minimum(a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    if (isNan(a)) return a;
+    if (isNan(b)) return b;
+    return @min(a, b);
+}
+
+/// How the reduction `kind` maps, combines and finishes elements of type `T`.
+fn Reducer(comptime kind: Kind, comptime T: type) type {
+    switch (comptime types.numericType(T)) {
+        .int, .float => {},
+        .cfloat => switch (kind) {
+            .amin, .amax, .argmin, .argmax => @compileError("zml.array." ++ @tagName(kind) ++ " requires an ordered type, got " ++ @typeName(T)),
+            else => {},
+        },
+        else => @compileError("zml.array." ++ @tagName(kind) ++ " only supports int, float and cfloat types, got " ++ @typeName(T)),
+    }
+
+    return struct {
+        /// Accumulator.
+        pub const A: type = switch (kind) {
+            .sum, .prod, .amin, .amax, .dot => T,
+            .argmin, .argmax => Indexed(T),
+            .mean => Wide(T),
+            .variance, .norm => types.Scalar(Wide(T)),
+        };
+        /// Result.
+        pub const R: type = switch (kind) {
+            .argmin, .argmax => u64,
+            .mean => types.EnsureFloat(T),
+            .variance, .norm => types.Scalar(types.EnsureFloat(T)),
+            else => T,
+        };
+        /// Value the terms are centred on, computed by a first pass.
+        pub const C: type = if (kind == .variance) Wide(T) else void;
+
+        pub const arity: usize = if (kind == .dot) 2 else 1;
+        pub const indexed: bool = kind == .argmin or kind == .argmax;
+        pub const two_pass: bool = kind == .variance;
+        pub const compensated: bool = switch (kind) {
+            .sum, .mean, .variance, .norm, .dot => types.numericType(A) == .float,
+            else => false,
+        };
+        pub const vector: bool = (T == f32 or T == f64) and !indexed and std.simd.suggestVectorLength(T) != null;
+
+        pub fn identity() A {
+            return switch (kind) {
+                .sum, .mean, .variance, .norm, .dot => zero(A),
+                .prod => one(A),
+                .amin => if (comptime types.numericType(T) == .float) std.math.inf(T) else std.math.maxInt(T),
+                .amax => if (comptime types.numericType(T) == .float) -std.math.inf(T) else std.math.minInt(T),
+                .argmin => .{ .value = if (comptime types.numericType(T) == .float) std.math.inf(T) else std.math.maxInt(T), .index = std.math.maxInt(u64) },
+                .argmax => .{ .value = if (comptime types.numericType(T) == .float) -std.math.inf(T) else std.math.minInt(T), .index = std.math.maxInt(u64) },
+            };
+        }
+
+        /// Term of element `x` (and `y` for `dot`), `k` being its index in
+        /// the reduction.
+        pub inline fn term(x: T, y: T, center: C, k: u64) A {
+            return switch (kind) {
+                .sum, .prod, .amin, .amax => x,
+                .mean => widen(x),
+                .dot => mul(x, y),
+                .norm => abs2(widen(x)),
+                .variance => abs2(sub(widen(x), center)),
+                .argmin, .argmax => .{ .value = x, .index = k },
+            };
+        }
+
+        pub inline fn combine(a: A, b: A) A {
+            return switch (kind) {
+                .prod => mul(a, b),
+                .amin => minimum(a, b),
+                .amax => maximum(a, b),
+                .argmin, .argmax => pick(a, b),
+                else => add(a, b),
+            };
+        }
+
+        /// The better of two indexed candidates: NaN first, then the
+        /// extremum, then the lower index.
+        inline fn pick(a: A, b: A) A {
+            const an: bool = isNan(a.value);
+            const bn: bool = isNan(b.value);
+            if (an or bn) {
+                if (an and bn)
+                    return if (a.index < b.index) a else b;
+
+                return if (an) a else b;
+            }
+
+            if (a.value == b.value)
+                return if (a.index < b.index) a else b;
+
+            if (comptime kind == .argmax)
+                return if (a.value > b.value) a else b;
+
+            return if (a.value < b.value) a else b;
+        }
+
+        pub fn finish(a: A, count: u64, ddof: u32) R {
+            return switch (kind) {
+                .argmin, .argmax => a.index,
+                .mean => narrow(R, divide(a, @floatFromInt(count))),
+                .variance => narrow(R, a / (@as(A, @floatFromInt(count)) - @as(A, @floatFromInt(ddof)))),
+                .norm => narrow(R, @sqrt(a)),
+                else => a,
+            };
+        }
+
+        pub inline fn vterm(comptime n: usize, x: @Vector(n, T), y: @Vector(n, T), center: @Vector(n, T)) @Vector(n, T) {
+            return switch (kind) {
+                .dot => x * y,
+                .norm => x * x,
+                .variance => (x - center) * (x - center),
+                else => x,
+            };
+        }
+
+        pub inline fn vcombine(comptime n: usize, a: @Vector(n, T), b: @Vector(n, T)) @Vector(n, T) {
+            return switch (kind) {
+                .prod => a * b,
+                .amin => @select(T, a != a, a, @select(T, b != b, b, @min(a, b))),
+                .amax => @select(T, a != a, a, @select(T, b != b, b, @max(a, b))),
+                else => a + b,
+            };
+        }
+
+        pub inline fn vreduce(comptime n: usize, v: @Vector(n, T)) A {
+            return switch (kind) {
+                .prod => @reduce(.Mul, v),
+                .amin => if (@reduce(.Or, v != v)) std.math.nan(T) else @reduce(.Min, v),
+                .amax => if (@reduce(.Or, v != v)) std.math.nan(T) else @reduce(.Max, v),
+                else => @reduce(.Add, v),
+            };
+        }
+    };
+}
+
+fn combineAll(comptime P: type, values: []const P.A) P.A {
+    if (values.len == 1)
+        return values[0];
+
+    const mid: usize = values.len / 2;
+    return P.combine(combineAll(P, values[0..mid]), combineAll(P, values[mid..]));
+}
+
+/// An input array, with its strides widened.
+fn View(comptime T: type) type {
+    return struct {
+        data: [*]const T,
+        ndim: u32,
+        shape: [max_dimensions]u32,
+        strides: [max_dimensions]isize,
+        base: isize,
+    };
+}
+
+fn view(x: anytype) View(types.Numeric(@TypeOf(x))) {
+    const X: type = @TypeOf(x);
+
+    comptime if (!types.isDenseArray(X) and !types.isStridedArray(X))
+        @compileError("zml.array reductions require dense or strided arrays, got " ++ @typeName(X));
+
+    var result: View(types.Numeric(X)) = .{
+        .data = x.data,
+        .ndim = x.ndim,
+        .shape = x.shape,
+        .strides = .{0} ** max_dimensions,
+        .base = if (comptime types.isStridedArray(X)) @intCast(x.offset) else 0,
+    };
+    for (0..x.ndim) |d|
+        result.strides[d] = x.strides[d];
+
+    return result;
+}
+
+/// An output array, with its strides widened.
+fn Target(comptime R: type) type {
+    return struct {
+        data: [*]R,
+        ndim: u32,
+        shape: [max_dimensions]u32,
+        strides: [max_dimensions]isize,
+        base: isize,
+    };
+}
+
+/// Marks the reduced axes, checking that they are in range and distinct.
+fn axisMask(ndim: u32, axes: []const u32) ![max_dimensions]bool {
+    if (axes.len == 0 or axes.len > ndim)
+        return array.Error.InvalidAxes;
+
+    var mask: [max_dimensions]bool = .{false} ** max_dimensions;
+    for (axes) |axis| {
+        if (axis >= ndim or mask[axis])
+            return array.Error.InvalidAxes;
+
+        mask[axis] = true;
+    }
+
+    return mask;
+}
+
+/// Shape of the result of reducing `shape` over `axes`, which is `{1}` if
+/// every axis is reduced.
+fn reducedShape(ndim: u32, shape: [max_dimensions]u32, axes: []const u32) !array.Broadcast {
+    const mask: [max_dimensions]bool = try axisMask(ndim, axes);
+
+    var result: array.Broadcast = .{ .ndim = 0, .shape = .{0} ** max_dimensions };
+    for (0..ndim) |d| {
+        if (!mask[d]) {
+            result.shape[result.ndim] = shape[d];
+            result.ndim += 1;
+        }
+    }
+
+    if (result.ndim == 0) {
+        result.shape[0] = 1;
+        result.ndim = 1;
+    }
+
+    return result;
+}
+
+fn Engine(comptime kind: Kind, comptime T: type) type {
+    const Red = Reducer(kind, T);
+    // First pass of `variance`
+    const Pre = Reducer(.mean, T);
+    const S: usize = Red.arity;
+
+    return struct {
+        src: [S][*]const T,
+        base: [S]isize,
+        out: [*]Red.R,
+        obase: isize,
+        /// Kept dimensions, with the strides of the sources and then of the
+        /// output.
+        kn: u32,
+        kshape: [max_dimensions]u32,
+        ks: [S + 1][max_dimensions]isize,
+        /// Reduced dimensions, with the strides of the sources.
+        rn: u32,
+        rshape: [max_dimensions]u32,
+        rs: [S][max_dimensions]isize,
+        rlines: usize,
+        count: u64,
+        ddof: u32,
+
+        const Self = @This();
+        const Cursor = [S]isize;
+
+        fn init(xs: [S]View(T), axes: []const u32, o: Target(Red.R), ddof: u32) !Self {
+            const x: View(T) = xs[0];
+            if (comptime S == 2) {
+                if (!std.mem.eql(u32, x.shape[0..x.ndim], xs[1].shape[0..xs[1].ndim]))
+                    return array.Error.DimensionMismatch;
+            }
+
+            const mask: [max_dimensions]bool = try axisMask(x.ndim, axes);
+            const keepdims: bool = o.ndim == x.ndim and x.ndim > 1;
+
+            var self: Self = .{
+                .src = undefined,
+                .base = undefined,
+                .out = o.data,
+                .obase = o.base,
+                .kn = 0,
+                .kshape = .{1} ** max_dimensions,
+                .ks = .{.{0} ** max_dimensions} ** (S + 1),
+                .rn = 0,
+                .rshape = .{1} ** max_dimensions,
+                .rs = .{.{0} ** max_dimensions} ** S,
+                .rlines = 1,
+                .count = 1,
+                .ddof = ddof,
+            };
+            inline for (0..S) |s| {
+                self.src[s] = xs[s].data;
+                self.base[s] = xs[s].base;
+            }
+
+            for (0..x.ndim) |d| {
+                if (mask[d]) {
+                    if (keepdims and o.shape[d] != 1)
+                        return array.Error.DimensionMismatch;
+
+                    self.rshape[self.rn] = x.shape[d];
+                    inline for (0..S) |s|
+                        self.rs[s][self.rn] = xs[s].strides[d];
+
+                    self.rn += 1;
+                } else {
+                    const od: usize = if (keepdims) d else self.kn;
+                    if (od >= o.ndim or o.shape[od] != x.shape[d])
+                        return array.Error.DimensionMismatch;
+
+                    self.kshape[self.kn] = x.shape[d];
+                    inline for (0..S) |s|
+                        self.ks[s][self.kn] = xs[s].strides[d];
+
+                    self.ks[S][self.kn] = o.strides[od];
+                    self.kn += 1;
+                }
+            }
+
+            if (!keepdims and o.ndim != @max(self.kn, 1))
+                return array.Error.DimensionMismatch;
+
+            if (self.kn == 0 and o.shape[0] != 1)
+                return array.Error.DimensionMismatch;
+
+            var ksets: [S + 1]*[max_dimensions]isize = undefined;
+            inline for (0..S + 1) |s|
+                ksets[s] = &self.ks[s];
+
+            self.kn = loop.normalize(self.kn, &self.kshape, &ksets);
+
+            // Arg reductions count elements in logical order
+            if (comptime !Red.indexed) {
+                var rsets: [S]*[max_dimensions]isize = undefined;
+                inline for (0..S) |s|
+                    rsets[s] = &self.rs[s];
+
+                self.rn = loop.normalize(self.rn, &self.rshape, &rsets);
+            }
+
+            for (self.rshape[0 .. self.rn - 1]) |n|
+                self.rlines *= n;
+
+            self.count = @as(u64, self.rlines) * self.rshape[self.rn - 1];
+
+            return self;
+        }
+
+        /// Whether the output is processed in tiles, i.e. the innermost kept
+        /// axis is closer in memory than the innermost reduced one.
+        fn tiled(self: *const Self) bool {
+            return self.kshape[self.kn - 1] > 1 and
+                @abs(self.ks[0][self.kn - 1]) < @abs(self.rs[0][self.rn - 1]);
+        }
+
+        /// Cursors in the sources and the output of the kept multi-index
+        /// `flat` over the first `dims` kept dimensions.
+        fn keptStart(self: *const Self, flat: usize, dims: u32, cur: *Cursor, ocur: *isize) void {
+            cur.* = self.base;
+            ocur.* = self.obase;
+
+            var rest: usize = flat;
+            var d: u32 = dims;
+            while (d > 0) {
+                d -= 1;
+                const i: isize = @intCast(rest % self.kshape[d]);
+                rest /= self.kshape[d];
+
+                inline for (0..S) |s|
+                    cur[s] += i * self.ks[s][d];
+
+                ocur.* += i * self.ks[S][d];
+            }
+        }
+
+        /// Cursors of reduced line `l` of the reduction starting at `cur`.
+        fn lineStart(self: *const Self, cur: Cursor, l: usize) Cursor {
+            var result: Cursor = cur;
+
+            var rest: usize = l;
+            var d: u32 = self.rn - 1;
+            while (d > 0) {
+                d -= 1;
+                const i: isize = @intCast(rest % self.rshape[d]);
+                rest /= self.rshape[d];
+
+                inline for (0..S) |s|
+                    result[s] += i * self.rs[s][d];
+            }
+
+            return result;
+        }
+
+        /// Reduces lines `l0..l1` of the reduction starting at `cur`,
+        /// pairwise.
+        fn lines(self: *const Self, comptime P: type, cur: Cursor, l0: usize, l1: usize, center: P.C) P.A {
+            if (l1 <= l0)
+                return P.identity();
+
+            if (l1 - l0 == 1) {
+                const len: usize = self.rshape[self.rn - 1];
+                return self.line(P, self.lineStart(cur, l0), 0, len, l0 * len, center);
+            }
+
+            const mid: usize = l0 + (l1 - l0) / 2;
+            return P.combine(self.lines(P, cur, l0, mid, center), self.lines(P, cur, mid, l1, center));
+        }
+
+        /// Reduces elements `j0..j1` of the reduced line starting at `cur`,
+        /// pairwise over blocks. `k0` is the index of element 0 of the line in
+        /// the reduction.
+        fn line(self: *const Self, comptime P: type, cur: Cursor, j0: usize, j1: usize, k0: u64, center: P.C) P.A {
+            if (j1 - j0 > block) {
+                const mid: usize = j0 + (j1 - j0) / 2 / 64 * 64;
+                return P.combine(self.line(P, cur, j0, mid, k0, center), self.line(P, cur, mid, j1, k0, center));
+            }
+
+            var step: Cursor = undefined;
+            var unit: bool = true;
+            inline for (0..S) |s| {
+                step[s] = self.rs[s][self.rn - 1];
+                unit = unit and step[s] == 1;
+            }
+
+            var acc: P.A = P.identity();
+            var j: usize = j0;
+
+            if (comptime P.vector) {
+                const n: comptime_int = comptime std.simd.suggestVectorLength(T).?;
+                const V: type = @Vector(n, T);
+
+                if (unit and j1 - j0 >= n) {
+                    const c: V = if (comptime P.C == void) undefined else @splat(center);
+                    var v: V = @splat(P.identity());
+                    while (j + n <= j1) : (j += n) {
+                        const x: V = self.src[0][offset(cur[0], j, 1)..][0..n].*;
+                        const y: V = if (comptime S == 2) self.src[S - 1][offset(cur[S - 1], j, 1)..][0..n].* else undefined;
+                        v = P.vcombine(n, v, P.vterm(n, x, y, c));
+                    }
+
+                    acc = P.vreduce(n, v);
+                }
+            }
+
+            while (j < j1) : (j += 1) {
+                const x: T = self.src[0][offset(cur[0], j, step[0])];
+                const y: T = if (comptime S == 2) self.src[S - 1][offset(cur[S - 1], j, step[S - 1])] else undefined;
+                acc = P.combine(acc, P.term(x, y, center, k0 + j));
+            }
+
+            return acc;
+        }
+
+        /// Full reduction starting at `cur`.
+        fn value(self: *const Self, cur: Cursor) Red.R {
+            const center: Red.C = if (comptime Red.two_pass)
+                divide(self.lines(Pre, cur, 0, self.rlines, {}), @floatFromInt(self.count))
+            else {};
+
+            return Red.finish(self.lines(Red, cur, 0, self.rlines, center), self.count, self.ddof);
+        }
+
+        /// `value` with the reduction itself split over `p`.
+        fn valueParallel(self: *const Self, p: *Pool, cur: Cursor) Red.R {
+            const center: Red.C = if (comptime Red.two_pass)
+                divide(self.spread(Pre, p, cur, {}), @floatFromInt(self.count))
+            else {};
+
+            return Red.finish(self.spread(Red, p, cur, center), self.count, self.ddof);
+        }
+
+        /// `lines(P, cur, 0, rlines, center)` split over `p`, by lines or, for
+        /// a single line, by elements.
+        fn spread(self: *const Self, comptime P: type, p: *Pool, cur: Cursor, center: P.C) P.A {
+            const len: usize = self.rshape[self.rn - 1];
+            const units: usize = if (self.rlines > 1) self.rlines else len / min_part;
+            const parts: usize = @max(1, @min(units, p.size() * parts_per_thread, max_parts));
+
+            var partials: [max_parts]P.A = undefined;
+
+            const Job = struct {
+                engine: *const Self,
+                cur: Cursor,
+                center: P.C,
+                parts: usize,
+                partials: [*]P.A,
+
+                fn run(job: @This(), _: usize, index: usize) void {
+                    const e: *const Self = job.engine;
+
+                    if (e.rlines > 1) {
+                        job.partials[index] = e.lines(P, job.cur, loop.split(e.rlines, index, job.parts, 1), loop.split(e.rlines, index + 1, job.parts, 1), job.center);
+                    } else {
+                        const n: usize = e.rshape[e.rn - 1];
+                        job.partials[index] = e.line(P, job.cur, loop.split(n, index, job.parts, 64), loop.split(n, index + 1, job.parts, 64), 0, job.center);
+                    }
+                }
+            };
+
+            p.parallelFor(parts, Job{ .engine = self, .cur = cur, .center = center, .parts = parts, .partials = &partials }, Job.run);
+
+            return combineAll(P, partials[0..parts]);
+        }
+
+        /// Output elements `o0..o1`, in kept order.
+        fn outputRange(self: *const Self, o0: usize, o1: usize) void {
+            var cur: Cursor = undefined;
+            var ocur: isize = undefined;
+
+            var o: usize = o0;
+            while (o < o1) : (o += 1) {
+                self.keptStart(o, self.kn, &cur, &ocur);
+                self.out[offset(ocur, 0, 0)] = self.value(cur);
+            }
+        }
+
+        /// Reduces the kept elements `j0..j1` of the kept line starting at
+        /// `cur` into `acc`, walking the reduced elements in the outer loop.
+        fn tilePass(self: *const Self, comptime P: type, cur: Cursor, j0: usize, j1: usize, acc: []P.A, centers: []const P.C) void {
+            const m: usize = j1 - j0;
+            const len: usize = self.rshape[self.rn - 1];
+
+            var kstep: Cursor = undefined;
+            var rstep: Cursor = undefined;
+            var unit: bool = true;
+            inline for (0..S) |s| {
+                kstep[s] = self.ks[s][self.kn - 1];
+                rstep[s] = self.rs[s][self.rn - 1];
+                unit = unit and kstep[s] == 1;
+            }
+
+            var comp: [tile]P.A = undefined;
+            for (acc[0..m]) |*a| a.* = P.identity();
+            if (comptime P.compensated) {
+                for (comp[0..m]) |*c| c.* = zero(P.A);
+            }
+
+            for (0..self.rlines) |l| {
+                const start: Cursor = self.lineStart(cur, l);
+
+                for (0..len) |r| {
+                    var at: Cursor = undefined;
+                    inline for (0..S) |s|
+                        at[s] = start[s] + @as(isize, @intCast(r)) * rstep[s] + @as(isize, @intCast(j0)) * kstep[s];
+
+                    var j: usize = 0;
+
+                    if (comptime P.vector) {
+                        if (unit) {
+                            const n: comptime_int = comptime std.simd.suggestVectorLength(T).?;
+                            const V: type = @Vector(n, T);
+
+                            while (j + n <= m) : (j += n) {
+                                const x: V = self.src[0][offset(at[0], j, 1)..][0..n].*;
+                                const y: V = if (comptime S == 2) self.src[S - 1][offset(at[S - 1], j, 1)..][0..n].* else undefined;
+                                const c: V = if (comptime P.C == void) undefined else centers[j..][0..n].*;
+                                const t: V = P.vterm(n, x, y, c);
+
+                                const a: V = acc[j..][0..n].*;
+                                if (comptime P.compensated) {
+                                    const e: V = t - @as(V, comp[j..][0..n].*);
+                                    const total: V = a + e;
+                                    comp[j..][0..n].* = (total - a) - e;
+                                    acc[j..][0..n].* = total;
+                                } else {
+                                    acc[j..][0..n].* = P.vcombine(n, a, t);
+                                }
+                            }
+                        }
+                    }
+
+                    while (j < m) : (j += 1) {
+                        const x: T = self.src[0][offset(at[0], j, kstep[0])];
+                        const y: T = if (comptime S == 2) self.src[S - 1][offset(at[S - 1], j, kstep[S - 1])] else undefined;
+                        const t: P.A = P.term(x, y, centers[j], @as(u64, l) * len + r);
+
+                        if (comptime P.compensated) {
+                            const e: P.A = t - comp[j];
+                            const total: P.A = acc[j] + e;
+                            comp[j] = (total - acc[j]) - e;
+                            acc[j] = total;
+                        } else {
+                            acc[j] = P.combine(acc[j], t);
+                        }
+                    }
+                }
+            }
+        }
+
+        /// Tiles `t0..t1`, each holding up to `tile` elements of a kept line.
+        fn tileRange(self: *const Self, t0: usize, t1: usize) void {
+            const klen: usize = self.kshape[self.kn - 1];
+            const per_line: usize = (klen + tile - 1) / tile;
+            const ostep: isize = self.ks[S][self.kn - 1];
+
+            var acc: [tile]Red.A = undefined;
+            var centers: [tile]Red.C = undefined;
+
+            var cur: Cursor = undefined;
+            var ocur: isize = undefined;
+
+            var t: usize = t0;
+            while (t < t1) : (t += 1) {
+                self.keptStart(t / per_line, self.kn - 1, &cur, &ocur);
+
+                const j0: usize = t % per_line * tile;
+                const j1: usize = @min(klen, j0 + tile);
+
+                if (comptime Red.two_pass) {
+                    var sums: [tile]Pre.A = undefined;
+                    const nothing: [tile]void = undefined;
+                    self.tilePass(Pre, cur, j0, j1, &sums, &nothing);
+
+                    for (centers[0 .. j1 - j0], sums[0 .. j1 - j0]) |*c, s|
+                        c.* = divide(s, @floatFromInt(self.count));
+                }
+
+                self.tilePass(Red, cur, j0, j1, &acc, &centers);
+
+                for (acc[0 .. j1 - j0], j0..) |a, j|
+                    self.out[offset(ocur, j, ostep)] = Red.finish(a, self.count, self.ddof);
+            }
+        }
+
+        fn run(self: *const Self) void {
+            var outputs: usize = 1;
+            for (self.kshape[0..self.kn]) |n|
+                outputs *= n;
+
+            const workers: ?*Pool = loop.team(@as(u64, outputs) * self.count);
+
+            if (self.tiled()) {
+                const klen: usize = self.kshape[self.kn - 1];
+                const tiles: usize = outputs / klen * ((klen + tile - 1) / tile);
+
+                const p: *Pool = workers orelse return self.tileRange(0, tiles);
+                parallelRange(self, p, tiles, tileRange);
+                return;
+            }
+
+            const p: *Pool = workers orelse return self.outputRange(0, outputs);
+
+            if (outputs >= p.size()) {
+                parallelRange(self, p, outputs, outputRange);
+                return;
+            }
+
+            // Few outputs: split every reduction instead
+            var cur: Cursor = undefined;
+            var ocur: isize = undefined;
+            for (0..outputs) |o| {
+                self.keptStart(o, self.kn, &cur, &ocur);
+                self.out[offset(ocur, 0, 0)] = self.valueParallel(p, cur);
+            }
+        }
+
+        /// Runs `func(self, i0, i1)` over `0..total` split into ranges on `p`.
+        fn parallelRange(self: *const Self, p: *Pool, total: usize, comptime func: fn (*const Self, usize, usize) void) void {
+            const Job = struct {
+                engine: *const Self,
+                total: usize,
+                parts: usize,
+
+                fn run(job: @This(), _: usize, index: usize) void {
+                    func(job.engine, loop.split(job.total, index, job.parts, 1), loop.split(job.total, index + 1, job.parts, 1));
+                }
+            };
+
+            const parts: usize = @max(1, @min(total, p.size() * parts_per_thread));
+            p.parallelFor(parts, Job{ .engine = self, .total = total, .parts = parts }, Job.run);
+        }
+    };
+}
+
+fn ddofOf(comptime kind: Kind, ctx: anytype) u32 {
+    return if (comptime kind == .variance) types.getFieldOrDefault(ctx, variance_context, "ddof") else 0;
+}
+
+fn validate(comptime kind: Kind, comptime Ctx: type) void {
+    if (kind == .variance) {
+        types.validateContext(Ctx, variance_context);
+    } else {
+        types.validateContext(Ctx, reduction_context);
+    }
+}
+
+/// Reduces `xs` over all the axes.
+fn reduceAll(comptime kind: Kind, comptime T: type, xs: [Reducer(kind, T).arity]View(T), ctx: anytype) !Result(kind, T) {
+    comptime validate(kind, @TypeOf(ctx));
+
+    const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, reduction_context, "pool"));
+    defer pool.leave(previous);
+
+    const axes: [max_dimensions]u32 = array.trivialPermutation(xs[0].ndim);
+
+    var result: Result(kind, T) = undefined;
+    var shape: [max_dimensions]u32 = .{0} ** max_dimensions;
+    shape[0] = 1;
+
+    const engine: Engine(kind, T) = try .init(xs, axes[0..xs[0].ndim], .{
+        .data = @ptrCast(&result),
+        .ndim = 1,
+        .shape = shape,
+        .strides = .{0} ** max_dimensions,
+        .base = 0,
+    }, ddofOf(kind, ctx));
+
+    engine.run();
+
+    return result;
+}
+
+/// Reduces `xs` over `axes` into `o`.
+fn reduceAxes_(comptime kind: Kind, comptime T: type, o: anytype, xs: [Reducer(kind, T).arity]View(T), axes: []const u32, ctx: anytype) !void {
+    comptime var O: type = @TypeOf(o);
+
+    comptime if (!types.isPointer(O) or types.isConstPointer(O))
+        @compileError("zml.array." ++ @tagName(kind) ++ "Axes_ requires the output to be a mutable pointer, got " ++ @typeName(O));
+
+    O = types.Child(O);
+
+    comptime if (!types.isDenseArray(O) and !types.isStridedArray(O))
+        @compileError("zml.array." ++ @tagName(kind) ++ "Axes_ requires the output to be a dense or strided array, got " ++ @typeName(O));
+
+    comptime if (types.Numeric(O) != Result(kind, T))
+        @compileError("zml.array." ++ @tagName(kind) ++ "Axes_ requires the output elements to be " ++ @typeName(Result(kind, T)) ++ ", got " ++ @typeName(types.Numeric(O)));
+
+    comptime validate(kind, @TypeOf(ctx));
+
+    const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, reduction_context, "pool"));
+    defer pool.leave(previous);
+
+    var target: Target(Result(kind, T)) = .{
+        .data = o.data,
+        .ndim = o.ndim,
+        .shape = o.shape,
+        .strides = .{0} ** max_dimensions,
+        .base = if (comptime types.isStridedArray(O)) @intCast(o.offset) else 0,
+    };
+    for (0..o.ndim) |d|
+        target.strides[d] = o.strides[d];
+
+    const engine: Engine(kind, T) = try .init(xs, axes, target, ddofOf(kind, ctx));
+    engine.run();
+}
+
+/// Reduces `xs` over `axes` into a new dense array.
+fn reduceAxes(comptime kind: Kind, comptime T: type, allocator: std.mem.Allocator, xs: [Reducer(kind, T).arity]View(T), axes: []const u32, ctx: anytype) !Dense(Result(kind, T), types.default_layout) {
+    const shape: array.Broadcast = try reducedShape(xs[0].ndim, xs[0].shape, axes);
+
+    var result: Dense(Result(kind, T), types.default_layout) = try .init(allocator, shape.shape[0..shape.ndim]);
+    errdefer result.deinit(allocator);
+
+    try reduceAxes_(kind, T, &result, xs, axes, ctx);
+
+    return result;
+}
+
+fn Of(comptime kind: Kind, comptime X: type) type {
+    return Result(kind, types.Numeric(X));
+}
+
+fn AxesOf(comptime kind: Kind, comptime X: type) type {
+    return Dense(Result(kind, types.Numeric(X)), types.default_layout);
+}
+
+/// Sum of the elements of `x`.
+///
+/// Parameters
+/// ----------
+/// `x` (`anytype`):
+/// A dense or strided array of int, float or cfloat type.
+///
+/// `ctx` (`anytype`):
+/// A context struct with an optional `pool` field (`?*Pool`).
+///
+/// Returns
+/// -------
+/// `types.Numeric(@TypeOf(x))`:
+/// The sum, accumulated pairwise.
+pub fn sum(x: anytype, ctx: anytype) !Of(.sum, @TypeOf(x)) {
+    return reduceAll(.sum, types.Numeric(@TypeOf(x)), .{view(x)}, ctx);
+}
+
+/// Sums `x` over `axes`, returning a dense array with those axes removed (or
+/// of shape `{1}` if every axis is reduced).
+///
+/// Errors
+/// ------
+/// `std.mem.Allocator.Error.OutOfMemory`:
+/// If memory allocation fails.
+///
+/// `array.Error.InvalidAxes`:
+/// If `axes` is empty, or has repeated or out of range axes.
+pub fn sumAxes(allocator: std.mem.Allocator, x: anytype, axes: []const u32, ctx: anytype) !AxesOf(.sum, @TypeOf(x)) {
+    return reduceAxes(.sum, types.Numeric(@TypeOf(x)), allocator, .{view(x)}, axes, ctx);
+}
+
+/// Sums `x` over `axes` into `o`, whose shape is either the one of the result
+/// of `sumAxes` or the one of `x` with the reduced axes set to 1.
+///
+/// Errors
+/// ------
+/// `array.Error.InvalidAxes`:
+/// If `axes` is empty, or has repeated or out of range axes.
+///
+/// `array.Error.DimensionMismatch`:
+/// If the shape of `o` does not match.
+pub fn sumAxes_(o: anytype, x: anytype, axes: []const u32, ctx: anytype) !void {
+    return reduceAxes_(.sum, types.Numeric(@TypeOf(x)), o, .{view(x)}, axes, ctx);
+}
+
+/// Product of the elements of `x`.
+pub fn prod(x: anytype, ctx: anytype) !Of(.prod, @TypeOf(x)) {
+    return reduceAll(.prod, types.Numeric(@TypeOf(x)), .{view(x)}, ctx);
+}
+
+/// Product of `x` over `axes`. See `sumAxes`.
+pub fn prodAxes(allocator: std.mem.Allocator, x: anytype, axes: []const u32, ctx: anytype) !AxesOf(.prod, @TypeOf(x)) {
+    return reduceAxes(.prod, types.Numeric(@TypeOf(x)), allocator, .{view(x)}, axes, ctx);
+}
+
+/// Product of `x` over `axes` into `o`. See `sumAxes_`.
+pub fn prodAxes_(o: anytype, x: anytype, axes: []const u32, ctx: anytype) !void {
+    return reduceAxes_(.prod, types.Numeric(@TypeOf(x)), o, .{view(x)}, axes, ctx);
+}
+
+/// Smallest element of `x`, or NaN if any element is NaN.
+pub fn amin(x: anytype, ctx: anytype) !Of(.amin, @TypeOf(x)) {
+    return reduceAll(.amin, types.Numeric(@TypeOf(x)), .{view(x)}, ctx);
+}
+
+/// Minimum of `x` over `axes`. See `sumAxes`.
+pub fn aminAxes(allocator: std.mem.Allocator, x: anytype, axes: []const u32, ctx: anytype) !AxesOf(.amin, @TypeOf(x)) {
+    return reduceAxes(.amin, types.Numeric(@TypeOf(x)), allocator, .{view(x)}, axes, ctx);
+}
+
+/// Minimum of `x` over `axes` into `o`. See `sumAxes_`.
+pub fn aminAxes_(o: anytype, x: anytype, axes: []const u32, ctx: anytype) !void {
+    return reduceAxes_(.amin, types.Numeric(@TypeOf(x)), o, .{view(x)}, axes, ctx);
+}
+
+/// Largest element of `x`, or NaN if any element is NaN.
+pub fn amax(x: anytype, ctx: anytype) !Of(.amax, @TypeOf(x)) {
+    return reduceAll(.amax, types.Numeric(@TypeOf(x)), .{view(x)}, ctx);
+}
+
+/// Maximum of `x` over `axes`. See `sumAxes`.
+pub fn amaxAxes(allocator: std.mem.Allocator, x: anytype, axes: []const u32, ctx: anytype) !AxesOf(.amax, @TypeOf(x)) {
+    return reduceAxes(.amax, types.Numeric(@TypeOf(x)), allocator, .{view(x)}, axes, ctx);
+}
+
+/// Maximum of `x` over `axes` into `o`. See `sumAxes_`.
+pub fn amaxAxes_(o: anytype, x: anytype, axes: []const u32, ctx: anytype) !void {
+    return reduceAxes_(.amax, types.Numeric(@TypeOf(x)), o, .{view(x)}, axes, ctx);
+}
+
+/// Row-major flat index of the first smallest element of `x`, or of the first
+/// NaN.
+pub fn argmin(x: anytype, ctx: anytype) !u64 {
+    return reduceAll(.argmin, types.Numeric(@TypeOf(x)), .{view(x)}, ctx);
+}
+
+/// Flat indices over `axes` of the minima of `x`. See `sumAxes`.
+pub fn argminAxes(allocator: std.mem.Allocator, x: anytype, axes: []const u32, ctx: anytype) !AxesOf(.argmin, @TypeOf(x)) {
+    return reduceAxes(.argmin, types.Numeric(@TypeOf(x)), allocator, .{view(x)}, axes, ctx);
+}
+
+/// Flat indices over `axes` of the minima of `x` into `o`. See `sumAxes_`.
+pub fn argminAxes_(o: anytype, x: anytype, axes: []const u32, ctx: anytype) !void {
+    return reduceAxes_(.argmin, types.Numeric(@TypeOf(x)), o, .{view(x)}, axes, ctx);
+}
+
+/// Row-major flat index of the first largest element of `x`, or of the first
+/// NaN.
+pub fn argmax(x: anytype, ctx: anytype) !u64 {
+    return reduceAll(.argmax, types.Numeric(@TypeOf(x)), .{view(x)}, ctx);
+}
+
+/// Flat indices over `axes` of the maxima of `x`. See `sumAxes`.
+pub fn argmaxAxes(allocator: std.mem.Allocator, x: anytype, axes: []const u32, ctx: anytype) !AxesOf(.argmax, @TypeOf(x)) {
+    return reduceAxes(.argmax, types.Numeric(@TypeOf(x)), allocator, .{view(x)}, axes, ctx);
+}
+
+/// Flat indices over `axes` of the maxima of `x` into `o`. See `sumAxes_`.
+pub fn argmaxAxes_(o: anytype, x: anytype, axes: []const u32, ctx: anytype) !void {
+    return reduceAxes_(.argmax, types.Numeric(@TypeOf(x)), o, .{view(x)}, axes, ctx);
+}
+
+/// Mean of the elements of `x`, as a float. Integers are accumulated in
+/// `f64`.
+pub fn mean(x: anytype, ctx: anytype) !Of(.mean, @TypeOf(x)) {
+    return reduceAll(.mean, types.Numeric(@TypeOf(x)), .{view(x)}, ctx);
+}
+
+/// Mean of `x` over `axes`. See `sumAxes`.
+pub fn meanAxes(allocator: std.mem.Allocator, x: anytype, axes: []const u32, ctx: anytype) !AxesOf(.mean, @TypeOf(x)) {
+    return reduceAxes(.mean, types.Numeric(@TypeOf(x)), allocator, .{view(x)}, axes, ctx);
+}
+
+/// Mean of `x` over `axes` into `o`. See `sumAxes_`.
+pub fn meanAxes_(o: anytype, x: anytype, axes: []const u32, ctx: anytype) !void {
+    return reduceAxes_(.mean, types.Numeric(@TypeOf(x)), o, .{view(x)}, axes, ctx);
+}
+
+/// Variance of the elements of `x`, `sum(|x - mean|^2) / (n - ddof)`,
+/// computed in two passes.
+///
+/// Parameters
+/// ----------
+/// `x` (`anytype`):
+/// A dense or strided array of int, float or cfloat type.
+///
+/// `ctx` (`anytype`):
+/// A context struct with optional `pool` (`?*Pool`) and `ddof` (`u32`,
+/// default 0) fields.
+pub fn variance(x: anytype, ctx: anytype) !Of(.variance, @TypeOf(x)) {
+    return reduceAll(.variance, types.Numeric(@TypeOf(x)), .{view(x)}, ctx);
+}
+
+/// Variance of `x` over `axes`. See `sumAxes` and `variance`.
+pub fn varianceAxes(allocator: std.mem.Allocator, x: anytype, axes: []const u32, ctx: anytype) !AxesOf(.variance, @TypeOf(x)) {
+    return reduceAxes(.variance, types.Numeric(@TypeOf(x)), allocator, .{view(x)}, axes, ctx);
+}
+
+/// Variance of `x` over `axes` into `o`. See `sumAxes_` and `variance`.
+pub fn varianceAxes_(o: anytype, x: anytype, axes: []const u32, ctx: anytype) !void {
+    return reduceAxes_(.variance, types.Numeric(@TypeOf(x)), o, .{view(x)}, axes, ctx);
+}
+
+/// Euclidean norm of the elements of `x`.
+pub fn norm(x: anytype, ctx: anytype) !Of(.norm, @TypeOf(x)) {
+    return reduceAll(.norm, types.Numeric(@TypeOf(x)), .{view(x)}, ctx);
+}
+
+/// Euclidean norm of `x` over `axes`. See `sumAxes`.
+pub fn normAxes(allocator: std.mem.Allocator, x: anytype, axes: []const u32, ctx: anytype) !AxesOf(.norm, @TypeOf(x)) {
+    return reduceAxes(.norm, types.Numeric(@TypeOf(x)), allocator, .{view(x)}, axes, ctx);
+}
+
+/// Euclidean norm of `x` over `axes` into `o`. See `sumAxes_`.
+pub fn normAxes_(o: anytype, x: anytype, axes: []const u32, ctx: anytype) !void {
+    return reduceAxes_(.norm, types.Numeric(@TypeOf(x)), o, .{view(x)}, axes, ctx);
+}
+
+fn checkDot(comptime X: type, comptime Y: type) void {
+    if (types.Numeric(X) != types.Numeric(Y))
+        @compileError("zml.array.dot requires both arrays to have the same element type, got " ++ @typeName(types.Numeric(X)) ++ " and " ++ @typeName(types.Numeric(Y)));
+}
+
+/// Sum of the element-wise products of `x` and `y`, which must have the same
+/// shape and element type. Complex elements are not conjugated.
+///
+/// Errors
+/// ------
+/// `array.Error.DimensionMismatch`:
+/// If `x` and `y` have different shapes.
+pub fn dot(x: anytype, y: anytype, ctx: anytype) !Of(.dot, @TypeOf(x)) {
+    comptime checkDot(@TypeOf(x), @TypeOf(y));
+    return reduceAll(.dot, types.Numeric(@TypeOf(x)), .{ view(x), view(y) }, ctx);
+}
+
+/// `dot` over `axes`. See `sumAxes`.
+pub fn dotAxes(allocator: std.mem.Allocator, x: anytype, y: anytype, axes: []const u32, ctx: anytype) !AxesOf(.dot, @TypeOf(x)) {
+    comptime checkDot(@TypeOf(x), @TypeOf(y));
+    return reduceAxes(.dot, types.Numeric(@TypeOf(x)), allocator, .{ view(x), view(y) }, axes, ctx);
+}
+
+/// `dot` over `axes` into `o`. See `sumAxes_`.
+pub fn dotAxes_(o: anytype, x: anytype, y: anytype, axes: []const u32, ctx: anytype) !void {
+    comptime checkDot(@TypeOf(x), @TypeOf(y));
+    return reduceAxes_(.dot, types.Numeric(@TypeOf(x)), o, .{ view(x), view(y) }, axes, ctx);
+}
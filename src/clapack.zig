@@ -0,0 +1,303 @@
+//! C exports of the LAPACK routines, in the style of ATLAS's `clapack.h`:
+//! the order is the first argument, complex arrays are `void *` and the
+//! functions return `info`, or -1 if an argument is invalid.
+//!
+//! The `_batch_strided`, `_batch` and `_batch_interleaved` variants are the
+//! routines of `zml.linalg.batched` for strided, pointer-array and
+//! interleaved batches (the latter only for real types). They return 0, or
+//! -1 if an argument is invalid; the `info` of each matrix, if any, is
+//! stored in the `info` array. See `include/clapack.h`.
+
+const zml = @import("zml");
+
+pub const CBLAS_ORDER = enum(c_int) {
+    CblasRowMajor = 101,
+    CblasColMajor = 102,
+
+    pub fn to_zml(self: CBLAS_ORDER) zml.Layout {
+        return switch (self) {
+            .CblasRowMajor => .row_major,
+            .CblasColMajor => .col_major,
+        };
+    }
+};
+
+pub const CBLAS_TRANSPOSE = enum(c_int) {
+    CblasNoTrans = 111,
+    CblasTrans = 112,
+    CblasConjTrans = 113,
+    CblasConjNoTrans = 114,
+
+    pub fn to_zml(self: CBLAS_TRANSPOSE) zml.linalg.Transpose {
+        return switch (self) {
+            .CblasNoTrans => .no_trans,
+            .CblasTrans => .trans,
+            .CblasConjTrans => .conj_trans,
+            .CblasConjNoTrans => .conj_no_trans,
+        };
+    }
+};
+
+pub const CBLAS_UPLO = enum(c_int) {
+    CblasUpper = 121,
+    CblasLower = 122,
+
+    pub fn to_zml(self: CBLAS_UPLO) zml.types.Uplo {
+        return switch (self) {
+            .CblasUpper => .upper,
+            .CblasLower => .lower,
+        };
+    }
+};
+
+/// Returns 0, or -1 if `result` is an error.
+pub fn status(result: anyerror!void) c_int {
+    result catch return -1;
+    return 0;
+}
+
+// Linear equations, general matrices
+export fn clapack_sgetrf(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]f32, lda: c_int, ipiv: [*c]c_int) c_int {
+    return zml.linalg.lapack.getrf(order.to_zml(), m, n, @as([*]f32, @ptrCast(@alignCast(a)), lda, @ptrCast(ipiv), .{}) catch -1;
+}
+export fn clapack_dgetrf(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]f64, lda: c_int, ipiv: [*c]c_int) c_int {
+    return zml.linalg.lapack.getrf(order.to_zml(), m, n, @as([*]f64, @ptrCast(@alignCast(a)), lda, @ptrCast(ipiv), .{}) catch -1;
+}
+export fn clapack_cgetrf(order: CBLAS_ORDER, m: c_int, n: c_int, a: *anyopaque, lda: c_int, ipiv: [*c]c_int) c_int {
+    return zml.linalg.lapack.getrf(order.to_zml(), m, n, @as([*]zml.cf32, @ptrCast(@alignCast(a)), lda, @ptrCast(ipiv), .{}) catch -1;
+}
+export fn clapack_zgetrf(order: CBLAS_ORDER, m: c_int, n: c_int, a: *anyopaque, lda: c_int, ipiv: [*c]c_int) c_int {
+    return zml.linalg.lapack.getrf(order.to_zml(), m, n, @as([*]zml.cf64, @ptrCast(@alignCast(a)), lda, @ptrCast(ipiv), .{}) catch -1;
+}
+
+export fn clapack_sgetrs(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const f32, lda: c_int, ipiv: [*c]const c_int, b: [*c]f32, ldb: c_int) c_int {
+    return status(zml.linalg.lapack.getrs(order.to_zml(), trans.to_zml(), n, nrhs, @as([*]const f32, @ptrCast(@alignCast(a))), lda, @ptrCast(ipiv), @as([*]f32, @ptrCast(@alignCast(b)), ldb, .{}));
+}
+export fn clapack_dgetrs(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const f64, lda: c_int, ipiv: [*c]const c_int, b: [*c]f64, ldb: c_int) c_int {
+    return status(zml.linalg.lapack.getrs(order.to_zml(), trans.to_zml(), n, nrhs, @as([*]const f64, @ptrCast(@alignCast(a))), lda, @ptrCast(ipiv), @as([*]f64, @ptrCast(@alignCast(b)), ldb, .{}));
+}
+export fn clapack_cgetrs(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: *const anyopaque, lda: c_int, ipiv: [*c]const c_int, b: *anyopaque, ldb: c_int) c_int {
+    return status(zml.linalg.lapack.getrs(order.to_zml(), trans.to_zml(), n, nrhs, @as([*]const zml.cf32, @ptrCast(@alignCast(a))), lda, @ptrCast(ipiv), @as([*]zml.cf32, @ptrCast(@alignCast(b)), ldb, .{}));
+}
+export fn clapack_zgetrs(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: *const anyopaque, lda: c_int, ipiv: [*c]const c_int, b: *anyopaque, ldb: c_int) c_int {
+    return status(zml.linalg.lapack.getrs(order.to_zml(), trans.to_zml(), n, nrhs, @as([*]const zml.cf64, @ptrCast(@alignCast(a))), lda, @ptrCast(ipiv), @as([*]zml.cf64, @ptrCast(@alignCast(b)), ldb, .{}));
+}
+
+export fn clapack_sgesv(order: CBLAS_ORDER, n: c_int, nrhs: c_int, a: [*c]f32, lda: c_int, ipiv: [*c]c_int, b: [*c]f32, ldb: c_int) c_int {
+    return zml.linalg.lapack.gesv(order.to_zml(), n, nrhs, @as([*]f32, @ptrCast(@alignCast(a)), lda, @ptrCast(ipiv), @as([*]f32, @ptrCast(@alignCast(b)), ldb, .{}) catch -1;
+}
+export fn clapack_dgesv(order: CBLAS_ORDER, n: c_int, nrhs: c_int, a: [*c]f64, lda: c_int, ipiv: [*c]c_int, b: [*c]f64, ldb: c_int) c_int {
+    return zml.linalg.lapack.gesv(order.to_zml(), n, nrhs, @as([*]f64, @ptrCast(@alignCast(a)), lda, @ptrCast(ipiv), @as([*]f64, @ptrCast(@alignCast(b)), ldb, .{}) catch -1;
+}
+export fn clapack_cgesv(order: CBLAS_ORDER, n: c_int, nrhs: c_int, a: *anyopaque, lda: c_int, ipiv: [*c]c_int, b: *anyopaque, ldb: c_int) c_int {
+    return zml.linalg.lapack.gesv(order.to_zml(), n, nrhs, @as([*]zml.cf32, @ptrCast(@alignCast(a)), lda, @ptrCast(ipiv), @as([*]zml.cf32, @ptrCast(@alignCast(b)), ldb, .{}) catch -1;
+}
+export fn clapack_zgesv(order: CBLAS_ORDER, n: c_int, nrhs: c_int, a: *anyopaque, lda: c_int, ipiv: [*c]c_int, b: *anyopaque, ldb: c_int) c_int {
+    return zml.linalg.lapack.gesv(order.to_zml(), n, nrhs, @as([*]zml.cf64, @ptrCast(@alignCast(a)), lda, @ptrCast(ipiv), @as([*]zml.cf64, @ptrCast(@alignCast(b)), ldb, .{}) catch -1;
+}
+
+// Linear equations, positive definite matrices
+export fn clapack_spotrf(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]f32, lda: c_int) c_int {
+    return zml.linalg.lapack.potrf(order.to_zml(), uplo.to_zml(), n, @as([*]f32, @ptrCast(@alignCast(a)), lda, .{}) catch -1;
+}
+export fn clapack_dpotrf(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]f64, lda: c_int) c_int {
+    return zml.linalg.lapack.potrf(order.to_zml(), uplo.to_zml(), n, @as([*]f64, @ptrCast(@alignCast(a)), lda, .{}) catch -1;
+}
+export fn clapack_cpotrf(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: *anyopaque, lda: c_int) c_int {
+    return zml.linalg.lapack.potrf(order.to_zml(), uplo.to_zml(), n, @as([*]zml.cf32, @ptrCast(@alignCast(a)), lda, .{}) catch -1;
+}
+export fn clapack_zpotrf(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: *anyopaque, lda: c_int) c_int {
+    return zml.linalg.lapack.potrf(order.to_zml(), uplo.to_zml(), n, @as([*]zml.cf64, @ptrCast(@alignCast(a)), lda, .{}) catch -1;
+}
+
+export fn clapack_spotrs(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const f32, lda: c_int, b: [*c]f32, ldb: c_int) c_int {
+    return status(zml.linalg.lapack.potrs(order.to_zml(), uplo.to_zml(), n, nrhs, @as([*]const f32, @ptrCast(@alignCast(a))), lda, @as([*]f32, @ptrCast(@alignCast(b)), ldb, .{}));
+}
+export fn clapack_dpotrs(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const f64, lda: c_int, b: [*c]f64, ldb: c_int) c_int {
+    return status(zml.linalg.lapack.potrs(order.to_zml(), uplo.to_zml(), n, nrhs, @as([*]const f64, @ptrCast(@alignCast(a))), lda, @as([*]f64, @ptrCast(@alignCast(b)), ldb, .{}));
+}
+export fn clapack_cpotrs(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: *const anyopaque, lda: c_int, b: *anyopaque, ldb: c_int) c_int {
+    return status(zml.linalg.lapack.potrs(order.to_zml(), uplo.to_zml(), n, nrhs, @as([*]const zml.cf32, @ptrCast(@alignCast(a))), lda, @as([*]zml.cf32, @ptrCast(@alignCast(b)), ldb, .{}));
+}
+export fn clapack_zpotrs(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: *const anyopaque, lda: c_int, b: *anyopaque, ldb: c_int) c_int {
+    return status(zml.linalg.lapack.potrs(order.to_zml(), uplo.to_zml(), n, nrhs, @as([*]const zml.cf64, @ptrCast(@alignCast(a))), lda, @as([*]zml.cf64, @ptrCast(@alignCast(b)), ldb, .{}));
+}
+
+export fn clapack_sposv(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]f32, lda: c_int, b: [*c]f32, ldb: c_int) c_int {
+    return zml.linalg.lapack.posv(order.to_zml(), uplo.to_zml(), n, nrhs, @as([*]f32, @ptrCast(@alignCast(a)), lda, @as([*]f32, @ptrCast(@alignCast(b)), ldb, .{}) catch -1;
+}
+export fn clapack_dposv(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]f64, lda: c_int, b: [*c]f64, ldb: c_int) c_int {
+    return zml.linalg.lapack.posv(order.to_zml(), uplo.to_zml(), n, nrhs, @as([*]f64, @ptrCast(@alignCast(a)), lda, @as([*]f64, @ptrCast(@alignCast(b)), ldb, .{}) catch -1;
+}
+export fn clapack_cposv(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: *anyopaque, lda: c_int, b: *anyopaque, ldb: c_int) c_int {
+    return zml.linalg.lapack.posv(order.to_zml(), uplo.to_zml(), n, nrhs, @as([*]zml.cf32, @ptrCast(@alignCast(a)), lda, @as([*]zml.cf32, @ptrCast(@alignCast(b)), ldb, .{}) catch -1;
+}
+export fn clapack_zposv(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: *anyopaque, lda: c_int, b: *anyopaque, ldb: c_int) c_int {
+    return zml.linalg.lapack.posv(order.to_zml(), uplo.to_zml(), n, nrhs, @as([*]zml.cf64, @ptrCast(@alignCast(a)), lda, @as([*]zml.cf64, @ptrCast(@alignCast(b)), ldb, .{}) catch -1;
+}
+
+// Batches of small matrices
+export fn clapack_sgetrf_batch_strided(order: CBLAS_ORDER, n: c_int, a: [*c]f32, lda: c_int, stride_a: usize, ipiv: [*c]c_int, stride_ipiv: usize, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(f32, order.to_zml(), n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride_ipiv } }, @ptrCast(info), count, .{}));
+}
+export fn clapack_dgetrf_batch_strided(order: CBLAS_ORDER, n: c_int, a: [*c]f64, lda: c_int, stride_a: usize, ipiv: [*c]c_int, stride_ipiv: usize, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(f64, order.to_zml(), n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride_ipiv } }, @ptrCast(info), count, .{}));
+}
+export fn clapack_cgetrf_batch_strided(order: CBLAS_ORDER, n: c_int, a: *anyopaque, lda: c_int, stride_a: usize, ipiv: [*c]c_int, stride_ipiv: usize, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(zml.cf32, order.to_zml(), n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride_ipiv } }, @ptrCast(info), count, .{}));
+}
+export fn clapack_zgetrf_batch_strided(order: CBLAS_ORDER, n: c_int, a: *anyopaque, lda: c_int, stride_a: usize, ipiv: [*c]c_int, stride_ipiv: usize, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(zml.cf64, order.to_zml(), n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride_ipiv } }, @ptrCast(info), count, .{}));
+}
+
+export fn clapack_sgetrf_batch(order: CBLAS_ORDER, n: c_int, a: [*c]const [*c]f32, lda: c_int, ipiv: [*c]const [*c]c_int, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(f32, order.to_zml(), n, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(ipiv) }, @ptrCast(info), count, .{}));
+}
+export fn clapack_dgetrf_batch(order: CBLAS_ORDER, n: c_int, a: [*c]const [*c]f64, lda: c_int, ipiv: [*c]const [*c]c_int, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(f64, order.to_zml(), n, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(ipiv) }, @ptrCast(info), count, .{}));
+}
+export fn clapack_cgetrf_batch(order: CBLAS_ORDER, n: c_int, a: [*c]const *anyopaque, lda: c_int, ipiv: [*c]const [*c]c_int, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(zml.cf32, order.to_zml(), n, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(ipiv) }, @ptrCast(info), count, .{}));
+}
+export fn clapack_zgetrf_batch(order: CBLAS_ORDER, n: c_int, a: [*c]const *anyopaque, lda: c_int, ipiv: [*c]const [*c]c_int, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(zml.cf64, order.to_zml(), n, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(ipiv) }, @ptrCast(info), count, .{}));
+}
+
+export fn clapack_sgetrf_batch_interleaved(order: CBLAS_ORDER, n: c_int, a: [*c]f32, lda: c_int, ipiv: [*c]c_int, info: [*c]c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(f32, order.to_zml(), n, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride } }, @ptrCast(info), count, .{}));
+}
+export fn clapack_dgetrf_batch_interleaved(order: CBLAS_ORDER, n: c_int, a: [*c]f64, lda: c_int, ipiv: [*c]c_int, info: [*c]c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.getrf(f64, order.to_zml(), n, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride } }, @ptrCast(info), count, .{}));
+}
+
+export fn clapack_sgetrs_batch_strided(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const f32, lda: c_int, stride_a: usize, ipiv: [*c]const c_int, stride_ipiv: usize, b: [*c]f32, ldb: c_int, stride_b: usize, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(f32, order.to_zml(), trans.to_zml(), n, nrhs, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride_ipiv } }, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, count, .{}));
+}
+export fn clapack_dgetrs_batch_strided(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const f64, lda: c_int, stride_a: usize, ipiv: [*c]const c_int, stride_ipiv: usize, b: [*c]f64, ldb: c_int, stride_b: usize, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(f64, order.to_zml(), trans.to_zml(), n, nrhs, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride_ipiv } }, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, count, .{}));
+}
+export fn clapack_cgetrs_batch_strided(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: *const anyopaque, lda: c_int, stride_a: usize, ipiv: [*c]const c_int, stride_ipiv: usize, b: *anyopaque, ldb: c_int, stride_b: usize, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(zml.cf32, order.to_zml(), trans.to_zml(), n, nrhs, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride_ipiv } }, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, count, .{}));
+}
+export fn clapack_zgetrs_batch_strided(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: *const anyopaque, lda: c_int, stride_a: usize, ipiv: [*c]const c_int, stride_ipiv: usize, b: *anyopaque, ldb: c_int, stride_b: usize, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(zml.cf64, order.to_zml(), trans.to_zml(), n, nrhs, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride_ipiv } }, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, count, .{}));
+}
+
+export fn clapack_sgetrs_batch(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const [*c]const f32, lda: c_int, ipiv: [*c]const [*c]const c_int, b: [*c]const [*c]f32, ldb: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(f32, order.to_zml(), trans.to_zml(), n, nrhs, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(ipiv) }, .{ .pointers = @ptrCast(b) }, ldb, count, .{}));
+}
+export fn clapack_dgetrs_batch(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const [*c]const f64, lda: c_int, ipiv: [*c]const [*c]const c_int, b: [*c]const [*c]f64, ldb: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(f64, order.to_zml(), trans.to_zml(), n, nrhs, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(ipiv) }, .{ .pointers = @ptrCast(b) }, ldb, count, .{}));
+}
+export fn clapack_cgetrs_batch(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const *const anyopaque, lda: c_int, ipiv: [*c]const [*c]const c_int, b: [*c]const *anyopaque, ldb: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(zml.cf32, order.to_zml(), trans.to_zml(), n, nrhs, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(ipiv) }, .{ .pointers = @ptrCast(b) }, ldb, count, .{}));
+}
+export fn clapack_zgetrs_batch(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const *const anyopaque, lda: c_int, ipiv: [*c]const [*c]const c_int, b: [*c]const *anyopaque, ldb: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(zml.cf64, order.to_zml(), trans.to_zml(), n, nrhs, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(ipiv) }, .{ .pointers = @ptrCast(b) }, ldb, count, .{}));
+}
+
+export fn clapack_sgetrs_batch_interleaved(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const f32, lda: c_int, ipiv: [*c]const c_int, b: [*c]f32, ldb: c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(f32, order.to_zml(), trans.to_zml(), n, nrhs, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride } }, .{ .interleaved = .{ .data = @ptrCast(@alignCast(b)), .stride = stride } }, ldb, count, .{}));
+}
+export fn clapack_dgetrs_batch_interleaved(order: CBLAS_ORDER, trans: CBLAS_TRANSPOSE, n: c_int, nrhs: c_int, a: [*c]const f64, lda: c_int, ipiv: [*c]const c_int, b: [*c]f64, ldb: c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.getrs(f64, order.to_zml(), trans.to_zml(), n, nrhs, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(ipiv)), .stride = stride } }, .{ .interleaved = .{ .data = @ptrCast(@alignCast(b)), .stride = stride } }, ldb, count, .{}));
+}
+
+export fn clapack_spotrf_batch_strided(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]f32, lda: c_int, stride_a: usize, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(f32, order.to_zml(), uplo.to_zml(), n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, @ptrCast(info), count, .{}));
+}
+export fn clapack_dpotrf_batch_strided(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]f64, lda: c_int, stride_a: usize, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(f64, order.to_zml(), uplo.to_zml(), n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, @ptrCast(info), count, .{}));
+}
+export fn clapack_cpotrf_batch_strided(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: *anyopaque, lda: c_int, stride_a: usize, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(zml.cf32, order.to_zml(), uplo.to_zml(), n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, @ptrCast(info), count, .{}));
+}
+export fn clapack_zpotrf_batch_strided(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: *anyopaque, lda: c_int, stride_a: usize, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(zml.cf64, order.to_zml(), uplo.to_zml(), n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, @ptrCast(info), count, .{}));
+}
+
+export fn clapack_spotrf_batch(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]const [*c]f32, lda: c_int, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(f32, order.to_zml(), uplo.to_zml(), n, .{ .pointers = @ptrCast(a) }, lda, @ptrCast(info), count, .{}));
+}
+export fn clapack_dpotrf_batch(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]const [*c]f64, lda: c_int, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(f64, order.to_zml(), uplo.to_zml(), n, .{ .pointers = @ptrCast(a) }, lda, @ptrCast(info), count, .{}));
+}
+export fn clapack_cpotrf_batch(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]const *anyopaque, lda: c_int, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(zml.cf32, order.to_zml(), uplo.to_zml(), n, .{ .pointers = @ptrCast(a) }, lda, @ptrCast(info), count, .{}));
+}
+export fn clapack_zpotrf_batch(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]const *anyopaque, lda: c_int, info: [*c]c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(zml.cf64, order.to_zml(), uplo.to_zml(), n, .{ .pointers = @ptrCast(a) }, lda, @ptrCast(info), count, .{}));
+}
+
+export fn clapack_spotrf_batch_interleaved(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]f32, lda: c_int, info: [*c]c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(f32, order.to_zml(), uplo.to_zml(), n, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, @ptrCast(info), count, .{}));
+}
+export fn clapack_dpotrf_batch_interleaved(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, a: [*c]f64, lda: c_int, info: [*c]c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.potrf(f64, order.to_zml(), uplo.to_zml(), n, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, @ptrCast(info), count, .{}));
+}
+
+export fn clapack_spotrs_batch_strided(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const f32, lda: c_int, stride_a: usize, b: [*c]f32, ldb: c_int, stride_b: usize, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(f32, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, count, .{}));
+}
+export fn clapack_dpotrs_batch_strided(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const f64, lda: c_int, stride_a: usize, b: [*c]f64, ldb: c_int, stride_b: usize, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(f64, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, count, .{}));
+}
+export fn clapack_cpotrs_batch_strided(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: *const anyopaque, lda: c_int, stride_a: usize, b: *anyopaque, ldb: c_int, stride_b: usize, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(zml.cf32, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, count, .{}));
+}
+export fn clapack_zpotrs_batch_strided(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: *const anyopaque, lda: c_int, stride_a: usize, b: *anyopaque, ldb: c_int, stride_b: usize, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(zml.cf64, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, count, .{}));
+}
+
+export fn clapack_spotrs_batch(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const [*c]const f32, lda: c_int, b: [*c]const [*c]f32, ldb: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(f32, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(b) }, ldb, count, .{}));
+}
+export fn clapack_dpotrs_batch(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const [*c]const f64, lda: c_int, b: [*c]const [*c]f64, ldb: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(f64, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(b) }, ldb, count, .{}));
+}
+export fn clapack_cpotrs_batch(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const *const anyopaque, lda: c_int, b: [*c]const *anyopaque, ldb: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(zml.cf32, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(b) }, ldb, count, .{}));
+}
+export fn clapack_zpotrs_batch(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const *const anyopaque, lda: c_int, b: [*c]const *anyopaque, ldb: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(zml.cf64, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(b) }, ldb, count, .{}));
+}
+
+export fn clapack_spotrs_batch_interleaved(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const f32, lda: c_int, b: [*c]f32, ldb: c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(f32, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(b)), .stride = stride } }, ldb, count, .{}));
+}
+export fn clapack_dpotrs_batch_interleaved(order: CBLAS_ORDER, uplo: CBLAS_UPLO, n: c_int, nrhs: c_int, a: [*c]const f64, lda: c_int, b: [*c]f64, ldb: c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.potrs(f64, order.to_zml(), uplo.to_zml(), n, nrhs, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(b)), .stride = stride } }, ldb, count, .{}));
+}
+
+export fn clapack_sgeqrf_batch_strided(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]f32, lda: c_int, stride_a: usize, tau: [*c]f32, stride_tau: usize, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(f32, order.to_zml(), m, n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(tau)), .stride = stride_tau } }, count, .{}));
+}
+export fn clapack_dgeqrf_batch_strided(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]f64, lda: c_int, stride_a: usize, tau: [*c]f64, stride_tau: usize, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(f64, order.to_zml(), m, n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(tau)), .stride = stride_tau } }, count, .{}));
+}
+export fn clapack_cgeqrf_batch_strided(order: CBLAS_ORDER, m: c_int, n: c_int, a: *anyopaque, lda: c_int, stride_a: usize, tau: *anyopaque, stride_tau: usize, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(zml.cf32, order.to_zml(), m, n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(tau)), .stride = stride_tau } }, count, .{}));
+}
+export fn clapack_zgeqrf_batch_strided(order: CBLAS_ORDER, m: c_int, n: c_int, a: *anyopaque, lda: c_int, stride_a: usize, tau: *anyopaque, stride_tau: usize, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(zml.cf64, order.to_zml(), m, n, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(tau)), .stride = stride_tau } }, count, .{}));
+}
+
+export fn clapack_sgeqrf_batch(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]const [*c]f32, lda: c_int, tau: [*c]const [*c]f32, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(f32, order.to_zml(), m, n, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(tau) }, count, .{}));
+}
+export fn clapack_dgeqrf_batch(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]const [*c]f64, lda: c_int, tau: [*c]const [*c]f64, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(f64, order.to_zml(), m, n, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(tau) }, count, .{}));
+}
+export fn clapack_cgeqrf_batch(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]const *anyopaque, lda: c_int, tau: [*c]const *anyopaque, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(zml.cf32, order.to_zml(), m, n, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(tau) }, count, .{}));
+}
+export fn clapack_zgeqrf_batch(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]const *anyopaque, lda: c_int, tau: [*c]const *anyopaque, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(zml.cf64, order.to_zml(), m, n, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(tau) }, count, .{}));
+}
+
+export fn clapack_sgeqrf_batch_interleaved(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]f32, lda: c_int, tau: [*c]f32, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(f32, order.to_zml(), m, n, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(tau)), .stride = stride } }, count, .{}));
+}
+export fn clapack_dgeqrf_batch_interleaved(order: CBLAS_ORDER, m: c_int, n: c_int, a: [*c]f64, lda: c_int, tau: [*c]f64, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.geqrf(f64, order.to_zml(), m, n, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(tau)), .stride = stride } }, count, .{}));
+}
@@ -567,6 +567,9 @@ pub const scalbn = @import("float/scalbn.zig").scalbn;
 // pub const nexttoward = @import("float/nexttoward.zig").nexttoward; // to implement
 pub const copysign = @import("float/copysign.zig").copysign;
 
+// Vector kernels
+pub const batch = @import("float/batch.zig");
+
 pub const Error = error{
     NotFinite,
 };
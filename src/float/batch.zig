@@ -0,0 +1,626 @@
+//! Vector versions of the elementary functions for `f32` and `f64`. Every
+//! function takes an `@Vector(n, f32)` or `@Vector(n, f64)` and returns a
+//! vector of the same type, and `map` applies one of them to a contiguous
+//! buffer. They are used by the element-wise array operations when the data
+//! is contiguous.
+//!
+//! The `f64` kernels use the same reductions and approximations as the scalar
+//! translations of openlibm, with every branch evaluated for all lanes and the
+//! results merged with `@select`. The `f32` kernels evaluate the `f64` kernel
+//! on widened lanes and round once, so they are faithfully rounded.
+//!
+//! Error bounds, in ULP of the result, against the correctly rounded value:
+//!
+//! | Function | `f32` | `f64` |
+//! |----------|-------|-------|
+//! | `exp`    | 1     | 2     |
+//! | `exp2`   | 1     | 2     |
+//! | `log`    | 1     | 2     |
+//! | `log2`   | 1     | 2     |
+//! | `log10`  | 1     | 2     |
+//! | `sqrt`   | 0     | 0     |
+//! | `sin`    | 1     | 2     |
+//! | `cos`    | 1     | 2     |
+//! | `tanh`   | 1     | 3     |
+//! | `erf`    | 1     | 3     |
+//!
+//! Special values (`nan`, `±inf`, `±0` and subnormals) give the same results
+//! as the scalar functions. Lanes of `sin` and `cos` with `|x| ≥ 1.5·2²⁰` need
+//! the full Payne-Hanek reduction and go through the scalar functions.
+
+const std = @import("std");
+
+const float = @import("../float.zig");
+
+/// Functions with a vector kernel.
+pub const Kernel = enum {
+    exp,
+    exp2,
+    log,
+    log2,
+    log10,
+    sqrt,
+    sin,
+    cos,
+    tanh,
+    erf,
+};
+
+/// Whether `T` has vector kernels on the target, that is, whether it is `f32`
+/// or `f64` and the target has vector registers for it.
+pub fn supports(comptime T: type) bool {
+    return (T == f32 or T == f64) and std.simd.suggestVectorLength(T) != null;
+}
+
+/// Computes `dst[i] = kernel(src[i])` for `i` in `0..len`. `dst` and `src`
+/// may be the same buffer, but must not overlap otherwise. The elements past
+/// the last full vector are padded with zeros and go through the same kernel,
+/// so the result does not depend on the position of an element.
+pub fn map(comptime kernel: Kernel, comptime T: type, dst: [*]T, src: [*]const T, len: usize) void {
+    comptime if (!supports(T))
+        @compileError("zml.float.batch.map: T must be f32 or f64 on a target with vector registers, got " ++ @typeName(T));
+
+    const n: comptime_int = comptime std.simd.suggestVectorLength(T).?;
+    const V = @Vector(n, T);
+
+    var i: usize = 0;
+    while (i + n <= len) : (i += n) {
+        const v: V = src[i..][0..n].*;
+        dst[i..][0..n].* = apply(kernel, v);
+    }
+
+    if (i < len) {
+        var buffer: [n]T = @splat(0.0);
+        @memcpy(buffer[0 .. len - i], src[i..len]);
+        const result: [n]T = apply(kernel, @as(V, buffer));
+        @memcpy(dst[i..len], result[0 .. len - i]);
+    }
+}
+
+/// Applies `kernel` to the vector `x`.
+pub inline fn apply(comptime kernel: Kernel, x: anytype) @TypeOf(x) {
+    return switch (comptime kernel) {
+        .exp => exp(x),
+        .exp2 => exp2(x),
+        .log => log(x),
+        .log2 => log2(x),
+        .log10 => log10(x),
+        .sqrt => sqrt(x),
+        .sin => sin(x),
+        .cos => cos(x),
+        .tanh => tanh(x),
+        .erf => erf(x),
+    };
+}
+
+/// Vector `eˣ`.
+pub inline fn exp(x: anytype) @TypeOf(x) {
+    return widen(exp64, x);
+}
+
+/// Vector `2ˣ`.
+pub inline fn exp2(x: anytype) @TypeOf(x) {
+    return widen(exp2_64, x);
+}
+
+/// Vector natural logarithm.
+pub inline fn log(x: anytype) @TypeOf(x) {
+    return widen(log64, x);
+}
+
+/// Vector base 2 logarithm.
+pub inline fn log2(x: anytype) @TypeOf(x) {
+    return widen(log2_64, x);
+}
+
+/// Vector base 10 logarithm.
+pub inline fn log10(x: anytype) @TypeOf(x) {
+    return widen(log10_64, x);
+}
+
+/// Vector square root, correctly rounded.
+pub inline fn sqrt(x: anytype) @TypeOf(x) {
+    _ = Lanes(@TypeOf(x));
+    return @sqrt(x);
+}
+
+/// Vector sine.
+pub inline fn sin(x: anytype) @TypeOf(x) {
+    return widen(sin64, x);
+}
+
+/// Vector cosine.
+pub inline fn cos(x: anytype) @TypeOf(x) {
+    return widen(cos64, x);
+}
+
+/// Vector hyperbolic tangent.
+pub inline fn tanh(x: anytype) @TypeOf(x) {
+    return widen(tanh64, x);
+}
+
+/// Vector error function.
+pub inline fn erf(x: anytype) @TypeOf(x) {
+    return widen(erf64, x);
+}
+
+/// Number of lanes of `V`, which must be a vector of `f32` or `f64`.
+fn Lanes(comptime V: type) comptime_int {
+    comptime if (@typeInfo(V) != .vector or
+        (@typeInfo(V).vector.child != f32 and @typeInfo(V).vector.child != f64))
+        @compileError("zml.float.batch: x must be a vector of f32 or f64, got " ++ @typeName(V));
+
+    return @typeInfo(V).vector.len;
+}
+
+/// Evaluates the `f64` kernel `f` on `x`, widening and rounding back `f32`
+/// lanes.
+inline fn widen(comptime f: anytype, x: anytype) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const n = Lanes(V);
+
+    if (comptime @typeInfo(V).vector.child == f64)
+        return f(x);
+
+    return @floatCast(f(@as(@Vector(n, f64), @floatCast(x))));
+}
+
+fn Ints(comptime V: type) type {
+    return @Vector(@typeInfo(V).vector.len, i64);
+}
+
+fn Bits(comptime V: type) type {
+    return @Vector(@typeInfo(V).vector.len, u64);
+}
+
+fn Mask(comptime V: type) type {
+    return @Vector(@typeInfo(V).vector.len, bool);
+}
+
+inline fn splat(comptime V: type, value: anytype) V {
+    return @splat(value);
+}
+
+inline fn shift(comptime V: type, comptime amount: u6) @Vector(@typeInfo(V).vector.len, u6) {
+    return @splat(amount);
+}
+
+inline fn both(a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    return @select(bool, a, b, splat(@TypeOf(a), false));
+}
+
+inline fn either(a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    return @select(bool, a, splat(@TypeOf(a), true), b);
+}
+
+/// `2ᵏ` for `-1022 ≤ k ≤ 1023`.
+inline fn pow2(comptime V: type, k: Ints(V)) V {
+    const e: Bits(V) = @bitCast(k + splat(Ints(V), 1023));
+    return @bitCast(e << shift(V, 52));
+}
+
+/// `p·2ᵏ` for `-1080 ≤ k ≤ 1030`, rounded once when the result is
+/// subnormal.
+inline fn scale(p: anytype, k: Ints(@TypeOf(p))) @TypeOf(p) {
+    const V = @TypeOf(p);
+    const h: Ints(V) = k >> shift(V, 1);
+    return p * pow2(V, h) * pow2(V, k - h);
+}
+
+/// Clears the low 32 bits of every lane.
+inline fn truncate(x: anytype) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const bits: Bits(V) = @bitCast(x);
+    return @bitCast(bits & splat(Bits(V), 0xffffffff00000000));
+}
+
+/// Error-free `a + b = s + e`.
+inline fn twoSum(a: anytype, b: @TypeOf(a), e: *@TypeOf(a)) @TypeOf(a) {
+    const s = a + b;
+    const bb = s - a;
+    e.* = (a - (s - bb)) + (b - bb);
+    return s;
+}
+
+const ln2: f64 = 6.93147180559945286227e-1;
+const ln2_hi: f64 = 6.93147180369123816490e-1;
+const ln2_lo: f64 = 1.90821492927058770002e-10;
+const inv_ln2: f64 = 1.44269504088896338700e+0;
+
+/// `1/(j + 2)!` for `j = 0..11`. With `|r| ≤ ln(2)/2` the truncation error of
+/// the degree 13 Taylor polynomial of `eʳ - 1` is below `2⁻⁵⁷`.
+const taylor: [12]f64 = blk: {
+    var c: [12]f64 = undefined;
+    var t: comptime_float = 0.5;
+    for (0..c.len) |j| {
+        c[j] = t;
+        t /= @as(comptime_float, @floatFromInt(j + 3));
+    }
+    break :blk c;
+};
+
+/// `eʳ - 1` for `|r| ≤ ln(2)/2`, with a relative error close to 1/2 ULP.
+inline fn expm1Poly(r: anytype) @TypeOf(r) {
+    const V = @TypeOf(r);
+
+    var q: V = splat(V, taylor[taylor.len - 1]);
+    inline for (1..taylor.len) |j|
+        q = q * r + splat(V, taylor[taylor.len - 1 - j]);
+
+    return r + r * r * q;
+}
+
+fn exp64(x: anytype) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const zero = splat(V, 0.0);
+
+    const inside = both(x >= splat(V, -7.45133219101941108420e+2), x <= splat(V, 7.09782712893383973096e+2));
+    const xs = @select(f64, inside, x, zero);
+
+    // x = k·ln(2) + r, |r| ≤ ln(2)/2
+    const kf = @round(xs * splat(V, inv_ln2));
+    const r = (xs - kf * splat(V, ln2_hi)) - kf * splat(V, ln2_lo);
+    const k: Ints(V) = @intFromFloat(kf);
+    const y = scale(splat(V, 1.0) + expm1Poly(r), k);
+
+    // Overflow, underflow and nan
+    const outside = @select(f64, x > zero, splat(V, std.math.inf(f64)), @select(f64, x < zero, zero, x + x));
+    return @select(f64, inside, y, outside);
+}
+
+fn exp2_64(x: anytype) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const zero = splat(V, 0.0);
+
+    const inside = both(x >= splat(V, -1075.0), x < splat(V, 1024.0));
+    const xs = @select(f64, inside, x, zero);
+
+    // x = k + r, |r| ≤ 1/2
+    const kf = @round(xs);
+    const r = (xs - kf) * splat(V, ln2);
+    const k: Ints(V) = @intFromFloat(kf);
+    const y = scale(splat(V, 1.0) + expm1Poly(r), k);
+
+    const outside = @select(f64, x > zero, splat(V, std.math.inf(f64)), @select(f64, x < zero, zero, x + x));
+    return @select(f64, inside, y, outside);
+}
+
+/// `x = 2ᵏ·(1 + f)` with `√2/2 ≤ 1 + f < √2`, and the terms of
+/// `log(1 + f) = f - hfsq + s·(hfsq + R)`, as in the scalar `log`.
+fn LogParts(comptime V: type) type {
+    return struct {
+        f: V,
+        hfsq: V,
+        s: V,
+        R: V,
+        k: V,
+        /// Whether `f` is in the range where the scalar `log` uses the
+        /// `hfsq` form.
+        wide: Mask(V),
+    };
+}
+
+inline fn logReduce(x: anytype) LogParts(@TypeOf(x)) {
+    const V = @TypeOf(x);
+    const U = Bits(V);
+    const I = Ints(V);
+
+    // Scale up subnormals
+    const tiny = x < splat(V, 0x1p-1022);
+    const xs = @select(f64, tiny, x * splat(V, 0x1p54), x);
+
+    const bits: U = @bitCast(xs);
+    var hx: U = bits >> shift(V, 32);
+    var k: I = @as(I, @bitCast(hx >> shift(V, 20))) - splat(I, 1023);
+    k -= @select(i64, tiny, splat(I, 54), splat(I, 0));
+    hx &= splat(U, 0x000fffff);
+
+    // Normalize xs or xs/2
+    const i: U = (hx + splat(U, 0x95f64)) & splat(U, 0x100000);
+    const m: V = @bitCast(((hx | (i ^ splat(U, 0x3ff00000))) << shift(V, 32)) | (bits & splat(U, 0xffffffff)));
+    k += @as(I, @bitCast(i >> shift(V, 20)));
+
+    const f = m - splat(V, 1.0);
+    const s = f / (splat(V, 2.0) + f);
+    const z = s * s;
+    const w = z * z;
+    const t1 = w *
+        (splat(V, 3.999999999940941908e-1) + w *
+            (splat(V, 2.222219843214978396e-1) + w *
+                splat(V, 1.531383769920937332e-1)));
+    const t2 = z *
+        (splat(V, 6.666666666666735130e-1) + w *
+            (splat(V, 2.857142874366239149e-1) + w *
+                (splat(V, 1.818357216161805012e-1) + w *
+                    splat(V, 1.479819860511658591e-1))));
+
+    const hi: I = @bitCast(hx);
+    return .{
+        .f = f,
+        .hfsq = splat(V, 0.5) * f * f,
+        .s = s,
+        .R = t2 + t1,
+        .k = @floatFromInt(k),
+        .wide = ((hi - splat(I, 0x6147a)) | (splat(I, 0x6b851) - hi)) > splat(I, 0),
+    };
+}
+
+/// Results of the logarithms for `x ≤ 0`, `+inf` and `nan`, merged into `y`.
+inline fn logSpecial(x: anytype, y: @TypeOf(x)) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const zero = splat(V, 0.0);
+    const inf = splat(V, std.math.inf(f64));
+
+    var r = @select(f64, x == inf, x, y);
+    r = @select(f64, x == zero, -inf, r);
+    return @select(f64, either(x < zero, x != x), splat(V, std.math.nan(f64)), r);
+}
+
+fn log64(x: anytype) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const p = logReduce(x);
+    const hi = p.k * splat(V, ln2_hi);
+    const lo = p.k * splat(V, ln2_lo);
+
+    const a = hi - ((p.hfsq - (p.s * (p.hfsq + p.R) + lo)) - p.f);
+    const b = hi - ((p.s * (p.f - p.R) - lo) - p.f);
+    return logSpecial(x, @select(f64, p.wide, a, b));
+}
+
+fn log2_64(x: anytype) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const p = logReduce(x);
+    const r = p.s * (p.hfsq + p.R);
+
+    const hi = truncate(p.f - p.hfsq);
+    const lo = (p.f - hi) - p.hfsq + r;
+    var val_hi = hi * splat(V, 1.44269504072144627571e+0);
+    var val_lo = (lo + hi) * splat(V, 1.67517131648865118353e-10) + lo * splat(V, 1.44269504072144627571e+0);
+
+    const w = p.k + val_hi;
+    val_lo += (p.k - w) + val_hi;
+    val_hi = w;
+
+    return logSpecial(x, val_lo + val_hi);
+}
+
+fn log10_64(x: anytype) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const p = logReduce(x);
+    const r = p.s * (p.hfsq + p.R);
+
+    const hi = truncate(p.f - p.hfsq);
+    const lo = (p.f - hi) - p.hfsq + r;
+    var val_hi = hi * splat(V, 4.34294481878168880939e-1);
+    const y2 = p.k * splat(V, 3.01029995663611771306e-1);
+    var val_lo = p.k * splat(V, 3.69423907715893078616e-13) + (lo + hi) * splat(V, 2.50829467116452752298e-11) + lo * splat(V, 4.34294481878168880939e-1);
+
+    const w = y2 + val_hi;
+    val_lo += (y2 - w) + val_hi;
+    val_hi = w;
+
+    return logSpecial(x, val_lo + val_hi);
+}
+
+/// Largest `|x|` reduced in vector form. Below it `n = round(x·2/π) < 2²⁰`,
+/// so the products of `n` with the 33 bit pieces of `π/2` are exact.
+const medium: f64 = 0x1.8p20;
+
+/// `x = n·π/2 + (y0 + y1)` for `|x| < medium`, with `π/2` split in three 33
+/// bit pieces and a tail, and the differences carried in double-double.
+fn Reduced(comptime V: type) type {
+    return struct {
+        y0: V,
+        y1: V,
+        n: Ints(V),
+    };
+}
+
+inline fn remPio2(x: anytype) Reduced(@TypeOf(x)) {
+    const V = @TypeOf(x);
+
+    const f = @round(x * splat(V, 6.36619772367581382433e-1));
+    var e: V = undefined;
+    var e2: V = undefined;
+
+    var r = x - f * splat(V, 1.57079632673412561417e+0);
+    r = twoSum(r, -(f * splat(V, 6.07710050630396597660e-11)), &e);
+    r = twoSum(r, -(f * splat(V, 2.02226624871116645580e-21)), &e2);
+    const w = f * splat(V, 8.47842766036889956997e-32) - (e + e2);
+
+    const y0 = r - w;
+    return .{
+        .y0 = y0,
+        .y1 = (r - y0) - w,
+        .n = @intFromFloat(f),
+    };
+}
+
+inline fn kernelSin(x: anytype, y: @TypeOf(x)) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const z = x * x;
+    const w = z * z;
+    const r = splat(V, 8.33333333332248946124e-3) +
+        z * (splat(V, -1.98412698298579493134e-4) + z * splat(V, 2.75573137070700676789e-6)) +
+        z * w * (splat(V, -2.50507602534068634195e-8) + z * splat(V, 1.58969099521155010221e-10));
+    const v = z * x;
+
+    return x - ((z * (splat(V, 0.5) * y - v * r) - y) - v * splat(V, -1.66666666666666324348e-1));
+}
+
+inline fn kernelCos(x: anytype, y: @TypeOf(x)) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const one = splat(V, 1.0);
+    const z = x * x;
+    const ww = z * z;
+    const r = z * (splat(V, 4.16666666666666019037e-2) + z *
+        (splat(V, -1.38888888888741095749e-3) + z * splat(V, 2.48015872894767294178e-5))) +
+        ww * ww * (splat(V, -2.75573143513906633035e-7) +
+            z * (splat(V, 2.08757232129817482790e-9) + z * splat(V, -1.13596475577881948265e-11)));
+    const hz = splat(V, 0.5) * z;
+    const w = one - hz;
+
+    return w + (((one - w) - hz) + (z * r - x * y));
+}
+
+/// Shared body of `sin64` and `cos64`. `phase` is 0 for the sine and 1 for
+/// the cosine, which is the sine shifted by one quadrant.
+inline fn sinCos(x: anytype, comptime phase: i64) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const I = Ints(V);
+    const n = Lanes(V);
+
+    const a = @abs(x);
+    const inside = a < splat(V, medium);
+    const p = remPio2(@select(f64, inside, x, splat(V, 0.0)));
+
+    const s = kernelSin(p.y0, p.y1);
+    const c = kernelCos(p.y0, p.y1);
+    const q = p.n + splat(I, phase);
+    const odd = (q & splat(I, 1)) != splat(I, 0);
+    const negative = (q & splat(I, 2)) != splat(I, 0);
+    const v = @select(f64, odd, c, s);
+    var y = @select(f64, negative, -v, v);
+
+    // inf and nan
+    y = @select(f64, inside, y, x - x);
+
+    if (comptime phase == 0)
+        y = @select(f64, a < splat(V, 0x1p-26), x, y);
+
+    const large = both(a >= splat(V, medium), a < splat(V, std.math.inf(f64)));
+    if (@reduce(.Or, large)) {
+        const xs: [n]f64 = x;
+        const mask: [n]bool = large;
+        var ys: [n]f64 = y;
+        for (0..n) |i| {
+            if (mask[i])
+                ys[i] = if (comptime phase == 0) float.sin(xs[i]) else float.cos(xs[i]);
+        }
+
+        y = ys;
+    }
+
+    return y;
+}
+
+fn sin64(x: anytype) @TypeOf(x) {
+    return sinCos(x, 0);
+}
+
+fn cos64(x: anytype) @TypeOf(x) {
+    return sinCos(x, 1);
+}
+
+/// `eʸ - 1` for `-2 ≤ y ≤ 0`.
+inline fn expm1Small(y: anytype) @TypeOf(y) {
+    const V = @TypeOf(y);
+
+    const kf = @round(y * splat(V, inv_ln2));
+    const r = (y - kf * splat(V, ln2_hi)) - kf * splat(V, ln2_lo);
+    const t = pow2(V, @intFromFloat(kf));
+
+    return t * expm1Poly(r) + (t - splat(V, 1.0));
+}
+
+fn tanh64(x: anytype) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const one = splat(V, 1.0);
+    const two = splat(V, 2.0);
+
+    const a = @abs(x);
+
+    // 1 ≤ |x| < 22: 1 - 2/(e²ˣ + 1)
+    const e = exp64(two * @min(a, splat(V, 22.0)));
+    const large = one - two / (e + one);
+
+    // |x| < 1: -t/(t + 2), t = e⁻²ˣ - 1
+    const t = expm1Small(splat(V, -2.0) * @min(a, one));
+    const small = -t / (t + two);
+
+    var z = @select(f64, a >= one, large, small);
+    z = @select(f64, a >= splat(V, 22.0), one, z);
+    z = @select(f64, x < splat(V, 0.0), -z, z);
+    z = @select(f64, a < splat(V, 0x1p-28), x, z);
+    return @select(f64, x != x, x + x, z);
+}
+
+fn erf64(x: anytype) @TypeOf(x) {
+    const V = @TypeOf(x);
+    const one = splat(V, 1.0);
+
+    const a = @abs(x);
+
+    // |x| < 0.84375
+    const z = x * x;
+    const r = splat(V, 1.28379167095512558561e-1) + z *
+        (splat(V, -3.25042107247001499370e-1) + z *
+            (splat(V, -2.84817495755985104766e-2) + z *
+                (splat(V, -5.77027029648944159157e-3) + z *
+                    splat(V, -2.37630166566501626084e-5))));
+    const s = one + z *
+        (splat(V, 3.97917223959155352819e-1) + z *
+            (splat(V, 6.50222499887672944485e-2) + z *
+                (splat(V, 5.08130628187576562776e-3) + z *
+                    (splat(V, 1.32494738004321644526e-4) + z *
+                        splat(V, -3.96022827877536812320e-6)))));
+    var y = x + x * (r / s);
+    y = @select(f64, a < splat(V, 0x1p-28), x + splat(V, 1.28379167095512586316e-1) * x, y);
+    y = @select(f64, a < splat(V, 0x1p-1015), splat(V, 0.125) * (splat(V, 8.0) * x + splat(V, 1.02703333676410069053e+0) * x), y);
+
+    // 0.84375 ≤ |x| < 1.25
+    const sm = a - one;
+    const P = splat(V, -2.36211856075265944077e-3) + sm *
+        (splat(V, 4.14856118683748331666e-1) + sm *
+            (splat(V, -3.72207876035701323847e-1) + sm *
+                (splat(V, 3.18346619901161753674e-1) + sm *
+                    (splat(V, -1.10894694282396677476e-1) + sm *
+                        (splat(V, 3.54783043256182359371e-2) + sm *
+                            splat(V, -2.16637559486879084300e-3))))));
+    const Q = one + sm *
+        (splat(V, 1.06420880400844228286e-1) + sm *
+            (splat(V, 5.40397917702171048937e-1) + sm *
+                (splat(V, 7.18286544141962662868e-2) + sm *
+                    (splat(V, 1.26171219808761642112e-1) + sm *
+                        (splat(V, 1.36370839120290507362e-2) + sm *
+                            splat(V, 1.19844998467991074170e-2))))));
+    const mid = splat(V, 8.45062911510467529297e-1) + P / Q;
+
+    // 1.25 ≤ |x| < 6, the coefficients of both intervals selected per lane
+    const at = @min(@max(a, splat(V, 1.25)), splat(V, 6.0));
+    const near = at < splat(V, 0x1.6db6ep+1); // |x| < 1/0.35
+    const ss = one / (at * at);
+    const R = pick(near, -9.86494403484714822705e-3, -9.86494292470009928597e-3) + ss *
+        (pick(near, -6.93858572707181764372e-1, -7.99283237680523006574e-1) + ss *
+            (pick(near, -1.05586262253232909814e+1, -1.77579549177547519889e+1) + ss *
+                (pick(near, -6.23753324503260060396e+1, -1.60636384855821916062e+2) + ss *
+                    (pick(near, -1.62396669462573470355e+2, -6.37566443368389627722e+2) + ss *
+                        (pick(near, -1.84605092906711035994e+2, -1.02509513161107724954e+3) + ss *
+                            (pick(near, -8.12874355063065934246e+1, -4.83519191608651397019e+2) + ss *
+                                pick(near, -9.81432934416914548592e+0, 0.0)))))));
+    const S = one + ss *
+        (pick(near, 1.96512716674392571292e+1, 3.03380607434824582924e+1) + ss *
+            (pick(near, 1.37657754143519042600e+2, 3.25792512996573918826e+2) + ss *
+                (pick(near, 4.34565877475229228821e+2, 1.53672958608443695994e+3) + ss *
+                    (pick(near, 6.45387271733267880336e+2, 3.19985821950859553908e+3) + ss *
+                        (pick(near, 4.29008140027567833386e+2, 2.55305040643316442583e+3) + ss *
+                            (pick(near, 1.08635005541779435134e+2, 4.74528541206955367215e+2) + ss *
+                                (pick(near, 6.57024977031928170135e+0, -2.24409524465858183362e+1) + ss *
+                                    pick(near, -6.04244152148580987438e-2, 0.0))))))));
+    const zz = truncate(at);
+    const tail = exp64(-zz * zz - splat(V, 0.5625)) * exp64((zz - at) * (zz + at) + R / S);
+    const far = one - tail / at;
+
+    var w = @select(f64, a < splat(V, 1.25), mid, far);
+    w = @select(f64, a >= splat(V, 6.0), one, w);
+    w = @select(f64, x < splat(V, 0.0), -w, w);
+
+    y = @select(f64, a < splat(V, 0.84375), y, w);
+    return @select(f64, x != x, x + x, y);
+}
+
+/// Per lane choice between the coefficients `a` and `b`.
+inline fn pick(mask: anytype, comptime a: f64, comptime b: f64) @Vector(@typeInfo(@TypeOf(mask)).vector.len, f64) {
+    const V = @Vector(@typeInfo(@TypeOf(mask)).vector.len, f64);
+    return @select(f64, mask, splat(V, a), splat(V, b));
+}
@@ -67,6 +67,29 @@ pub const Integer = struct {
         };
     }
 
+    /// Initializes a new integer whose limbs live in `buffer`, typically an
+    /// array on the stack, so that values of up to `buffer.len` limbs need no
+    /// allocation. Growing past it moves the limbs to memory from the
+    /// allocator given to `reserve`, which is then the one to pass to
+    /// `deinit`.
+    ///
+    /// The integer must not be used after `buffer` goes out of scope.
+    ///
+    /// ## Arguments
+    /// * `buffer` (`[]u32`): The storage for the limbs.
+    ///
+    /// ## Returns
+    /// `Integer`: The newly initialized integer, with value zero.
+    pub fn initBuffer(buffer: []u32) Integer {
+        return .{
+            .limbs = buffer.ptr,
+            .size = 0,
+            ._llen = types.scast(u32, buffer.len),
+            .positive = true,
+            .flags = .{ .owns_data = true, .writable = true, .inline_data = true },
+        };
+    }
+
     /// Initializes a new integer with the specified value.
     ///
     /// ## Signature
@@ -109,7 +132,7 @@ pub const Integer = struct {
     /// ## Returns
     /// `void`
     pub fn deinit(self: *Integer, allocator: std.mem.Allocator) void {
-        if (self.flags.owns_data)
+        if (self.flags.owns_data and !self.flags.inline_data)
             allocator.free(self.limbs[0..self._llen]);
 
         self.* = undefined;
@@ -137,7 +160,16 @@ pub const Integer = struct {
             return integer.Error.DataNotOwned;
 
         if (new_size > self._llen) {
-            self.limbs = (try allocator.realloc(self.limbs[0..self._llen], new_size)).ptr;
+            if (self.flags.inline_data) {
+                // Move out of the caller's buffer.
+                const limbs: []u32 = try allocator.alloc(u32, new_size);
+                @memcpy(limbs[0..self._llen], self.limbs[0..self._llen]);
+                self.limbs = limbs.ptr;
+                self.flags.inline_data = false;
+            } else {
+                self.limbs = (try allocator.realloc(self.limbs[0..self._llen], new_size)).ptr;
+            }
+
             self._llen = new_size;
         }
     }
@@ -159,7 +191,7 @@ pub const Integer = struct {
         if (!self.flags.owns_data)
             return integer.Error.DataNotOwned;
 
-        if (self.size == self._llen)
+        if (self.size == self._llen or self.flags.inline_data)
             return;
 
         self.limbs = (try allocator.realloc(self.limbs[0..self._llen], self.size)).ptr;
@@ -544,6 +576,10 @@ pub const mul_ = @import("integer/mul_.zig").mul_;
 pub const div = @import("integer/div.zig").div;
 pub const div_ = @import("integer/div_.zig").div_;
 
+/// Multiplication and division kernels on limb slices, with their crossover
+/// thresholds.
+pub const nat = @import("integer/nat.zig");
+
 // Comparison operations
 pub const cmp = @import("integer/cmp.zig").cmp;
 pub const eq = @import("integer/eq.zig").eq;
@@ -559,6 +595,7 @@ pub const abs_ = @import("integer/abs_.zig").abs_;
 pub const neg = @import("integer/neg.zig").neg;
 
 pub const gcd = @import("integer/gcd.zig").gcd;
+pub const gcd_ = @import("integer/gcd_.zig").gcd_;
 
 pub const Error = error{
     ZeroDivision,
@@ -571,4 +608,12 @@ pub const Error = error{
 pub const Flags = packed struct {
     owns_data: bool = true,
     writable: bool = true,
+    /// The limbs live in a buffer provided by the caller (see
+    /// `Integer.initBuffer`), not in memory from the allocator.
+    inline_data: bool = false,
 };
+
+/// Limbs kept inline, on the stack, by the temporaries of the integer and
+/// rational operations. Temporaries that do not grow past it need no
+/// allocation.
+pub const small_limbs: u32 = 4;
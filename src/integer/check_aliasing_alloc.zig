@@ -4,14 +4,19 @@ const types = @import("../types.zig");
 const integer = @import("../integer.zig");
 
 /// Checks if `x` is aliased with `o`, and if so, returns a copy of `x`
-/// allocated with `allocator`. Otherwise, returns `x`.
+/// allocated with `allocator`. Otherwise, returns a view of `x` that does not
+/// own its data, so that the result can always be deinitialized.
 pub fn check_aliasing_alloc(allocator: std.mem.Allocator, o: *const integer.Integer, x: anytype) !@TypeOf(x) {
     switch (comptime types.numericType(@TypeOf(x))) {
         .bool, .int, .float, .dyadic, .cfloat => return x,
-        .integer => return if (@import("check_aliasing.zig").check_aliasing(o, x))
-            x.copy(allocator)
-        else
-            x,
+        .integer => {
+            if (@import("check_aliasing.zig").check_aliasing(o, x))
+                return x.copy(allocator);
+
+            var view: @TypeOf(x) = x;
+            view.flags.owns_data = false;
+            return view;
+        },
         else => unreachable,
     }
 }
@@ -4,12 +4,19 @@ const types = @import("../types.zig");
 const ops = @import("../ops.zig");
 const integer = @import("../integer.zig");
 const Integer = integer.Integer;
+const scratch = @import("../scratch.zig");
+
+const check_aliasing = @import("check_aliasing.zig").check_aliasing;
+const nat = @import("nat.zig");
 
 /// Performs in-place division between two operands of integer, cfloat, dyadic,
 /// float, int or bool types, where at least one operand must be of integer
 /// type. The operation is performed by casting both operands to integer, then
 /// dividing them in-place.
 ///
+/// Short quotients use Knuth's long division, longer ones the recursive
+/// division of Burnikel and Ziegler (see `nat.thresholds`).
+///
 /// Aliasing between the output operand `o` and the input operands `x` or `y` is
 /// allowed.
 ///
@@ -54,80 +61,33 @@ pub fn div_(allocator: std.mem.Allocator, o: *Integer, x: anytype, y: anytype) !
                 if (y.size == 0)
                     return integer.Error.ZeroDivision;
 
-                if (integer.lt(
-                    integer.abs(null, x) catch unreachable,
-                    integer.abs(null, y) catch unreachable,
-                ))
+                if (x.size < y.size or (x.size == y.size and
+                    nat.cmp(x.limbs[0..x.size], y.limbs[0..y.size]) == .lt))
                     return o.set(allocator, 0);
 
-                if (y.size == 1) {
-                    try o.reserve(allocator, x.size);
-                    var carry: u64 = 0;
-                    var i: u32 = x.size;
-                    while (i > 0) : (i -= 1) {
-                        const limb: u64 = (carry << 32) | types.scast(u64, x.limbs[i - 1]);
-                        const q: u32 = @truncate(limb / types.scast(u64, y.limbs[0]));
-                        carry = limb % types.scast(u64, y.limbs[0]);
-                        o.limbs[i - 1] = q;
-                    }
-
-                    o.size = x.size;
-                    o.truncate();
-                    o.positive = x.positive == y.positive;
-                    return;
-                }
-
-                // x.size and y.size > 1
-                const n: u32 = y.size;
-                const m: u32 = x.size - n;
+                const size: u32 = x.size - y.size + 1;
+                const positive: bool = x.positive == y.positive;
+                const temporaries: std.mem.Allocator = scratch.allocator(allocator);
 
-                // Ensure o has enough capacity for the left shift
-                var r: Integer = try .init(allocator, x.size + 1);
-                try r.set(allocator, x);
-                defer r.deinit(allocator);
+                if (!check_aliasing(o, x) and !check_aliasing(o, y)) {
+                    try o.reserve(allocator, size);
+                    try nat.divRem(temporaries, o.limbs[0..size], null, x.limbs[0..x.size], y.limbs[0..y.size], nat.thresholds);
+                } else {
+                    // The quotient goes aside first, on the stack when small.
+                    var buffer: [integer.small_limbs]u32 = undefined;
+                    var q: Integer = .initBuffer(&buffer);
+                    defer q.deinit(temporaries);
+                    try q.reserve(temporaries, size);
 
-                const s: u32 = @clz(y.limbs[n - 1]);
+                    try nat.divRem(temporaries, q.limbs[0..size], null, x.limbs[0..x.size], y.limbs[0..y.size], nat.thresholds);
 
-                // We left shift so y.limbs[n - 1] & (1 << 31) != 0
-                // So, no need to allocate an extra limb for v
-                var v: Integer = try y.copy(allocator);
-                defer v.deinit(allocator);
-
-                if (s > 0) {
-                    _ = shiftLeftInPlace(v.limbs[0..v.size], null, @intCast(s));
-                    if (shiftLeftInPlace(r.limbs[0..r.size], &r.limbs[r.size], @intCast(s)))
-                        r.size += 1;
+                    try o.reserve(allocator, size);
+                    @memcpy(o.limbs[0..size], q.limbs[0..size]);
                 }
 
-                try o.reserve(allocator, m + 1);
-
-                var j: u32 = m;
-                while (true) : (j -= 1) {
-                    const qhat: u32 = estimate_qhat(
-                        if (j + n < r.size) r.limbs[j + n] else 0,
-                        if (j + n - 1 < r.size) r.limbs[j + n - 1] else 0,
-                        if (j + n - 2 < r.size) r.limbs[j + n - 2] else 0,
-                        v.limbs[n - 1],
-                        v.limbs[n - 2],
-                    );
-
-                    o.limbs[j] = qhat;
-
-                    if (mul_sub_(r.limbs[j .. j + n + 1], v.limbs[0..n], qhat)) {
-                        o.limbs[j] -= 1;
-                        add_back(r.limbs[j .. j + n + 1], v.limbs[0..n]);
-                    }
-
-                    if (j == 0) break;
-                }
-
-                o.size = m + 1;
+                o.size = size;
+                o.positive = positive;
                 o.truncate();
-
-                if (s > 0) shiftRightInPlace(r.limbs[0..n], @intCast(s));
-                if (r.limbs[r.size - 1] == 0 and r.size > 1) r.size -= 1;
-
-                o.positive = x.positive == y.positive;
             },
             .cfloat => return div_(allocator, o, x, y.re),
             .dyadic => {
@@ -220,76 +180,3 @@ pub fn shiftRightInPlace(limbs: []u32, s: u5) void {
         carry = new_carry;
     }
 }
-
-fn estimate_qhat(
-    u_high: u32, // u[j+n]
-    u_next: u32, // u[j+n−1]
-    u_next2: u32, // u[j+n−2]
-    v_high: u32, // v[n−1]
-    v_next: u32, // v[n−2]
-) u32 {
-    const b: u64 = 1 << 32;
-    const num: u64 = (types.scast(u64, u_high) << 32) | u_next;
-    var qhat: u64 = num / types.scast(u64, v_high);
-    var rhat: u64 = num % types.scast(u64, v_high);
-
-    var i: usize = 0;
-    while (i < 2) : (i += 1) {
-        if (qhat >= b or (qhat * types.scast(u64, v_next) > (rhat << 32) + types.scast(u64, u_next2))) {
-            qhat -= 1;
-            rhat += types.scast(u64, v_high);
-            if (rhat >= b) break;
-        } else break;
-    }
-
-    return @truncate(qhat);
-}
-
-fn mul_sub_(u_part: []u32, v: []const u32, qhat: u32) bool {
-    var carry: u64 = 0;
-    var borrow: u64 = 0;
-    const n = v.len;
-
-    var i: usize = 0;
-    while (i < n) : (i += 1) {
-        const prod: u64 = types.scast(u64, v[i]) * qhat + carry;
-        carry = prod >> 32;
-        const prod_low: u64 = prod & 0xFFFFFFFF;
-
-        // Compute u_part[i] - prod_low - borrow
-        const u_val: u64 = @as(u64, u_part[i]);
-        const sub_val: u64 = prod_low + borrow;
-
-        if (u_val >= sub_val) {
-            u_part[i] = @truncate(u_val - sub_val);
-            borrow = 0;
-        } else {
-            u_part[i] = @truncate(u_val + (1 << 32) - sub_val);
-            borrow = 1;
-        }
-    }
-
-    const high_res = @subWithOverflow(@as(u64, u_part[n]), carry + borrow);
-    u_part[n] = @truncate(high_res[0]);
-
-    return high_res[1] != 0;
-}
-
-fn add_back(u_part: []u32, v: []const u32) void {
-    var carry: u64 = 0;
-    const n = v.len;
-    var i: usize = 0;
-
-    while (i < n) : (i += 1) {
-        const sum: u64 = @as(u64, u_part[i]) + @as(u64, v[i]) + carry;
-        u_part[i] = @truncate(sum);
-        carry = sum >> 32;
-    }
-
-    var k = n;
-    while (carry != 0 and k < u_part.len) : (k += 1) {
-        const sum: u64 = @as(u64, u_part[k]) + carry;
-        u_part[k] = @truncate(sum);
-        carry = sum >> 32;
-    }
-}
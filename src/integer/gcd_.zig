@@ -0,0 +1,211 @@
+const std = @import("std");
+
+const types = @import("../types.zig");
+const scratch = @import("../scratch.zig");
+const integer = @import("../integer.zig");
+const Integer = integer.Integer;
+
+const check_aliasing_alloc = @import("check_aliasing_alloc.zig").check_aliasing_alloc;
+const nat = @import("nat.zig");
+
+/// Computes the greatest common divisor between two operands of integer,
+/// cfloat, dyadic, float, int or bool types in-place, where at least one
+/// operand must be of integer type. The operation is performed by casting both
+/// operands to integer, then applying the binary GCD algorithm.
+///
+/// Operands that fit in 64 bits are handled natively, and the second operand
+/// is worked on in a stack buffer, so small operands need no allocation other
+/// than for `o`.
+///
+/// Aliasing between the output operand `o` and the input operands `x` or `y` is
+/// allowed.
+///
+/// ## Signature
+/// ```zig
+/// integer.gcd_(allocator: std.mem.Allocator, o: *Integer, x: X, y: Y) !void
+/// ```
+///
+/// ## Arguments
+/// * `allocator` (`std.mem.Allocator`): The allocator to use for memory
+///   allocations. Must be the same allocator used to initialize `o`.
+/// * `o` (`*Integer`): A pointer to the output operand where the result will be
+///   stored.
+/// * `x` (`anytype`): The left operand.
+/// * `y` (`anytype`): The right operand.
+///
+/// ## Returns
+/// `void`
+///
+/// ## Errors
+/// * `std.mem.Allocator.Error.OutOfMemory`: If memory allocation fails.
+/// * `integer.Error.NotWritable`: If the output operand `o` is not writable.
+/// * `integer.Error.DataNotOwned`: If the output operand `o` does not own its
+///   data and resizing is needed.
+pub fn gcd_(allocator: std.mem.Allocator, o: *Integer, x: anytype, y: anytype) !void {
+    const X: type = @TypeOf(x);
+    const Y: type = @TypeOf(y);
+
+    comptime if (!types.isNumeric(X) or !types.isNumeric(Y) or
+        !types.numericType(X).le(.integer) or !types.numericType(Y).le(.integer) or
+        (types.numericType(X) != .integer and types.numericType(Y) != .integer))
+        @compileError("zml.integer.gcd_: at least one of x or y must be an integer, the other must be a bool, an int, a float, a dyadic, a cfloat or an integer, got\n\tx: " ++
+            @typeName(X) ++ "\n\ty: " ++ @typeName(Y) ++ "\n");
+
+    if (!o.flags.writable)
+        return integer.Error.NotWritable;
+
+    switch (comptime types.numericType(X)) {
+        .integer => switch (comptime types.numericType(Y)) {
+            .integer => {
+                const temporaries: std.mem.Allocator = scratch.allocator(allocator);
+
+                // |y| goes to a temporary, |x| to o.
+                var buffer: [integer.small_limbs]u32 = undefined;
+                var b: Integer = .initBuffer(&buffer);
+                defer b.deinit(temporaries);
+                try b.set(temporaries, y);
+                b.positive = true;
+
+                var tx: Integer = try check_aliasing_alloc(temporaries, o, x);
+                defer tx.deinit(temporaries);
+                try o.set(allocator, tx);
+                o.positive = true;
+
+                if (b.size == 0)
+                    return;
+
+                if (o.size == 0)
+                    return o.set(allocator, b);
+
+                if (o.size <= 2 and b.size <= 2) {
+                    const g: u64 = std.math.gcd(o.toInt(u64), b.toInt(u64));
+                    return o.set(allocator, g);
+                }
+
+                // Remove common factors of 2 from both, store in `shift`.
+                const shift: u32 = @min(trailingZeroBits(o.*), trailingZeroBits(b));
+                shiftRight(o, shift);
+                shiftRight(&b, shift);
+
+                // Make sure the first one is odd.
+                shiftRight(o, trailingZeroBits(o.*));
+
+                // Subtract the smaller from the larger in place, working through
+                // pointers so that the values never leave their storage.
+                var u: *Integer = o;
+                var v: *Integer = &b;
+                while (v.size != 0) {
+                    shiftRight(v, trailingZeroBits(v.*));
+
+                    if (nat.cmp(u.limbs[0..u.size], v.limbs[0..v.size]) == .gt)
+                        std.mem.swap(*Integer, &u, &v);
+
+                    _ = nat.sub(v.limbs[0..v.size], v.limbs[0..v.size], u.limbs[0..u.size]);
+                    v.truncate();
+                }
+
+                if (u != o)
+                    try o.set(allocator, u.*);
+
+                // Restore common factors of 2.
+                try shiftLeft(allocator, o, shift);
+            },
+            .cfloat => return gcd_(allocator, o, x, y.re),
+            .dyadic => {
+                var ty = try @import("../dyadic/asInteger.zig").asInteger(y);
+                ty[0].limbs = &ty[1];
+
+                return gcd_(allocator, o, x, ty[0]);
+            },
+            .float => {
+                var ty = try @import("../float/asInteger.zig").asInteger(y);
+                ty[0].limbs = &ty[1];
+
+                return gcd_(allocator, o, x, ty[0]);
+            },
+            .int => {
+                var ty = @import("../int/asInteger.zig").asInteger(y);
+                ty[0].limbs = &ty[1];
+
+                return gcd_(allocator, o, x, ty[0]);
+            },
+            .bool => return gcd_(
+                allocator,
+                o,
+                x,
+                types.cast(Integer, y, .{}) catch unreachable,
+            ),
+            else => unreachable,
+        },
+        .cfloat => return gcd_(allocator, o, x.re, y),
+        .dyadic => {
+            var tx = try @import("../dyadic/asInteger.zig").asInteger(x);
+            tx[0].limbs = &tx[1];
+
+            return gcd_(allocator, o, tx[0], y);
+        },
+        .float => {
+            var tx = try @import("../float/asInteger.zig").asInteger(x);
+            tx[0].limbs = &tx[1];
+
+            return gcd_(allocator, o, tx[0], y);
+        },
+        .int => {
+            var tx = @import("../int/asInteger.zig").asInteger(x);
+            tx[0].limbs = &tx[1];
+
+            return gcd_(allocator, o, tx[0], y);
+        },
+        .bool => return gcd_(
+            allocator,
+            o,
+            types.cast(Integer, x, .{}) catch unreachable,
+            y,
+        ),
+        else => unreachable,
+    }
+}
+
+fn trailingZeroBits(self: Integer) u32 {
+    var count: u32 = 0;
+    var i: u32 = 0;
+    while (i < self.size) : (i += 1) {
+        const limb = self.limbs[i];
+        if (limb == 0) {
+            count += 32;
+        } else {
+            count += @ctz(limb);
+            break;
+        }
+    }
+    return count;
+}
+
+/// Shifts right by `bits`, at most the number of trailing zero bits.
+fn shiftRight(self: *Integer, bits: u32) void {
+    const limbs: u32 = bits / 32;
+    if (limbs > 0) {
+        std.mem.copyForwards(u32, self.limbs[0 .. self.size - limbs], self.limbs[limbs..self.size]);
+        self.size -= limbs;
+    }
+
+    nat.shr(self.limbs[0..self.size], @intCast(bits % 32));
+    self.truncate();
+}
+
+fn shiftLeft(allocator: std.mem.Allocator, self: *Integer, bits: u32) !void {
+    if (bits == 0 or self.size == 0) return;
+
+    const limbs: u32 = bits / 32;
+    try self.reserve(allocator, self.size + limbs + 1);
+
+    std.mem.copyBackwards(u32, self.limbs[limbs .. self.size + limbs], self.limbs[0..self.size]);
+    @memset(self.limbs[0..limbs], 0);
+    self.size += limbs;
+
+    const carry: u32 = nat.shl(self.limbs[0..self.size], @intCast(bits % 32));
+    if (carry != 0) {
+        self.limbs[self.size] = carry;
+        self.size += 1;
+    }
+}
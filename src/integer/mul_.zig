@@ -4,14 +4,19 @@ const types = @import("../types.zig");
 const ops = @import("../ops.zig");
 const integer = @import("../integer.zig");
 const Integer = integer.Integer;
+const scratch = @import("../scratch.zig");
 
 const check_aliasing_alloc = @import("check_aliasing_alloc.zig").check_aliasing_alloc;
+const nat = @import("nat.zig");
 
 /// Performs in-place multiplication between two operands of integer, cfloat,
 /// dyadic, float, int or bool types, where at least one operand must be of
 /// integer type. The operation is performed by casting both operands to
 /// integer, then multiplying them in-place.
 ///
+/// The algorithm is chosen from the size of the smaller operand: schoolbook,
+/// Karatsuba, Toom-3 or a number theoretic transform (see `nat.thresholds`).
+///
 /// Aliasing between the output operand `o` and the input operands `x` or `y` is
 /// allowed.
 ///
@@ -55,38 +60,23 @@ pub fn mul_(allocator: std.mem.Allocator, o: *Integer, x: anytype, y: anytype) !
                 if (x.size == 0 or y.size == 0)
                     return o.set(allocator, 0);
 
+                const temporaries: std.mem.Allocator = scratch.allocator(allocator);
+
                 // Aliasing check.
-                var tx: Integer = try check_aliasing_alloc(allocator, o, x);
-                defer tx.deinit(allocator);
-                var ty: Integer = try check_aliasing_alloc(allocator, o, y);
-                defer ty.deinit(allocator);
+                var tx: Integer = try check_aliasing_alloc(temporaries, o, x);
+                defer tx.deinit(temporaries);
+                var ty: Integer = try check_aliasing_alloc(temporaries, o, y);
+                defer ty.deinit(temporaries);
 
                 try o.reserve(allocator, tx.size + ty.size);
 
-                var i: u32 = 0;
-                while (i < tx.size + ty.size) : (i += 1) {
-                    o.limbs[i] = 0;
-                }
-
-                i = 0;
-                while (i < tx.size) : (i += 1) {
-                    var carry: u128 = 0;
-                    var j: u32 = 0;
-                    while (j < ty.size) : (j += 1) {
-                        const acc: u128 = types.scast(u128, o.limbs[i + j]) +
-                            types.scast(u128, tx.limbs[i]) * types.scast(u128, ty.limbs[j]) + carry;
-                        o.limbs[i + j] = @truncate(acc & 0xFFFFFFFF);
-                        carry = acc >> 32;
-                    }
-
-                    // Propagate leftover carry.
-                    var k: u32 = i + ty.size;
-                    while (carry != 0) : (k += 1) {
-                        const acc: u128 = types.scast(u128, o.limbs[k]) + carry;
-                        o.limbs[k] = @truncate(acc & 0xFFFFFFFF);
-                        carry = acc >> 32;
-                    }
-                }
+                try nat.mul(
+                    temporaries,
+                    o.limbs[0 .. tx.size + ty.size],
+                    tx.limbs[0..tx.size],
+                    ty.limbs[0..ty.size],
+                    nat.thresholds,
+                );
 
                 o.size = tx.size + ty.size;
                 o.positive = tx.positive == ty.positive;
@@ -0,0 +1,737 @@
+//! Kernels on natural numbers stored as little-endian slices of 32-bit limbs,
+//! the magnitudes of `Integer`. Signs, sizes and aliasing are handled by the
+//! callers.
+//!
+//! Multiplication picks schoolbook, Karatsuba, Toom-3 or a number theoretic
+//! transform from the size of the smaller operand; unbalanced operands are cut
+//! into balanced blocks first. Division uses Knuth's algorithm D below
+//! `thresholds.division` quotient limbs, and the recursive division of
+//! Burnikel and Ziegler above (Brent and Zimmermann, Modern Computer
+//! Arithmetic, algorithms 1.8 and 1.9), so it inherits the complexity of the
+//! multiplication. The crossover points are passed explicitly, as a
+//! `Thresholds`; `Integer` uses `thresholds`.
+
+const std = @import("std");
+
+pub const Thresholds = struct {
+    /// Size of the smaller operand, in limbs, from which Karatsuba is used.
+    /// At least 4, below that the recursion does not shrink.
+    karatsuba: usize = 32,
+    /// Size of the smaller operand, in limbs, from which Toom-3 is used.
+    toom3: usize = 160,
+    /// Size of the smaller operand, in limbs, from which the number theoretic
+    /// transform is used.
+    ntt: usize = 3072,
+    /// Size of the quotient, in limbs, from which division is recursive.
+    division: usize = 80,
+};
+
+/// Crossover points between the algorithms used by `Integer`, measured with
+/// `bench/integer.zig`.
+pub const thresholds: Thresholds = .{};
+
+/// Index of the most significant nonzero limb plus one.
+pub fn normalizedLen(a: []const u32) usize {
+    var n: usize = a.len;
+    while (n > 0 and a[n - 1] == 0) n -= 1;
+
+    return n;
+}
+
+/// Compares `a` and `b`, which may have different lengths and leading zeros.
+pub fn cmp(a: []const u32, b: []const u32) std.math.Order {
+    const n: usize = normalizedLen(a);
+    const m: usize = normalizedLen(b);
+    if (n != m)
+        return std.math.order(n, m);
+
+    var i: usize = n;
+    while (i > 0) {
+        i -= 1;
+        if (a[i] != b[i])
+            return std.math.order(a[i], b[i]);
+    }
+
+    return .eq;
+}
+
+/// `r = a + b` with `r.len == a.len >= b.len`, returning the carry out. `r`
+/// may be `a` or `b`.
+pub fn add(r: []u32, a: []const u32, b: []const u32) u32 {
+    var carry: u64 = 0;
+    for (0..b.len) |i| {
+        const s: u64 = @as(u64, a[i]) + b[i] + carry;
+        r[i] = @truncate(s);
+        carry = s >> 32;
+    }
+
+    for (b.len..a.len) |i| {
+        const s: u64 = @as(u64, a[i]) + carry;
+        r[i] = @truncate(s);
+        carry = s >> 32;
+    }
+
+    return @intCast(carry);
+}
+
+/// `r = a - b` with `r.len == a.len >= b.len`, returning the borrow out. `r`
+/// may be `a` or `b`.
+pub fn sub(r: []u32, a: []const u32, b: []const u32) u32 {
+    var borrow: u64 = 0;
+    for (0..b.len) |i| {
+        const d: u64 = @as(u64, a[i]) -% b[i] -% borrow;
+        r[i] = @truncate(d);
+        borrow = d >> 63;
+    }
+
+    for (b.len..a.len) |i| {
+        const d: u64 = @as(u64, a[i]) -% borrow;
+        r[i] = @truncate(d);
+        borrow = d >> 63;
+    }
+
+    return @intCast(borrow);
+}
+
+/// `r = b - r` with `r.len >= b.len`, `b` zero extended.
+fn subReverse(r: []u32, b: []const u32) void {
+    var borrow: u64 = 0;
+    for (r, 0..) |*x, i| {
+        const d: u64 = @as(u64, if (i < b.len) b[i] else 0) -% x.* -% borrow;
+        x.* = @truncate(d);
+        borrow = d >> 63;
+    }
+}
+
+/// Subtracts one from `a`, which must be nonzero.
+fn decrement(a: []u32) void {
+    for (a) |*x| {
+        x.* -%= 1;
+        if (x.* != std.math.maxInt(u32))
+            return;
+    }
+}
+
+/// `r[0..a.len] += a * m`, returning the carry limb.
+pub fn addMulLimb(r: []u32, a: []const u32, m: u32) u32 {
+    var carry: u64 = 0;
+    for (a, 0..) |x, i| {
+        const t: u64 = @as(u64, x) * m + r[i] + carry;
+        r[i] = @truncate(t);
+        carry = t >> 32;
+    }
+
+    return @intCast(carry);
+}
+
+/// `r[0..a.len] -= a * m`, returning the borrow limb.
+pub fn subMulLimb(r: []u32, a: []const u32, m: u32) u32 {
+    var carry: u64 = 0;
+    for (a, 0..) |x, i| {
+        const p: u64 = @as(u64, x) * m + carry;
+        const d = @subWithOverflow(r[i], @as(u32, @truncate(p)));
+        r[i] = d[0];
+        carry = (p >> 32) + d[1];
+    }
+
+    return @intCast(carry);
+}
+
+/// `r = a / d` with `r.len == a.len`, returning the remainder. `r` may be `a`.
+pub fn divLimb(r: []u32, a: []const u32, d: u32) u32 {
+    var rem: u64 = 0;
+    var i: usize = a.len;
+    while (i > 0) {
+        i -= 1;
+        const cur: u64 = (rem << 32) | a[i];
+        r[i] = @truncate(cur / d);
+        rem = cur % d;
+    }
+
+    return @intCast(rem);
+}
+
+/// Shifts `a` left by `s` bits in place, returning the bits shifted out.
+pub fn shl(a: []u32, s: u5) u32 {
+    if (s == 0)
+        return 0;
+
+    var carry: u32 = 0;
+    for (a) |*x| {
+        const out: u32 = x.* >> @intCast(32 - @as(u6, s));
+        x.* = (x.* << s) | carry;
+        carry = out;
+    }
+
+    return carry;
+}
+
+/// Shifts `a` right by `s` bits in place.
+pub fn shr(a: []u32, s: u5) void {
+    if (s == 0)
+        return;
+
+    var carry: u32 = 0;
+    var i: usize = a.len;
+    while (i > 0) {
+        i -= 1;
+        const out: u32 = a[i] << @intCast(32 - @as(u6, s));
+        a[i] = (a[i] >> s) | carry;
+        carry = out;
+    }
+}
+
+/// Copies `a` into `r`, zero extending it to `r.len`.
+fn copyPad(r: []u32, a: []const u32) void {
+    @memcpy(r[0..a.len], a);
+    @memset(r[a.len..], 0);
+}
+
+/// `r = ±r ± b` on magnitudes of width `r.len >= b.len`, returning the sign of
+/// the result (`true` for negative).
+fn addSigned(r: []u32, r_negative: bool, b: []const u32, b_negative: bool) bool {
+    if (r_negative == b_negative) {
+        _ = add(r, r, b);
+        return r_negative;
+    }
+
+    if (cmp(r, b) != .lt) {
+        _ = sub(r, r, b);
+        return r_negative and normalizedLen(r) != 0;
+    }
+
+    subReverse(r, b);
+    return b_negative;
+}
+
+// Multiplication
+
+/// `r = a * b` with `r.len == a.len + b.len`, using the algorithms selected by
+/// `t`. `r` must not overlap `a` or `b`.
+pub fn mul(allocator: std.mem.Allocator, r: []u32, a: []const u32, b: []const u32, t: Thresholds) !void {
+    const x: []const u32, const y: []const u32 = ordered(a, b);
+
+    if (y.len == 0) {
+        @memset(r, 0);
+        return;
+    }
+
+    if (y.len < t.karatsuba)
+        return mulBasecase(r, x, y);
+
+    if (y.len >= t.ntt)
+        return mulNtt(allocator, r, x, y);
+
+    const buffer: []u32 = try allocator.alloc(u32, scratchLen(x.len, y.len, t));
+    defer allocator.free(buffer);
+
+    var scratch: Scratch = .{ .buffer = buffer, .thresholds = t };
+    mulRec(r, x, y, &scratch);
+}
+
+/// Schoolbook multiplication, `r.len == a.len + b.len`.
+pub fn mulBasecase(r: []u32, a: []const u32, b: []const u32) void {
+    @memset(r[0..a.len], 0);
+    for (b, 0..) |m, j|
+        r[a.len + j] = addMulLimb(r[j..], a, m);
+}
+
+/// Bump allocator for the temporaries of the recursive multiplications,
+/// sized up front by `scratchLen`, along with the thresholds they use.
+const Scratch = struct {
+    buffer: []u32,
+    used: usize = 0,
+    thresholds: Thresholds,
+
+    fn take(self: *Scratch, n: usize) []u32 {
+        const result: []u32 = self.buffer[self.used..][0..n];
+        self.used += n;
+        return result;
+    }
+};
+
+fn ordered(a: []const u32, b: []const u32) struct { []const u32, []const u32 } {
+    return if (a.len >= b.len) .{ a, b } else .{ b, a };
+}
+
+/// Scratch used by `mulRec` for operands of `n >= m` limbs. Mirrors its
+/// dispatch.
+fn scratchLen(n: usize, m: usize, t: Thresholds) usize {
+    if (m < t.karatsuba)
+        return 0;
+
+    if (m <= (n + 1) / 2) {
+        const last: usize = n - (n - 1) / m * m;
+        return 2 * m + @max(scratchLen(m, m, t), scratchLen(m, last, t));
+    }
+
+    if (m >= t.toom3) {
+        const k: usize = (n + 2) / 3;
+        if (m > 2 * k) {
+            return @max(
+                scratchLen(k, k, t),
+                scratchLen(@max(n - 2 * k, m - 2 * k), @min(n - 2 * k, m - 2 * k), t),
+                6 * (k + 1) + 5 * (2 * k + 2) + scratchLen(k + 1, k + 1, t),
+            );
+        }
+    }
+
+    const h: usize = (n + 1) / 2;
+    return @max(
+        scratchLen(h, h, t),
+        scratchLen(@max(n - h, m - h), @min(n - h, m - h), t),
+        4 * h + 4 + scratchLen(h + 1, h + 1, t),
+    );
+}
+
+/// `r = x * y` with `x.len >= y.len`.
+fn mulRec(r: []u32, x: []const u32, y: []const u32, scratch: *Scratch) void {
+    if (y.len < scratch.thresholds.karatsuba)
+        return mulBasecase(r, x, y);
+
+    if (y.len <= (x.len + 1) / 2)
+        return mulUnbalanced(r, x, y, scratch);
+
+    if (y.len >= scratch.thresholds.toom3 and y.len > 2 * ((x.len + 2) / 3))
+        return mulToom3(r, x, y, scratch);
+
+    mulKaratsuba(r, x, y, scratch);
+}
+
+/// Cuts `x` into blocks of `y.len` limbs and accumulates their products.
+fn mulUnbalanced(r: []u32, x: []const u32, y: []const u32, scratch: *Scratch) void {
+    const mark: usize = scratch.used;
+    defer scratch.used = mark;
+
+    const product: []u32 = scratch.take(2 * y.len);
+
+    @memset(r, 0);
+    var i: usize = 0;
+    while (i < x.len) : (i += y.len) {
+        const block: []const u32 = x[i..@min(i + y.len, x.len)];
+        const p: []u32 = product[0 .. block.len + y.len];
+        const u: []const u32, const v: []const u32 = ordered(block, y);
+        mulRec(p, u, v, scratch);
+        _ = add(r[i..], r[i..], p);
+    }
+}
+
+fn mulKaratsuba(r: []u32, x: []const u32, y: []const u32, scratch: *Scratch) void {
+    const n: usize = x.len;
+    const m: usize = y.len;
+    const h: usize = (n + 1) / 2;
+
+    const x0: []const u32 = x[0..h];
+    const x1: []const u32 = x[h..];
+    const y0: []const u32 = y[0..h];
+    const y1: []const u32 = y[h..];
+
+    // z0 and z2 go straight to their place in r.
+    mulRec(r[0 .. 2 * h], x0, y0, scratch);
+    const u: []const u32, const v: []const u32 = ordered(x1, y1);
+    mulRec(r[2 * h ..], u, v, scratch);
+
+    const mark: usize = scratch.used;
+    defer scratch.used = mark;
+
+    const sx: []u32 = scratch.take(h + 1);
+    sx[h] = add(sx[0..h], x0, x1);
+    const sy: []u32 = scratch.take(h + 1);
+    sy[h] = add(sy[0..h], y0, y1);
+
+    // z1 = (x0 + x1)(y0 + y1) - z0 - z2
+    const z: []u32 = scratch.take(2 * h + 2);
+    mulRec(z, sx, sy, scratch);
+    _ = sub(z, z, r[0 .. 2 * h]);
+    _ = sub(z, z, r[2 * h ..]);
+
+    _ = add(r[h..], r[h..], z[0..@min(z.len, r.len - h)]);
+}
+
+/// Toom-3 with evaluation points 0, 1, -1, -2 and infinity, and Bodrato's
+/// interpolation sequence.
+fn mulToom3(r: []u32, x: []const u32, y: []const u32, scratch: *Scratch) void {
+    const n: usize = x.len;
+    const m: usize = y.len;
+    const k: usize = (n + 2) / 3;
+    const w: usize = 2 * k + 2;
+
+    mulRec(r[0 .. 2 * k], x[0..k], y[0..k], scratch);
+    const u: []const u32, const v: []const u32 = ordered(x[2 * k ..], y[2 * k ..]);
+    mulRec(r[4 * k ..], u, v, scratch);
+    @memset(r[2 * k .. 4 * k], 0);
+
+    const mark: usize = scratch.used;
+    defer scratch.used = mark;
+
+    const a1: []u32 = scratch.take(k + 1);
+    const am1: []u32 = scratch.take(k + 1);
+    const am2: []u32 = scratch.take(k + 1);
+    const b1: []u32 = scratch.take(k + 1);
+    const bm1: []u32 = scratch.take(k + 1);
+    const bm2: []u32 = scratch.take(k + 1);
+    const am1_negative: bool, const am2_negative: bool = evaluate(x[0..k], x[k .. 2 * k], x[2 * k .. n], a1, am1, am2);
+    const bm1_negative: bool, const bm2_negative: bool = evaluate(y[0..k], y[k .. 2 * k], y[2 * k .. m], b1, bm1, bm2);
+
+    const v1: []u32 = scratch.take(w);
+    const vm1: []u32 = scratch.take(w);
+    const vm2: []u32 = scratch.take(w);
+    const c0: []u32 = scratch.take(w);
+    const c4: []u32 = scratch.take(w);
+
+    mulRec(v1, a1, b1, scratch);
+    mulRec(vm1, am1, bm1, scratch);
+    mulRec(vm2, am2, bm2, scratch);
+    var v1_negative: bool = false;
+    var vm1_negative: bool = am1_negative != bm1_negative;
+    var vm2_negative: bool = am2_negative != bm2_negative;
+    copyPad(c0, r[0 .. 2 * k]);
+    copyPad(c4, r[4 * k ..]);
+
+    // r3 = (r(-2) - r(1)) / 3
+    vm2_negative = addSigned(vm2, vm2_negative, v1, true);
+    _ = divLimb(vm2, vm2, 3);
+    // r1 = (r(1) - r(-1)) / 2
+    v1_negative = addSigned(v1, v1_negative, vm1, !vm1_negative);
+    shr(v1, 1);
+    // r2 = r(-1) - r(0)
+    vm1_negative = addSigned(vm1, vm1_negative, c0, true);
+    // r3 = (r2 - r3) / 2 + 2 r(inf)
+    vm2_negative = addSigned(vm2, !vm2_negative, vm1, vm1_negative);
+    shr(vm2, 1);
+    copyPad(c0, c4);
+    _ = shl(c0, 1);
+    vm2_negative = addSigned(vm2, vm2_negative, c0, false);
+    // r2 = r2 + r1 - r(inf)
+    vm1_negative = addSigned(vm1, vm1_negative, v1, v1_negative);
+    vm1_negative = addSigned(vm1, vm1_negative, c4, true);
+    // r1 = r1 - r3
+    v1_negative = addSigned(v1, v1_negative, vm2, !vm2_negative);
+
+    std.debug.assert(!v1_negative and !vm1_negative and !vm2_negative);
+
+    _ = add(r[k..], r[k..], v1[0..@min(w, r.len - k)]);
+    _ = add(r[2 * k ..], r[2 * k ..], vm1[0..@min(w, r.len - 2 * k)]);
+    _ = add(r[3 * k ..], r[3 * k ..], vm2[0..@min(w, r.len - 3 * k)]);
+}
+
+/// Evaluates `p0 + p1 t + p2 t^2` at 1, -1 and -2 into `e1`, `em1` and `em2`
+/// (`k + 1` limbs each), returning the signs of the last two.
+fn evaluate(p0: []const u32, p1: []const u32, p2: []const u32, e1: []u32, em1: []u32, em2: []u32) struct { bool, bool } {
+    copyPad(e1, p0);
+    _ = add(e1, e1, p2);
+
+    @memcpy(em1, e1);
+    const em1_negative: bool = addSigned(em1, false, p1, true);
+    _ = add(e1, e1, p1);
+
+    // (2 p2 - p1) 2 + p0
+    copyPad(em2, p2);
+    _ = shl(em2, 1);
+    var em2_negative: bool = addSigned(em2, false, p1, true);
+    _ = shl(em2, 1);
+    em2_negative = addSigned(em2, em2_negative, p0, false);
+
+    return .{ em1_negative, em2_negative };
+}
+
+// Number theoretic transform over the prime 2^64 - 2^32 + 1. The operands
+// are cut into 16-bit digits so that the convolution of up to 2^32 digits
+// stays below the prime.
+
+const prime: u64 = 0xffffffff00000001;
+const epsilon: u64 = 0xffffffff; // 2^64 mod prime
+const generator: u64 = 7;
+
+fn reduce(x: u128) u64 {
+    const lo: u64 = @truncate(x);
+    const hi: u64 = @truncate(x >> 64);
+
+    // 2^96 = -1 and 2^64 = 2^32 - 1
+    var t = @subWithOverflow(lo, hi >> 32);
+    if (t[1] != 0)
+        t[0] -%= epsilon;
+
+    const s = @addWithOverflow(t[0], (hi & 0xffffffff) * epsilon);
+    var result: u64 = s[0] +% epsilon * s[1];
+    if (result >= prime)
+        result -= prime;
+
+    return result;
+}
+
+fn addMod(a: u64, b: u64) u64 {
+    const s = @addWithOverflow(a, b);
+    return if (s[1] != 0 or s[0] >= prime) s[0] -% prime else s[0];
+}
+
+fn subMod(a: u64, b: u64) u64 {
+    const d = @subWithOverflow(a, b);
+    return if (d[1] != 0) d[0] -% epsilon else d[0];
+}
+
+fn mulMod(a: u64, b: u64) u64 {
+    return reduce(@as(u128, a) * b);
+}
+
+fn powMod(base: u64, exponent: u64) u64 {
+    var result: u64 = 1;
+    var b: u64 = base;
+    var e: u64 = exponent;
+    while (e != 0) : (e >>= 1) {
+        if (e & 1 != 0)
+            result = mulMod(result, b);
+
+        b = mulMod(b, b);
+    }
+
+    return result;
+}
+
+/// In-place radix-2 transform of `a`, whose length is a power of two.
+fn ntt(a: []u64, inverse: bool) void {
+    const n: usize = a.len;
+
+    var j: usize = 0;
+    for (1..n) |i| {
+        var bit: usize = n >> 1;
+        while (j & bit != 0) : (bit >>= 1)
+            j ^= bit;
+
+        j ^= bit;
+        if (i < j)
+            std.mem.swap(u64, &a[i], &a[j]);
+    }
+
+    var len: usize = 2;
+    while (len <= n) : (len <<= 1) {
+        var root: u64 = powMod(generator, (prime - 1) / len);
+        if (inverse)
+            root = powMod(root, prime - 2);
+
+        const half: usize = len / 2;
+        var i: usize = 0;
+        while (i < n) : (i += len) {
+            var twiddle: u64 = 1;
+            for (0..half) |l| {
+                const u: u64 = a[i + l];
+                const v: u64 = mulMod(a[i + l + half], twiddle);
+                a[i + l] = addMod(u, v);
+                a[i + l + half] = subMod(u, v);
+                twiddle = mulMod(twiddle, root);
+            }
+        }
+    }
+
+    if (inverse) {
+        const scale: u64 = powMod(n, prime - 2);
+        for (a) |*x|
+            x.* = mulMod(x.*, scale);
+    }
+}
+
+/// Multiplication through the number theoretic transform,
+/// `r.len == a.len + b.len`.
+pub fn mulNtt(allocator: std.mem.Allocator, r: []u32, a: []const u32, b: []const u32) !void {
+    const n: usize = std.math.ceilPowerOfTwoAssert(usize, 2 * (a.len + b.len));
+    std.debug.assert(n <= 1 << 32);
+
+    const fa: []u64 = try allocator.alloc(u64, n);
+    defer allocator.free(fa);
+    const fb: []u64 = try allocator.alloc(u64, n);
+    defer allocator.free(fb);
+
+    for ([_][]u64{ fa, fb }, [_][]const u32{ a, b }) |f, limbs| {
+        for (limbs, 0..) |limb, i| {
+            f[2 * i] = limb & 0xffff;
+            f[2 * i + 1] = limb >> 16;
+        }
+
+        @memset(f[2 * limbs.len ..], 0);
+        ntt(f, false);
+    }
+
+    for (fa, fb) |*x, y|
+        x.* = mulMod(x.*, y);
+
+    ntt(fa, true);
+
+    var carry: u128 = 0;
+    for (r, 0..) |*limb, i| {
+        carry += fa[2 * i];
+        const lo: u32 = @truncate(carry & 0xffff);
+        carry >>= 16;
+        carry += fa[2 * i + 1];
+        const hi: u32 = @truncate(carry & 0xffff);
+        carry >>= 16;
+        limb.* = lo | (hi << 16);
+    }
+}
+
+// Division
+
+/// Limbs of temporaries `divRem` keeps on the stack before falling back to
+/// the allocator.
+const small_division: usize = 64;
+
+/// `q = a / b` and `r = a mod b` with `a.len >= b.len`, `q.len == a.len -
+/// b.len + 1`, `r.len == b.len` and a nonzero most significant limb in `b`,
+/// using the algorithms selected by `t`. `q` and `r` must not overlap `a` or
+/// `b`.
+pub fn divRem(allocator: std.mem.Allocator, q: []u32, r: ?[]u32, a: []const u32, b: []const u32, t: Thresholds) !void {
+    const n: usize = b.len;
+
+    if (n == 1) {
+        const rem: u32 = divLimb(q, a, b[0]);
+        if (r) |rr|
+            rr[0] = rem;
+
+        return;
+    }
+
+    // Operands of a few limbs are divided on the stack.
+    var stack = std.heap.stackFallback(small_division * @sizeOf(u32), allocator);
+    const temporaries: std.mem.Allocator = stack.get();
+
+    // Normalize so that the top bit of the divisor is set.
+    const s: u5 = @intCast(@clz(b[n - 1]));
+
+    const v: []u32 = try temporaries.alloc(u32, n);
+    defer temporaries.free(v);
+    @memcpy(v, b);
+    _ = shl(v, s);
+
+    const u: []u32 = try temporaries.alloc(u32, a.len + 1);
+    defer temporaries.free(u);
+    @memcpy(u[0..a.len], a);
+    u[a.len] = shl(u[0..a.len], s);
+
+    // The top limb of u is below the one of v, so the quotient has q.len limbs.
+    const quotient: []u32 = try temporaries.alloc(u32, q.len + 1);
+    defer temporaries.free(quotient);
+    try divUnbalanced(temporaries, quotient, u, v, t);
+    @memcpy(q, quotient[0..q.len]);
+
+    if (r) |rr| {
+        shr(u[0..n], s);
+        @memcpy(rr, u[0..n]);
+    }
+}
+
+/// `q = u / v` for a normalized `v`, leaving the remainder in `u[0..v.len]`.
+/// `q.len == u.len - v.len + 1`.
+fn divUnbalanced(allocator: std.mem.Allocator, q: []u32, u: []u32, v: []const u32, t: Thresholds) !void {
+    const n: usize = v.len;
+    var m: usize = u.len - n;
+
+    @memset(q, 0);
+    if (m <= n)
+        return divRec(allocator, q, u, v, t);
+
+    // Quotient blocks of n limbs from the top, each a 2n by n division.
+    const block: []u32 = try allocator.alloc(u32, n + 1);
+    defer allocator.free(block);
+
+    while (m > n) {
+        const start: usize = m - n;
+        try divRec(allocator, block, u[start .. m + n], v, t);
+        _ = add(q[start..], q[start..], block);
+        m = start;
+    }
+
+    try divRec(allocator, block[0 .. m + 1], u[0 .. m + n], v, t);
+    _ = add(q, q, block[0 .. m + 1]);
+}
+
+/// `q = u / v` for a normalized `v` and `u.len - v.len <= v.len`, leaving the
+/// remainder in `u[0..v.len]` and zeros above. `q.len == u.len - v.len + 1`.
+fn divRec(allocator: std.mem.Allocator, q: []u32, u: []u32, v: []const u32, t: Thresholds) !void {
+    const n: usize = v.len;
+    const m: usize = u.len - n;
+
+    if (m < @max(t.division, 3))
+        return divBasecase(q, u, v);
+
+    const k: usize = m / 2;
+    const v1: []const u32 = v[k..];
+    const v0: []const u32 = v[0..k];
+
+    const buffer: []u32 = try allocator.alloc(u32, (m + 1) + (k + 1));
+    defer allocator.free(buffer);
+    const product: []u32 = buffer[0 .. m + 1];
+    const q0: []u32 = buffer[m + 1 ..];
+
+    // High half of the quotient from the top limbs against the top of v.
+    @memset(q[0..k], 0);
+    try divRec(allocator, q[k..], u[2 * k ..], v1, t);
+
+    // u[k..n + k] holds the partial remainder; take q1 v0 off it, with at
+    // most two corrections.
+    try mul(allocator, product, q[k..], v0, t);
+    const high: []u32 = u[k .. n + k + 1];
+    while (cmp(high, product) == .lt) {
+        decrement(q[k..]);
+        _ = add(high, high, v);
+    }
+
+    _ = sub(high, high, product);
+
+    // Low half the same way.
+    try divRec(allocator, q0, u[k .. n + k], v1, t);
+    _ = add(q, q, q0);
+
+    try mul(allocator, product[0 .. 2 * k + 1], q0, v0, t);
+    const low: []u32 = u[0 .. n + 1];
+    while (cmp(low, product[0 .. 2 * k + 1]) == .lt) {
+        decrement(q);
+        _ = add(low, low, v);
+    }
+
+    _ = sub(low, low, product[0 .. 2 * k + 1]);
+}
+
+/// Knuth's algorithm D, `q.len == u.len - v.len + 1`.
+fn divBasecase(q: []u32, u: []u32, v: []const u32) void {
+    const n: usize = v.len;
+    const m: usize = u.len - n;
+
+    std.debug.assert(n >= 2);
+
+    q[m] = 0;
+    if (cmp(u[m..], v) != .lt) {
+        _ = sub(u[m..], u[m..], v);
+        q[m] = 1;
+    }
+
+    var j: usize = m;
+    while (j > 0) {
+        j -= 1;
+
+        var qhat: u32 = estimateQhat(u[j + n], u[j + n - 1], u[j + n - 2], v[n - 1], v[n - 2]);
+        const borrow: u32 = subMulLimb(u[j .. j + n], v, qhat);
+        const top = @subWithOverflow(u[j + n], borrow);
+        u[j + n] = top[0];
+        if (top[1] != 0) {
+            qhat -= 1;
+            u[j + n] +%= add(u[j .. j + n], u[j .. j + n], v);
+        }
+
+        q[j] = qhat;
+    }
+}
+
+fn estimateQhat(u_high: u32, u_next: u32, u_next2: u32, v_high: u32, v_next: u32) u32 {
+    const b: u64 = 1 << 32;
+    const num: u64 = (@as(u64, u_high) << 32) | u_next;
+    var qhat: u64 = num / v_high;
+    var rhat: u64 = num % v_high;
+
+    while (qhat >= b or qhat * v_next > (rhat << 32) + u_next2) {
+        qhat -= 1;
+        rhat += v_high;
+        if (rhat >= b)
+            break;
+    }
+
+    return @intCast(qhat);
+}
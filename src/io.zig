@@ -0,0 +1,62 @@
+//! Namespace for reading and writing arrays and matrices.
+//!
+//! * `npy`: NumPy `.npy` files for dense arrays and general dense matrices.
+//! * `csr`: a binary format for general sparse matrices, in their compressed
+//!   row (or column) form.
+//! * `matrix_market`: streaming reader for Matrix Market coordinate files.
+//!
+//! The binary formats keep their data aligned so that `npy.map` and `csr.map`
+//! can expose a file as a non-owning array or matrix without copying or
+//! parsing it.
+
+const std = @import("std");
+
+pub const npy = @import("io/npy.zig");
+pub const csr = @import("io/csr.zig");
+pub const matrix_market = @import("io/matrix_market.zig");
+
+/// A file mapped into memory, and the non-owning array or matrix of type `D`
+/// viewing it.
+///
+/// The mapping is private: the elements can be modified in place, but the
+/// changes are never written back to the file.
+pub fn Mapped(comptime D: type) type {
+    return struct {
+        /// View of the data in the mapping; its `owns_data` flag is false.
+        value: D,
+        memory: []align(std.heap.page_size_min) u8,
+
+        /// Unmaps the file, invalidating `value`.
+        pub fn unmap(self: *Mapped(D)) void {
+            std.posix.munmap(self.memory);
+            self.* = undefined;
+        }
+    };
+}
+
+/// Maps the whole of `file` into memory, privately and writable.
+pub fn mapFile(file: std.fs.File) ![]align(std.heap.page_size_min) u8 {
+    const size: u64 = (try file.stat()).size;
+    if (size == 0)
+        return Error.InvalidFormat;
+
+    return std.posix.mmap(
+        null,
+        std.math.cast(usize, size) orelse return Error.FileTooLarge,
+        std.posix.PROT.READ | std.posix.PROT.WRITE,
+        .{ .TYPE = .PRIVATE },
+        file.handle,
+        0,
+    );
+}
+
+pub const Error = error{
+    InvalidFormat,
+    UnsupportedFormat,
+    TypeMismatch,
+    LayoutMismatch,
+    DimensionMismatch,
+    NotContiguous,
+    Misaligned,
+    FileTooLarge,
+};
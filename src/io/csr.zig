@@ -0,0 +1,282 @@
+//! A binary format for general sparse matrices (`matrix.general.Sparse`),
+//! storing their compressed arrays as they are in memory: CSR for row major
+//! matrices and CSC for column major ones.
+//!
+//! A file is a 64 byte header followed by `ptr`, `idx` and `data`, each
+//! starting at a multiple of 64 bytes:
+//!
+//! | Offset | Size | Field                                                   |
+//! |--------|------|---------------------------------------------------------|
+//! | 0      | 6    | `"\x93ZMLSP"`                                           |
+//! | 6      | 1    | Version, 1.                                             |
+//! | 7      | 1    | Layout: 0 if row major (CSR), 1 if column major (CSC).  |
+//! | 8      | 8    | NumPy type string of the elements, padded with spaces.  |
+//! | 16     | 12   | `rows`, `cols` and `nnz`, as little-endian `u32`s.      |
+//! | 28     | 36   | Reserved, zero.                                         |
+//!
+//! `read` streams the arrays into the matrix, in chunks, and `map` views them
+//! in a mapping of the file without copying them.
+
+const std = @import("std");
+
+const types = @import("../types.zig");
+
+const io = @import("../io.zig");
+const npy = @import("npy.zig");
+
+const magic = "\x93ZMLSP";
+const version: u8 = 1;
+
+/// Alignment of each array in the file.
+pub const alignment: usize = 64;
+
+pub const Header = extern struct {
+    magic: [6]u8,
+    version: u8,
+    layout: u8,
+    descr: [8]u8,
+    rows: u32,
+    cols: u32,
+    nnz: u32,
+    reserved: [36]u8 = .{0} ** 36,
+
+    comptime {
+        if (@sizeOf(Header) != alignment)
+            @compileError("zml.io.csr.Header must be 64 bytes");
+    }
+
+    fn init(comptime M: type, m: *const M) Header {
+        var header: Header = .{
+            .magic = magic.*,
+            .version = version,
+            .layout = if (comptime M.storage_layout == .row_major) 0 else 1,
+            .descr = .{' '} ** 8,
+            .rows = m.rows,
+            .cols = m.cols,
+            .nnz = m.nnz,
+        };
+        const string: []const u8 = comptime npy.descr(types.Numeric(M));
+        @memcpy(header.descr[0..string.len], string);
+
+        return header;
+    }
+
+    /// Checks that the header describes a matrix of type `M`.
+    fn check(self: *const Header, comptime M: type) !void {
+        if (!std.mem.eql(u8, &self.magic, magic))
+            return io.Error.InvalidFormat;
+
+        if (self.version != version)
+            return io.Error.UnsupportedFormat;
+
+        if (self.layout != @as(u8, if (comptime M.storage_layout == .row_major) 0 else 1))
+            return io.Error.LayoutMismatch;
+
+        if (!npy.matches(types.Numeric(M), std.mem.trimRight(u8, &self.descr, " ")))
+            return io.Error.TypeMismatch;
+    }
+
+    /// Length of the major dimension: rows for CSR, columns for CSC.
+    fn major(self: *const Header) u32 {
+        return if (self.layout == 0) self.rows else self.cols;
+    }
+
+    /// Length of `ptr`, one more than the major dimension, which may be
+    /// `maxInt(u32)`.
+    fn ptrLen(self: *const Header) usize {
+        return @as(usize, self.major()) + 1;
+    }
+
+    /// Offsets of `ptr`, `idx` and `data`, and the size of the file.
+    fn offsets(self: *const Header, comptime T: type) [4]u64 {
+        const ptr: u64 = alignment;
+        const idx: u64 = std.mem.alignForward(u64, ptr + @as(u64, self.ptrLen()) * @sizeOf(u32), alignment);
+        const data: u64 = std.mem.alignForward(u64, idx + @as(u64, self.nnz) * @sizeOf(u32), alignment);
+
+        return .{ ptr, idx, data, data + @as(u64, self.nnz) * @sizeOf(T) };
+    }
+};
+
+fn requireSparse(comptime M: type) void {
+    if (!types.isGeneralSparseMatrix(M))
+        @compileError("zml.io.csr requires a matrix.general.Sparse, got " ++ @typeName(M));
+}
+
+/// Checks that `ptr` and `idx` form a valid compressed structure, with the
+/// indices of each line sorted and distinct, so that a corrupt file can not
+/// produce out of bounds accesses or a matrix the kernels misread.
+fn validate(header: *const Header, ptr: []const u32, idx: []const u32) !void {
+    const minor: u32 = if (header.layout == 0) header.cols else header.rows;
+
+    if (ptr[0] != 0 or ptr[ptr.len - 1] != header.nnz)
+        return io.Error.InvalidFormat;
+
+    for (ptr[0 .. ptr.len - 1], ptr[1..]) |start, end| {
+        if (start > end or end > idx.len)
+            return io.Error.InvalidFormat;
+
+        const line: []const u32 = idx[start..end];
+        for (line, 0..) |i, k| {
+            if (i >= minor or (k > 0 and line[k - 1] >= i))
+                return io.Error.InvalidFormat;
+        }
+    }
+}
+
+/// Reads `len` elements of type `E` in chunks, growing the result as they
+/// arrive, so that a corrupt length runs into the end of the data instead of
+/// allocating it up front.
+fn readArray(comptime E: type, allocator: std.mem.Allocator, reader: *std.Io.Reader, len: usize) ![]E {
+    const chunk: usize = @max(1, (1 << 16) / @sizeOf(E));
+
+    var result: std.ArrayList(E) = .empty;
+    errdefer result.deinit(allocator);
+
+    while (result.items.len < len) {
+        const slice: []E = try result.addManyAsSlice(allocator, @min(chunk, len - result.items.len));
+        try reader.readSliceAll(std.mem.sliceAsBytes(slice));
+    }
+
+    return result.toOwnedSlice(allocator);
+}
+
+/// Writes `m`, a general sparse matrix.
+///
+/// ## Arguments
+/// * `writer` (`*std.Io.Writer`): The writer to write the file to.
+/// * `m` (`anytype`): The matrix to write.
+///
+/// ## Errors
+/// * `std.Io.Writer.Error.WriteFailed`: If writing fails.
+pub fn write(writer: *std.Io.Writer, m: anytype) !void {
+    const M: type = @TypeOf(m);
+    comptime requireSparse(M);
+
+    const header: Header = .init(M, &m);
+    const offsets: [4]u64 = header.offsets(types.Numeric(M));
+
+    try writer.writeAll(std.mem.asBytes(&header));
+    try writer.writeAll(std.mem.sliceAsBytes(m.ptr[0..header.ptrLen()]));
+    try writer.splatByteAll(0, offsets[1] - (offsets[0] + @as(u64, header.ptrLen()) * @sizeOf(u32)));
+    try writer.writeAll(std.mem.sliceAsBytes(m.idx[0..m.nnz]));
+    try writer.splatByteAll(0, offsets[2] - (offsets[1] + @as(u64, m.nnz) * @sizeOf(u32)));
+    try writer.writeAll(std.mem.sliceAsBytes(m.data[0..m.nnz]));
+}
+
+/// Reads a matrix of type `M`, a general sparse matrix, reading each array
+/// directly into its final storage.
+///
+/// ## Arguments
+/// * `allocator` (`std.mem.Allocator`): The allocator to use for the arrays.
+/// * `M` (`type`): The matrix type to read.
+/// * `reader` (`*std.Io.Reader`): The reader positioned at the start of the
+///   file.
+///
+/// ## Returns
+/// `M`: The matrix read, owning its arrays.
+///
+/// ## Errors
+/// * `std.mem.Allocator.Error.OutOfMemory`: If memory allocation fails.
+/// * `std.Io.Reader.Error`: If reading fails or the file is truncated.
+/// * `io.Error.InvalidFormat`: If the file is not a valid sparse matrix file,
+///   including indices out of range, unsorted or repeated within a line, and
+///   `bool` values other than 0 or 1.
+/// * `io.Error.TypeMismatch`: If the elements are not of the type of `M`.
+/// * `io.Error.LayoutMismatch`: If the file is CSC and `M` row major, or vice
+///   versa.
+pub fn read(allocator: std.mem.Allocator, comptime M: type, reader: *std.Io.Reader) !M {
+    comptime requireSparse(M);
+    const T: type = types.Numeric(M);
+
+    var header: Header = undefined;
+    try reader.readSliceAll(std.mem.asBytes(&header));
+    try header.check(M);
+
+    const offsets: [4]u64 = header.offsets(T);
+
+    // The sizes in the header are not trusted until the arrays have been
+    // read: they grow as the data arrives.
+    const ptr: []u32 = try readArray(u32, allocator, reader, header.ptrLen());
+    errdefer allocator.free(ptr);
+
+    if (ptr[0] != 0 or ptr[ptr.len - 1] != header.nnz)
+        return io.Error.InvalidFormat;
+
+    try reader.discardAll64(offsets[1] - (offsets[0] + ptr.len * @sizeOf(u32)));
+    const idx: []u32 = try readArray(u32, allocator, reader, header.nnz);
+    errdefer allocator.free(idx);
+
+    try reader.discardAll64(offsets[2] - (offsets[1] + idx.len * @sizeOf(u32)));
+    const data: []T = try readArray(T, allocator, reader, header.nnz);
+    errdefer allocator.free(data);
+
+    try validate(&header, ptr, idx);
+    try npy.checkData(T, std.mem.sliceAsBytes(data));
+
+    return .{
+        .data = data.ptr,
+        .idx = idx.ptr,
+        .ptr = ptr.ptr,
+        .nnz = header.nnz,
+        .rows = header.rows,
+        .cols = header.cols,
+        .flags = .{ .owns_data = true },
+    };
+}
+
+/// Maps a sparse matrix file into memory and returns an `M`, a general sparse
+/// matrix, viewing its arrays, without copying them.
+///
+/// ## Arguments
+/// * `M` (`type`): The matrix type to map.
+/// * `file` (`std.fs.File`): The file to map. It can be closed once mapped.
+///
+/// ## Returns
+/// `io.Mapped(M)`: The mapping, with the view in its `value` field. Unmap it
+/// with `unmap` once done.
+///
+/// ## Errors
+/// * `std.posix.MMapError`: If mapping fails.
+/// * `io.Error.InvalidFormat`: If the file is not a valid sparse matrix file,
+///   including indices out of range, unsorted or repeated within a line, and
+///   `bool` values other than 0 or 1, or is truncated.
+/// * `io.Error.TypeMismatch`: If the elements are not of the type of `M`.
+/// * `io.Error.LayoutMismatch`: If the file is CSC and `M` row major, or vice
+///   versa.
+pub fn map(comptime M: type, file: std.fs.File) !io.Mapped(M) {
+    comptime requireSparse(M);
+    const T: type = types.Numeric(M);
+
+    const memory: []align(std.heap.page_size_min) u8 = try io.mapFile(file);
+    errdefer std.posix.munmap(memory);
+
+    if (memory.len < @sizeOf(Header))
+        return io.Error.InvalidFormat;
+
+    const header: *const Header = @ptrCast(memory.ptr);
+    try header.check(M);
+
+    const offsets: [4]u64 = header.offsets(T);
+    if (memory.len < offsets[3])
+        return io.Error.InvalidFormat;
+
+    const ptr: [*]u32 = @ptrCast(@alignCast(memory.ptr + offsets[0]));
+    const idx: [*]u32 = @ptrCast(@alignCast(memory.ptr + offsets[1]));
+    const data: [*]T = @ptrCast(@alignCast(memory.ptr + offsets[2]));
+
+    try validate(header, ptr[0..header.ptrLen()], idx[0..header.nnz]);
+    try npy.checkData(T, memory[@intCast(offsets[2])..@intCast(offsets[3])]);
+
+    return .{
+        .value = .{
+            .data = data,
+            .idx = idx,
+            .ptr = ptr,
+            .nnz = header.nnz,
+            .rows = header.rows,
+            .cols = header.cols,
+            .flags = .{ .owns_data = false },
+        },
+        .memory = memory,
+    };
+}
@@ -0,0 +1,355 @@
+//! Streaming reader for Matrix Market coordinate files
+//! (`%%MatrixMarket matrix coordinate ...`) into general sparse matrices
+//! (`matrix.general.Sparse`).
+//!
+//! The file is read twice: the first pass counts the entries of each row (or
+//! column, for column major matrices) and the second one writes every entry
+//! directly into its final place in `data` and `idx`. Memory is bounded by the
+//! matrix itself, with no intermediate list of triplets and no per-entry
+//! builder calls. Symmetric, skew-symmetric and hermitian files are expanded
+//! to the full matrix, and duplicate entries are summed.
+
+const std = @import("std");
+
+const types = @import("../types.zig");
+
+const io = @import("../io.zig");
+
+const Field = enum { real, integer, complex, pattern };
+const Symmetry = enum { general, symmetric, @"skew-symmetric", hermitian };
+
+const Banner = struct {
+    field: Field,
+    symmetry: Symmetry,
+    rows: u32,
+    cols: u32,
+    entries: u64,
+};
+
+/// Reads the next line that is neither blank nor a comment, without its line
+/// ending, or `null` at the end of the file.
+fn nextLine(reader: *std.Io.Reader) !?[]const u8 {
+    while (true) {
+        const line: []const u8 = reader.takeDelimiterInclusive('\n') catch |err| switch (err) {
+            error.EndOfStream => last: {
+                // Last line, without a line ending.
+                const rest: []const u8 = reader.buffered();
+                if (rest.len == 0)
+                    return null;
+
+                reader.toss(rest.len);
+                break :last rest;
+            },
+            else => |e| return e,
+        };
+
+        const trimmed: []const u8 = std.mem.trim(u8, line, " \t\r\n");
+        if (trimmed.len != 0 and trimmed[0] != '%')
+            return trimmed;
+    }
+}
+
+/// Reads the banner and the size line.
+fn readBanner(reader: *std.Io.Reader) !Banner {
+    const line: []const u8 = reader.takeDelimiterInclusive('\n') catch |err| switch (err) {
+        error.EndOfStream => return io.Error.InvalidFormat,
+        else => |e| return e,
+    };
+
+    var words = std.mem.tokenizeAny(u8, line, " \t\r\n");
+    if (!std.ascii.eqlIgnoreCase(words.next() orelse "", "%%MatrixMarket") or
+        !std.ascii.eqlIgnoreCase(words.next() orelse "", "matrix"))
+        return io.Error.InvalidFormat;
+
+    // Only the coordinate format is sparse; `array` files are dense.
+    if (!std.ascii.eqlIgnoreCase(words.next() orelse "", "coordinate"))
+        return io.Error.UnsupportedFormat;
+
+    const field: Field = keyword(Field, words.next() orelse "") orelse return io.Error.UnsupportedFormat;
+    const symmetry: Symmetry = keyword(Symmetry, words.next() orelse "") orelse return io.Error.UnsupportedFormat;
+
+    const size: []const u8 = try nextLine(reader) orelse return io.Error.InvalidFormat;
+    var numbers = std.mem.tokenizeAny(u8, size, " \t");
+    const rows: u32 = try number(u32, numbers.next());
+    const cols: u32 = try number(u32, numbers.next());
+    const count: u64 = try number(u64, numbers.next());
+
+    if (symmetry != .general and rows != cols)
+        return io.Error.InvalidFormat;
+
+    return .{
+        .field = field,
+        .symmetry = symmetry,
+        .rows = rows,
+        .cols = cols,
+        .entries = count,
+    };
+}
+
+fn keyword(comptime E: type, word: []const u8) ?E {
+    inline for (comptime std.enums.values(E)) |tag| {
+        if (std.ascii.eqlIgnoreCase(word, @tagName(tag)))
+            return tag;
+    }
+
+    return null;
+}
+
+fn number(comptime N: type, token: ?[]const u8) !N {
+    const string: []const u8 = token orelse return io.Error.InvalidFormat;
+
+    return switch (@typeInfo(N)) {
+        .int => std.fmt.parseInt(N, string, 10) catch return io.Error.InvalidFormat,
+        .float => std.fmt.parseFloat(N, string) catch return io.Error.InvalidFormat,
+        else => comptime unreachable,
+    };
+}
+
+/// Checks that the values of a file with field `field` and symmetry
+/// `symmetry` can be stored in `T`.
+fn check(comptime T: type, field: Field, symmetry: Symmetry) !void {
+    switch (comptime types.numericType(T)) {
+        .bool => if (field != .pattern and field != .integer) return io.Error.TypeMismatch,
+        .int => if (field == .real or field == .complex) return io.Error.TypeMismatch,
+        .float => if (field == .complex) return io.Error.TypeMismatch,
+        .cfloat => {},
+        else => unreachable,
+    }
+
+    if (symmetry == .@"skew-symmetric" and (T == bool or types.isUnsigned(T)))
+        return io.Error.TypeMismatch;
+}
+
+/// Parses the value of an entry, the tokens after its indices.
+fn value(comptime T: type, field: Field, tokens: anytype) !T {
+    return switch (field) {
+        .pattern => types.scast(T, @as(u8, 1)),
+        .integer => fromInteger(T, try number(i64, tokens.next())),
+        .real => types.scast(T, try number(f64, tokens.next())),
+        .complex => if (comptime types.numericType(T) == .cfloat) .{
+            .re = types.scast(types.Scalar(T), try number(f64, tokens.next())),
+            .im = types.scast(types.Scalar(T), try number(f64, tokens.next())),
+        } else unreachable,
+    };
+}
+
+/// Converts an integer value to `T`, failing if an int or bool can not hold
+/// it exactly.
+fn fromInteger(comptime T: type, x: i64) !T {
+    return switch (comptime types.numericType(T)) {
+        .bool => switch (x) {
+            0 => false,
+            1 => true,
+            else => io.Error.TypeMismatch,
+        },
+        .int => std.math.cast(T, x) orelse io.Error.TypeMismatch,
+        else => types.scast(T, x),
+    };
+}
+
+/// The value of the entry mirrored across the diagonal.
+fn mirror(comptime T: type, symmetry: Symmetry, x: T) !T {
+    return switch (symmetry) {
+        .general, .symmetric => x,
+        .@"skew-symmetric" => switch (comptime types.numericType(T)) {
+            .bool => unreachable,
+            .int => if (comptime types.isUnsigned(T))
+                unreachable
+            else if (x == std.math.minInt(T))
+                io.Error.TypeMismatch
+            else
+                -x,
+            .float => -x,
+            .cfloat => .{ .re = -x.re, .im = -x.im },
+            else => unreachable,
+        },
+        .hermitian => if (comptime types.numericType(T) == .cfloat) .{ .re = x.re, .im = -x.im } else x,
+    };
+}
+
+fn sum(comptime T: type, x: T, y: T) !T {
+    return switch (comptime types.numericType(T)) {
+        .bool => x or y,
+        .int => std.math.add(T, x, y) catch io.Error.TypeMismatch,
+        .float => x + y,
+        .cfloat => .{ .re = x.re + y.re, .im = x.im + y.im },
+        else => unreachable,
+    };
+}
+
+/// Reads the entries of the file, calling `sink.entry(row, col, value)` for
+/// each one, including the mirrored ones.
+fn entries(comptime T: type, reader: *std.Io.Reader, banner: *const Banner, sink: anytype) !void {
+    var count: u64 = 0;
+    while (count < banner.entries) : (count += 1) {
+        const line: []const u8 = try nextLine(reader) orelse return io.Error.InvalidFormat;
+        var tokens = std.mem.tokenizeAny(u8, line, " \t");
+
+        const i: u32 = try number(u32, tokens.next());
+        const j: u32 = try number(u32, tokens.next());
+        if (i == 0 or i > banner.rows or j == 0 or j > banner.cols)
+            return io.Error.InvalidFormat;
+
+        const x: T = try value(T, banner.field, &tokens);
+        try sink.entry(i - 1, j - 1, x);
+
+        if (banner.symmetry != .general and i != j)
+            try sink.entry(j - 1, i - 1, try mirror(T, banner.symmetry, x));
+    }
+}
+
+/// Reads a Matrix Market coordinate file into a matrix of type `M`, a general
+/// sparse matrix of fixed precision elements.
+///
+/// ## Arguments
+/// * `allocator` (`std.mem.Allocator`): The allocator to use for the matrix.
+/// * `M` (`type`): The matrix type to read.
+/// * `file` (`std.fs.File`): The file to read. It must be seekable, as it is
+///   read twice.
+///
+/// ## Returns
+/// `M`: The matrix read, owning its arrays, with sorted indices and duplicate
+/// entries summed.
+///
+/// ## Errors
+/// * `std.mem.Allocator.Error.OutOfMemory`: If memory allocation fails.
+/// * `std.fs.File.Reader.SeekError`: If the file can not be rewound.
+/// * `std.Io.Reader.Error`: If reading fails or a line is longer than 4096
+///   bytes.
+/// * `io.Error.InvalidFormat`: If the file is not a valid Matrix Market file.
+/// * `io.Error.UnsupportedFormat`: If the file is not in coordinate format.
+/// * `io.Error.TypeMismatch`: If the values of the file can not be stored in
+///   the elements of `M`, like complex values in a real matrix, or integers,
+///   their negations or sums out of the range of an int element type.
+/// * `io.Error.FileTooLarge`: If the matrix has more than `2^32 - 1` nonzero
+///   entries.
+pub fn read(allocator: std.mem.Allocator, comptime M: type, file: std.fs.File) !M {
+    if (comptime !types.isGeneralSparseMatrix(M))
+        @compileError("zml.io.matrix_market.read requires a matrix.general.Sparse, got " ++ @typeName(M));
+
+    const T: type = types.Numeric(M);
+    if (comptime types.isAllocated(T))
+        @compileError("zml.io.matrix_market.read requires fixed precision elements, got " ++ @typeName(T));
+
+    const row_major: bool = comptime M.storage_layout == .row_major;
+
+    var buffer: [4096]u8 = undefined;
+    var file_reader = file.reader(&buffer);
+    const reader: *std.Io.Reader = &file_reader.interface;
+
+    const banner: Banner = try readBanner(reader);
+    try check(T, banner.field, banner.symmetry);
+
+    const major: u32 = if (row_major) banner.rows else banner.cols;
+
+    // First pass: count the entries of each major index into `ptr[m + 1]`.
+    const ptr: []u32 = try allocator.alloc(u32, @as(usize, major) + 1);
+    errdefer allocator.free(ptr);
+    @memset(ptr, 0);
+
+    const Counter = struct {
+        ptr: []u32,
+        total: u64 = 0,
+
+        fn entry(self: *@This(), i: u32, j: u32, _: T) !void {
+            self.ptr[(if (row_major) i else j) + 1] += 1;
+            self.total += 1;
+            if (self.total > std.math.maxInt(u32))
+                return io.Error.FileTooLarge;
+        }
+    };
+
+    var counter: Counter = .{ .ptr = ptr };
+    try entries(T, reader, &banner, &counter);
+    const total: u32 = @intCast(counter.total);
+
+    for (1..ptr.len) |m|
+        ptr[m] += ptr[m - 1];
+
+    var idx: []u32 = try allocator.alloc(u32, total);
+    errdefer allocator.free(idx);
+    var data: []T = try allocator.alloc(T, total);
+    errdefer allocator.free(data);
+
+    // Second pass: `ptr[m]` is the next free position of major index `m`, so
+    // that afterwards it holds the start of `m + 1`.
+    try file_reader.seekTo(0);
+    _ = try readBanner(reader);
+
+    const Filler = struct {
+        ptr: []u32,
+        idx: []u32,
+        data: []T,
+
+        fn entry(self: *@This(), i: u32, j: u32, x: T) !void {
+            const m: u32 = if (row_major) i else j;
+
+            // The file changed between the passes.
+            if (self.ptr[m] >= self.idx.len)
+                return io.Error.InvalidFormat;
+
+            self.idx[self.ptr[m]] = if (row_major) j else i;
+            self.data[self.ptr[m]] = x;
+            self.ptr[m] += 1;
+        }
+    };
+
+    var filler: Filler = .{ .ptr = ptr, .idx = idx, .data = data };
+    try entries(T, reader, &banner, &filler);
+
+    var shift: u32 = major;
+    while (shift > 0) : (shift -= 1)
+        ptr[shift] = ptr[shift - 1];
+    ptr[0] = 0;
+
+    // Sort each major index and sum its duplicates, compacting in place.
+    const Sorter = struct {
+        idx: []u32,
+        data: []T,
+
+        pub fn lessThan(self: *const @This(), a: usize, b: usize) bool {
+            return self.idx[a] < self.idx[b];
+        }
+
+        pub fn swap(self: *const @This(), a: usize, b: usize) void {
+            std.mem.swap(u32, &self.idx[a], &self.idx[b]);
+            std.mem.swap(T, &self.data[a], &self.data[b]);
+        }
+    };
+
+    var nnz: u32 = 0;
+    var start: u32 = 0;
+    for (0..major) |m| {
+        const end: u32 = ptr[m + 1];
+        std.sort.pdqContext(start, end, Sorter{ .idx = idx, .data = data });
+
+        ptr[m] = nnz;
+        for (start..end) |k| {
+            if (nnz > ptr[m] and idx[nnz - 1] == idx[k]) {
+                data[nnz - 1] = try sum(T, data[nnz - 1], data[k]);
+            } else {
+                idx[nnz] = idx[k];
+                data[nnz] = data[k];
+                nnz += 1;
+            }
+        }
+
+        start = end;
+    }
+    ptr[major] = nnz;
+
+    if (nnz < total) {
+        idx = try allocator.realloc(idx, nnz);
+        data = try allocator.realloc(data, nnz);
+    }
+
+    return .{
+        .data = data.ptr,
+        .idx = idx.ptr,
+        .ptr = ptr.ptr,
+        .nnz = nnz,
+        .rows = banner.rows,
+        .cols = banner.cols,
+        .flags = .{ .owns_data = true },
+    };
+}
@@ -0,0 +1,418 @@
+//! NumPy `.npy` files for dense arrays (`array.Dense`) and general dense
+//! matrices (`matrix.general.Dense`).
+//!
+//! Files are written in format version 1.0, or 2.0 when the header does not
+//! fit, with the header padded so that the data starts at a multiple of 64
+//! bytes; `map` relies on it to view a file without copying it. Row major data
+//! is stored in C order and column major data in Fortran order.
+//!
+//! The supported element types are those with a NumPy counterpart: `bool`,
+//! the signed and unsigned 8 to 64 bit ints, `f16`, `f32`, `f64`, `cf32` and
+//! `cf64`, always little-endian.
+
+const std = @import("std");
+const builtin = @import("builtin");
+
+const types = @import("../types.zig");
+const Layout = types.Layout;
+const cfloat = @import("../cfloat.zig");
+const array = @import("../array.zig");
+
+const io = @import("../io.zig");
+
+const magic = "\x93NUMPY";
+
+/// Alignment of the data in the files written.
+pub const alignment: usize = 64;
+
+comptime {
+    if (builtin.cpu.arch.endian() != .little)
+        @compileError("zml.io.npy only supports little-endian targets");
+}
+
+/// Returns the NumPy type string of `T`.
+pub fn descr(comptime T: type) []const u8 {
+    return switch (T) {
+        bool => "|b1",
+        i8 => "|i1",
+        u8 => "|u1",
+        i16 => "<i2",
+        u16 => "<u2",
+        i32 => "<i4",
+        u32 => "<u4",
+        i64 => "<i8",
+        u64 => "<u8",
+        f16 => "<f2",
+        f32 => "<f4",
+        f64 => "<f8",
+        cfloat.cf32 => complex(T, "<c8"),
+        cfloat.cf64 => complex(T, "<c16"),
+        else => @compileError("zml.io.npy: " ++ @typeName(T) ++ " has no NumPy counterpart"),
+    };
+}
+
+fn complex(comptime T: type, comptime string: []const u8) []const u8 {
+    if (@offsetOf(T, "re") != 0 or @offsetOf(T, "im") != @sizeOf(T) / 2)
+        @compileError("zml.io.npy: " ++ @typeName(T) ++ " is not laid out as a real and an imaginary part");
+
+    return string;
+}
+
+/// Whether the type string `string` read from a file describes `T`. The byte
+/// order mark is ignored for single byte types.
+pub fn matches(comptime T: type, string: []const u8) bool {
+    const expected: []const u8 = comptime descr(T);
+    if (string.len != expected.len)
+        return false;
+
+    if (string[0] != expected[0] and !(expected[0] == '|' and (string[0] == '<' or string[0] == '=')))
+        return false;
+
+    return std.mem.eql(u8, string[1..], expected[1..]);
+}
+
+/// Header of an `.npy` file.
+pub const Header = struct {
+    descr: []const u8,
+    fortran_order: bool,
+    ndim: u32,
+    shape: [array.max_dimensions]u32,
+    /// Offset of the data from the start of the file.
+    offset: usize,
+
+    /// Number of elements, or `io.Error.FileTooLarge` if it does not fit in
+    /// a `u64`.
+    pub fn size(self: *const Header) !u64 {
+        return count(self.shape[0..self.ndim]);
+    }
+};
+
+/// Product of the dimensions in `shape`.
+fn count(shape: []const u32) !u64 {
+    var result: u64 = 1;
+    for (shape) |dim|
+        result = std.math.mul(u64, result, dim) catch return io.Error.FileTooLarge;
+
+    return result;
+}
+
+/// Returns the length of the preamble (magic string, version and header
+/// length) and of the header, given the first 12 bytes of a file.
+fn preamble(bytes: *const [12]u8) !struct { usize, usize } {
+    if (!std.mem.eql(u8, bytes[0..6], magic))
+        return io.Error.InvalidFormat;
+
+    return switch (bytes[6]) {
+        1 => .{ 10, std.mem.readInt(u16, bytes[8..10], .little) },
+        2, 3 => .{ 12, std.mem.readInt(u32, bytes[8..12], .little) },
+        else => io.Error.UnsupportedFormat,
+    };
+}
+
+/// Finds the value of `key` in the header dictionary `text`.
+fn value(text: []const u8, comptime key: []const u8) ![]const u8 {
+    inline for (.{ "'", "\"" }) |quote| {
+        if (std.mem.indexOf(u8, text, quote ++ key ++ quote)) |start| {
+            const rest: []const u8 = text[start + key.len + 2 ..];
+            const colon: usize = std.mem.indexOfScalar(u8, rest, ':') orelse return io.Error.InvalidFormat;
+            return std.mem.trimLeft(u8, rest[colon + 1 ..], " ");
+        }
+    }
+
+    return io.Error.InvalidFormat;
+}
+
+/// Parses the header dictionary `text`, which starts at `offset - text.len`.
+fn parse(text: []const u8, offset: usize) !Header {
+    var header: Header = .{
+        .descr = undefined,
+        .fortran_order = undefined,
+        .ndim = 0,
+        .shape = .{0} ** array.max_dimensions,
+        .offset = offset,
+    };
+
+    const d: []const u8 = try value(text, "descr");
+    if (d.len < 2 or (d[0] != '\'' and d[0] != '"'))
+        return io.Error.InvalidFormat;
+    header.descr = d[1 .. std.mem.indexOfScalarPos(u8, d, 1, d[0]) orelse return io.Error.InvalidFormat];
+
+    const f: []const u8 = try value(text, "fortran_order");
+    if (std.mem.startsWith(u8, f, "True")) {
+        header.fortran_order = true;
+    } else if (std.mem.startsWith(u8, f, "False")) {
+        header.fortran_order = false;
+    } else {
+        return io.Error.InvalidFormat;
+    }
+
+    const s: []const u8 = try value(text, "shape");
+    if (s.len == 0 or s[0] != '(')
+        return io.Error.InvalidFormat;
+    const end: usize = std.mem.indexOfScalar(u8, s, ')') orelse return io.Error.InvalidFormat;
+
+    var dims = std.mem.tokenizeAny(u8, s[1..end], ", ");
+    while (dims.next()) |dim| {
+        if (header.ndim == array.max_dimensions)
+            return array.Error.TooManyDimensions;
+
+        header.shape[header.ndim] = std.fmt.parseInt(u32, std.mem.trimRight(u8, dim, "L"), 10) catch return io.Error.InvalidFormat;
+        header.ndim += 1;
+    }
+
+    return header;
+}
+
+/// Parses the header of the `.npy` file in `bytes`.
+pub fn parseHeader(bytes: []const u8) !Header {
+    if (bytes.len < 12)
+        return io.Error.InvalidFormat;
+
+    const skip: usize, const len: usize = try preamble(bytes[0..12]);
+    if (bytes.len < skip + len)
+        return io.Error.InvalidFormat;
+
+    return parse(bytes[skip .. skip + len], skip + len);
+}
+
+/// Element type and layout of `D`, which must be a dense array or a general
+/// dense matrix.
+fn Info(comptime D: type) type {
+    if (!types.isDenseArray(D) and !types.isGeneralDenseMatrix(D))
+        @compileError("zml.io.npy requires an array.Dense or a matrix.general.Dense, got " ++ @typeName(D));
+
+    return struct {
+        const T: type = types.Numeric(D);
+        const layout: Layout = D.storage_layout;
+        const is_matrix: bool = types.isGeneralDenseMatrix(D);
+    };
+}
+
+/// Checks that `header` describes data of type `D`.
+fn check(comptime D: type, header: *const Header) !void {
+    const I = Info(D);
+
+    if (!matches(I.T, header.descr))
+        return io.Error.TypeMismatch;
+
+    if (header.ndim == 0 or try header.size() == 0)
+        return array.Error.ZeroDimension;
+
+    if (comptime I.is_matrix) {
+        if (header.ndim != 2)
+            return io.Error.DimensionMismatch;
+    } else {
+        // Array strides are 32-bit.
+        if (try header.size() > std.math.maxInt(u32))
+            return io.Error.FileTooLarge;
+    }
+
+    // The order of a vector is irrelevant.
+    if (header.ndim > 1 and header.fortran_order != (I.layout == .col_major))
+        return io.Error.LayoutMismatch;
+}
+
+/// A `D` viewing `data`, laid out as described by `header`.
+fn view(comptime D: type, header: *const Header, data: [*]Info(D).T) !D {
+    if (comptime Info(D).is_matrix) {
+        return .{
+            .data = data,
+            .rows = header.shape[0],
+            .cols = header.shape[1],
+            .ld = if (comptime Info(D).layout == .row_major) header.shape[1] else header.shape[0],
+            .flags = .{ .owns_data = false },
+        };
+    } else {
+        const size: u64 = try header.size();
+        var flat: D = .{
+            .data = data,
+            .ndim = 1,
+            .shape = .{0} ** array.max_dimensions,
+            .strides = .{0} ** array.max_dimensions,
+            .size = size,
+            .flags = .{ .owns_data = false },
+        };
+        flat.shape[0] = @intCast(size);
+        flat.strides[0] = 1;
+
+        return flat.reshape(header.shape[0..header.ndim]);
+    }
+}
+
+/// Writes `x`, a dense array or general dense matrix, as an `.npy` file.
+///
+/// ## Arguments
+/// * `writer` (`*std.Io.Writer`): The writer to write the file to.
+/// * `x` (`anytype`): The array or matrix to write.
+///
+/// ## Errors
+/// * `std.Io.Writer.Error.WriteFailed`: If writing fails.
+/// * `io.Error.NotContiguous`: If `x` is a broadcast array, whose data does
+///   not hold every element.
+pub fn write(writer: *std.Io.Writer, x: anytype) !void {
+    const I = Info(@TypeOf(x));
+
+    var ndim: u32 = 2;
+    var shape: [array.max_dimensions]u32 = .{0} ** array.max_dimensions;
+    if (comptime I.is_matrix) {
+        shape[0] = x.rows;
+        shape[1] = x.cols;
+    } else {
+        ndim = x.ndim;
+        @memcpy(shape[0..ndim], x.shape[0..ndim]);
+
+        if (try count(shape[0..ndim]) != x.size)
+            return io.Error.NotContiguous;
+    }
+
+    // Dictionary, padded with spaces and a newline to the alignment.
+    var buffer: [64 + 12 * array.max_dimensions]u8 = undefined;
+    var dictionary: std.Io.Writer = .fixed(&buffer);
+    dictionary.print("{{'descr': '{s}', 'fortran_order': {s}, 'shape': (", .{
+        comptime descr(I.T),
+        if (I.layout == .col_major) "True" else "False",
+    }) catch unreachable;
+    for (shape[0..ndim]) |dim|
+        dictionary.print("{d}, ", .{dim}) catch unreachable;
+    dictionary.writeAll("), }") catch unreachable;
+    const text: []const u8 = dictionary.buffered();
+
+    const v1: bool = std.mem.alignForward(usize, 10 + text.len + 1, alignment) - 10 <= std.math.maxInt(u16);
+    const skip: usize = if (v1) 10 else 12;
+    const len: usize = std.mem.alignForward(usize, skip + text.len + 1, alignment) - skip;
+
+    try writer.writeAll(magic);
+    if (v1) {
+        try writer.writeAll(&.{ 1, 0 });
+        try writer.writeInt(u16, @intCast(len), .little);
+    } else {
+        try writer.writeAll(&.{ 2, 0 });
+        try writer.writeInt(u32, @intCast(len), .little);
+    }
+    try writer.writeAll(text);
+    try writer.splatByteAll(' ', len - text.len - 1);
+    try writer.writeByte('\n');
+
+    if (comptime I.is_matrix) {
+        const contiguous: u32 = if (comptime I.layout == .row_major) x.cols else x.rows;
+        const lines: u32 = if (comptime I.layout == .row_major) x.rows else x.cols;
+
+        if (x.ld == contiguous) {
+            try writer.writeAll(std.mem.sliceAsBytes(x.data[0 .. @as(usize, lines) * contiguous]));
+        } else {
+            for (0..lines) |i|
+                try writer.writeAll(std.mem.sliceAsBytes(x.data[i * x.ld ..][0..contiguous]));
+        }
+    } else {
+        try writer.writeAll(std.mem.sliceAsBytes(x.data[0..x.size]));
+    }
+}
+
+/// Reads an `.npy` file into a new `D`, a dense array or general dense
+/// matrix.
+///
+/// ## Arguments
+/// * `allocator` (`std.mem.Allocator`): The allocator to use for the data.
+/// * `D` (`type`): The array or matrix type to read.
+/// * `reader` (`*std.Io.Reader`): The reader positioned at the start of the
+///   file.
+///
+/// ## Returns
+/// `D`: The array or matrix read, owning its data.
+///
+/// ## Errors
+/// * `std.mem.Allocator.Error.OutOfMemory`: If memory allocation fails.
+/// * `std.Io.Reader.Error`: If reading fails or the file is truncated.
+/// * `io.Error.InvalidFormat`: If the file is not an `.npy` file, or holds
+///   a `bool` other than 0 or 1.
+/// * `io.Error.TypeMismatch`: If the elements are not of the type of `D`.
+/// * `io.Error.LayoutMismatch`: If the order of the file is not the layout of
+///   `D`.
+/// * `io.Error.DimensionMismatch`: If `D` is a matrix and the data is not
+///   2-dimensional.
+/// * `io.Error.FileTooLarge`: If the number of elements overflows, or does
+///   not fit in a `u32` for an array.
+pub fn read(allocator: std.mem.Allocator, comptime D: type, reader: *std.Io.Reader) !D {
+    const skip: usize, const len: usize = try preamble(try reader.peekArray(12));
+    reader.toss(skip);
+
+    const text: []u8 = try allocator.alloc(u8, len);
+    defer allocator.free(text);
+    try reader.readSliceAll(text);
+
+    const header: Header = try parse(text, skip + len);
+    try check(D, &header);
+
+    var result: D = if (comptime Info(D).is_matrix)
+        try .init(allocator, header.shape[0], header.shape[1])
+    else
+        try .init(allocator, header.shape[0..header.ndim]);
+    errdefer result.deinit(allocator);
+
+    const bytes: []u8 = std.mem.sliceAsBytes(result.data[0..try header.size()]);
+    try reader.readSliceAll(bytes);
+    try checkData(Info(D).T, bytes);
+
+    return result;
+}
+
+/// Checks that `bytes` hold valid elements of type `T`: every byte of `bool`
+/// data must be 0 or 1.
+pub fn checkData(comptime T: type, bytes: []const u8) !void {
+    if (comptime T != bool)
+        return;
+
+    for (bytes) |byte| {
+        if (byte > 1)
+            return io.Error.InvalidFormat;
+    }
+}
+
+/// Maps an `.npy` file into memory and returns a `D`, a dense array or
+/// general dense matrix, viewing its data, without copying it.
+///
+/// ## Arguments
+/// * `D` (`type`): The array or matrix type to map.
+/// * `file` (`std.fs.File`): The file to map. It can be closed once mapped.
+///
+/// ## Returns
+/// `io.Mapped(D)`: The mapping, with the view in its `value` field. Unmap it
+/// with `unmap` once done.
+///
+/// ## Errors
+/// * `std.posix.MMapError`: If mapping fails.
+/// * `io.Error.InvalidFormat`: If the file is not an `.npy` file, is
+///   truncated, or holds a `bool` other than 0 or 1.
+/// * `io.Error.TypeMismatch`: If the elements are not of the type of `D`.
+/// * `io.Error.LayoutMismatch`: If the order of the file is not the layout of
+///   `D`.
+/// * `io.Error.DimensionMismatch`: If `D` is a matrix and the data is not
+///   2-dimensional.
+/// * `io.Error.Misaligned`: If the data is not aligned for the elements, as
+///   in files whose header is not padded.
+/// * `io.Error.FileTooLarge`: If the size of the data overflows, or the
+///   number of elements does not fit in a `u32` for an array.
+pub fn map(comptime D: type, file: std.fs.File) !io.Mapped(D) {
+    const T: type = Info(D).T;
+
+    const memory: []align(std.heap.page_size_min) u8 = try io.mapFile(file);
+    errdefer std.posix.munmap(memory);
+
+    const header: Header = try parseHeader(memory);
+    try check(D, &header);
+
+    if (header.offset % @alignOf(T) != 0)
+        return io.Error.Misaligned;
+
+    const bytes: u64 = std.math.mul(u64, try header.size(), @sizeOf(T)) catch return io.Error.FileTooLarge;
+    if (memory.len - header.offset < bytes)
+        return io.Error.InvalidFormat;
+
+    try checkData(T, memory[header.offset..][0..@intCast(bytes)]);
+
+    const data: [*]T = @ptrCast(@alignCast(memory.ptr + header.offset));
+    return .{
+        .value = try view(D, &header, data),
+        .memory = memory,
+    };
+}
@@ -0,0 +1,56 @@
+//! Root of the zml shared library: the LAPACK exports of `clapack.zig` and
+//! the batched BLAS routines declared in `include/zml.h`. The CBLAS exports
+//! are built on their own by the `cblas` step.
+
+const zml = @import("zml");
+
+const clapack = @import("clapack.zig");
+const CBLAS_ORDER = clapack.CBLAS_ORDER;
+const CBLAS_TRANSPOSE = clapack.CBLAS_TRANSPOSE;
+const status = clapack.status;
+
+comptime {
+    _ = clapack;
+}
+
+// Batches of small matrices
+export fn zml_sgemm_batch_strided(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: f32, a: [*c]const f32, lda: c_int, stride_a: usize, b: [*c]const f32, ldb: c_int, stride_b: usize, beta: f32, c: [*c]f32, ldc: c_int, stride_c: usize, count: usize) c_int {
+    return status(zml.linalg.batched.gemm(f32, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, beta, .{ .strided = .{ .data = @ptrCast(@alignCast(c)), .stride = stride_c } }, ldc, count, .{}));
+}
+export fn zml_dgemm_batch_strided(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: f64, a: [*c]const f64, lda: c_int, stride_a: usize, b: [*c]const f64, ldb: c_int, stride_b: usize, beta: f64, c: [*c]f64, ldc: c_int, stride_c: usize, count: usize) c_int {
+    return status(zml.linalg.batched.gemm(f64, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, beta, .{ .strided = .{ .data = @ptrCast(@alignCast(c)), .stride = stride_c } }, ldc, count, .{}));
+}
+export fn zml_cgemm_batch_strided(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: *const anyopaque, a: *const anyopaque, lda: c_int, stride_a: usize, b: *const anyopaque, ldb: c_int, stride_b: usize, beta: *const anyopaque, c: *anyopaque, ldc: c_int, stride_c: usize, count: usize) c_int {
+    const alpha_: *const zml.cf32 = @ptrCast(@alignCast(alpha));
+    const beta_: *const zml.cf32 = @ptrCast(@alignCast(beta));
+    return status(zml.linalg.batched.gemm(zml.cf32, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha_.*, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, beta_.*, .{ .strided = .{ .data = @ptrCast(@alignCast(c)), .stride = stride_c } }, ldc, count, .{}));
+}
+export fn zml_zgemm_batch_strided(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: *const anyopaque, a: *const anyopaque, lda: c_int, stride_a: usize, b: *const anyopaque, ldb: c_int, stride_b: usize, beta: *const anyopaque, c: *anyopaque, ldc: c_int, stride_c: usize, count: usize) c_int {
+    const alpha_: *const zml.cf64 = @ptrCast(@alignCast(alpha));
+    const beta_: *const zml.cf64 = @ptrCast(@alignCast(beta));
+    return status(zml.linalg.batched.gemm(zml.cf64, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha_.*, .{ .strided = .{ .data = @ptrCast(@alignCast(a)), .stride = stride_a } }, lda, .{ .strided = .{ .data = @ptrCast(@alignCast(b)), .stride = stride_b } }, ldb, beta_.*, .{ .strided = .{ .data = @ptrCast(@alignCast(c)), .stride = stride_c } }, ldc, count, .{}));
+}
+
+export fn zml_sgemm_batch(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: f32, a: [*c]const [*c]const f32, lda: c_int, b: [*c]const [*c]const f32, ldb: c_int, beta: f32, c: [*c]const [*c]f32, ldc: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.gemm(f32, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(b) }, ldb, beta, .{ .pointers = @ptrCast(c) }, ldc, count, .{}));
+}
+export fn zml_dgemm_batch(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: f64, a: [*c]const [*c]const f64, lda: c_int, b: [*c]const [*c]const f64, ldb: c_int, beta: f64, c: [*c]const [*c]f64, ldc: c_int, count: usize) c_int {
+    return status(zml.linalg.batched.gemm(f64, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(b) }, ldb, beta, .{ .pointers = @ptrCast(c) }, ldc, count, .{}));
+}
+export fn zml_cgemm_batch(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: *const anyopaque, a: [*c]const *const anyopaque, lda: c_int, b: [*c]const *const anyopaque, ldb: c_int, beta: *const anyopaque, c: [*c]const *anyopaque, ldc: c_int, count: usize) c_int {
+    const alpha_: *const zml.cf32 = @ptrCast(@alignCast(alpha));
+    const beta_: *const zml.cf32 = @ptrCast(@alignCast(beta));
+    return status(zml.linalg.batched.gemm(zml.cf32, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha_.*, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(b) }, ldb, beta_.*, .{ .pointers = @ptrCast(c) }, ldc, count, .{}));
+}
+export fn zml_zgemm_batch(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: *const anyopaque, a: [*c]const *const anyopaque, lda: c_int, b: [*c]const *const anyopaque, ldb: c_int, beta: *const anyopaque, c: [*c]const *anyopaque, ldc: c_int, count: usize) c_int {
+    const alpha_: *const zml.cf64 = @ptrCast(@alignCast(alpha));
+    const beta_: *const zml.cf64 = @ptrCast(@alignCast(beta));
+    return status(zml.linalg.batched.gemm(zml.cf64, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha_.*, .{ .pointers = @ptrCast(a) }, lda, .{ .pointers = @ptrCast(b) }, ldb, beta_.*, .{ .pointers = @ptrCast(c) }, ldc, count, .{}));
+}
+
+export fn zml_sgemm_batch_interleaved(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: f32, a: [*c]const f32, lda: c_int, b: [*c]const f32, ldb: c_int, beta: f32, c: [*c]f32, ldc: c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.gemm(f32, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(b)), .stride = stride } }, ldb, beta, .{ .interleaved = .{ .data = @ptrCast(@alignCast(c)), .stride = stride } }, ldc, count, .{}));
+}
+export fn zml_dgemm_batch_interleaved(order: CBLAS_ORDER, transa: CBLAS_TRANSPOSE, transb: CBLAS_TRANSPOSE, m: c_int, n: c_int, k: c_int, alpha: f64, a: [*c]const f64, lda: c_int, b: [*c]const f64, ldb: c_int, beta: f64, c: [*c]f64, ldc: c_int, stride: usize, count: usize) c_int {
+    return status(zml.linalg.batched.gemm(f64, order.to_zml(), transa.to_zml(), transb.to_zml(), m, n, k, alpha, .{ .interleaved = .{ .data = @ptrCast(@alignCast(a)), .stride = stride } }, lda, .{ .interleaved = .{ .data = @ptrCast(@alignCast(b)), .stride = stride } }, ldb, beta, .{ .interleaved = .{ .data = @ptrCast(@alignCast(c)), .stride = stride } }, ldc, count, .{}));
+}
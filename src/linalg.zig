@@ -9,6 +9,7 @@ const ops = @import("ops.zig");
 
 pub const blas = @import("linalg/blas.zig");
 pub const lapack = @import("linalg/lapack.zig");
+pub const batched = @import("linalg/batched.zig");
 
 pub inline fn dot(x: anytype, y: anytype, ctx: anytype) !Coerce(Numeric(@TypeOf(x)), Numeric(@TypeOf(y))) {
     const X: type = @TypeOf(x);
@@ -0,0 +1,859 @@
+//! Batched routines for many small, independent matrices of the same size.
+//!
+//! The routines in `blas` and `lapack` are built for one large matrix: every
+//! call validates its arguments, looks up block sizes with `ilaenv` and runs
+//! generic loops, which costs more than the arithmetic itself for matrices of
+//! a few rows. The routines here take a whole batch of `count` matrices
+//! instead:
+//! - the arguments are validated once for the batch,
+//! - matrices of up to `max_fixed` rows use kernels specialized at compile
+//!   time for their size, with fully unrolled loops on stack copies; larger
+//!   ones use the same unblocked algorithms with runtime sizes,
+//! - large batches are split in chunks of matrices over the current pool
+//!   (see `zml.pool`), or the one in the `pool` field of `ctx`.
+//!
+//! A batch (`Batch`) is laid out in one of three ways:
+//! - `strided`: matrix `i` starts at `data + i * stride`,
+//! - `pointers`: matrix `i` starts at `pointers[i]`,
+//! - `interleaved`: element `k` of matrix `i` is at `data[k * stride + i]`,
+//!   with `stride >= count`. The same element of consecutive matrices is
+//!   contiguous, so the kernels work on `@Vector`s of matrices, one per lane.
+//!   Only `f32` and `f64`.
+//!
+//! Within a matrix, element `(r, c)` is at offset `r + c * ld` in column
+//! major order and `r * ld + c` in row major order, as in the other routines;
+//! for interleaved batches that offset is `k`. All the batches given to one
+//! call must be interleaved, or none. `ipiv` and `tau` are batches of vectors
+//! laid out in the same way, with the offset of element `j` being `j`.
+//!
+//! Supported types are `f32`, `f64`, `cf32` and `cf64`. Dimensions are `i32`,
+//! as in `lapack`; `count` is the number of matrices in the batch.
+
+const types = @import("../types.zig");
+const scast = types.scast;
+const int = @import("../int.zig");
+
+const pool = @import("../pool.zig");
+const Pool = pool.Pool;
+
+const linalg = @import("../linalg.zig");
+const blas = @import("blas.zig");
+const lapack = @import("lapack.zig");
+const Order = types.Layout;
+const Transpose = linalg.Transpose;
+const Uplo = types.Uplo;
+
+const kernels = @import("batched/kernels.zig");
+const interleaved = @import("batched/interleaved.zig");
+
+/// Largest size with a kernel specialized at compile time.
+pub const max_fixed: u32 = 8;
+
+/// Matrices per task when a batch is split over a pool. A multiple of every
+/// vector length, so that interleaved chunks start on a lane group.
+const chunk: usize = 64;
+
+/// Minimum number of flops of a whole batch before it is split over a pool.
+const parallel_threshold: u64 = 1 << 20;
+
+/// Context accepted by the batched routines.
+const parallel_context = .{
+    .pool = .{
+        .type = ?*Pool,
+        .required = false,
+        .default = null,
+        .description = "The pool to split the batch over. If not provided, the current pool is used (see `zml.pool.current`).",
+    },
+};
+
+/// A batch of matrices (or vectors) pointed to by `P`, `[*]T` or
+/// `[*]const T`.
+pub fn Batch(comptime P: type) type {
+    return union(enum) {
+        /// Matrix `i` starts at `data + i * stride`.
+        strided: struct {
+            data: P,
+            stride: usize,
+        },
+        /// Matrix `i` starts at `pointers[i]`.
+        pointers: [*]const P,
+        /// Element `k` of matrix `i` is at `data[k * stride + i]`.
+        interleaved: struct {
+            data: P,
+            stride: usize,
+        },
+
+        /// Start of matrix `i` of a `strided` or `pointers` batch.
+        pub inline fn at(self: @This(), i: usize) P {
+            return switch (self) {
+                .strided => |s| s.data + i * s.stride,
+                .pointers => |p| p[i],
+                .interleaved => unreachable,
+            };
+        }
+
+        inline fn isInterleaved(self: @This()) bool {
+            return self == .interleaved;
+        }
+
+        /// Stride between the elements of an interleaved batch, 1 otherwise.
+        inline fn scale(self: @This()) usize {
+            return switch (self) {
+                .interleaved => |s| s.stride,
+                else => 1,
+            };
+        }
+
+        /// Elements `i..` of an interleaved batch.
+        inline fn lane(self: @This(), i: usize) P {
+            return self.interleaved.data + i;
+        }
+
+        fn valid(self: @This(), count: usize) bool {
+            return switch (self) {
+                .interleaved => |s| s.stride >= count,
+                else => true,
+            };
+        }
+    };
+}
+
+fn requireSupported(comptime T: type, comptime name: []const u8) void {
+    if (!kernels.isComplex(T) and T != f32 and T != f64)
+        @compileError("zml.linalg.batched." ++ name ++ " requires T to be f32, f64, cf32 or cf64, got " ++ @typeName(T));
+}
+
+/// Strides of the rows and columns of a matrix with leading dimension `ld`.
+inline fn strides(order: Order, ld: usize) [2]usize {
+    return if (order == .col_major) .{ 1, ld } else .{ ld, 1 };
+}
+
+/// Checks that the batches are either all interleaved or all not, and that
+/// interleaved batches are possible for `T`.
+fn compatible(comptime T: type, count: usize, batches: anytype) bool {
+    const first: bool = batches[0].isInterleaved();
+    inline for (batches) |batch| {
+        if (batch.isInterleaved() != first or !batch.valid(count))
+            return false;
+    }
+
+    return !first or !kernels.isComplex(T);
+}
+
+/// Calls `func(job, start, end)` over `0..count`, in chunks on a pool if the
+/// batch is large enough.
+fn run(count: usize, flops: u64, job: anytype, comptime func: fn (@TypeOf(job), usize, usize) void) void {
+    const Job = @TypeOf(job);
+    const Chunked = struct {
+        job: Job,
+        count: usize,
+
+        fn call(self: @This(), _: usize, index: usize) void {
+            const start: usize = index * chunk;
+            func(self.job, start, @min(start + chunk, self.count));
+        }
+    };
+
+    if (count > chunk and flops *| scast(u64, count) >= parallel_threshold) {
+        if (pool.current()) |current| {
+            if (current.size() > 1) {
+                current.parallelFor((count + chunk - 1) / chunk, Chunked{ .job = job, .count = count }, Chunked.call);
+                return;
+            }
+        }
+    }
+
+    func(job, 0, count);
+}
+
+/// Calls `func(job, N, V, i)` on the lane groups of `start..end` of an
+/// interleaved batch: full groups of `interleaved.lanes(T)` matrices, then
+/// the remainder one matrix at a time.
+inline fn lanes(comptime T: type, comptime N: ?u32, start: usize, end: usize, job: anytype, comptime func: anytype) void {
+    const V: usize = interleaved.lanes(T);
+
+    var i: usize = start;
+    while (i + V <= end) : (i += V)
+        func(job, N, V, i);
+
+    while (i < end) : (i += 1)
+        func(job, N, 1, i);
+}
+
+/// Calls `body(job, N, start, end)` with `N` the size if it has a
+/// specialized kernel, `null` otherwise.
+inline fn sized(size: u32, job: anytype, comptime body: anytype, start: usize, end: usize) void {
+    switch (size) {
+        inline 1...max_fixed => |N| body(job, N, start, end),
+        else => body(job, null, start, end),
+    }
+}
+
+/// Computes the matrix-matrix products
+///
+/// ```zig
+///     C[i] = alpha * op(A[i]) * op(B[i]) + beta * C[i],
+/// ```
+///
+/// for every matrix `i` of the batch, where `op(X)` is `X`, `X^T` or `X^H`,
+/// `op(A[i])` is `m`-by-`k` and `op(B[i])` is `k`-by-`n`.
+///
+/// Parameters
+/// ----------
+/// `T` (`type`): The element type.
+///
+/// `order` (`Order`): Whether the matrices are row-major or column-major.
+///
+/// `transa`, `transb` (`Transpose`): The operations applied to `A` and `B`.
+///
+/// `m`, `n`, `k` (`i32`): The dimensions of the products. Must be greater
+/// than or equal to 0.
+///
+/// `alpha`, `beta` (`T`): The scalars. When `beta` is zero, `C` need not be
+/// set on input.
+///
+/// `a`, `b` (`Batch([*]const T)`), `c` (`Batch([*]T)`): The matrices, with
+/// leading dimensions `lda`, `ldb` and `ldc`.
+///
+/// `count` (`usize`): The number of matrices in the batch.
+///
+/// `ctx` (`anytype`): A context struct with an optional `pool` field
+/// (`?*Pool`).
+///
+/// Errors
+/// ------
+/// `linalg.blas.Error.InvalidArgument`: If a dimension is negative, a leading
+/// dimension too small, or the batches are not all interleaved or all not.
+pub fn gemm(
+    comptime T: type,
+    order: Order,
+    transa: Transpose,
+    transb: Transpose,
+    m: i32,
+    n: i32,
+    k: i32,
+    alpha: T,
+    a: Batch([*]const T),
+    lda: i32,
+    b: Batch([*]const T),
+    ldb: i32,
+    beta: T,
+    c: Batch([*]T),
+    ldc: i32,
+    count: usize,
+    ctx: anytype,
+) !void {
+    comptime requireSupported(T, "gemm");
+    comptime types.validateContext(@TypeOf(ctx), parallel_context);
+
+    // Row-major C = op(A) * op(B) is column-major C^T = op(B)^T * op(A)^T.
+    if (order == .row_major)
+        return gemm(T, .col_major, transb, transa, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc, count, ctx);
+
+    const no_a: bool = transa == .no_trans or transa == .conj_no_trans;
+    const no_b: bool = transb == .no_trans or transb == .conj_no_trans;
+    if (m < 0 or n < 0 or k < 0 or
+        lda < int.max(1, if (no_a) m else k) or
+        ldb < int.max(1, if (no_b) k else n) or
+        ldc < int.max(1, m) or
+        !compatible(T, count, .{ a, b, c }))
+        return blas.Error.InvalidArgument;
+
+    if (count == 0 or m == 0 or n == 0)
+        return;
+
+    const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, parallel_context, "pool"));
+    defer pool.leave(previous);
+
+    const Job = struct {
+        transa: Transpose,
+        transb: Transpose,
+        m: u32,
+        n: u32,
+        k: u32,
+        alpha: T,
+        a: Batch([*]const T),
+        lda: usize,
+        b: Batch([*]const T),
+        ldb: usize,
+        beta: T,
+        c: Batch([*]T),
+        ldc: usize,
+
+        fn range(job: @This(), start: usize, end: usize) void {
+            const square: bool = job.m == job.n and job.n == job.k;
+            sized(if (square) job.m else 0, job, body, start, end);
+        }
+
+        fn body(job: @This(), comptime N: ?u32, start: usize, end: usize) void {
+            if (comptime !kernels.isComplex(T)) {
+                if (job.c.isInterleaved())
+                    return lanes(T, N, start, end, job, group);
+            }
+
+            for (start..end) |i| {
+                kernels.gemm(T, N, job.transa, job.transb, job.m, job.n, job.k, job.alpha, job.a.at(i), 1, job.lda, job.b.at(i), 1, job.ldb, job.beta, job.c.at(i), 1, job.ldc);
+            }
+        }
+
+        fn group(job: @This(), comptime N: ?u32, comptime V: usize, i: usize) void {
+            const sa: usize = job.a.scale();
+            const sb: usize = job.b.scale();
+            const sc: usize = job.c.scale();
+            interleaved.gemm(V, T, N, job.transa, job.transb, job.m, job.n, job.k, job.alpha, job.a.lane(i), sa, job.lda * sa, job.b.lane(i), sb, job.ldb * sb, job.beta, job.c.lane(i), sc, job.ldc * sc);
+        }
+    };
+
+    const flops: u64 = 2 * scast(u64, m) * scast(u64, n) * scast(u64, k);
+    run(count, flops, Job{
+        .transa = transa,
+        .transb = transb,
+        .m = scast(u32, m),
+        .n = scast(u32, n),
+        .k = scast(u32, k),
+        .alpha = alpha,
+        .a = a,
+        .lda = scast(usize, lda),
+        .b = b,
+        .ldb = scast(usize, ldb),
+        .beta = beta,
+        .c = c,
+        .ldc = scast(usize, ldc),
+    }, Job.range);
+}
+
+/// Computes the LU factorizations with partial pivoting
+///
+/// ```zig
+///     A[i] = P[i] * L[i] * U[i],
+/// ```
+///
+/// of the `n`-by-`n` matrices of the batch, as `lapack.getrf`.
+///
+/// Parameters
+/// ----------
+/// `T` (`type`): The element type.
+///
+/// `order` (`Order`): Whether the matrices are row-major or column-major.
+///
+/// `n` (`i32`): The order of the matrices. Must be greater than or equal to
+/// 0.
+///
+/// `a` (`Batch([*]T)`): The matrices, with leading dimension `lda`. On
+/// return, the factors `L` (without its unit diagonal) and `U`.
+///
+/// `ipiv` (`Batch([*]i32)`): On return, the 1-based pivot indices of each
+/// matrix, `n` each.
+///
+/// `info` (`[*]i32`): Array of size `count`. On return, 0 for each matrix
+/// factored, or `j` if `U[j - 1, j - 1]` is exactly zero.
+///
+/// `count` (`usize`): The number of matrices in the batch.
+///
+/// `ctx` (`anytype`): A context struct with an optional `pool` field
+/// (`?*Pool`).
+///
+/// Errors
+/// ------
+/// `linalg.lapack.Error.InvalidArgument`: If `n` is negative, `lda` is less
+/// than `max(1, n)`, or the batches are not all interleaved or all not.
+pub fn getrf(
+    comptime T: type,
+    order: Order,
+    n: i32,
+    a: Batch([*]T),
+    lda: i32,
+    ipiv: Batch([*]i32),
+    info: [*]i32,
+    count: usize,
+    ctx: anytype,
+) !void {
+    comptime requireSupported(T, "getrf");
+    comptime types.validateContext(@TypeOf(ctx), parallel_context);
+
+    if (n < 0 or lda < int.max(1, n) or !compatible(T, count, .{ a, ipiv }))
+        return lapack.Error.InvalidArgument;
+
+    if (count == 0)
+        return;
+
+    if (n == 0) {
+        @memset(info[0..count], 0);
+        return;
+    }
+
+    const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, parallel_context, "pool"));
+    defer pool.leave(previous);
+
+    const Job = struct {
+        n: u32,
+        a: Batch([*]T),
+        s: [2]usize,
+        ipiv: Batch([*]i32),
+        info: [*]i32,
+
+        fn range(job: @This(), start: usize, end: usize) void {
+            sized(job.n, job, body, start, end);
+        }
+
+        fn body(job: @This(), comptime N: ?u32, start: usize, end: usize) void {
+            if (comptime !kernels.isComplex(T)) {
+                if (job.a.isInterleaved())
+                    return lanes(T, N, start, end, job, group);
+            }
+
+            for (start..end) |i|
+                job.info[i] = kernels.getrf(T, N, job.n, job.a.at(i), job.s[0], job.s[1], job.ipiv.at(i));
+        }
+
+        fn group(job: @This(), comptime N: ?u32, comptime V: usize, i: usize) void {
+            const sa: usize = job.a.scale();
+            interleaved.getrf(V, T, N, job.n, job.a.lane(i), job.s[0] * sa, job.s[1] * sa, job.ipiv.lane(i), job.ipiv.scale(), job.info + i);
+        }
+    };
+
+    const size: u64 = scast(u64, n);
+    run(count, 2 * size * size * size / 3, Job{
+        .n = scast(u32, n),
+        .a = a,
+        .s = strides(order, scast(usize, lda)),
+        .ipiv = ipiv,
+        .info = info,
+    }, Job.range);
+}
+
+/// Solves the systems of linear equations
+///
+/// ```zig
+///     op(A[i]) * X[i] = B[i],
+/// ```
+///
+/// with the LU factorizations computed by `getrf`, for every matrix `i` of
+/// the batch, as `lapack.getrs`.
+///
+/// Parameters
+/// ----------
+/// `T` (`type`): The element type.
+///
+/// `order` (`Order`): Whether the matrices are row-major or column-major.
+///
+/// `trans` (`Transpose`): The operation applied to `A`: `no_trans`, `trans`
+/// or `conj_trans`.
+///
+/// `n` (`i32`): The order of the matrices `A`. Must be greater than or equal
+/// to 0.
+///
+/// `nrhs` (`i32`): The number of right-hand sides, the columns of each `B`.
+/// Must be greater than or equal to 0.
+///
+/// `a` (`Batch([*]const T)`): The factors from `getrf`, with leading
+/// dimension `lda`.
+///
+/// `ipiv` (`Batch([*]const i32)`): The pivot indices from `getrf`.
+///
+/// `b` (`Batch([*]T)`): The right-hand sides, with leading dimension `ldb`.
+/// On return, the solutions.
+///
+/// `count` (`usize`): The number of matrices in the batch.
+///
+/// `ctx` (`anytype`): A context struct with an optional `pool` field
+/// (`?*Pool`).
+///
+/// Errors
+/// ------
+/// `linalg.lapack.Error.InvalidArgument`: If `trans` is `conj_no_trans`, a
+/// dimension is negative, a leading dimension too small, or the batches are
+/// not all interleaved or all not.
+pub fn getrs(
+    comptime T: type,
+    order: Order,
+    trans: Transpose,
+    n: i32,
+    nrhs: i32,
+    a: Batch([*]const T),
+    lda: i32,
+    ipiv: Batch([*]const i32),
+    b: Batch([*]T),
+    ldb: i32,
+    count: usize,
+    ctx: anytype,
+) !void {
+    comptime requireSupported(T, "getrs");
+    comptime types.validateContext(@TypeOf(ctx), parallel_context);
+
+    if (trans == .conj_no_trans or n < 0 or nrhs < 0 or lda < int.max(1, n) or
+        ldb < int.max(1, if (order == .col_major) n else nrhs) or
+        !compatible(T, count, .{ a, ipiv, b }))
+        return lapack.Error.InvalidArgument;
+
+    if (count == 0 or n == 0 or nrhs == 0)
+        return;
+
+    const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, parallel_context, "pool"));
+    defer pool.leave(previous);
+
+    const Job = struct {
+        trans: Transpose,
+        n: u32,
+        nrhs: u32,
+        a: Batch([*]const T),
+        s: [2]usize,
+        ipiv: Batch([*]const i32),
+        b: Batch([*]T),
+        sb: [2]usize,
+
+        fn range(job: @This(), start: usize, end: usize) void {
+            sized(job.n, job, body, start, end);
+        }
+
+        fn body(job: @This(), comptime N: ?u32, start: usize, end: usize) void {
+            if (comptime !kernels.isComplex(T)) {
+                if (job.a.isInterleaved())
+                    return lanes(T, N, start, end, job, group);
+            }
+
+            switch (job.trans) {
+                inline .no_trans, .trans, .conj_trans => |t| {
+                    for (start..end) |i|
+                        kernels.getrs(T, N, t, job.n, job.nrhs, job.a.at(i), job.s[0], job.s[1], job.ipiv.at(i), job.b.at(i), job.sb[0], job.sb[1]);
+                },
+                .conj_no_trans => unreachable,
+            }
+        }
+
+        fn group(job: @This(), comptime N: ?u32, comptime V: usize, i: usize) void {
+            const sa: usize = job.a.scale();
+            const sb: usize = job.b.scale();
+            interleaved.getrs(V, T, N, job.trans, job.n, job.nrhs, job.a.lane(i), job.s[0] * sa, job.s[1] * sa, job.ipiv.lane(i), job.ipiv.scale(), job.b.lane(i), job.sb[0] * sb, job.sb[1] * sb);
+        }
+    };
+
+    const size: u64 = scast(u64, n);
+    run(count, 2 * size * size * scast(u64, nrhs), Job{
+        .trans = trans,
+        .n = scast(u32, n),
+        .nrhs = scast(u32, nrhs),
+        .a = a,
+        .s = strides(order, scast(usize, lda)),
+        .ipiv = ipiv,
+        .b = b,
+        .sb = strides(order, scast(usize, ldb)),
+    }, Job.range);
+}
+
+/// Computes the Cholesky factorizations
+///
+/// ```zig
+///     A[i] = U[i]^H * U[i], or A[i] = L[i] * L[i]^H,
+/// ```
+///
+/// of the Hermitian (symmetric, for real types) positive definite `n`-by-`n`
+/// matrices of the batch, as `lapack.potrf`.
+///
+/// Parameters
+/// ----------
+/// `T` (`type`): The element type.
+///
+/// `order` (`Order`): Whether the matrices are row-major or column-major.
+///
+/// `uplo` (`Uplo`): Whether the upper or lower triangles are stored and
+/// factored.
+///
+/// `n` (`i32`): The order of the matrices. Must be greater than or equal to
+/// 0.
+///
+/// `a` (`Batch([*]T)`): The matrices, with leading dimension `lda`. On
+/// return, the factors, in the triangle given by `uplo`.
+///
+/// `info` (`[*]i32`): Array of size `count`. On return, 0 for each matrix
+/// factored, or `j` if its leading minor of order `j` is not positive
+/// definite; the factorization of that matrix could not be completed.
+///
+/// `count` (`usize`): The number of matrices in the batch.
+///
+/// `ctx` (`anytype`): A context struct with an optional `pool` field
+/// (`?*Pool`).
+///
+/// Errors
+/// ------
+/// `linalg.lapack.Error.InvalidArgument`: If `n` is negative, `lda` is less
+/// than `max(1, n)`, or `a` is interleaved for a complex type.
+pub fn potrf(
+    comptime T: type,
+    order: Order,
+    uplo: Uplo,
+    n: i32,
+    a: Batch([*]T),
+    lda: i32,
+    info: [*]i32,
+    count: usize,
+    ctx: anytype,
+) !void {
+    comptime requireSupported(T, "potrf");
+    comptime types.validateContext(@TypeOf(ctx), parallel_context);
+
+    if (n < 0 or lda < int.max(1, n) or !compatible(T, count, .{a}))
+        return lapack.Error.InvalidArgument;
+
+    if (count == 0)
+        return;
+
+    if (n == 0) {
+        @memset(info[0..count], 0);
+        return;
+    }
+
+    const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, parallel_context, "pool"));
+    defer pool.leave(previous);
+
+    const Job = struct {
+        upper: bool,
+        n: u32,
+        a: Batch([*]T),
+        s: [2]usize,
+        info: [*]i32,
+
+        fn range(job: @This(), start: usize, end: usize) void {
+            sized(job.n, job, body, start, end);
+        }
+
+        fn body(job: @This(), comptime N: ?u32, start: usize, end: usize) void {
+            if (comptime !kernels.isComplex(T)) {
+                if (job.a.isInterleaved())
+                    return lanes(T, N, start, end, job, group);
+            }
+
+            // The kernels factor the lower triangle; see `kernels.zig`.
+            if (job.upper) {
+                for (start..end) |i|
+                    job.info[i] = kernels.potrf(T, N, true, job.n, job.a.at(i), job.s[1], job.s[0]);
+            } else {
+                for (start..end) |i|
+                    job.info[i] = kernels.potrf(T, N, false, job.n, job.a.at(i), job.s[0], job.s[1]);
+            }
+        }
+
+        fn group(job: @This(), comptime N: ?u32, comptime V: usize, i: usize) void {
+            const sa: usize = job.a.scale();
+            const s: [2]usize = if (job.upper) .{ job.s[1], job.s[0] } else job.s;
+            interleaved.potrf(V, T, N, job.n, job.a.lane(i), s[0] * sa, s[1] * sa, job.info + i);
+        }
+    };
+
+    const size: u64 = scast(u64, n);
+    run(count, size * size * size / 3, Job{
+        .upper = uplo == .upper,
+        .n = scast(u32, n),
+        .a = a,
+        .s = strides(order, scast(usize, lda)),
+        .info = info,
+    }, Job.range);
+}
+
+/// Solves the systems of linear equations
+///
+/// ```zig
+///     A[i] * X[i] = B[i],
+/// ```
+///
+/// with the Cholesky factorizations computed by `potrf`, for every matrix `i`
+/// of the batch, as `lapack.potrs`.
+///
+/// Parameters
+/// ----------
+/// `T` (`type`): The element type.
+///
+/// `order` (`Order`): Whether the matrices are row-major or column-major.
+///
+/// `uplo` (`Uplo`): Whether the factors are `U` or `L`, as given to `potrf`.
+///
+/// `n` (`i32`): The order of the matrices `A`. Must be greater than or equal
+/// to 0.
+///
+/// `nrhs` (`i32`): The number of right-hand sides, the columns of each `B`.
+/// Must be greater than or equal to 0.
+///
+/// `a` (`Batch([*]const T)`): The factors from `potrf`, with leading
+/// dimension `lda`.
+///
+/// `b` (`Batch([*]T)`): The right-hand sides, with leading dimension `ldb`.
+/// On return, the solutions.
+///
+/// `count` (`usize`): The number of matrices in the batch.
+///
+/// `ctx` (`anytype`): A context struct with an optional `pool` field
+/// (`?*Pool`).
+///
+/// Errors
+/// ------
+/// `linalg.lapack.Error.InvalidArgument`: If a dimension is negative, a
+/// leading dimension too small, or the batches are not all interleaved or all
+/// not.
+pub fn potrs(
+    comptime T: type,
+    order: Order,
+    uplo: Uplo,
+    n: i32,
+    nrhs: i32,
+    a: Batch([*]const T),
+    lda: i32,
+    b: Batch([*]T),
+    ldb: i32,
+    count: usize,
+    ctx: anytype,
+) !void {
+    comptime requireSupported(T, "potrs");
+    comptime types.validateContext(@TypeOf(ctx), parallel_context);
+
+    if (n < 0 or nrhs < 0 or lda < int.max(1, n) or
+        ldb < int.max(1, if (order == .col_major) n else nrhs) or
+        !compatible(T, count, .{ a, b }))
+        return lapack.Error.InvalidArgument;
+
+    if (count == 0 or n == 0 or nrhs == 0)
+        return;
+
+    const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, parallel_context, "pool"));
+    defer pool.leave(previous);
+
+    const Job = struct {
+        upper: bool,
+        n: u32,
+        nrhs: u32,
+        a: Batch([*]const T),
+        s: [2]usize,
+        b: Batch([*]T),
+        sb: [2]usize,
+
+        fn range(job: @This(), start: usize, end: usize) void {
+            sized(job.n, job, body, start, end);
+        }
+
+        fn body(job: @This(), comptime N: ?u32, start: usize, end: usize) void {
+            if (comptime !kernels.isComplex(T)) {
+                if (job.a.isInterleaved())
+                    return lanes(T, N, start, end, job, group);
+            }
+
+            if (job.upper) {
+                for (start..end) |i|
+                    kernels.potrs(T, N, true, job.n, job.nrhs, job.a.at(i), job.s[1], job.s[0], job.b.at(i), job.sb[0], job.sb[1]);
+            } else {
+                for (start..end) |i|
+                    kernels.potrs(T, N, false, job.n, job.nrhs, job.a.at(i), job.s[0], job.s[1], job.b.at(i), job.sb[0], job.sb[1]);
+            }
+        }
+
+        fn group(job: @This(), comptime N: ?u32, comptime V: usize, i: usize) void {
+            const sa: usize = job.a.scale();
+            const sb: usize = job.b.scale();
+            const s: [2]usize = if (job.upper) .{ job.s[1], job.s[0] } else job.s;
+            interleaved.potrs(V, T, N, job.n, job.nrhs, job.a.lane(i), s[0] * sa, s[1] * sa, job.b.lane(i), job.sb[0] * sb, job.sb[1] * sb);
+        }
+    };
+
+    const size: u64 = scast(u64, n);
+    run(count, 2 * size * size * scast(u64, nrhs), Job{
+        .upper = uplo == .upper,
+        .n = scast(u32, n),
+        .nrhs = scast(u32, nrhs),
+        .a = a,
+        .s = strides(order, scast(usize, lda)),
+        .b = b,
+        .sb = strides(order, scast(usize, ldb)),
+    }, Job.range);
+}
+
+/// Computes the QR factorizations
+///
+/// ```zig
+///     A[i] = Q[i] * R[i],
+/// ```
+///
+/// of the `m`-by-`n` matrices of the batch, as `lapack.geqrf`.
+///
+/// Parameters
+/// ----------
+/// `T` (`type`): The element type.
+///
+/// `order` (`Order`): Whether the matrices are row-major or column-major.
+///
+/// `m`, `n` (`i32`): The dimensions of the matrices. Must be greater than or
+/// equal to 0.
+///
+/// `a` (`Batch([*]T)`): The matrices, with leading dimension `lda`. On
+/// return, `R` on and above the diagonal and the elementary reflectors of `Q`
+/// below it.
+///
+/// `tau` (`Batch([*]T)`): On return, the scalar factors of the elementary
+/// reflectors, `min(m, n)` for each matrix.
+///
+/// `count` (`usize`): The number of matrices in the batch.
+///
+/// `ctx` (`anytype`): A context struct with an optional `pool` field
+/// (`?*Pool`).
+///
+/// Errors
+/// ------
+/// `linalg.lapack.Error.InvalidArgument`: If a dimension is negative, `lda`
+/// is too small, or the batches are not all interleaved or all not.
+pub fn geqrf(
+    comptime T: type,
+    order: Order,
+    m: i32,
+    n: i32,
+    a: Batch([*]T),
+    lda: i32,
+    tau: Batch([*]T),
+    count: usize,
+    ctx: anytype,
+) !void {
+    comptime requireSupported(T, "geqrf");
+    comptime types.validateContext(@TypeOf(ctx), parallel_context);
+
+    if (m < 0 or n < 0 or lda < int.max(1, if (order == .col_major) m else n) or
+        !compatible(T, count, .{ a, tau }))
+        return lapack.Error.InvalidArgument;
+
+    if (count == 0 or m == 0 or n == 0)
+        return;
+
+    const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, parallel_context, "pool"));
+    defer pool.leave(previous);
+
+    const Job = struct {
+        m: u32,
+        n: u32,
+        a: Batch([*]T),
+        s: [2]usize,
+        tau: Batch([*]T),
+
+        fn range(job: @This(), start: usize, end: usize) void {
+            sized(if (job.m == job.n) job.m else 0, job, body, start, end);
+        }
+
+        fn body(job: @This(), comptime N: ?u32, start: usize, end: usize) void {
+            if (comptime !kernels.isComplex(T)) {
+                if (job.a.isInterleaved())
+                    return lanes(T, N, start, end, job, group);
+            }
+
+            for (start..end) |i|
+                kernels.geqrf(T, N, job.m, job.n, job.a.at(i), job.s[0], job.s[1], job.tau.at(i));
+        }
+
+        fn group(job: @This(), comptime N: ?u32, comptime V: usize, i: usize) void {
+            const sa: usize = job.a.scale();
+            interleaved.geqrf(V, T, N, job.m, job.n, job.a.lane(i), job.s[0] * sa, job.s[1] * sa, job.tau.lane(i), job.tau.scale());
+        }
+    };
+
+    const mn: u64 = scast(u64, int.min(m, n));
+    run(count, 2 * scast(u64, int.max(m, n)) * mn * mn, Job{
+        .m = scast(u32, m),
+        .n = scast(u32, n),
+        .a = a,
+        .s = strides(order, scast(usize, lda)),
+        .tau = tau,
+    }, Job.range);
+}
@@ -0,0 +1,454 @@
+//! Kernels for `interleaved` batches of real matrices.
+//!
+//! In an interleaved batch, element `k` of matrix `i` is at
+//! `data[k * stride + i]`, so the same element of consecutive matrices is
+//! contiguous. Each kernel processes `V` consecutive matrices at once, one
+//! per lane of a `@Vector(V, T)`: every scalar operation of the unblocked
+//! algorithm becomes a vector operation, and data-dependent decisions
+//! (pivot rows, zero pivots, failed Cholesky steps) are made per lane with
+//! `@select`. The pointers given point at the first matrix of the group and
+//! the strides are already multiplied by the batch stride.
+//!
+//! As in `kernels.zig`, `N` is the comptime size when known.
+
+const std = @import("std");
+
+const linalg = @import("../../linalg.zig");
+const Transpose = linalg.Transpose;
+
+/// Number of matrices processed at once for `T`.
+pub fn lanes(comptime T: type) comptime_int {
+    return std.simd.suggestVectorLength(T) orelse 16 / @sizeOf(T);
+}
+
+inline fn load(comptime V: usize, comptime T: type, p: [*]const T) @Vector(V, T) {
+    return p[0..V].*;
+}
+
+inline fn store(comptime V: usize, comptime T: type, p: [*]T, v: @Vector(V, T)) void {
+    p[0..V].* = v;
+}
+
+inline fn splat(comptime V: usize, comptime T: type, x: T) @Vector(V, T) {
+    return @splat(x);
+}
+
+/// `info` with the lanes that have not failed yet set to fail at step `j`.
+inline fn first(comptime V: usize, info: @Vector(V, i32), j: usize) @Vector(V, i32) {
+    return @select(i32, info == splat(V, i32, 0), splat(V, i32, @intCast(j + 1)), info);
+}
+
+// General matrix multiplication.
+
+/// Computes `C = alpha * op(A) * op(B) + beta * C` for `V` matrices.
+pub fn gemm(
+    comptime V: usize,
+    comptime T: type,
+    comptime N: ?u32,
+    transa: Transpose,
+    transb: Transpose,
+    m: u32,
+    n: u32,
+    k: u32,
+    alpha: T,
+    a: [*]const T,
+    ars: usize,
+    acs: usize,
+    b: [*]const T,
+    brs: usize,
+    bcs: usize,
+    beta: T,
+    c: [*]T,
+    crs: usize,
+    ccs: usize,
+) void {
+    // Real matrices: the conjugating variants are the plain ones.
+    const sa: [2]usize = if (transa == .no_trans or transa == .conj_no_trans) .{ ars, acs } else .{ acs, ars };
+    const sb: [2]usize = if (transb == .no_trans or transb == .conj_no_trans) .{ brs, bcs } else .{ bcs, brs };
+
+    if (N) |size|
+        return gemmIn(V, T, size, size, size, alpha, a, sa[0], sa[1], b, sb[0], sb[1], beta, c, crs, ccs);
+
+    gemmIn(V, T, m, n, k, alpha, a, sa[0], sa[1], b, sb[0], sb[1], beta, c, crs, ccs);
+}
+
+inline fn gemmIn(
+    comptime V: usize,
+    comptime T: type,
+    m: usize,
+    n: usize,
+    k: usize,
+    alpha: T,
+    a: [*]const T,
+    ars: usize,
+    acs: usize,
+    b: [*]const T,
+    brs: usize,
+    bcs: usize,
+    beta: T,
+    c: [*]T,
+    crs: usize,
+    ccs: usize,
+) void {
+    for (0..n) |j| {
+        for (0..m) |i| {
+            var s: @Vector(V, T) = @splat(0);
+            for (0..k) |l|
+                s += load(V, T, a + i * ars + l * acs) * load(V, T, b + l * brs + j * bcs);
+
+            const p: [*]T = c + i * crs + j * ccs;
+            if (beta == 0) {
+                store(V, T, p, splat(V, T, alpha) * s);
+            } else {
+                store(V, T, p, splat(V, T, alpha) * s + splat(V, T, beta) * load(V, T, p));
+            }
+        }
+    }
+}
+
+// LU factorization.
+
+/// Factors `V` `n × n` matrices as `P * L * U` with partial pivoting,
+/// storing the pivots of matrix `l` in lane `l` of `ipiv` (stride `ps`) and
+/// its `info` in `info[l]`.
+pub fn getrf(comptime V: usize, comptime T: type, comptime N: ?u32, n: u32, a: [*]T, rs: usize, cs: usize, ipiv: [*]i32, ps: usize, info: [*]i32) void {
+    store(V, i32, info, getf2(V, T, N orelse n, a, rs, cs, ipiv, ps));
+}
+
+inline fn getf2(comptime V: usize, comptime T: type, n: usize, a: [*]T, rs: usize, cs: usize, ipiv: [*]i32, ps: usize) @Vector(V, i32) {
+    const I = @Vector(V, i32);
+
+    var info: I = @splat(0);
+    for (0..n) |j| {
+        // Pivot row of each lane.
+        var max: @Vector(V, T) = @abs(load(V, T, a + j * rs + j * cs));
+        var p: I = @splat(@intCast(j));
+        for (j + 1..n) |i| {
+            const v: @Vector(V, T) = @abs(load(V, T, a + i * rs + j * cs));
+            const greater = v > max;
+            max = @select(T, greater, v, max);
+            p = @select(i32, greater, splat(V, i32, @intCast(i)), p);
+        }
+
+        store(V, i32, ipiv + j * ps, p + splat(V, i32, 1));
+
+        // Swap row j with the pivot row, in the lanes that pivot on row i.
+        for (j + 1..n) |i| {
+            const swap = p == splat(V, i32, @intCast(i));
+            if (!@reduce(.Or, swap))
+                continue;
+
+            for (0..n) |c| {
+                const x: @Vector(V, T) = load(V, T, a + j * rs + c * cs);
+                const y: @Vector(V, T) = load(V, T, a + i * rs + c * cs);
+                store(V, T, a + j * rs + c * cs, @select(T, swap, y, x));
+                store(V, T, a + i * rs + c * cs, @select(T, swap, x, y));
+            }
+        }
+
+        // Lanes with a zero pivot record it and skip the scaling.
+        const singular = max == splat(V, T, 0);
+        info = @select(i32, singular, first(V, info, j), info);
+
+        const pivot: @Vector(V, T) = @select(T, singular, splat(V, T, 1), load(V, T, a + j * rs + j * cs));
+        const r: @Vector(V, T) = splat(V, T, 1) / pivot;
+        for (j + 1..n) |i|
+            store(V, T, a + i * rs + j * cs, load(V, T, a + i * rs + j * cs) * r);
+
+        for (j + 1..n) |c| {
+            const t: @Vector(V, T) = load(V, T, a + j * rs + c * cs);
+            for (j + 1..n) |i|
+                store(V, T, a + i * rs + c * cs, load(V, T, a + i * rs + c * cs) - load(V, T, a + i * rs + j * cs) * t);
+        }
+    }
+
+    return info;
+}
+
+/// Solves `op(A) * X = B` for `V` matrices with the factorizations from
+/// `getrf`.
+pub fn getrs(
+    comptime V: usize,
+    comptime T: type,
+    comptime N: ?u32,
+    trans: Transpose,
+    n: u32,
+    nrhs: u32,
+    a: [*]const T,
+    rs: usize,
+    cs: usize,
+    ipiv: [*]const i32,
+    ps: usize,
+    b: [*]T,
+    brs: usize,
+    bcs: usize,
+) void {
+    const size: usize = N orelse n;
+
+    if (trans == .no_trans) {
+        swapRows(V, T, size, nrhs, ipiv, ps, false, b, brs, bcs);
+
+        for (0..nrhs) |c| {
+            const x: [*]T = b + c * bcs;
+
+            // Solve L * Y = B, L unit lower triangular.
+            for (0..size) |j| {
+                const t: @Vector(V, T) = load(V, T, x + j * brs);
+                for (j + 1..size) |i|
+                    store(V, T, x + i * brs, load(V, T, x + i * brs) - load(V, T, a + i * rs + j * cs) * t);
+            }
+
+            // Solve U * X = Y.
+            var j: usize = size;
+            while (j > 0) {
+                j -= 1;
+
+                const t: @Vector(V, T) = load(V, T, x + j * brs) / load(V, T, a + j * rs + j * cs);
+                store(V, T, x + j * brs, t);
+                for (0..j) |i|
+                    store(V, T, x + i * brs, load(V, T, x + i * brs) - load(V, T, a + i * rs + j * cs) * t);
+            }
+        }
+    } else {
+        for (0..nrhs) |c| {
+            const x: [*]T = b + c * bcs;
+
+            // Solve U^T * Z = B.
+            for (0..size) |i| {
+                var s: @Vector(V, T) = load(V, T, x + i * brs);
+                for (0..i) |l|
+                    s -= load(V, T, a + l * rs + i * cs) * load(V, T, x + l * brs);
+
+                store(V, T, x + i * brs, s / load(V, T, a + i * rs + i * cs));
+            }
+
+            // Solve L^T * X = Z, L unit lower triangular.
+            var i: usize = size;
+            while (i > 0) {
+                i -= 1;
+
+                var s: @Vector(V, T) = load(V, T, x + i * brs);
+                for (i + 1..size) |l|
+                    s -= load(V, T, a + l * rs + i * cs) * load(V, T, x + l * brs);
+
+                store(V, T, x + i * brs, s);
+            }
+        }
+
+        swapRows(V, T, size, nrhs, ipiv, ps, true, b, brs, bcs);
+    }
+}
+
+/// Applies the row interchanges of each lane to `b`, in reverse if
+/// `reverse`.
+inline fn swapRows(comptime V: usize, comptime T: type, n: usize, nrhs: usize, ipiv: [*]const i32, ps: usize, comptime reverse: bool, b: [*]T, brs: usize, bcs: usize) void {
+    for (0..n) |step| {
+        const i: usize = if (reverse) n - 1 - step else step;
+        const p: @Vector(V, i32) = load(V, i32, ipiv + i * ps) - splat(V, i32, 1);
+
+        for (i + 1..n) |r| {
+            const swap = p == splat(V, i32, @intCast(r));
+            if (!@reduce(.Or, swap))
+                continue;
+
+            for (0..nrhs) |c| {
+                const x: @Vector(V, T) = load(V, T, b + i * brs + c * bcs);
+                const y: @Vector(V, T) = load(V, T, b + r * brs + c * bcs);
+                store(V, T, b + i * brs + c * bcs, @select(T, swap, y, x));
+                store(V, T, b + r * brs + c * bcs, @select(T, swap, x, y));
+            }
+        }
+    }
+}
+
+// Cholesky factorization, on the lower triangle; see `kernels.zig` for the
+// upper one.
+
+/// Factors `V` symmetric positive definite `n × n` matrices as `L * L^T`,
+/// storing the `info` of matrix `l` in `info[l]`. Once a lane fails, the rest
+/// of its matrix is left unspecified.
+pub fn potrf(comptime V: usize, comptime T: type, comptime N: ?u32, n: u32, a: [*]T, rs: usize, cs: usize, info: [*]i32) void {
+    store(V, i32, info, potf2(V, T, N orelse n, a, rs, cs));
+}
+
+inline fn potf2(comptime V: usize, comptime T: type, n: usize, a: [*]T, rs: usize, cs: usize) @Vector(V, i32) {
+    var info: @Vector(V, i32) = @splat(0);
+    for (0..n) |j| {
+        var d: @Vector(V, T) = load(V, T, a + j * rs + j * cs);
+        for (0..j) |l| {
+            const x: @Vector(V, T) = load(V, T, a + j * rs + l * cs);
+            d -= x * x;
+        }
+
+        // Written this way round so that NaNs fail too.
+        const positive = d > splat(V, T, 0);
+        info = @select(i32, positive, info, first(V, info, j));
+
+        const ljj: @Vector(V, T) = @sqrt(@select(T, positive, d, splat(V, T, 1)));
+        store(V, T, a + j * rs + j * cs, @select(T, positive, ljj, d));
+
+        const r: @Vector(V, T) = splat(V, T, 1) / ljj;
+        for (j + 1..n) |i| {
+            var s: @Vector(V, T) = load(V, T, a + i * rs + j * cs);
+            for (0..j) |l|
+                s -= load(V, T, a + i * rs + l * cs) * load(V, T, a + j * rs + l * cs);
+
+            store(V, T, a + i * rs + j * cs, s * r);
+        }
+    }
+
+    return info;
+}
+
+/// Solves `A * X = B` for `V` matrices with the factorizations `L * L^T`
+/// from `potrf`.
+pub fn potrs(
+    comptime V: usize,
+    comptime T: type,
+    comptime N: ?u32,
+    n: u32,
+    nrhs: u32,
+    a: [*]const T,
+    rs: usize,
+    cs: usize,
+    b: [*]T,
+    brs: usize,
+    bcs: usize,
+) void {
+    const size: usize = N orelse n;
+
+    for (0..nrhs) |c| {
+        const x: [*]T = b + c * bcs;
+
+        // Solve L * Y = B.
+        for (0..size) |i| {
+            var s: @Vector(V, T) = load(V, T, x + i * brs);
+            for (0..i) |l|
+                s -= load(V, T, a + i * rs + l * cs) * load(V, T, x + l * brs);
+
+            store(V, T, x + i * brs, s / load(V, T, a + i * rs + i * cs));
+        }
+
+        // Solve L^T * X = Y.
+        var i: usize = size;
+        while (i > 0) {
+            i -= 1;
+
+            var s: @Vector(V, T) = load(V, T, x + i * brs);
+            for (i + 1..size) |l|
+                s -= load(V, T, a + l * rs + i * cs) * load(V, T, x + l * brs);
+
+            store(V, T, x + i * brs, s / load(V, T, a + i * rs + i * cs));
+        }
+    }
+}
+
+// QR factorization.
+
+/// Factors `V` `m × n` matrices as `Q * R`, as `geqrf`, storing the scalar
+/// factors of the reflectors in `tau` (stride `ts`).
+pub fn geqrf(comptime V: usize, comptime T: type, comptime N: ?u32, m: u32, n: u32, a: [*]T, rs: usize, cs: usize, tau: [*]T, ts: usize) void {
+    if (N) |size|
+        return geqr2(V, T, size, size, a, rs, cs, tau, ts);
+
+    geqr2(V, T, m, n, a, rs, cs, tau, ts);
+}
+
+/// Norm of `x[1..len]`, scaled by its largest element.
+inline fn norm(comptime V: usize, comptime T: type, len: usize, x: [*]const T, inc: usize) @Vector(V, T) {
+    const zero: @Vector(V, T) = @splat(0);
+
+    var scale: @Vector(V, T) = zero;
+    for (1..len) |r|
+        scale = @max(scale, @abs(load(V, T, x + r * inc)));
+
+    const safe: @Vector(V, T) = @select(T, scale == zero, splat(V, T, 1), scale);
+    var ssq: @Vector(V, T) = zero;
+    for (1..len) |r| {
+        const y: @Vector(V, T) = load(V, T, x + r * inc) / safe;
+        ssq += y * y;
+    }
+
+    return safe * @sqrt(ssq);
+}
+
+/// `-sign(alpha) * sqrt(alpha^2 + xnorm^2)`, without overflow; lanes in
+/// `zeros` get `-sign(alpha) * |alpha|`.
+inline fn reflect(comptime V: usize, comptime T: type, alpha: @Vector(V, T), xnorm: @Vector(V, T), zeros: @Vector(V, bool)) @Vector(V, T) {
+    const w: @Vector(V, T) = @select(T, zeros, splat(V, T, 1), @max(@abs(alpha), xnorm));
+    const h: @Vector(V, T) = w * @sqrt((alpha / w) * (alpha / w) + (xnorm / w) * (xnorm / w));
+
+    return @select(T, alpha >= splat(V, T, 0), -h, h);
+}
+
+inline fn geqr2(comptime V: usize, comptime T: type, m: usize, n: usize, a: [*]T, rs: usize, cs: usize, tau: [*]T, ts: usize) void {
+    const I = @Vector(V, i32);
+
+    const zero: @Vector(V, T) = @splat(0);
+    const one: @Vector(V, T) = @splat(1);
+    const none: @Vector(V, bool) = @splat(false);
+    const safmin: T = std.math.floatMin(T) / std.math.floatEps(T);
+
+    for (0..@min(m, n)) |i| {
+        const d: [*]T = a + i * rs + i * cs;
+
+        // Reflector H(i), as larfg; lanes with a zero column get tau = 0.
+        var alpha: @Vector(V, T) = load(V, T, d);
+        var xnorm: @Vector(V, T) = norm(V, T, m - i, d, rs);
+        const zeros = xnorm == zero;
+        var beta: @Vector(V, T) = reflect(V, T, alpha, xnorm, zeros);
+
+        // In the lanes where beta and xnorm may be inaccurate, scale x and
+        // recompute them.
+        var knt: I = @splat(0);
+        while (true) {
+            const tiny = @select(bool, zeros, none, @select(bool, knt < splat(V, i32, 20), @abs(beta) < splat(V, T, safmin), none));
+            if (!@reduce(.Or, tiny))
+                break;
+
+            const f: @Vector(V, T) = @select(T, tiny, splat(V, T, 1 / safmin), one);
+            for (1..m - i) |r|
+                store(V, T, d + r * rs, load(V, T, d + r * rs) * f);
+
+            beta *= f;
+            alpha *= f;
+            knt += @select(i32, tiny, splat(V, i32, 1), splat(V, i32, 0));
+        }
+
+        if (@reduce(.Or, knt > splat(V, i32, 0))) {
+            xnorm = norm(V, T, m - i, d, rs);
+            beta = reflect(V, T, alpha, xnorm, zeros);
+        }
+
+        const safe_beta: @Vector(V, T) = @select(T, zeros, one, beta);
+        const t: @Vector(V, T) = @select(T, zeros, zero, (beta - alpha) / safe_beta);
+        store(V, T, tau + i * ts, t);
+
+        const scal: @Vector(V, T) = @select(T, zeros, one, one / @select(T, zeros, one, alpha - beta));
+        for (1..m - i) |r|
+            store(V, T, d + r * rs, load(V, T, d + r * rs) * scal);
+
+        while (@reduce(.Or, knt > splat(V, i32, 0))) {
+            const scaled = knt > splat(V, i32, 0);
+            beta = @select(T, scaled, beta * splat(V, T, safmin), beta);
+            knt -= @select(i32, scaled, splat(V, i32, 1), splat(V, i32, 0));
+        }
+
+        store(V, T, d, @select(T, zeros, alpha, beta));
+
+        // Apply H(i) = I - tau * v * v^T to a[i..m, i + 1..n], with
+        // v = (1, a[i + 1..m, i]).
+        for (i + 1..n) |c| {
+            const col: [*]T = a + i * rs + c * cs;
+
+            var s: @Vector(V, T) = load(V, T, col);
+            for (1..m - i) |r|
+                s += load(V, T, d + r * rs) * load(V, T, col + r * rs);
+
+            s *= t;
+            store(V, T, col, load(V, T, col) - s);
+            for (1..m - i) |r|
+                store(V, T, col + r * rs, load(V, T, col + r * rs) - load(V, T, d + r * rs) * s);
+        }
+    }
+}
@@ -0,0 +1,590 @@
+//! Kernels for one small matrix, used by the `strided` and `pointers`
+//! batches.
+//!
+//! Every kernel takes the size as a comptime `N: ?u32`. When it is known, the
+//! matrices are copied to column-major arrays on the stack and the algorithm
+//! runs with comptime bounds and strides, so the loops are fully unrolled and
+//! vectorized; otherwise it runs in place with the runtime size `n`. Element
+//! `(r, c)` of a matrix is at `r * rs + c * cs`, which covers both orders.
+//!
+//! The algorithms are the unblocked LAPACK ones (`getf2`, `getrs`, `potf2`,
+//! `potrs`, `geqr2`) without argument checks or workspace queries; the
+//! arguments are validated once per batch by the callers.
+
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const cfloat = @import("../../cfloat.zig");
+const cf32 = cfloat.cf32;
+const cf64 = cfloat.cf64;
+
+const linalg = @import("../../linalg.zig");
+const Transpose = linalg.Transpose;
+
+pub inline fn isComplex(comptime T: type) bool {
+    return T == cf32 or T == cf64;
+}
+
+pub fn Real(comptime T: type) type {
+    return if (comptime isComplex(T)) types.Scalar(T) else T;
+}
+
+// Scalar helpers, as in `blas/blocked.zig`.
+
+inline fn zero(comptime T: type) T {
+    return if (comptime isComplex(T)) .{ .re = 0, .im = 0 } else 0;
+}
+
+inline fn one(comptime T: type) T {
+    return if (comptime isComplex(T)) .{ .re = 1, .im = 0 } else 1;
+}
+
+inline fn isZero(comptime T: type, x: T) bool {
+    return if (comptime isComplex(T)) x.re == 0 and x.im == 0 else x == 0;
+}
+
+inline fn add(comptime T: type, x: T, y: T) T {
+    return if (comptime isComplex(T)) x.add(y) else x + y;
+}
+
+inline fn sub(comptime T: type, x: T, y: T) T {
+    return if (comptime isComplex(T)) x.sub(y) else x - y;
+}
+
+inline fn mul(comptime T: type, x: T, y: T) T {
+    return if (comptime isComplex(T)) x.mul(y) else x * y;
+}
+
+inline fn div(comptime T: type, x: T, y: T) T {
+    return if (comptime isComplex(T)) x.div(y) else x / y;
+}
+
+inline fn conj(comptime T: type, x: T) T {
+    return if (comptime isComplex(T)) x.conj() else x;
+}
+
+/// `x` if `conjugate` is false, its conjugate otherwise.
+inline fn maybeConj(comptime T: type, comptime conjugate: bool, x: T) T {
+    return if (conjugate) conj(T, x) else x;
+}
+
+inline fn re(comptime T: type, x: T) Real(T) {
+    return if (comptime isComplex(T)) x.re else x;
+}
+
+inline fn im(comptime T: type, x: T) Real(T) {
+    return if (comptime isComplex(T)) x.im else 0;
+}
+
+inline fn fromReal(comptime T: type, x: Real(T)) T {
+    return if (comptime isComplex(T)) .{ .re = x, .im = 0 } else x;
+}
+
+/// `x * s` for a real `s`.
+inline fn scaleReal(comptime T: type, x: T, s: Real(T)) T {
+    return if (comptime isComplex(T)) .{ .re = x.re * s, .im = x.im * s } else x * s;
+}
+
+/// `|re(x)| + |im(x)|`, the magnitude LAPACK pivots on.
+inline fn abs1(comptime T: type, x: T) Real(T) {
+    return if (comptime isComplex(T)) @abs(x.re) + @abs(x.im) else @abs(x);
+}
+
+/// `|x|^2`.
+inline fn abs2(comptime T: type, x: T) Real(T) {
+    return if (comptime isComplex(T)) x.re * x.re + x.im * x.im else x * x;
+}
+
+/// Copies an `m × n` matrix with strides `rs` and `cs` from `src` to `dst`,
+/// with strides `drs` and `dcs`.
+inline fn copy(comptime T: type, m: usize, n: usize, src: [*]const T, rs: usize, cs: usize, dst: [*]T, drs: usize, dcs: usize) void {
+    for (0..n) |c| {
+        for (0..m) |r|
+            dst[r * drs + c * dcs] = src[r * rs + c * cs];
+    }
+}
+
+/// Euclidean norm of `n` elements of `x` with stride `inc`, scaled to avoid
+/// overflow and underflow.
+inline fn norm(comptime T: type, n: usize, x: [*]const T, inc: usize) Real(T) {
+    const R: type = Real(T);
+
+    var scale: R = 0;
+    var ssq: R = 1;
+    for (0..n) |i| {
+        const parts: [2]R = .{ re(T, x[i * inc]), im(T, x[i * inc]) };
+        for (parts) |part| {
+            if (part != 0) {
+                const a: R = @abs(part);
+                if (scale < a) {
+                    ssq = 1 + ssq * (scale / a) * (scale / a);
+                    scale = a;
+                } else {
+                    ssq += (a / scale) * (a / scale);
+                }
+            }
+        }
+    }
+
+    return scale * @sqrt(ssq);
+}
+
+/// `sqrt(x^2 + y^2 + z^2)`, avoiding unnecessary overflow.
+inline fn hypot3(comptime R: type, x: R, y: R, z: R) R {
+    const w: R = @max(@abs(x), @abs(y), @abs(z));
+    if (w == 0)
+        return @abs(x) + @abs(y) + @abs(z);
+
+    return w * @sqrt((x / w) * (x / w) + (y / w) * (y / w) + (z / w) * (z / w));
+}
+
+// General matrix multiplication.
+
+/// Computes `C = alpha * op(A) * op(B) + beta * C` for an `m × k` `op(A)`
+/// and a `k × n` `op(B)`. `N`, if given, is `m`, `n` and `k`.
+pub fn gemm(
+    comptime T: type,
+    comptime N: ?u32,
+    transa: Transpose,
+    transb: Transpose,
+    m: u32,
+    n: u32,
+    k: u32,
+    alpha: T,
+    a: [*]const T,
+    ars: usize,
+    acs: usize,
+    b: [*]const T,
+    brs: usize,
+    bcs: usize,
+    beta: T,
+    c: [*]T,
+    crs: usize,
+    ccs: usize,
+) void {
+    if (N) |size| {
+        // op(A) is packed transposed and op(B) as is, so that every element
+        // of the product is a dot product of two contiguous columns.
+        var at: [size * size]T = undefined;
+        var bp: [size * size]T = undefined;
+        pack(T, size, transa, true, a, ars, acs, &at);
+        pack(T, size, transb, false, b, brs, bcs, &bp);
+
+        for (0..size) |j| {
+            for (0..size) |i| {
+                var s: T = zero(T);
+                for (0..size) |l|
+                    s = add(T, s, mul(T, at[l + i * size], bp[l + j * size]));
+
+                c[i * crs + j * ccs] = combine(T, alpha, s, beta, c[i * crs + j * ccs]);
+            }
+        }
+
+        return;
+    }
+
+    // Strides of op(A) and op(B).
+    const sa: [2]usize = if (transa == .no_trans or transa == .conj_no_trans) .{ ars, acs } else .{ acs, ars };
+    const sb: [2]usize = if (transb == .no_trans or transb == .conj_no_trans) .{ brs, bcs } else .{ bcs, brs };
+    const ca: bool = isComplex(T) and (transa == .conj_trans or transa == .conj_no_trans);
+    const cb: bool = isComplex(T) and (transb == .conj_trans or transb == .conj_no_trans);
+
+    for (0..n) |j| {
+        for (0..m) |i| {
+            var s: T = zero(T);
+            for (0..k) |l| {
+                const x: T = a[i * sa[0] + l * sa[1]];
+                const y: T = b[l * sb[0] + j * sb[1]];
+                s = add(T, s, mul(T, if (ca) conj(T, x) else x, if (cb) conj(T, y) else y));
+            }
+
+            c[i * crs + j * ccs] = combine(T, alpha, s, beta, c[i * crs + j * ccs]);
+        }
+    }
+}
+
+/// Copies `op(X)`, `size × size`, to the column-major `dst`, transposed if
+/// `transposed`.
+inline fn pack(comptime T: type, comptime size: u32, trans: Transpose, comptime transposed: bool, x: [*]const T, rs: usize, cs: usize, dst: *[size * size]T) void {
+    const swap: bool = (trans == .trans or trans == .conj_trans) != transposed;
+    const conjugate: bool = trans == .conj_trans or trans == .conj_no_trans;
+
+    for (0..size) |j| {
+        for (0..size) |i| {
+            const v: T = if (swap) x[j * rs + i * cs] else x[i * rs + j * cs];
+            dst[i + j * size] = if (isComplex(T) and conjugate) conj(T, v) else v;
+        }
+    }
+}
+
+/// `alpha * s + beta * c`, without reading `c` when `beta` is zero.
+inline fn combine(comptime T: type, alpha: T, s: T, beta: T, c: T) T {
+    if (isZero(T, beta))
+        return mul(T, alpha, s);
+
+    return add(T, mul(T, alpha, s), mul(T, beta, c));
+}
+
+// LU factorization.
+
+/// Factors the `n × n` matrix `a` as `P * L * U` with partial pivoting.
+/// Returns `info` as `getrf`: 0, or the 1-based index of the first zero
+/// pivot.
+pub fn getrf(comptime T: type, comptime N: ?u32, n: u32, a: [*]T, rs: usize, cs: usize, ipiv: [*]i32) i32 {
+    if (N) |size| {
+        var local: [size * size]T = undefined;
+        copy(T, size, size, a, rs, cs, &local, 1, size);
+        const info: i32 = getf2(T, size, &local, 1, size, ipiv);
+        copy(T, size, size, &local, 1, size, a, rs, cs);
+
+        return info;
+    }
+
+    return getf2(T, n, a, rs, cs, ipiv);
+}
+
+inline fn getf2(comptime T: type, n: usize, a: [*]T, rs: usize, cs: usize, ipiv: [*]i32) i32 {
+    var info: i32 = 0;
+    for (0..n) |j| {
+        var p: usize = j;
+        var max: Real(T) = abs1(T, a[j * rs + j * cs]);
+        for (j + 1..n) |i| {
+            const v: Real(T) = abs1(T, a[i * rs + j * cs]);
+            if (v > max) {
+                max = v;
+                p = i;
+            }
+        }
+
+        ipiv[j] = @intCast(p + 1);
+
+        if (max != 0) {
+            if (p != j) {
+                for (0..n) |c|
+                    std.mem.swap(T, &a[j * rs + c * cs], &a[p * rs + c * cs]);
+            }
+
+            const r: T = div(T, one(T), a[j * rs + j * cs]);
+            for (j + 1..n) |i|
+                a[i * rs + j * cs] = mul(T, a[i * rs + j * cs], r);
+        } else if (info == 0) {
+            info = @intCast(j + 1);
+        }
+
+        for (j + 1..n) |c| {
+            const t: T = a[j * rs + c * cs];
+            if (isZero(T, t))
+                continue;
+
+            for (j + 1..n) |i|
+                a[i * rs + c * cs] = sub(T, a[i * rs + c * cs], mul(T, a[i * rs + j * cs], t));
+        }
+    }
+
+    return info;
+}
+
+/// Solves `op(A) * X = B` with the factorization from `getrf`, for `nrhs`
+/// right-hand sides.
+pub fn getrs(
+    comptime T: type,
+    comptime N: ?u32,
+    comptime trans: Transpose,
+    n: u32,
+    nrhs: u32,
+    a: [*]const T,
+    rs: usize,
+    cs: usize,
+    ipiv: [*]const i32,
+    b: [*]T,
+    brs: usize,
+    bcs: usize,
+) void {
+    if (N) |size| {
+        var local: [size * size]T = undefined;
+        copy(T, size, size, a, rs, cs, &local, 1, size);
+
+        return getrsIn(T, trans, size, nrhs, &local, 1, size, ipiv, b, brs, bcs);
+    }
+
+    return getrsIn(T, trans, n, nrhs, a, rs, cs, ipiv, b, brs, bcs);
+}
+
+inline fn getrsIn(
+    comptime T: type,
+    comptime trans: Transpose,
+    n: usize,
+    nrhs: usize,
+    a: [*]const T,
+    rs: usize,
+    cs: usize,
+    ipiv: [*]const i32,
+    b: [*]T,
+    brs: usize,
+    bcs: usize,
+) void {
+    if (trans == .no_trans) {
+        swapRows(T, n, nrhs, ipiv, false, b, brs, bcs);
+
+        for (0..nrhs) |c| {
+            const x: [*]T = b + c * bcs;
+
+            // Solve L * Y = B, L unit lower triangular.
+            for (0..n) |j| {
+                const t: T = x[j * brs];
+                if (isZero(T, t))
+                    continue;
+
+                for (j + 1..n) |i|
+                    x[i * brs] = sub(T, x[i * brs], mul(T, a[i * rs + j * cs], t));
+            }
+
+            // Solve U * X = Y.
+            var j: usize = n;
+            while (j > 0) {
+                j -= 1;
+                x[j * brs] = div(T, x[j * brs], a[j * rs + j * cs]);
+
+                const t: T = x[j * brs];
+                for (0..j) |i|
+                    x[i * brs] = sub(T, x[i * brs], mul(T, a[i * rs + j * cs], t));
+            }
+        }
+    } else {
+        const conjugate: bool = trans == .conj_trans;
+
+        for (0..nrhs) |c| {
+            const x: [*]T = b + c * bcs;
+
+            // Solve U^T * Z = B or U^H * Z = B.
+            for (0..n) |i| {
+                var s: T = x[i * brs];
+                for (0..i) |l|
+                    s = sub(T, s, mul(T, maybeConj(T, conjugate, a[l * rs + i * cs]), x[l * brs]));
+
+                x[i * brs] = div(T, s, maybeConj(T, conjugate, a[i * rs + i * cs]));
+            }
+
+            // Solve L^T * X = Z or L^H * X = Z, L unit lower triangular.
+            var i: usize = n;
+            while (i > 0) {
+                i -= 1;
+
+                var s: T = x[i * brs];
+                for (i + 1..n) |l|
+                    s = sub(T, s, mul(T, maybeConj(T, conjugate, a[l * rs + i * cs]), x[l * brs]));
+
+                x[i * brs] = s;
+            }
+        }
+
+        swapRows(T, n, nrhs, ipiv, true, b, brs, bcs);
+    }
+}
+
+/// Applies the row interchanges in `ipiv` to `b`, in reverse if `reverse`.
+inline fn swapRows(comptime T: type, n: usize, nrhs: usize, ipiv: [*]const i32, comptime reverse: bool, b: [*]T, brs: usize, bcs: usize) void {
+    for (0..n) |step| {
+        const i: usize = if (reverse) n - 1 - step else step;
+        const p: usize = @intCast(ipiv[i] - 1);
+        if (p == i)
+            continue;
+
+        for (0..nrhs) |c|
+            std.mem.swap(T, &b[i * brs + c * bcs], &b[p * brs + c * bcs]);
+    }
+}
+
+// Cholesky factorization.
+//
+// Both kernels work on the lower triangle. An upper triangle `U` is the
+// lower triangle of its (conjugate) transpose, so the callers swap `rs` and
+// `cs` and set `conjugate` for complex types: the elements are conjugated
+// when read and written, which turns `U^H * U` into `L * L^H`.
+
+/// Factors the Hermitian positive definite `n × n` matrix `a` as `L * L^H`.
+/// Returns `info` as `potrf`: 0, or the order of the first leading minor
+/// that is not positive definite.
+pub fn potrf(comptime T: type, comptime N: ?u32, comptime conjugate: bool, n: u32, a: [*]T, rs: usize, cs: usize) i32 {
+    if (N) |size| {
+        var local: [size * size]T = undefined;
+        copy(T, size, size, a, rs, cs, &local, 1, size);
+        const info: i32 = potf2(T, conjugate, size, &local, 1, size);
+        copy(T, size, size, &local, 1, size, a, rs, cs);
+
+        return info;
+    }
+
+    return potf2(T, conjugate, n, a, rs, cs);
+}
+
+inline fn potf2(comptime T: type, comptime conjugate: bool, n: usize, a: [*]T, rs: usize, cs: usize) i32 {
+    for (0..n) |j| {
+        var d: Real(T) = re(T, a[j * rs + j * cs]);
+        for (0..j) |l|
+            d -= abs2(T, a[j * rs + l * cs]);
+
+        if (!(d > 0)) {
+            a[j * rs + j * cs] = fromReal(T, d);
+            return @intCast(j + 1);
+        }
+
+        const ljj: Real(T) = @sqrt(d);
+        a[j * rs + j * cs] = fromReal(T, ljj);
+
+        const r: Real(T) = 1 / ljj;
+        for (j + 1..n) |i| {
+            var s: T = maybeConj(T, conjugate, a[i * rs + j * cs]);
+            for (0..j) |l|
+                s = sub(T, s, mul(T, maybeConj(T, conjugate, a[i * rs + l * cs]), maybeConj(T, !conjugate, a[j * rs + l * cs])));
+
+            a[i * rs + j * cs] = maybeConj(T, conjugate, scaleReal(T, s, r));
+        }
+    }
+
+    return 0;
+}
+
+/// Solves `A * X = B` with the factorization `L * L^H` from `potrf`, for
+/// `nrhs` right-hand sides.
+pub fn potrs(
+    comptime T: type,
+    comptime N: ?u32,
+    comptime conjugate: bool,
+    n: u32,
+    nrhs: u32,
+    a: [*]const T,
+    rs: usize,
+    cs: usize,
+    b: [*]T,
+    brs: usize,
+    bcs: usize,
+) void {
+    if (N) |size| {
+        var local: [size * size]T = undefined;
+        copy(T, size, size, a, rs, cs, &local, 1, size);
+
+        return potrsIn(T, conjugate, size, nrhs, &local, 1, size, b, brs, bcs);
+    }
+
+    return potrsIn(T, conjugate, n, nrhs, a, rs, cs, b, brs, bcs);
+}
+
+inline fn potrsIn(
+    comptime T: type,
+    comptime conjugate: bool,
+    n: usize,
+    nrhs: usize,
+    a: [*]const T,
+    rs: usize,
+    cs: usize,
+    b: [*]T,
+    brs: usize,
+    bcs: usize,
+) void {
+    for (0..nrhs) |c| {
+        const x: [*]T = b + c * bcs;
+
+        // Solve L * Y = B.
+        for (0..n) |i| {
+            var s: T = x[i * brs];
+            for (0..i) |l|
+                s = sub(T, s, mul(T, maybeConj(T, conjugate, a[i * rs + l * cs]), x[l * brs]));
+
+            x[i * brs] = scaleReal(T, s, 1 / re(T, a[i * rs + i * cs]));
+        }
+
+        // Solve L^H * X = Y.
+        var i: usize = n;
+        while (i > 0) {
+            i -= 1;
+
+            var s: T = x[i * brs];
+            for (i + 1..n) |l|
+                s = sub(T, s, mul(T, maybeConj(T, !conjugate, a[l * rs + i * cs]), x[l * brs]));
+
+            x[i * brs] = scaleReal(T, s, 1 / re(T, a[i * rs + i * cs]));
+        }
+    }
+}
+
+// QR factorization.
+
+/// Factors the `m × n` matrix `a` as `Q * R`, with `Q` represented as a
+/// product of `min(m, n)` elementary reflectors, as `geqrf`. `N`, if given,
+/// is `m` and `n`.
+pub fn geqrf(comptime T: type, comptime N: ?u32, m: u32, n: u32, a: [*]T, rs: usize, cs: usize, tau: [*]T) void {
+    if (N) |size| {
+        var local: [size * size]T = undefined;
+        copy(T, size, size, a, rs, cs, &local, 1, size);
+        geqr2(T, size, size, &local, 1, size, tau);
+        copy(T, size, size, &local, 1, size, a, rs, cs);
+
+        return;
+    }
+
+    geqr2(T, m, n, a, rs, cs, tau);
+}
+
+inline fn geqr2(comptime T: type, m: usize, n: usize, a: [*]T, rs: usize, cs: usize, tau: [*]T) void {
+    const R: type = Real(T);
+
+    for (0..@min(m, n)) |i| {
+        const d: usize = i * rs + i * cs;
+
+        // Generate the reflector H(i) annihilating a[i + 1..m, i], as larfg.
+        var alpha: T = a[d];
+        var xnorm: R = norm(T, m - i - 1, a + d + rs, rs);
+
+        if (xnorm == 0 and im(T, alpha) == 0) {
+            tau[i] = zero(T);
+            continue;
+        }
+
+        var beta: R = -std.math.copysign(hypot3(R, re(T, alpha), im(T, alpha), xnorm), re(T, alpha));
+
+        // beta and xnorm may be inaccurate; scale x and recompute them.
+        const safmin: R = std.math.floatMin(R) / std.math.floatEps(R);
+        var knt: usize = 0;
+        if (@abs(beta) < safmin) {
+            while (@abs(beta) < safmin and knt < 20) : (knt += 1) {
+                for (i + 1..m) |r|
+                    a[r * rs + i * cs] = scaleReal(T, a[r * rs + i * cs], 1 / safmin);
+
+                beta /= safmin;
+                alpha = scaleReal(T, alpha, 1 / safmin);
+            }
+
+            xnorm = norm(T, m - i - 1, a + d + rs, rs);
+            beta = -std.math.copysign(hypot3(R, re(T, alpha), im(T, alpha), xnorm), re(T, alpha));
+        }
+
+        tau[i] = if (comptime isComplex(T))
+            .{ .re = (beta - alpha.re) / beta, .im = -alpha.im / beta }
+        else
+            (beta - alpha) / beta;
+
+        const scal: T = div(T, one(T), sub(T, alpha, fromReal(T, beta)));
+        for (i + 1..m) |r|
+            a[r * rs + i * cs] = mul(T, a[r * rs + i * cs], scal);
+
+        for (0..knt) |_|
+            beta *= safmin;
+
+        a[d] = fromReal(T, beta);
+
+        // Apply H(i)^H = I - conj(tau) * v * v^H to a[i..m, i + 1..n], with
+        // v = (1, a[i + 1..m, i]).
+        const t: T = conj(T, tau[i]);
+        for (i + 1..n) |c| {
+            var w: T = a[i * rs + c * cs];
+            for (i + 1..m) |r|
+                w = add(T, w, mul(T, conj(T, a[r * rs + i * cs]), a[r * rs + c * cs]));
+
+            w = mul(T, t, w);
+            a[i * rs + c * cs] = sub(T, a[i * rs + c * cs], w);
+            for (i + 1..m) |r|
+                a[r * rs + c * cs] = sub(T, a[r * rs + c * cs], mul(T, a[r * rs + i * cs], w));
+        }
+    }
+}
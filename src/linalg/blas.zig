@@ -15,6 +15,8 @@ const linalg = @import("../linalg.zig");
 
 const ci = @import("../c.zig").c;
 
+const pool = @import("../pool.zig");
+
 const Order = types.Order;
 const Transpose = linalg.Transpose;
 const Uplo = types.Uplo;
@@ -13853,6 +13855,10 @@ pub inline fn ztrsv(
 /// If the `link_cblas` option is not `null`, the function will try to call the
 /// corresponding CBLAS function, if available. In that case, no errors will be
 /// raised even if the arguments are invalid.
+///
+/// For `f32`, `f64`, `cf32` and `cf64` operands, large problems are split over
+/// a pool, as set by the `pool` and `scratch` fields of `ctx` (see
+/// `zml.pool`).
 pub inline fn gemm(
     order: Order,
     transa: Transpose,
@@ -13918,7 +13924,7 @@ pub inline fn gemm(
         // When implemented, expand if
         @compileError("zml.linalg.blas.gemm not implemented for arbitrary precision types yet");
     } else {
-        types.validateContext(@TypeOf(ctx), .{});
+        types.validateContext(@TypeOf(ctx), pool.parallel_context);
     };
 
     if (comptime A == B and A == C and types.canCoerce(Al, A) and types.canCoerce(Be, A) and options.link_cblas != null) {
@@ -13945,7 +13951,10 @@ pub inline fn gemm(
         }
     }
 
-    return @import("blas/gemm.zig").gemm(order, transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, ctx);
+    const scope: pool.Scope = pool.enterContext(ctx);
+    defer scope.leave();
+
+    return @import("blas/gemm.zig").gemm(order, transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, types.stripStructFields(ctx, &.{ "pool", "scratch" }));
 }
 
 /// Computes a matrix-matrix product with general matrices.
@@ -14550,6 +14559,10 @@ pub inline fn gemmtr(
 /// If the `link_cblas` option is not `null`, the function will try to call the
 /// corresponding CBLAS function, if available. In that case, no errors will be
 /// raised even if the arguments are invalid.
+///
+/// For `f32`, `f64`, `cf32` and `cf64` operands, large problems are split over
+/// a pool, as set by the `pool` and `scratch` fields of `ctx` (see
+/// `zml.pool`).
 pub inline fn hemm(
     order: Order,
     side: Side,
@@ -14614,7 +14627,7 @@ pub inline fn hemm(
         // When implemented, expand if
         @compileError("zml.linalg.blas.hemm not implemented for arbitrary precision types yet");
     } else {
-        types.validateContext(@TypeOf(ctx), .{});
+        types.validateContext(@TypeOf(ctx), pool.parallel_context);
     };
 
     if (comptime A == B and A == C and types.canCoerce(Al, A) and types.canCoerce(Be, A) and options.link_cblas != null) {
@@ -14634,7 +14647,10 @@ pub inline fn hemm(
         }
     }
 
-    return @import("blas/hemm.zig").hemm(order, side, uplo, m, n, alpha, a, lda, b, ldb, beta, c, ldc, ctx);
+    const scope: pool.Scope = pool.enterContext(ctx);
+    defer scope.leave();
+
+    return @import("blas/hemm.zig").hemm(order, side, uplo, m, n, alpha, a, lda, b, ldb, beta, c, ldc, types.stripStructFields(ctx, &.{ "pool", "scratch" }));
 }
 
 /// Computes a matrix-matrix product where one input matrix is Hermitian.
@@ -15633,6 +15649,10 @@ pub inline fn zher2k(
 /// If the `link_cblas` option is not `null`, the function will try to call the
 /// corresponding CBLAS function, if available. In that case, no errors will be
 /// raised even if the arguments are invalid.
+///
+/// For `f32`, `f64`, `cf32` and `cf64` operands, large problems are split over
+/// a pool, as set by the `pool` and `scratch` fields of `ctx` (see
+/// `zml.pool`).
 pub inline fn symm(
     order: Order,
     side: Side,
@@ -15697,7 +15717,7 @@ pub inline fn symm(
         // When implemented, expand if
         @compileError("zml.linalg.blas.symm not implemented for arbitrary precision types yet");
     } else {
-        types.validateContext(@TypeOf(ctx), .{});
+        types.validateContext(@TypeOf(ctx), pool.parallel_context);
     };
 
     if (comptime A == B and A == C and types.canCoerce(Al, A) and types.canCoerce(Be, A) and options.link_cblas != null) {
@@ -15724,7 +15744,10 @@ pub inline fn symm(
         }
     }
 
-    return @import("blas/symm.zig").symm(order, side, uplo, m, n, alpha, a, lda, b, ldb, beta, c, ldc, ctx);
+    const scope: pool.Scope = pool.enterContext(ctx);
+    defer scope.leave();
+
+    return @import("blas/symm.zig").symm(order, side, uplo, m, n, alpha, a, lda, b, ldb, beta, c, ldc, types.stripStructFields(ctx, &.{ "pool", "scratch" }));
 }
 
 /// Computes a matrix-matrix product where one input matrix is symmetric.
@@ -16175,6 +16198,10 @@ pub inline fn zsymm(
 /// If the `link_cblas` option is not `null`, the function will try to call the
 /// corresponding CBLAS function, if available. In that case, no errors will be
 /// raised even if the arguments are invalid.
+///
+/// For `f32`, `f64`, `cf32` and `cf64` operands, large problems are split over
+/// a pool, as set by the `pool` and `scratch` fields of `ctx` (see
+/// `zml.pool`).
 pub inline fn syrk(
     order: Order,
     uplo: Uplo,
@@ -16227,7 +16254,7 @@ pub inline fn syrk(
         // When implemented, expand if
         @compileError("zml.linalg.blas.syrk not implemented for arbitrary precision types yet");
     } else {
-        types.validateContext(@TypeOf(ctx), .{});
+        types.validateContext(@TypeOf(ctx), pool.parallel_context);
     };
 
     if (comptime A == C and types.canCoerce(Al, A) and types.canCoerce(Be, A) and options.link_cblas != null) {
@@ -16254,7 +16281,10 @@ pub inline fn syrk(
         }
     }
 
-    return @import("blas/syrk.zig").syrk(order, uplo, trans, n, k, alpha, a, lda, beta, c, ldc, ctx);
+    const scope: pool.Scope = pool.enterContext(ctx);
+    defer scope.leave();
+
+    return @import("blas/syrk.zig").syrk(order, uplo, trans, n, k, alpha, a, lda, beta, c, ldc, types.stripStructFields(ctx, &.{ "pool", "scratch" }));
 }
 
 /// Performs a symmetric rank-`k` update.
@@ -17284,6 +17314,10 @@ pub inline fn zsyr2k(
 /// If the `link_cblas` option is not `null`, the function will try to call the
 /// corresponding CBLAS function, if available. In that case, no errors will be
 /// raised even if the arguments are invalid.
+///
+/// For `f32`, `f64`, `cf32` and `cf64` operands, large problems are split over
+/// a pool, as set by the `pool` and `scratch` fields of `ctx` (see
+/// `zml.pool`).
 pub inline fn trmm(
     order: Order,
     side: Side,
@@ -17329,7 +17363,7 @@ pub inline fn trmm(
         // When implemented, expand if
         @compileError("zml.linalg.blas.trmm not implemented for arbitrary precision types yet");
     } else {
-        types.validateContext(@TypeOf(ctx), .{});
+        types.validateContext(@TypeOf(ctx), pool.parallel_context);
     };
 
     if (comptime A == B and types.canCoerce(Al, A) and options.link_cblas != null) {
@@ -17354,7 +17388,10 @@ pub inline fn trmm(
         }
     }
 
-    return @import("blas/trmm.zig").trmm(order, side, uplo, transa, diag, m, n, alpha, a, lda, b, ldb, ctx);
+    const scope: pool.Scope = pool.enterContext(ctx);
+    defer scope.leave();
+
+    return @import("blas/trmm.zig").trmm(order, side, uplo, transa, diag, m, n, alpha, a, lda, b, ldb, types.stripStructFields(ctx, &.{ "pool", "scratch" }));
 }
 
 /// Computes a matrix-matrix product where one input matrix is triangular.
@@ -17810,6 +17847,10 @@ pub inline fn ztrmm(
 /// If the `link_cblas` option is not `null`, the function will try to call the
 /// corresponding CBLAS function, if available. In that case, no errors will be
 /// raised even if the arguments are invalid.
+///
+/// For `f32`, `f64`, `cf32` and `cf64` operands, large problems are split over
+/// a pool, as set by the `pool` and `scratch` fields of `ctx` (see
+/// `zml.pool`).
 pub inline fn trsm(
     order: Order,
     side: Side,
@@ -17855,7 +17896,7 @@ pub inline fn trsm(
         // When implemented, expand if
         @compileError("zml.linalg.blas.trsm not implemented for arbitrary precision types yet");
     } else {
-        types.validateContext(@TypeOf(ctx), .{});
+        types.validateContext(@TypeOf(ctx), pool.parallel_context);
     };
 
     if (comptime A == B and types.canCoerce(Al, A) and options.link_cblas != null) {
@@ -17880,7 +17921,10 @@ pub inline fn trsm(
         }
     }
 
-    return @import("blas/trsm.zig").trsm(order, side, uplo, transa, diag, m, n, alpha, a, lda, b, ldb, ctx);
+    const scope: pool.Scope = pool.enterContext(ctx);
+    defer scope.leave();
+
+    return @import("blas/trsm.zig").trsm(order, side, uplo, transa, diag, m, n, alpha, a, lda, b, ldb, types.stripStructFields(ctx, &.{ "pool", "scratch" }));
 }
 
 /// Solves a triangular matrix equation.
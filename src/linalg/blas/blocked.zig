@@ -0,0 +1,1252 @@
+//! Packed, cache-blocked level 3 engine for the native float and cfloat
+//! types.
+//!
+//! The reference level 3 routines work element by element through `ops`,
+//! which keeps them generic over every numeric type but leaves the vector
+//! units idle. For `f32`, `f64`, `cf32` and `cf64` the routines in this file
+//! follow the usual GotoBLAS/BLIS structure instead: `op(B)` is packed into
+//! `kc × nc` panels, `op(A)` into `mc × kc` panels, and a register-tiled
+//! `mr × nr` microkernel built on `@Vector` accumulates the products. `symm`,
+//! `hemm`, `syrk`, `trmm` and `trsm` are expressed on top of the same engine
+//! so they share the microkernel.
+//!
+//! When a pool is available (see `pool.current`) and the problem is large
+//! enough, the work is split into independent pieces that run in parallel,
+//! each with its own packing buffers: `gemm`, `symm` and `hemm` cut `C` into
+//! a 2D grid of tiles, `syrk` distributes the block columns of `C`, and
+//! `trmm` and `trsm` cut `B` along the dimension they treat independently.
+//!
+//! All routines here assume column-major storage and already validated
+//! arguments; the `k_*` kernels in the sibling files handle the row-major
+//! mapping and argument checking before dispatching here.
+
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const scast = types.scast;
+const cfloat = @import("../../cfloat.zig");
+const cf32 = cfloat.cf32;
+const cf64 = cfloat.cf64;
+
+const pool = @import("../../pool.zig");
+const Pool = pool.Pool;
+const scratch = @import("../../scratch.zig");
+
+const linalg = @import("../../linalg.zig");
+const Transpose = linalg.Transpose;
+const Side = linalg.Side;
+const Uplo = types.Uplo;
+const Diag = types.Diag;
+
+/// Minimum `m * n * k` for which packing pays off. Smaller problems stay on
+/// the reference path.
+pub const threshold: u64 = 48 * 48 * 48;
+
+/// Size of the diagonal blocks used by the blocked `syrk`, `trmm` and `trsm`.
+const block_size: usize = 64;
+
+/// Checks whether `T` has a packed implementation.
+pub inline fn isSupported(comptime T: type) bool {
+    return T == f32 or T == f64 or T == cf32 or T == cf64;
+}
+
+/// Checks whether a problem of the given dimensions is large enough to be
+/// worth packing.
+pub inline fn worthwhile(m: i32, n: i32, k: i32) bool {
+    return scast(u64, m) * scast(u64, n) * scast(u64, k) >= threshold;
+}
+
+inline fn isComplex(comptime T: type) bool {
+    return T == cf32 or T == cf64;
+}
+
+fn Real(comptime T: type) type {
+    return if (comptime isComplex(T)) types.Scalar(T) else T;
+}
+
+/// Blocking parameters for the engine.
+pub const Blocking = struct {
+    /// Vector length, in scalars.
+    vl: usize,
+    /// Rows of the microtile.
+    mr: usize,
+    /// Columns of the microtile.
+    nr: usize,
+    /// Rows of a packed `A` block, sized to stay resident in L2.
+    mc: usize,
+    /// Depth of the packed panels.
+    kc: usize,
+    /// Columns of a packed `B` block, sized to stay resident in L3.
+    nc: usize,
+};
+
+pub fn blocking(comptime T: type) Blocking {
+    const R: type = Real(T);
+    const vl: usize = std.simd.suggestVectorLength(R) orelse 16 / @sizeOf(R);
+    const l2: usize = 256 * 1024;
+    const l3: usize = 4 * 1024 * 1024;
+    const kc: usize = 256;
+
+    // Complex tiles keep separate real and imaginary accumulators, so they
+    // use half the rows to fit the same register budget.
+    const mr: usize = if (comptime isComplex(T)) vl else 2 * vl;
+    const nr: usize = if (comptime isComplex(T)) 4 else 6;
+
+    return .{
+        .vl = vl,
+        .mr = mr,
+        .nr = nr,
+        .mc = @max(mr, (l2 / (kc * @sizeOf(T))) / mr * mr),
+        .kc = kc,
+        .nc = @max(nr, (l3 / (kc * @sizeOf(T))) / nr * nr),
+    };
+}
+
+/// Shape of the matrix read through an `Operand`.
+pub const Kind = enum {
+    general,
+    symmetric,
+    hermitian,
+    triangular,
+};
+
+/// Read-only view of `op(X)` for a column-major matrix `X`. `get(i, j)`
+/// returns element `(i, j)` of `op(X)`, resolving transposition,
+/// conjugation, the mirrored half of symmetric and hermitian matrices and
+/// the implicit zeros and unit diagonal of triangular matrices.
+pub fn Operand(comptime T: type) type {
+    return struct {
+        ptr: [*]const T,
+        ld: usize,
+        trans: bool = false,
+        conj: bool = false,
+        kind: Kind = .general,
+        upper: bool = true,
+        unit: bool = false,
+        row: usize = 0,
+        col: usize = 0,
+
+        const Self = @This();
+
+        pub fn init(ptr: [*]const T, ld: i32, trans: Transpose) Self {
+            return .{
+                .ptr = ptr,
+                .ld = scast(usize, ld),
+                .trans = trans == .trans or trans == .conj_trans,
+                .conj = trans == .conj_trans or trans == .conj_no_trans,
+            };
+        }
+
+        /// Returns the view of `op(X)[i.., j..]`.
+        pub inline fn view(self: Self, i: usize, j: usize) Self {
+            var result: Self = self;
+            result.row += i;
+            result.col += j;
+            return result;
+        }
+
+        pub inline fn get(self: Self, i: usize, j: usize) T {
+            var si: usize = if (self.trans) self.col + j else self.row + i;
+            var sj: usize = if (self.trans) self.row + i else self.col + j;
+            var conjugate: bool = self.conj;
+
+            switch (self.kind) {
+                .general => {},
+                .symmetric, .hermitian => {
+                    if ((self.upper and si > sj) or (!self.upper and si < sj)) {
+                        std.mem.swap(usize, &si, &sj);
+
+                        if (self.kind == .hermitian)
+                            conjugate = !conjugate;
+                    }
+
+                    if (comptime isComplex(T)) {
+                        if (self.kind == .hermitian and si == sj)
+                            return .{ .re = self.ptr[si + sj * self.ld].re, .im = 0 };
+                    }
+                },
+                .triangular => {
+                    if ((self.upper and si > sj) or (!self.upper and si < sj))
+                        return zero(T);
+
+                    if (self.unit and si == sj)
+                        return one(T);
+                },
+            }
+
+            const value: T = self.ptr[si + sj * self.ld];
+            return if (conjugate) conj(T, value) else value;
+        }
+    };
+}
+
+/// Packing buffers for the engine, plus an optional scratch buffer used by
+/// the triangular routines. Allocating them up front lets the blocked
+/// routines fall back to the reference path on `OutOfMemory` before `C` has
+/// been touched.
+pub fn Workspace(comptime T: type) type {
+    return struct {
+        apack: []align(64) Real(T),
+        bpack: []align(64) Real(T),
+        tmp: []T,
+
+        const Self = @This();
+
+        /// Allocates buffers for products with at most `m` rows and `n`
+        /// columns, and `tmp_len` elements of scratch.
+        pub fn init(allocator: std.mem.Allocator, m: usize, n: usize, tmp_len: usize) !Self {
+            const bk: Blocking = comptime blocking(T);
+            const w: usize = if (comptime isComplex(T)) 2 else 1;
+            const mc: usize = roundUp(@min(bk.mc, @max(m, 1)), bk.mr);
+            const nc: usize = roundUp(@min(bk.nc, @max(n, 1)), bk.nr);
+
+            const apack = try allocator.alignedAlloc(Real(T), .@"64", mc * bk.kc * w);
+            errdefer allocator.free(apack);
+
+            const bpack = try allocator.alignedAlloc(Real(T), .@"64", bk.kc * nc * w);
+            errdefer allocator.free(bpack);
+
+            const tmp = try allocator.alloc(T, tmp_len);
+
+            return .{
+                .apack = apack,
+                .bpack = bpack,
+                .tmp = tmp,
+            };
+        }
+
+        pub fn deinit(self: *Self, allocator: std.mem.Allocator) void {
+            allocator.free(self.apack);
+            allocator.free(self.bpack);
+            allocator.free(self.tmp);
+            self.* = undefined;
+        }
+    };
+}
+
+// Scalar helpers. The engine only ever sees the four native types, so these
+// avoid the generality (and the error unions) of `ops`.
+
+inline fn zero(comptime T: type) T {
+    return if (comptime isComplex(T)) .{ .re = 0, .im = 0 } else 0;
+}
+
+inline fn one(comptime T: type) T {
+    return if (comptime isComplex(T)) .{ .re = 1, .im = 0 } else 1;
+}
+
+inline fn isZero(comptime T: type, x: T) bool {
+    return if (comptime isComplex(T)) x.re == 0 and x.im == 0 else x == 0;
+}
+
+inline fn isOne(comptime T: type, x: T) bool {
+    return if (comptime isComplex(T)) x.re == 1 and x.im == 0 else x == 1;
+}
+
+inline fn add(comptime T: type, x: T, y: T) T {
+    return if (comptime isComplex(T)) x.add(y) else x + y;
+}
+
+inline fn sub(comptime T: type, x: T, y: T) T {
+    return if (comptime isComplex(T)) x.sub(y) else x - y;
+}
+
+inline fn mul(comptime T: type, x: T, y: T) T {
+    return if (comptime isComplex(T)) x.mul(y) else x * y;
+}
+
+inline fn div(comptime T: type, x: T, y: T) T {
+    return if (comptime isComplex(T)) x.div(y) else x / y;
+}
+
+inline fn conj(comptime T: type, x: T) T {
+    return if (comptime isComplex(T)) x.conj() else x;
+}
+
+inline fn neg(comptime T: type, x: T) T {
+    return if (comptime isComplex(T)) x.neg() else -x;
+}
+
+/// Computes `c = beta * c` for an `m × n` block, without reading `c` when
+/// `beta` is zero.
+fn scale(comptime T: type, m: usize, n: usize, beta: T, c: [*]T, ldc: usize) void {
+    if (isOne(T, beta))
+        return;
+
+    var j: usize = 0;
+    while (j < n) : (j += 1) {
+        const col: [*]T = c + j * ldc;
+
+        if (isZero(T, beta)) {
+            @memset(col[0..m], zero(T));
+        } else {
+            var i: usize = 0;
+            while (i < m) : (i += 1) {
+                col[i] = mul(T, beta, col[i]);
+            }
+        }
+    }
+}
+
+/// Packs `op(A)[ic..ic + mc, pc..pc + kc]` into `mr`-row panels. Each panel
+/// stores, for every `p`, `mr` real parts followed (for complex types) by
+/// `mr` imaginary parts. Rows past `mc` are zero-padded.
+fn packA(comptime T: type, mc: usize, kc: usize, a: Operand(T), ic: usize, pc: usize, buffer: [*]Real(T)) void {
+    const bk: Blocking = comptime blocking(T);
+    const w: usize = if (comptime isComplex(T)) 2 else 1;
+
+    var dst: [*]Real(T) = buffer;
+    var ir: usize = 0;
+    while (ir < mc) : (ir += bk.mr) {
+        const mr: usize = @min(bk.mr, mc - ir);
+
+        var p: usize = 0;
+        while (p < kc) : (p += 1) {
+            if (a.kind == .general and !a.trans and !a.conj) {
+                // Contiguous column of A: the common case.
+                const src: [*]const T = a.ptr + (a.row + ic + ir) + (a.col + pc + p) * a.ld;
+
+                var i: usize = 0;
+                while (i < mr) : (i += 1) {
+                    if (comptime isComplex(T)) {
+                        dst[i] = src[i].re;
+                        dst[bk.mr + i] = src[i].im;
+                    } else {
+                        dst[i] = src[i];
+                    }
+                }
+            } else {
+                var i: usize = 0;
+                while (i < mr) : (i += 1) {
+                    const value: T = a.get(ic + ir + i, pc + p);
+
+                    if (comptime isComplex(T)) {
+                        dst[i] = value.re;
+                        dst[bk.mr + i] = value.im;
+                    } else {
+                        dst[i] = value;
+                    }
+                }
+            }
+
+            var i: usize = mr;
+            while (i < bk.mr) : (i += 1) {
+                dst[i] = 0;
+                if (comptime isComplex(T))
+                    dst[bk.mr + i] = 0;
+            }
+
+            dst += bk.mr * w;
+        }
+    }
+}
+
+/// Packs `op(B)[pc..pc + kc, jc..jc + nc]` into `nr`-column panels, with the
+/// same real/imaginary split as `packA`. Columns past `nc` are zero-padded.
+fn packB(comptime T: type, kc: usize, nc: usize, b: Operand(T), pc: usize, jc: usize, buffer: [*]Real(T)) void {
+    const bk: Blocking = comptime blocking(T);
+    const w: usize = if (comptime isComplex(T)) 2 else 1;
+
+    var dst: [*]Real(T) = buffer;
+    var jr: usize = 0;
+    while (jr < nc) : (jr += bk.nr) {
+        const nr: usize = @min(bk.nr, nc - jr);
+
+        var p: usize = 0;
+        while (p < kc) : (p += 1) {
+            if (b.kind == .general and b.trans and !b.conj) {
+                // Contiguous row of op(B) = B^T.
+                const src: [*]const T = b.ptr + (b.col + jc + jr) + (b.row + pc + p) * b.ld;
+
+                var j: usize = 0;
+                while (j < nr) : (j += 1) {
+                    if (comptime isComplex(T)) {
+                        dst[j] = src[j].re;
+                        dst[bk.nr + j] = src[j].im;
+                    } else {
+                        dst[j] = src[j];
+                    }
+                }
+            } else {
+                var j: usize = 0;
+                while (j < nr) : (j += 1) {
+                    const value: T = b.get(pc + p, jc + jr + j);
+
+                    if (comptime isComplex(T)) {
+                        dst[j] = value.re;
+                        dst[bk.nr + j] = value.im;
+                    } else {
+                        dst[j] = value;
+                    }
+                }
+            }
+
+            var j: usize = nr;
+            while (j < bk.nr) : (j += 1) {
+                dst[j] = 0;
+                if (comptime isComplex(T))
+                    dst[bk.nr + j] = 0;
+            }
+
+            dst += bk.nr * w;
+        }
+    }
+}
+
+/// Multiplies an `mr × kc` packed panel of `A` by a `kc × nr` packed panel of
+/// `B`, and adds `alpha` times the result to the `mr_eff × nr_eff` corner of
+/// the tile at `c`.
+fn microkernel(
+    comptime T: type,
+    kc: usize,
+    ap: [*]const Real(T),
+    bp: [*]const Real(T),
+    alpha: T,
+    c: [*]T,
+    ldc: usize,
+    mr_eff: usize,
+    nr_eff: usize,
+) void {
+    @setFloatMode(.optimized);
+
+    const R: type = Real(T);
+    const bk: Blocking = comptime blocking(T);
+    const V = @Vector(bk.vl, R);
+    const nv: usize = bk.mr / bk.vl;
+
+    var a: [*]const R = ap;
+    var b: [*]const R = bp;
+
+    if (comptime !isComplex(T)) {
+        var acc: [bk.nr][nv]V = undefined;
+        inline for (0..bk.nr) |j| {
+            inline for (0..nv) |v| {
+                acc[j][v] = @splat(0);
+            }
+        }
+
+        var p: usize = 0;
+        while (p < kc) : (p += 1) {
+            var av: [nv]V = undefined;
+            inline for (0..nv) |v| {
+                av[v] = a[v * bk.vl ..][0..bk.vl].*;
+            }
+
+            inline for (0..bk.nr) |j| {
+                const bv: V = @splat(b[j]);
+                inline for (0..nv) |v| {
+                    acc[j][v] += av[v] * bv;
+                }
+            }
+
+            a += bk.mr;
+            b += bk.nr;
+        }
+
+        var tile: [bk.nr][bk.mr]R = undefined;
+        inline for (0..bk.nr) |j| {
+            inline for (0..nv) |v| {
+                tile[j][v * bk.vl ..][0..bk.vl].* = acc[j][v];
+            }
+        }
+
+        var j: usize = 0;
+        while (j < nr_eff) : (j += 1) {
+            const col: [*]T = c + j * ldc;
+
+            var i: usize = 0;
+            while (i < mr_eff) : (i += 1) {
+                col[i] += alpha * tile[j][i];
+            }
+        }
+    } else {
+        var acc_re: [bk.nr][nv]V = undefined;
+        var acc_im: [bk.nr][nv]V = undefined;
+        inline for (0..bk.nr) |j| {
+            inline for (0..nv) |v| {
+                acc_re[j][v] = @splat(0);
+                acc_im[j][v] = @splat(0);
+            }
+        }
+
+        var p: usize = 0;
+        while (p < kc) : (p += 1) {
+            var ar: [nv]V = undefined;
+            var ai: [nv]V = undefined;
+            inline for (0..nv) |v| {
+                ar[v] = a[v * bk.vl ..][0..bk.vl].*;
+                ai[v] = a[bk.mr + v * bk.vl ..][0..bk.vl].*;
+            }
+
+            inline for (0..bk.nr) |j| {
+                const br: V = @splat(b[j]);
+                const bi: V = @splat(b[bk.nr + j]);
+                inline for (0..nv) |v| {
+                    acc_re[j][v] += ar[v] * br - ai[v] * bi;
+                    acc_im[j][v] += ar[v] * bi + ai[v] * br;
+                }
+            }
+
+            a += 2 * bk.mr;
+            b += 2 * bk.nr;
+        }
+
+        var tile_re: [bk.nr][bk.mr]R = undefined;
+        var tile_im: [bk.nr][bk.mr]R = undefined;
+        inline for (0..bk.nr) |j| {
+            inline for (0..nv) |v| {
+                tile_re[j][v * bk.vl ..][0..bk.vl].* = acc_re[j][v];
+                tile_im[j][v * bk.vl ..][0..bk.vl].* = acc_im[j][v];
+            }
+        }
+
+        var j: usize = 0;
+        while (j < nr_eff) : (j += 1) {
+            const col: [*]T = c + j * ldc;
+
+            var i: usize = 0;
+            while (i < mr_eff) : (i += 1) {
+                const re: R = tile_re[j][i];
+                const im: R = tile_im[j][i];
+                col[i].re += alpha.re * re - alpha.im * im;
+                col[i].im += alpha.re * im + alpha.im * re;
+            }
+        }
+    }
+}
+
+/// Runs the microkernel over every tile of a packed `mc × kc` block of `A`
+/// and a packed `kc × nc` block of `B`.
+fn macrokernel(
+    comptime T: type,
+    mc: usize,
+    nc: usize,
+    kc: usize,
+    alpha: T,
+    ap: [*]const Real(T),
+    bp: [*]const Real(T),
+    c: [*]T,
+    ldc: usize,
+) void {
+    const bk: Blocking = comptime blocking(T);
+    const w: usize = if (comptime isComplex(T)) 2 else 1;
+
+    var jr: usize = 0;
+    while (jr < nc) : (jr += bk.nr) {
+        const nr: usize = @min(bk.nr, nc - jr);
+
+        var ir: usize = 0;
+        while (ir < mc) : (ir += bk.mr) {
+            const mr: usize = @min(bk.mr, mc - ir);
+
+            microkernel(
+                T,
+                kc,
+                ap + ir * kc * w,
+                bp + jr * kc * w,
+                alpha,
+                c + ir + jr * ldc,
+                ldc,
+                mr,
+                nr,
+            );
+        }
+    }
+}
+
+/// Computes `C = alpha * op(A) * op(B) + beta * C` for an `m × n` block `C`,
+/// with `op(A)` and `op(B)` given as operands of inner dimension `k`.
+pub fn gemmPacked(
+    comptime T: type,
+    ws: *const Workspace(T),
+    m: usize,
+    n: usize,
+    k: usize,
+    alpha: T,
+    a: Operand(T),
+    b: Operand(T),
+    beta: T,
+    c: [*]T,
+    ldc: usize,
+) void {
+    const bk: Blocking = comptime blocking(T);
+
+    scale(T, m, n, beta, c, ldc);
+
+    if (m == 0 or n == 0 or k == 0 or isZero(T, alpha))
+        return;
+
+    var jc: usize = 0;
+    while (jc < n) : (jc += bk.nc) {
+        const nc: usize = @min(bk.nc, n - jc);
+
+        var pc: usize = 0;
+        while (pc < k) : (pc += bk.kc) {
+            const kc: usize = @min(bk.kc, k - pc);
+
+            packB(T, kc, nc, b, pc, jc, ws.bpack.ptr);
+
+            var ic: usize = 0;
+            while (ic < m) : (ic += bk.mc) {
+                const mc: usize = @min(bk.mc, m - ic);
+
+                packA(T, mc, kc, a, ic, pc, ws.apack.ptr);
+
+                macrokernel(T, mc, nc, kc, alpha, ws.apack.ptr, ws.bpack.ptr, c + ic + jc * ldc, ldc);
+            }
+        }
+    }
+}
+
+/// Minimum number of multiply-adds before a routine splits its work over
+/// the current pool.
+pub const parallel_threshold: u64 = 128 * 128 * 128;
+
+/// Returns the pool to spread a problem of `flops` multiply-adds over, or
+/// `null` if it should run on the calling thread.
+fn team(flops: u64) ?*Pool {
+    if (flops < parallel_threshold)
+        return null;
+
+    const current: *Pool = pool.current() orelse return null;
+    return if (current.size() > 1) current else null;
+}
+
+/// Calls `func(job, lane, index)` for every `index` in `0..count`, on
+/// `workers` if given.
+fn forEach(workers: ?*Pool, count: usize, job: anytype, comptime func: fn (@TypeOf(job), usize, usize) void) void {
+    if (workers) |p| {
+        p.parallelFor(count, job, func);
+        return;
+    }
+
+    var i: usize = 0;
+    while (i < count) : (i += 1) {
+        func(job, 0, i);
+    }
+}
+
+/// Allocates one workspace per lane, for products of at most `m × n`. The
+/// buffers come from `allocator`, the array of workspaces from `small`.
+fn allocWorkspaces(comptime T: type, allocator: std.mem.Allocator, lanes: usize, m: usize, n: usize, tmp: usize) ![]Workspace(T) {
+    const wss: []Workspace(T) = try small().alloc(Workspace(T), lanes);
+    errdefer small().free(wss);
+
+    var i: usize = 0;
+    errdefer for (wss[0..i]) |*ws| ws.deinit(allocator);
+
+    while (i < lanes) : (i += 1) {
+        wss[i] = try .init(allocator, m, n, tmp);
+    }
+
+    return wss;
+}
+
+fn freeWorkspaces(comptime T: type, allocator: std.mem.Allocator, wss: []Workspace(T)) void {
+    for (wss) |*ws| ws.deinit(allocator);
+    small().free(wss);
+}
+
+/// Allocator for the bookkeeping of a call: the current arena, or a general
+/// purpose allocator. `scratch.cache` rounds every block up to a page.
+inline fn small() std.mem.Allocator {
+    return scratch.allocator(std.heap.smp_allocator);
+}
+
+inline fn ceilDiv(a: usize, b: usize) usize {
+    return (a + b - 1) / b;
+}
+
+inline fn roundUp(a: usize, b: usize) usize {
+    return ceilDiv(a, b) * b;
+}
+
+/// Splits `len` independent rows or columns into chunks for `threads`
+/// threads, keeping each chunk a multiple of `granule` and wide enough for
+/// the packed kernels to be efficient.
+fn chunkSize(len: usize, threads: usize, granule: usize) usize {
+    if (threads <= 1)
+        return @max(len, 1);
+
+    return @max(roundUp(ceilDiv(len, 2 * threads), granule), 4 * granule);
+}
+
+/// Tiling of an `m × n` output into `rows × cols` tiles of `tm × tn`.
+const Grid = struct {
+    tm: usize,
+    tn: usize,
+    rows: usize,
+    cols: usize,
+
+    /// Picks roughly square tiles, aligned to the microtile, so that there
+    /// are about four per thread.
+    fn init(comptime T: type, m: usize, n: usize, threads: usize) Grid {
+        const bk: Blocking = comptime blocking(T);
+
+        if (threads <= 1)
+            return .{ .tm = @max(m, 1), .tn = @max(n, 1), .rows = 1, .cols = 1 };
+
+        const target: f64 = @floatFromInt(4 * threads);
+        const ratio: f64 = @as(f64, @floatFromInt(@max(m, 1))) / @as(f64, @floatFromInt(@max(n, 1)));
+        const rows: usize = std.math.clamp(@as(usize, @intFromFloat(@round(@sqrt(target * ratio)))), 1, ceilDiv(@max(m, 1), bk.mr));
+        const cols: usize = std.math.clamp(ceilDiv(4 * threads, rows), 1, ceilDiv(@max(n, 1), bk.nr));
+
+        const tm: usize = roundUp(ceilDiv(@max(m, 1), rows), bk.mr);
+        const tn: usize = roundUp(ceilDiv(@max(n, 1), cols), bk.nr);
+
+        return .{
+            .tm = tm,
+            .tn = tn,
+            .rows = ceilDiv(@max(m, 1), tm),
+            .cols = ceilDiv(@max(n, 1), tn),
+        };
+    }
+};
+
+/// Computes `C = alpha * op(A) * op(B) + beta * C` for operands of any
+/// kind. With a pool available, `C` is split into a 2D grid of tiles that
+/// are computed independently, each with its own packing buffers.
+fn gemmOperands(
+    comptime T: type,
+    m: usize,
+    n: usize,
+    k: usize,
+    alpha: T,
+    a: Operand(T),
+    b: Operand(T),
+    beta: T,
+    c: [*]T,
+    ldc: usize,
+) !void {
+    const allocator: std.mem.Allocator = scratch.allocator(scratch.cache);
+
+    const workers: ?*Pool = team(scast(u64, m) * scast(u64, n) * scast(u64, k));
+    const grid: Grid = .init(T, m, n, if (workers) |p| p.size() else 1);
+    const count: usize = grid.rows * grid.cols;
+
+    const wss: []Workspace(T) = try allocWorkspaces(T, allocator, if (workers) |p| p.lanes(count) else 1, grid.tm, grid.tn, 0);
+    defer freeWorkspaces(T, allocator, wss);
+
+    const Job = struct {
+        wss: []Workspace(T),
+        grid: Grid,
+        m: usize,
+        n: usize,
+        k: usize,
+        alpha: T,
+        a: Operand(T),
+        b: Operand(T),
+        beta: T,
+        c: [*]T,
+        ldc: usize,
+
+        fn run(job: @This(), lane: usize, index: usize) void {
+            const i0: usize = (index / job.grid.cols) * job.grid.tm;
+            const j0: usize = (index % job.grid.cols) * job.grid.tn;
+
+            gemmPacked(
+                T,
+                &job.wss[lane],
+                @min(job.grid.tm, job.m - i0),
+                @min(job.grid.tn, job.n - j0),
+                job.k,
+                job.alpha,
+                job.a.view(i0, 0),
+                job.b.view(0, j0),
+                job.beta,
+                job.c + i0 + j0 * job.ldc,
+                job.ldc,
+            );
+        }
+    };
+
+    forEach(workers, count, Job{
+        .wss = wss,
+        .grid = grid,
+        .m = m,
+        .n = n,
+        .k = k,
+        .alpha = alpha,
+        .a = a,
+        .b = b,
+        .beta = beta,
+        .c = c,
+        .ldc = ldc,
+    }, Job.run);
+}
+
+/// Packed `gemm` on column-major storage.
+pub fn gemm(
+    comptime T: type,
+    transa: Transpose,
+    transb: Transpose,
+    m: i32,
+    n: i32,
+    k: i32,
+    alpha: T,
+    a: [*]const T,
+    lda: i32,
+    b: [*]const T,
+    ldb: i32,
+    beta: T,
+    c: [*]T,
+    ldc: i32,
+) !void {
+    return gemmOperands(
+        T,
+        scast(usize, m),
+        scast(usize, n),
+        scast(usize, k),
+        alpha,
+        .init(a, lda, transa),
+        .init(b, ldb, transb),
+        beta,
+        c,
+        scast(usize, ldc),
+    );
+}
+
+/// Packed `symm` (`kind = .symmetric`) or `hemm` (`kind = .hermitian`) on
+/// column-major storage.
+pub fn symm(
+    comptime T: type,
+    comptime kind: Kind,
+    side: Side,
+    uplo: Uplo,
+    m: i32,
+    n: i32,
+    alpha: T,
+    a: [*]const T,
+    lda: i32,
+    b: [*]const T,
+    ldb: i32,
+    beta: T,
+    c: [*]T,
+    ldc: i32,
+) !void {
+    var aop: Operand(T) = .init(a, lda, .no_trans);
+    aop.kind = kind;
+    aop.upper = uplo == .upper;
+    const bop: Operand(T) = .init(b, ldb, .no_trans);
+
+    if (side == .left) {
+        return gemmOperands(T, scast(usize, m), scast(usize, n), scast(usize, m), alpha, aop, bop, beta, c, scast(usize, ldc));
+    } else {
+        return gemmOperands(T, scast(usize, m), scast(usize, n), scast(usize, n), alpha, bop, aop, beta, c, scast(usize, ldc));
+    }
+}
+
+/// Packed `syrk` on column-major storage. Off-diagonal blocks of the `uplo`
+/// triangle of `C` are updated in place; diagonal blocks are computed into a
+/// scratch tile so the opposite triangle is never written. Block columns of
+/// `C` are independent and are spread over the current pool.
+pub fn syrk(
+    comptime T: type,
+    uplo: Uplo,
+    trans: Transpose,
+    n: i32,
+    k: i32,
+    alpha: T,
+    a: [*]const T,
+    lda: i32,
+    beta: T,
+    c: [*]T,
+    ldc: i32,
+) !void {
+    const allocator: std.mem.Allocator = scratch.allocator(scratch.cache);
+    const nn: usize = scast(usize, n);
+    const kk: usize = scast(usize, k);
+
+    const workers: ?*Pool = team(scast(u64, nn) * scast(u64, nn) * scast(u64, kk) / 2);
+    const count: usize = ceilDiv(nn, block_size);
+
+    const wss: []Workspace(T) = try allocWorkspaces(T, allocator, if (workers) |p| p.lanes(count) else 1, nn, @min(nn, block_size), block_size * block_size);
+    defer freeWorkspaces(T, allocator, wss);
+
+    const Job = struct {
+        wss: []Workspace(T),
+        uplo: Uplo,
+        n: usize,
+        k: usize,
+        alpha: T,
+        lop: Operand(T),
+        rop: Operand(T),
+        beta: T,
+        c: [*]T,
+        ldc: usize,
+
+        fn run(job: @This(), lane: usize, index: usize) void {
+            const ws: *const Workspace(T) = &job.wss[lane];
+            const tmp: []T = ws.tmp;
+            const j0: usize = index * block_size;
+            const nb: usize = @min(block_size, job.n - j0);
+
+            if (job.uplo == .upper) {
+                if (j0 > 0)
+                    gemmPacked(T, ws, j0, nb, job.k, job.alpha, job.lop, job.rop.view(0, j0), job.beta, job.c + j0 * job.ldc, job.ldc);
+            } else {
+                if (j0 + nb < job.n)
+                    gemmPacked(T, ws, job.n - j0 - nb, nb, job.k, job.alpha, job.lop.view(j0 + nb, 0), job.rop.view(0, j0), job.beta, job.c + (j0 + nb) + j0 * job.ldc, job.ldc);
+            }
+
+            gemmPacked(T, ws, nb, nb, job.k, job.alpha, job.lop.view(j0, 0), job.rop.view(0, j0), zero(T), tmp.ptr, nb);
+
+            var j: usize = 0;
+            while (j < nb) : (j += 1) {
+                const col: [*]T = job.c + j0 + (j0 + j) * job.ldc;
+                const start: usize = if (job.uplo == .upper) 0 else j;
+                const end: usize = if (job.uplo == .upper) j + 1 else nb;
+
+                var i: usize = start;
+                while (i < end) : (i += 1) {
+                    col[i] = if (isZero(T, job.beta))
+                        tmp[i + j * nb]
+                    else
+                        add(T, mul(T, job.beta, col[i]), tmp[i + j * nb]);
+                }
+            }
+        }
+    };
+
+    // C = alpha * L * R + beta * C, with L = op(A) and R = op(A)^T.
+    forEach(workers, count, Job{
+        .wss = wss,
+        .uplo = uplo,
+        .n = nn,
+        .k = kk,
+        .alpha = alpha,
+        .lop = .init(a, lda, if (trans == .no_trans) .no_trans else .trans),
+        .rop = .init(a, lda, if (trans == .no_trans) .trans else .no_trans),
+        .beta = beta,
+        .c = c,
+        .ldc = scast(usize, ldc),
+    }, Job.run);
+}
+
+/// A `trmm` or `trsm` problem. Columns of `B` (rows for `side = right`) are
+/// independent, so the problem can be cut into slices along them.
+fn Triangular(comptime T: type) type {
+    return struct {
+        side: Side,
+        /// `op(A)`, read as a general matrix.
+        aop: Operand(T),
+        /// `op(A)`, read as a triangular matrix.
+        tri: Operand(T),
+        /// Whether `op(A)` is upper triangular.
+        upper: bool,
+        m: usize,
+        n: usize,
+        alpha: T,
+        b: [*]T,
+        ldb: usize,
+
+        const Self = @This();
+
+        fn init(side: Side, uplo: Uplo, transa: Transpose, diag: Diag, m: i32, n: i32, alpha: T, a: [*]const T, lda: i32, b: [*]T, ldb: i32) Self {
+            const aop: Operand(T) = .init(a, lda, transa);
+            var tri: Operand(T) = aop;
+            tri.kind = .triangular;
+            tri.upper = uplo == .upper;
+            tri.unit = diag == .unit;
+
+            return .{
+                .side = side,
+                .aop = aop,
+                .tri = tri,
+                .upper = (uplo == .upper) != aop.trans,
+                .m = scast(usize, m),
+                .n = scast(usize, n),
+                .alpha = alpha,
+                .b = b,
+                .ldb = scast(usize, ldb),
+            };
+        }
+
+        /// Length of the dimension of `B` along which slices are cut.
+        fn independent(self: Self) usize {
+            return if (self.side == .left) self.n else self.m;
+        }
+
+        /// Returns the problem restricted to `len` columns (rows for
+        /// `side = right`) of `B` starting at `start`.
+        fn slice(self: Self, start: usize, len: usize) Self {
+            var result: Self = self;
+
+            if (self.side == .left) {
+                result.n = len;
+                result.b = self.b + start * self.ldb;
+            } else {
+                result.m = len;
+                result.b = self.b + start;
+            }
+
+            return result;
+        }
+
+        /// Computes `B = alpha * op(A) * B` or `B = alpha * B * op(A)`. Each
+        /// block row (or column) of `B` is rebuilt in the scratch buffer from
+        /// the diagonal block of `op(A)` and the part of `B` that has not been
+        /// overwritten yet, then copied back.
+        fn multiply(p: Self, ws: *const Workspace(T)) void {
+            const tmp: []T = ws.tmp;
+            const bop: Operand(T) = .{ .ptr = p.b, .ld = p.ldb };
+
+            if (p.side == .left) {
+                const blocks: usize = ceilDiv(p.m, block_size);
+                var s: usize = 0;
+                while (s < blocks) : (s += 1) {
+                    // Upper: top to bottom, so the rows below are still
+                    // untouched. Lower: bottom to top, so the rows above are.
+                    const blk: usize = if (p.upper) s else blocks - 1 - s;
+                    const i0: usize = blk * block_size;
+                    const nb: usize = @min(block_size, p.m - i0);
+
+                    gemmPacked(T, ws, nb, p.n, nb, p.alpha, p.tri.view(i0, i0), bop.view(i0, 0), zero(T), tmp.ptr, nb);
+
+                    if (p.upper) {
+                        if (i0 + nb < p.m)
+                            gemmPacked(T, ws, nb, p.n, p.m - i0 - nb, p.alpha, p.aop.view(i0, i0 + nb), bop.view(i0 + nb, 0), one(T), tmp.ptr, nb);
+                    } else {
+                        if (i0 > 0)
+                            gemmPacked(T, ws, nb, p.n, i0, p.alpha, p.aop.view(i0, 0), bop, one(T), tmp.ptr, nb);
+                    }
+
+                    var j: usize = 0;
+                    while (j < p.n) : (j += 1) {
+                        @memcpy((p.b + i0 + j * p.ldb)[0..nb], tmp[j * nb ..][0..nb]);
+                    }
+                }
+            } else {
+                const blocks: usize = ceilDiv(p.n, block_size);
+                var s: usize = 0;
+                while (s < blocks) : (s += 1) {
+                    // Upper: right to left, so the columns to the left are
+                    // still untouched. Lower: left to right, so the ones to
+                    // the right are.
+                    const blk: usize = if (p.upper) blocks - 1 - s else s;
+                    const j0: usize = blk * block_size;
+                    const nb: usize = @min(block_size, p.n - j0);
+
+                    gemmPacked(T, ws, p.m, nb, nb, p.alpha, bop.view(0, j0), p.tri.view(j0, j0), zero(T), tmp.ptr, p.m);
+
+                    if (p.upper) {
+                        if (j0 > 0)
+                            gemmPacked(T, ws, p.m, nb, j0, p.alpha, bop, p.aop.view(0, j0), one(T), tmp.ptr, p.m);
+                    } else {
+                        if (j0 + nb < p.n)
+                            gemmPacked(T, ws, p.m, nb, p.n - j0 - nb, p.alpha, bop.view(0, j0 + nb), p.aop.view(j0 + nb, j0), one(T), tmp.ptr, p.m);
+                    }
+
+                    var j: usize = 0;
+                    while (j < nb) : (j += 1) {
+                        @memcpy((p.b + (j0 + j) * p.ldb)[0..p.m], tmp[j * p.m ..][0..p.m]);
+                    }
+                }
+            }
+        }
+
+        /// Solves `op(A) * X = alpha * B` or `X * op(A) = alpha * B` in
+        /// place. Diagonal blocks are solved by substitution, and the solved
+        /// block is eliminated from the rest of `B` with a packed
+        /// rank-`block_size` update.
+        fn solve(p: Self, ws: *const Workspace(T)) void {
+            const bop: Operand(T) = .{ .ptr = p.b, .ld = p.ldb };
+            const minus_one: T = neg(T, one(T));
+
+            scale(T, p.m, p.n, p.alpha, p.b, p.ldb);
+
+            if (p.side == .left) {
+                const blocks: usize = ceilDiv(p.m, block_size);
+                var s: usize = 0;
+                while (s < blocks) : (s += 1) {
+                    // Upper: back substitution, bottom block first. Lower:
+                    // forward substitution, top block first.
+                    const blk: usize = if (p.upper) blocks - 1 - s else s;
+                    const i0: usize = blk * block_size;
+                    const nb: usize = @min(block_size, p.m - i0);
+
+                    solveLeft(T, p.tri.view(i0, i0), p.upper, nb, p.n, p.b + i0, p.ldb);
+
+                    if (p.upper) {
+                        if (i0 > 0)
+                            gemmPacked(T, ws, i0, p.n, nb, minus_one, p.aop.view(0, i0), bop.view(i0, 0), one(T), p.b, p.ldb);
+                    } else {
+                        if (i0 + nb < p.m)
+                            gemmPacked(T, ws, p.m - i0 - nb, p.n, nb, minus_one, p.aop.view(i0 + nb, i0), bop.view(i0, 0), one(T), p.b + i0 + nb, p.ldb);
+                    }
+                }
+            } else {
+                const blocks: usize = ceilDiv(p.n, block_size);
+                var s: usize = 0;
+                while (s < blocks) : (s += 1) {
+                    // Upper: left block first. Lower: right block first.
+                    const blk: usize = if (p.upper) s else blocks - 1 - s;
+                    const j0: usize = blk * block_size;
+                    const nb: usize = @min(block_size, p.n - j0);
+
+                    solveRight(T, p.tri.view(j0, j0), p.upper, p.m, nb, p.b + j0 * p.ldb, p.ldb);
+
+                    if (p.upper) {
+                        if (j0 + nb < p.n)
+                            gemmPacked(T, ws, p.m, p.n - j0 - nb, nb, minus_one, bop.view(0, j0), p.aop.view(j0, j0 + nb), one(T), p.b + (j0 + nb) * p.ldb, p.ldb);
+                    } else {
+                        if (j0 > 0)
+                            gemmPacked(T, ws, p.m, j0, nb, minus_one, bop.view(0, j0), p.aop.view(j0, 0), one(T), p.b, p.ldb);
+                    }
+                }
+            }
+        }
+    };
+}
+
+/// Cuts a `trmm` or `trsm` problem into slices of `B`, one per task, and
+/// runs `func` on each with its own workspace. `with_buffer` requests a
+/// `block_size`-wide scratch buffer per workspace.
+fn forEachSlice(
+    comptime T: type,
+    problem: Triangular(T),
+    comptime with_buffer: bool,
+    comptime func: fn (Triangular(T), *const Workspace(T)) void,
+) !void {
+    const allocator: std.mem.Allocator = scratch.allocator(scratch.cache);
+    const bk: Blocking = comptime blocking(T);
+
+    const order: u64 = if (problem.side == .left) problem.m else problem.n;
+    const workers: ?*Pool = team(scast(u64, problem.m) * scast(u64, problem.n) * order / 2);
+
+    const len: usize = problem.independent();
+    const chunk: usize = chunkSize(len, if (workers) |p| p.size() else 1, if (problem.side == .left) bk.nr else bk.mr);
+    const count: usize = ceilDiv(@max(len, 1), chunk);
+
+    const first: Triangular(T) = problem.slice(0, @min(chunk, len));
+    const wss: []Workspace(T) = try allocWorkspaces(
+        T,
+        allocator,
+        if (workers) |p| p.lanes(count) else 1,
+        first.m,
+        first.n,
+        if (with_buffer) block_size * first.independent() else 0,
+    );
+    defer freeWorkspaces(T, allocator, wss);
+
+    const Job = struct {
+        wss: []Workspace(T),
+        problem: Triangular(T),
+        chunk: usize,
+        len: usize,
+
+        fn run(job: @This(), lane: usize, index: usize) void {
+            const start: usize = index * job.chunk;
+            func(job.problem.slice(start, @min(job.chunk, job.len - start)), &job.wss[lane]);
+        }
+    };
+
+    forEach(workers, count, Job{ .wss = wss, .problem = problem, .chunk = chunk, .len = len }, Job.run);
+}
+
+/// Packed `trmm` on column-major storage, with the slices of `B` spread over
+/// the current pool.
+pub fn trmm(
+    comptime T: type,
+    side: Side,
+    uplo: Uplo,
+    transa: Transpose,
+    diag: Diag,
+    m: i32,
+    n: i32,
+    alpha: T,
+    a: [*]const T,
+    lda: i32,
+    b: [*]T,
+    ldb: i32,
+) !void {
+    return forEachSlice(T, .init(side, uplo, transa, diag, m, n, alpha, a, lda, b, ldb), true, Triangular(T).multiply);
+}
+
+/// Packed `trsm` on column-major storage, with the slices of `B` spread over
+/// the current pool.
+pub fn trsm(
+    comptime T: type,
+    side: Side,
+    uplo: Uplo,
+    transa: Transpose,
+    diag: Diag,
+    m: i32,
+    n: i32,
+    alpha: T,
+    a: [*]const T,
+    lda: i32,
+    b: [*]T,
+    ldb: i32,
+) !void {
+    return forEachSlice(T, .init(side, uplo, transa, diag, m, n, alpha, a, lda, b, ldb), false, Triangular(T).solve);
+}
+
+/// Solves `T * X = B` in place for an `nb × nb` triangular `T` and an
+/// `nb × n` block `B`.
+fn solveLeft(comptime T: type, t: Operand(T), upper: bool, nb: usize, n: usize, b: [*]T, ldb: usize) void {
+    var j: usize = 0;
+    while (j < n) : (j += 1) {
+        const col: [*]T = b + j * ldb;
+
+        if (upper) {
+            var r: usize = nb;
+            while (r > 0) {
+                r -= 1;
+
+                var s: T = col[r];
+                var c: usize = r + 1;
+                while (c < nb) : (c += 1) {
+                    s = sub(T, s, mul(T, t.get(r, c), col[c]));
+                }
+
+                col[r] = div(T, s, t.get(r, r));
+            }
+        } else {
+            var r: usize = 0;
+            while (r < nb) : (r += 1) {
+                var s: T = col[r];
+                var c: usize = 0;
+                while (c < r) : (c += 1) {
+                    s = sub(T, s, mul(T, t.get(r, c), col[c]));
+                }
+
+                col[r] = div(T, s, t.get(r, r));
+            }
+        }
+    }
+}
+
+/// Solves `X * T = B` in place for an `nb × nb` triangular `T` and an
+/// `m × nb` block `B`, working column by column.
+fn solveRight(comptime T: type, t: Operand(T), upper: bool, m: usize, nb: usize, b: [*]T, ldb: usize) void {
+    var s: usize = 0;
+    while (s < nb) : (s += 1) {
+        const c: usize = if (upper) s else nb - 1 - s;
+        const col: [*]T = b + c * ldb;
+
+        var r: usize = 0;
+        while (r < nb) : (r += 1) {
+            if ((upper and r >= c) or (!upper and r <= c))
+                continue;
+
+            const factor: T = t.get(r, c);
+            if (isZero(T, factor))
+                continue;
+
+            const other: [*]const T = b + r * ldb;
+            var i: usize = 0;
+            while (i < m) : (i += 1) {
+                col[i] = sub(T, col[i], mul(T, factor, other[i]));
+            }
+        }
+
+        const d: T = t.get(c, c);
+        if (!isOne(T, d)) {
+            var i: usize = 0;
+            while (i < m) : (i += 1) {
+                col[i] = div(T, col[i], d);
+            }
+        }
+    }
+}
@@ -8,6 +8,7 @@ const int = @import("../../int.zig");
 
 const linalg = @import("../../linalg.zig");
 const blas = @import("../blas.zig");
+const blocked = @import("blocked.zig");
 const Order = types.Order;
 const Transpose = linalg.Transpose;
 
@@ -139,6 +140,15 @@ fn k_gemm(
             return;
         }
 
+        if (comptime blocked.isSupported(CC) and A == CC and B == CC and C == CC) {
+            if (blocked.worthwhile(m, n, k)) fast: {
+                blocked.gemm(CC, transa, transb, m, n, k, scast(CC, alpha), a, lda, b, ldb, scast(CC, beta), c, ldc) catch |err| switch (err) {
+                    error.OutOfMemory => break :fast,
+                };
+                return;
+            }
+        }
+
         if (notb) {
             if (nota) {
                 if (noconjb) {
@@ -8,6 +8,7 @@ const int = @import("../../int.zig");
 
 const linalg = @import("../../linalg.zig");
 const blas = @import("../blas.zig");
+const blocked = @import("blocked.zig");
 const Order = types.Order;
 const Side = linalg.Side;
 const Uplo = types.Uplo;
@@ -130,6 +131,15 @@ fn k_hemm(
             return;
         }
 
+        if (comptime blocked.isSupported(CC) and A == CC and B == CC and C == CC) {
+            if (blocked.worthwhile(m, n, if (side == .left) m else n)) fast: {
+                blocked.symm(CC, .hermitian, side, uplo, m, n, scast(CC, alpha), a, lda, b, ldb, scast(CC, beta), c, ldc) catch |err| switch (err) {
+                    error.OutOfMemory => break :fast,
+                };
+                return;
+            }
+        }
+
         if (side == .left) {
             if (uplo == .upper) {
                 var j: i32 = 0;
@@ -8,6 +8,7 @@ const int = @import("../../int.zig");
 
 const linalg = @import("../../linalg.zig");
 const blas = @import("../blas.zig");
+const blocked = @import("blocked.zig");
 const Order = types.Order;
 const Transpose = linalg.Transpose;
 const Uplo = types.Uplo;
@@ -150,6 +151,15 @@ fn k_syrk(
             return;
         }
 
+        if (comptime blocked.isSupported(CC) and A == CC and C == CC) {
+            if (blocked.worthwhile(n, n, k)) fast: {
+                blocked.syrk(CC, uplo, trans, n, k, scast(CC, alpha), a, lda, scast(CC, beta), c, ldc) catch |err| switch (err) {
+                    error.OutOfMemory => break :fast,
+                };
+                return;
+            }
+        }
+
         if (trans == .no_trans) {
             if (uplo == .upper) {
                 var j: i32 = 0;
@@ -9,6 +9,7 @@ const int = @import("../../int.zig");
 
 const linalg = @import("../../linalg.zig");
 const blas = @import("../blas.zig");
+const blocked = @import("blocked.zig");
 const Order = types.Order;
 const Transpose = linalg.Transpose;
 const Side = linalg.Side;
@@ -112,6 +113,15 @@ fn k_trsm(
             return;
         }
 
+        if (comptime blocked.isSupported(CC) and A == CC and B == CC) {
+            if (blocked.worthwhile(m, n, if (side == .left) m else n)) fast: {
+                blocked.trsm(CC, side, uplo, transa, diag, m, n, scast(CC, alpha), a, lda, b, ldb) catch |err| switch (err) {
+                    error.OutOfMemory => break :fast,
+                };
+                return;
+            }
+        }
+
         if (side == .left) {
             if (not) {
                 if (uplo == .upper) {
@@ -15,6 +15,8 @@ const linalg = @import("../linalg.zig");
 
 const ci = @import("../c.zig").c;
 
+const pool = @import("../pool.zig");
+
 const Order = types.Order;
 const Transpose = linalg.Transpose;
 const Uplo = types.Uplo;
@@ -1127,6 +1129,9 @@ pub inline fn zgetrf2(
 /// If the `link_cblas` option is not `null`, the function will try to call the
 /// corresponding LAPACKE function, if available. In that case, no errors will
 /// be raised even if the arguments are invalid.
+///
+/// Large factorizations run as a graph of panel and update tasks on a pool,
+/// as set by the `pool` and `scratch` fields of `ctx` (see `zml.pool`).
 pub inline fn getrf(
     order: Order,
     m: i32,
@@ -1150,7 +1155,7 @@ pub inline fn getrf(
         // When implemented, expand if
         @compileError("zml.linalg.lapack.getrf not implemented for arbitrary precision types yet");
     } else {
-        types.validateContext(@TypeOf(ctx), .{});
+        types.validateContext(@TypeOf(ctx), pool.parallel_context);
     };
 
     if (comptime options.link_lapacke != null) {
@@ -1201,7 +1206,10 @@ pub inline fn getrf(
         }
     }
 
-    return @import("lapack/getrf.zig").getrf(order, m, n, a, lda, ipiv, ctx);
+    const scope: pool.Scope = pool.enterContext(ctx);
+    defer scope.leave();
+
+    return @import("lapack/getrf.zig").getrf(order, m, n, a, lda, ipiv, types.stripStructFields(ctx, &.{ "pool", "scratch" }));
 }
 
 /// Computes the LU factorization of a general `m`-by-`n` matrix.
@@ -2972,6 +2980,9 @@ pub inline fn zpotrf2(
 /// If the `link_cblas` option is not `null`, the function will try to call the
 /// corresponding LAPACKE function, if available. In that case, no errors will
 /// be raised even if the arguments are invalid.
+///
+/// Large factorizations run as a graph of panel and update tasks on a pool,
+/// as set by the `pool` and `scratch` fields of `ctx` (see `zml.pool`).
 pub inline fn potrf(
     order: Order,
     uplo: Uplo,
@@ -2994,7 +3005,7 @@ pub inline fn potrf(
         // When implemented, expand if
         @compileError("zml.linalg.lapack.potrf not implemented for arbitrary precision types yet");
     } else {
-        types.validateContext(@TypeOf(ctx), .{});
+        types.validateContext(@TypeOf(ctx), pool.parallel_context);
     };
 
     if (comptime options.link_lapacke != null) {
@@ -3041,7 +3052,10 @@ pub inline fn potrf(
         }
     }
 
-    return @import("lapack/potrf.zig").potrf(order, uplo, n, a, lda, ctx);
+    const scope: pool.Scope = pool.enterContext(ctx);
+    defer scope.leave();
+
+    return @import("lapack/potrf.zig").potrf(order, uplo, n, a, lda, types.stripStructFields(ctx, &.{ "pool", "scratch" }));
 }
 
 /// Computes the Cholesky factorization of a symmetric positive-definite matrix.
@@ -5168,7 +5182,10 @@ pub inline fn geqrf(
         }
     }
 
-    return @import("lapack/geqrf.zig").geqrf(order, m, n, a, lda, tau, work, lwork, ctx);
+    const scope: pool.Scope = pool.enterContext(ctx);
+    defer scope.leave();
+
+    return @import("lapack/geqrf.zig").geqrf(order, m, n, a, lda, tau, work, lwork, types.stripStructFields(ctx, &.{ "pool", "scratch" }));
 }
 
 pub inline fn org2r(
@@ -14,6 +14,7 @@ const Direction = lapack.Direction;
 const Storage = lapack.Storage;
 
 const utils = @import("../utils.zig");
+const parallel = @import("parallel.zig");
 
 pub fn geqrf(
     order: Order,
@@ -73,6 +74,23 @@ pub fn geqrf(
         }
     }
 
+    if (comptime !types.isArbitraryPrecision(types.Child(@TypeOf(a))) and nb >= nbmin and nb < k and nx < k) {
+        if (parallel.team(m, n, nb)) |workers| {
+            if (parallel.geqrf(workers, order, m, n, a, lda, tau, nb)) |_| {
+                try ops.set(
+                    &work[0],
+                    iws,
+                    ctx,
+                );
+
+                return;
+            } else |_| {
+                // Not enough memory for the task graph, fall back to the
+                // sequential blocked code.
+            }
+        }
+    }
+
     var i: i32 = 0;
     if (nb >= nbmin and nb < k and nx < k) {
         // use blocked code initially
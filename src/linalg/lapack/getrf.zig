@@ -10,6 +10,7 @@ const lapack = @import("../lapack.zig");
 const Order = types.Order;
 
 const utils = @import("../utils.zig");
+const parallel = @import("parallel.zig");
 
 pub fn getrf(
     order: Order,
@@ -47,6 +48,15 @@ pub fn getrf(
                 ctx,
             ) catch unreachable;
         } else {
+            if (parallel.team(m, n, nb)) |workers| {
+                if (parallel.getrf(workers, order, m, n, a, lda, ipiv, nb)) |result| {
+                    return result;
+                } else |_| {
+                    // Not enough memory for the task graph, fall back to the
+                    // sequential blocked code.
+                }
+            }
+
             // Use blocked code.
             var j: i32 = 0;
             while (j < int.min(m, n)) : (j += nb) {
@@ -0,0 +1,598 @@
+//! Task-graph versions of the blocked factorizations.
+//!
+//! A right-looking blocked factorization of a matrix with `blocks` column
+//! blocks runs, at step `j`, a panel task that factors column block `j` and
+//! an update task per column block `c > j` that applies step `j` to it.
+//! `getrf` updates with `laswp`, `trsm` and `gemm`, `potrf` with
+//! `syrk`/`herk` and `gemm`, and `geqrf` with `larfb` after forming the block
+//! reflector with `larft` in the panel. Each task only waits for what it
+//! actually reads:
+//!
+//! - `panel(j)` waits for `update(j - 1, j)`,
+//! - `update(j, c)` waits for `panel(j)` and `update(j - 1, c)`,
+//!
+//! so the panel of step `j + 1` starts as soon as its own column block has
+//! been updated, overlapping the rest of the trailing update of step `j`
+//! (lookahead), and updates of different steps pipeline across the matrix.
+//! The level 3 calls inside the tasks run on the same pool, so large tasks
+//! are split further without adding threads.
+
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const scast = types.scast;
+const int = @import("../../int.zig");
+
+const pool = @import("../../pool.zig");
+const Pool = pool.Pool;
+const scratch = @import("../../scratch.zig");
+
+const blas = @import("../blas.zig");
+const lapack = @import("../lapack.zig");
+const Order = types.Order;
+const Uplo = types.Uplo;
+
+const utils = @import("../utils.zig");
+
+/// Returns the pool to factor an `m × n` matrix with block size `nb` on, or
+/// `null` if the sequential blocked code should be used.
+pub fn team(m: i32, n: i32, nb: i32) ?*Pool {
+    if (int.min(m, n) < 4 * nb)
+        return null;
+
+    const current: *Pool = pool.current() orelse return null;
+    return if (current.size() > 1) current else null;
+}
+
+/// Builds and runs the panel/update graph for `steps` panels over `blocks`
+/// column blocks (`blocks >= steps`).
+fn factor(
+    workers: *Pool,
+    steps: u32,
+    blocks: u32,
+    context: anytype,
+    comptime panel: fn (@TypeOf(context), u32) void,
+    comptime update: fn (@TypeOf(context), u32, u32) void,
+) !void {
+    const allocator: std.mem.Allocator = scratch.allocator(std.heap.smp_allocator);
+
+    const Node = struct {
+        step: u32,
+        block: u32,
+    };
+
+    const Job = struct {
+        context: @TypeOf(context),
+        nodes: []const Node,
+
+        fn run(job: @This(), id: u32) void {
+            const node: Node = job.nodes[id];
+            if (node.block == node.step) {
+                panel(job.context, node.step);
+            } else {
+                update(job.context, node.step, node.block);
+            }
+        }
+    };
+
+    // Node of panel(j) is first[j], node of update(j, c) is first[j] + c - j.
+    const first: []u32 = try allocator.alloc(u32, steps);
+    defer allocator.free(first);
+
+    var count: u32 = 0;
+    for (first, 0..) |*id, j| {
+        id.* = count;
+        count += blocks - scast(u32, j);
+    }
+
+    const nodes: []Node = try allocator.alloc(Node, count);
+    defer allocator.free(nodes);
+
+    var graph: pool.Graph(Job, Job.run) = try .init(allocator, count);
+    defer graph.deinit();
+
+    var j: u32 = 0;
+    while (j < steps) : (j += 1) {
+        var c: u32 = j;
+        while (c < blocks) : (c += 1) {
+            const id: u32 = first[j] + c - j;
+            nodes[id] = .{ .step = j, .block = c };
+
+            if (c == j) {
+                if (j > 0)
+                    try graph.depend(id, first[j - 1] + 1);
+            } else {
+                try graph.depend(id, first[j]);
+
+                if (j > 0)
+                    try graph.depend(id, first[j - 1] + c - j + 1);
+            }
+        }
+    }
+
+    try graph.run(workers, .{ .context = context, .nodes = nodes });
+}
+
+/// Task-graph `getrf`. Row interchanges are applied to the columns right of
+/// each panel by its update tasks, and to the columns left of it once the
+/// graph has finished.
+pub fn getrf(workers: *Pool, order: Order, m: i32, n: i32, a: anytype, lda: i32, ipiv: [*]i32, nb: i32) !i32 {
+    const allocator: std.mem.Allocator = scratch.allocator(std.heap.smp_allocator);
+    const k: i32 = int.min(m, n);
+    const steps: u32 = scast(u32, int.div(k + nb - 1, nb));
+    const blocks: u32 = scast(u32, int.div(n + nb - 1, nb));
+
+    const infos: []i32 = try allocator.alloc(i32, steps);
+    defer allocator.free(infos);
+
+    const Context = struct {
+        order: Order,
+        m: i32,
+        n: i32,
+        nb: i32,
+        a: @TypeOf(a),
+        lda: i32,
+        ipiv: [*]i32,
+        infos: []i32,
+
+        const Self = @This();
+
+        fn panel(self: Self, step: u32) void {
+            const j: i32 = scast(i32, step) * self.nb;
+            const jb: i32 = int.min(int.min(self.m, self.n) - j, self.nb);
+
+            // Factor diagonal and subdiagonal blocks and test for exact singularity.
+            self.infos[step] = lapack.getrf2(
+                self.order,
+                self.m - j,
+                jb,
+                self.a + utils.index(self.order, j, j, self.lda),
+                self.lda,
+                self.ipiv + scast(u32, j),
+                .{},
+            ) catch unreachable;
+
+            // Adjust the pivot indices.
+            var i: i32 = j;
+            while (i < int.min(self.m, j + jb)) : (i += 1) {
+                self.ipiv[scast(u32, i)] += j;
+            }
+
+            // When m < n the last panel can be narrower than its column
+            // block; the rest of the block belongs to the trailing matrix.
+            const end: i32 = int.min(self.n, j + self.nb);
+            if (j + jb < end)
+                self.apply(j, jb, j + jb, end - j - jb);
+        }
+
+        fn update(self: Self, step: u32, block: u32) void {
+            const j: i32 = scast(i32, step) * self.nb;
+            const c: i32 = scast(i32, block) * self.nb;
+
+            self.apply(j, int.min(int.min(self.m, self.n) - j, self.nb), c, int.min(self.nb, self.n - c));
+        }
+
+        /// Applies the panel at `j` of width `jb` to columns `c..c + cw`.
+        fn apply(self: Self, j: i32, jb: i32, c: i32, cw: i32) void {
+            // Apply interchanges.
+            lapack.laswp(
+                self.order,
+                cw,
+                self.a + utils.index(self.order, 0, c, self.lda),
+                self.lda,
+                j + 1,
+                j + jb,
+                self.ipiv,
+                1,
+            ) catch unreachable;
+
+            // Compute block row of U.
+            blas.trsm(
+                self.order,
+                .left,
+                .lower,
+                .no_trans,
+                .unit,
+                jb,
+                cw,
+                1,
+                self.a + utils.index(self.order, j, j, self.lda),
+                self.lda,
+                self.a + utils.index(self.order, j, c, self.lda),
+                self.lda,
+                .{},
+            ) catch unreachable;
+
+            if (j + jb < self.m) {
+                // Update trailing submatrix.
+                blas.gemm(
+                    self.order,
+                    .no_trans,
+                    .no_trans,
+                    self.m - j - jb,
+                    cw,
+                    jb,
+                    -1,
+                    self.a + utils.index(self.order, j + jb, j, self.lda),
+                    self.lda,
+                    self.a + utils.index(self.order, j, c, self.lda),
+                    self.lda,
+                    1,
+                    self.a + utils.index(self.order, j + jb, c, self.lda),
+                    self.lda,
+                    .{},
+                ) catch unreachable;
+            }
+        }
+    };
+
+    try factor(workers, steps, blocks, Context{
+        .order = order,
+        .m = m,
+        .n = n,
+        .nb = nb,
+        .a = a,
+        .lda = lda,
+        .ipiv = ipiv,
+        .infos = infos,
+    }, Context.panel, Context.update);
+
+    var info: i32 = 0;
+    var step: u32 = 0;
+    while (step < steps) : (step += 1) {
+        const j: i32 = scast(i32, step) * nb;
+        const jb: i32 = int.min(k - j, nb);
+
+        if (info == 0 and infos[step] > 0)
+            info = infos[step] + j;
+
+        // Apply interchanges to columns 1:j - 1.
+        lapack.laswp(
+            order,
+            j,
+            a,
+            lda,
+            j + 1,
+            j + jb,
+            ipiv,
+            1,
+        ) catch unreachable;
+    }
+
+    return info;
+}
+
+/// Task-graph `potrf`, right-looking over block columns (`uplo = lower`) or
+/// block rows (`uplo = upper`). Once a diagonal block fails to factor, the
+/// remaining tasks are skipped.
+pub fn potrf(workers: *Pool, order: Order, uplo: Uplo, n: i32, a: anytype, lda: i32, nb: i32) !i32 {
+    const blocks: u32 = scast(u32, int.div(n + nb - 1, nb));
+
+    var info: std.atomic.Value(i32) = .init(0);
+
+    const Context = struct {
+        order: Order,
+        uplo: Uplo,
+        n: i32,
+        nb: i32,
+        a: @TypeOf(a),
+        lda: i32,
+        info: *std.atomic.Value(i32),
+
+        const Self = @This();
+
+        fn panel(self: Self, step: u32) void {
+            if (self.info.load(.acquire) != 0)
+                return;
+
+            const j: i32 = scast(i32, step) * self.nb;
+            const jb: i32 = int.min(self.nb, self.n - j);
+
+            const iinfo: i32 = lapack.potrf2(
+                self.order,
+                self.uplo,
+                jb,
+                self.a + utils.index(self.order, j, j, self.lda),
+                self.lda,
+                .{},
+            ) catch unreachable;
+
+            if (iinfo != 0) {
+                self.info.store(iinfo + j, .release);
+                return;
+            }
+
+            if (j + jb < self.n) {
+                if (self.uplo == .upper) {
+                    // Compute the current block row.
+                    blas.trsm(
+                        self.order,
+                        .left,
+                        .upper,
+                        .conj_trans,
+                        .non_unit,
+                        jb,
+                        self.n - j - jb,
+                        1,
+                        self.a + utils.index(self.order, j, j, self.lda),
+                        self.lda,
+                        self.a + utils.index(self.order, j, j + jb, self.lda),
+                        self.lda,
+                        .{},
+                    ) catch unreachable;
+                } else {
+                    // Compute the current block column.
+                    blas.trsm(
+                        self.order,
+                        .right,
+                        .lower,
+                        .conj_trans,
+                        .non_unit,
+                        self.n - j - jb,
+                        jb,
+                        1,
+                        self.a + utils.index(self.order, j, j, self.lda),
+                        self.lda,
+                        self.a + utils.index(self.order, j + jb, j, self.lda),
+                        self.lda,
+                        .{},
+                    ) catch unreachable;
+                }
+            }
+        }
+
+        fn update(self: Self, step: u32, block: u32) void {
+            if (self.info.load(.acquire) != 0)
+                return;
+
+            const A: type = types.Child(@TypeOf(self.a));
+            const j: i32 = scast(i32, step) * self.nb;
+            const jb: i32 = int.min(self.nb, self.n - j);
+            const c: i32 = scast(i32, block) * self.nb;
+            const cw: i32 = int.min(self.nb, self.n - c);
+
+            if (self.uplo == .upper) {
+                // Update the diagonal block of block row c ...
+                if (comptime !types.isComplex(A)) {
+                    blas.syrk(
+                        self.order,
+                        .upper,
+                        .trans,
+                        cw,
+                        jb,
+                        -1,
+                        self.a + utils.index(self.order, j, c, self.lda),
+                        self.lda,
+                        1,
+                        self.a + utils.index(self.order, c, c, self.lda),
+                        self.lda,
+                        .{},
+                    ) catch unreachable;
+                } else {
+                    blas.herk(
+                        self.order,
+                        .upper,
+                        .conj_trans,
+                        cw,
+                        jb,
+                        -1,
+                        self.a + utils.index(self.order, j, c, self.lda),
+                        self.lda,
+                        1,
+                        self.a + utils.index(self.order, c, c, self.lda),
+                        self.lda,
+                        .{},
+                    ) catch unreachable;
+                }
+
+                // ... and the rest of it.
+                if (c + cw < self.n) {
+                    blas.gemm(
+                        self.order,
+                        .conj_trans,
+                        .no_trans,
+                        cw,
+                        self.n - c - cw,
+                        jb,
+                        -1,
+                        self.a + utils.index(self.order, j, c, self.lda),
+                        self.lda,
+                        self.a + utils.index(self.order, j, c + cw, self.lda),
+                        self.lda,
+                        1,
+                        self.a + utils.index(self.order, c, c + cw, self.lda),
+                        self.lda,
+                        .{},
+                    ) catch unreachable;
+                }
+            } else {
+                // Update the diagonal block of block column c ...
+                if (comptime !types.isComplex(A)) {
+                    blas.syrk(
+                        self.order,
+                        .lower,
+                        .no_trans,
+                        cw,
+                        jb,
+                        -1,
+                        self.a + utils.index(self.order, c, j, self.lda),
+                        self.lda,
+                        1,
+                        self.a + utils.index(self.order, c, c, self.lda),
+                        self.lda,
+                        .{},
+                    ) catch unreachable;
+                } else {
+                    blas.herk(
+                        self.order,
+                        .lower,
+                        .no_trans,
+                        cw,
+                        jb,
+                        -1,
+                        self.a + utils.index(self.order, c, j, self.lda),
+                        self.lda,
+                        1,
+                        self.a + utils.index(self.order, c, c, self.lda),
+                        self.lda,
+                        .{},
+                    ) catch unreachable;
+                }
+
+                // ... and the rest of it.
+                if (c + cw < self.n) {
+                    blas.gemm(
+                        self.order,
+                        .no_trans,
+                        .conj_trans,
+                        self.n - c - cw,
+                        cw,
+                        jb,
+                        -1,
+                        self.a + utils.index(self.order, c + cw, j, self.lda),
+                        self.lda,
+                        self.a + utils.index(self.order, c, j, self.lda),
+                        self.lda,
+                        1,
+                        self.a + utils.index(self.order, c + cw, c, self.lda),
+                        self.lda,
+                        .{},
+                    ) catch unreachable;
+                }
+            }
+        }
+    };
+
+    try factor(workers, blocks, blocks, Context{
+        .order = order,
+        .uplo = uplo,
+        .n = n,
+        .nb = nb,
+        .a = a,
+        .lda = lda,
+        .info = &info,
+    }, Context.panel, Context.update);
+
+    return info.load(.acquire);
+}
+
+/// Task-graph `geqrf`. Every panel keeps its own triangular factor `T`, and
+/// every column block its own `larfb` workspace, so updates from different
+/// steps can run at the same time.
+pub fn geqrf(workers: *Pool, order: Order, m: i32, n: i32, a: anytype, lda: i32, tau: anytype, nb: i32) !void {
+    const A: type = types.Child(@TypeOf(a));
+    const allocator: std.mem.Allocator = scratch.allocator(std.heap.smp_allocator);
+    const k: i32 = int.min(m, n);
+    const steps: u32 = scast(u32, int.div(k + nb - 1, nb));
+    const blocks: u32 = scast(u32, int.div(n + nb - 1, nb));
+    const tile: usize = scast(usize, nb) * scast(usize, nb);
+
+    const t: []A = try allocator.alloc(A, steps * tile);
+    defer allocator.free(t);
+
+    const work: []A = try allocator.alloc(A, blocks * tile);
+    defer allocator.free(work);
+
+    const Context = struct {
+        order: Order,
+        m: i32,
+        n: i32,
+        nb: i32,
+        a: @TypeOf(a),
+        lda: i32,
+        tau: @TypeOf(tau),
+        t: []A,
+        work: []A,
+        tile: usize,
+
+        const Self = @This();
+
+        fn panel(self: Self, step: u32) void {
+            const j: i32 = scast(i32, step) * self.nb;
+            const jb: i32 = int.min(int.min(self.m, self.n) - j, self.nb);
+
+            // Compute the qr factorization of the current block
+            // a(j:m,j:j+jb-1)
+            lapack.geqr2(
+                self.order,
+                self.m - j,
+                jb,
+                self.a + utils.index(self.order, j, j, self.lda),
+                self.lda,
+                self.tau + scast(u32, j),
+                self.work[step * self.tile ..].ptr,
+                .{},
+            ) catch unreachable;
+
+            if (j + jb < self.n) {
+                // Form the triangular factor of the block reflector
+                // h = h(j) h(j+1) . . . h(j+jb-1)
+                lapack.larft(
+                    self.order,
+                    .forward,
+                    .columnwise,
+                    self.m - j,
+                    jb,
+                    self.a + utils.index(self.order, j, j, self.lda),
+                    self.lda,
+                    self.tau + scast(u32, j),
+                    self.t[step * self.tile ..].ptr,
+                    self.nb,
+                    .{},
+                ) catch unreachable;
+
+                // When m < n the last panel can be narrower than its column
+                // block; the rest of the block belongs to the trailing
+                // matrix.
+                const end: i32 = int.min(self.n, j + self.nb);
+                if (j + jb < end)
+                    self.apply(step, j + jb, end - j - jb, step);
+            }
+        }
+
+        fn update(self: Self, step: u32, block: u32) void {
+            const c: i32 = scast(i32, block) * self.nb;
+            self.apply(step, c, int.min(self.nb, self.n - c), block);
+        }
+
+        /// Applies h**h of panel `step` to columns `c..c + cw`, using the
+        /// workspace of column block `block`.
+        fn apply(self: Self, step: u32, c: i32, cw: i32, block: u32) void {
+            const j: i32 = scast(i32, step) * self.nb;
+            const jb: i32 = int.min(int.min(self.m, self.n) - j, self.nb);
+
+            lapack.larfb(
+                self.order,
+                .left,
+                .conj_trans,
+                .forward,
+                .columnwise,
+                self.m - j,
+                cw,
+                jb,
+                self.a + utils.index(self.order, j, j, self.lda),
+                self.lda,
+                self.t[step * self.tile ..].ptr,
+                self.nb,
+                self.a + utils.index(self.order, j, c, self.lda),
+                self.lda,
+                self.work[block * self.tile ..].ptr,
+                if (self.order == .col_major) cw else jb,
+                .{},
+            ) catch unreachable;
+        }
+    };
+
+    try factor(workers, steps, blocks, Context{
+        .order = order,
+        .m = m,
+        .n = n,
+        .nb = nb,
+        .a = a,
+        .lda = lda,
+        .tau = tau,
+        .t = t,
+        .work = work,
+        .tile = tile,
+    }, Context.panel, Context.update);
+}
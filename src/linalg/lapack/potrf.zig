@@ -13,6 +13,7 @@ const Order = types.Order;
 const Uplo = types.Uplo;
 
 const utils = @import("../utils.zig");
+const parallel = @import("parallel.zig");
 
 pub fn potrf(
     order: Order,
@@ -48,6 +49,15 @@ pub fn potrf(
                 ctx,
             ) catch unreachable;
         } else {
+            if (parallel.team(n, n, nb)) |workers| {
+                if (parallel.potrf(workers, order, uplo, n, a, lda, nb)) |result| {
+                    return result;
+                } else |_| {
+                    // Not enough memory for the task graph, fall back to the
+                    // sequential blocked code.
+                }
+            }
+
             // Use blocked code.
             if (uplo == .upper) {
                 // Compute the Cholesky factorization A = U^T * U or A = U^H * U.
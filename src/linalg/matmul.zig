@@ -16,6 +16,18 @@ const linalg = @import("../linalg.zig");
 const blas = @import("blas.zig");
 const lapack = @import("lapack.zig");
 
+const pool = @import("../pool.zig");
+const Pool = pool.Pool;
+
+const sparse_context = .{
+    .pool = .{
+        .type = ?*Pool,
+        .required = false,
+        .default = null,
+        .description = "The pool to run on. If not provided, the current pool is used (see `zml.pool.current`).",
+    },
+};
+
 pub inline fn matmul(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anytype) !MulCoerce(@TypeOf(a), @TypeOf(b)) {
     const A: type = @TypeOf(a);
     const B: type = @TypeOf(b);
@@ -29,10 +41,19 @@ pub inline fn matmul(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx:
     comptime if (types.isArbitraryPrecision(Numeric(A)) or types.isArbitraryPrecision(Numeric(B))) {
         // When implemented, expand if
         @compileError("zml.linalg.matmul not implemented for arbitrary precision types yet");
+    } else if (types.isSparseMatrix(A) or types.isSparseMatrix(B)) {
+        types.validateContext(@TypeOf(ctx), sparse_context);
     } else {
         types.validateContext(@TypeOf(ctx), .{});
     };
 
+    if (comptime types.isSparseMatrix(A) or types.isSparseMatrix(B)) {
+        const previous: ?*Pool = pool.enter(types.getFieldOrDefault(ctx, sparse_context, "pool"));
+        defer pool.leave(previous);
+
+        return sparseMatmul(allocator, a, b, types.stripStructFields(ctx, &.{"pool"}));
+    }
+
     if (comptime !types.isMatrix(A)) { // vector * matrix
         const m: u32 = if (comptime types.isSquareMatrix(B)) b.size else b.rows;
         const n: u32 = if (comptime types.isSquareMatrix(B)) b.size else b.cols;
@@ -710,6 +731,65 @@ pub inline fn matmul(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx:
     }
 }
 
+/// Products where at least one operand is a sparse matrix. Compressed sparse
+/// matrices of every kind go through the `sp` kernels and block sparse
+/// matrices through the `bge` ones; see `matmul/sparse.zig` and
+/// `matmul/block.zig`.
+fn sparseMatmul(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anytype) !MulCoerce(@TypeOf(a), @TypeOf(b)) {
+    const A: type = @TypeOf(a);
+    const B: type = @TypeOf(b);
+
+    if (comptime !types.isMatrix(A)) { // vector * sparse matrix
+        if (a.len != (if (comptime types.isSquareMatrix(B)) b.size else b.rows))
+            return linalg.Error.DimensionMismatch;
+
+        if (comptime types.vectorType(A) != .dense)
+            @compileError("matmul not implemented for " ++ @typeName(A) ++ " and " ++ @typeName(B));
+
+        if (comptime types.isBlockMatrix(B))
+            return @import("matmul/dvbge.zig").vm(allocator, a, b, ctx); // dense vector * block sparse matrix
+
+        return @import("matmul/dvsp.zig").vm(allocator, a, b, ctx); // dense vector * sparse matrix
+    } else if (comptime !types.isMatrix(B)) { // sparse matrix * vector
+        if (b.len != (if (comptime types.isSquareMatrix(A)) a.size else a.cols))
+            return linalg.Error.DimensionMismatch;
+
+        if (comptime types.vectorType(B) != .dense)
+            @compileError("matmul not implemented for " ++ @typeName(A) ++ " and " ++ @typeName(B));
+
+        if (comptime types.isBlockMatrix(A))
+            return @import("matmul/bgedv.zig").mv(allocator, a, b, ctx); // block sparse matrix * dense vector
+
+        return @import("matmul/spdv.zig").mv(allocator, a, b, ctx); // sparse matrix * dense vector
+    } else {
+        if ((if (comptime types.isSquareMatrix(A)) a.size else a.cols) != (if (comptime types.isSquareMatrix(B)) b.size else b.rows))
+            return linalg.Error.DimensionMismatch;
+
+        if (comptime types.isSparseMatrix(A) and types.isSparseMatrix(B)) {
+            if (comptime types.isBlockMatrix(A) or types.isBlockMatrix(B))
+                @compileError("matmul not implemented for " ++ @typeName(A) ++ " and " ++ @typeName(B));
+
+            return @import("matmul/spsp.zig").mm(allocator, a, b, ctx); // sparse matrix * sparse matrix
+        } else if (comptime types.isSparseMatrix(A)) {
+            if (comptime types.matrixType(B) != .general_dense)
+                @compileError("matmul not implemented for " ++ @typeName(A) ++ " and " ++ @typeName(B));
+
+            if (comptime types.isBlockMatrix(A))
+                return @import("matmul/bgedge.zig").mm(allocator, a, b, ctx); // block sparse matrix * dense general matrix
+
+            return @import("matmul/spdge.zig").mm(allocator, a, b, ctx); // sparse matrix * dense general matrix
+        } else {
+            if (comptime types.matrixType(A) != .general_dense)
+                @compileError("matmul not implemented for " ++ @typeName(A) ++ " and " ++ @typeName(B));
+
+            if (comptime types.isBlockMatrix(B))
+                return @import("matmul/dgebge.zig").mm(allocator, a, b, ctx); // dense general matrix * block sparse matrix
+
+            return @import("matmul/dgesp.zig").mm(allocator, a, b, ctx); // dense general matrix * sparse matrix
+        }
+    }
+}
+
 fn defaultSlowVM(result: anytype, x: anytype, a: anytype, ctx: anytype) !void {
     const A: type = @TypeOf(a);
     const C: type = Numeric(types.Child(@TypeOf(result)));
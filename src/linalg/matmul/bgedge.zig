@@ -0,0 +1,33 @@
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const MulCoerce = types.MulCoerce;
+
+const matrix = @import("../../matrix.zig");
+
+const sparse = @import("sparse.zig");
+const block = @import("block.zig");
+
+pub inline fn mm(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anytype) !MulCoerce(@TypeOf(a), @TypeOf(b)) {
+    const A: type = @TypeOf(a);
+    const B: type = @TypeOf(b);
+    const C: type = types.Coerce(types.Numeric(A), types.Numeric(B));
+
+    const op: block.Operand(types.Numeric(A)) = block.operand(a);
+
+    var result: matrix.general.Dense(C, types.layoutOf(B)) = try .full(allocator, op.rows, b.cols, 0, ctx);
+    errdefer result.deinit(allocator);
+
+    try block.multiplyColumns(
+        types.Numeric(A),
+        types.Numeric(B),
+        C,
+        allocator,
+        op,
+        b.cols,
+        sparse.view([*]const types.Numeric(B), b),
+        sparse.view([*]C, result),
+    );
+
+    return result;
+}
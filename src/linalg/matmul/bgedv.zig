@@ -0,0 +1,27 @@
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const MulCoerce = types.MulCoerce;
+
+const vector = @import("../../vector.zig");
+
+const sparse = @import("sparse.zig");
+const block = @import("block.zig");
+
+pub inline fn mv(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anytype) !MulCoerce(@TypeOf(a), @TypeOf(b)) {
+    const A: type = @TypeOf(a);
+    const B: type = @TypeOf(b);
+    const C: type = types.Coerce(types.Numeric(A), types.Numeric(B));
+
+    const op: block.Operand(types.Numeric(A)) = block.operand(a);
+
+    var result: vector.Dense(C) = try .full(allocator, op.rows, 0, ctx);
+    errdefer result.deinit(allocator);
+
+    const x: []const types.Numeric(B) = try sparse.contiguous(allocator, b);
+    defer sparse.freeContiguous(allocator, b, x);
+
+    block.multiply(types.Numeric(A), types.Numeric(B), C, op, x.ptr, result.data);
+
+    return result;
+}
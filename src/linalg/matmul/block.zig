@@ -0,0 +1,224 @@
+//! Kernels shared by the products involving a block sparse matrix
+//! (`matrix.general.Block`).
+//!
+//! Every stored block is applied to a segment of the dense operand by a small
+//! dense kernel. For `f32` and `f64` and the usual block sizes (2, 3, 4 and 8)
+//! the size is made comptime and the block is applied with `@Vector`: a dot
+//! product per row for row-major blocks and an accumulation of columns for
+//! column-major ones. Other sizes and types go through `ops`.
+//!
+//! As for the compressed kernels in `sparse.zig`, block rows of a BSR matrix
+//! are split over the current pool in ranges holding about the same number of
+//! blocks, while the block columns of a BSC matrix add into arbitrary output
+//! segments and run serially. Products with a dense matrix apply the vector
+//! kernel to one column at a time.
+
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const scast = types.scast;
+const ops = @import("../../ops.zig");
+const constants = @import("../../constants.zig");
+
+const pool = @import("../../pool.zig");
+const Pool = pool.Pool;
+
+const sparse = @import("sparse.zig");
+const Strided = sparse.Strided;
+
+/// A block sparse matrix as seen by the product kernels.
+pub fn Operand(comptime T: type) type {
+    return struct {
+        rows: u32,
+        cols: u32,
+        bsize: u32,
+        ptr: [*]const u32,
+        idx: [*]const u32,
+        data: [*]const T,
+        /// Whether the compressed lines are block rows (BSR) or block columns
+        /// (BSC).
+        rowwise: bool,
+        /// Whether the blocks are stored row-major.
+        block_rowwise: bool,
+
+        const Self = @This();
+
+        /// Number of compressed block lines.
+        pub fn lines(self: Self) u32 {
+            return (if (self.rowwise) self.rows else self.cols) / self.bsize;
+        }
+
+        /// The same storage read as the transpose of the matrix.
+        pub fn transpose(self: Self) Self {
+            var result: Self = self;
+            result.rows = self.cols;
+            result.cols = self.rows;
+            result.rowwise = !self.rowwise;
+            result.block_rowwise = !self.block_rowwise;
+            return result;
+        }
+    };
+}
+
+/// Returns the `Operand` view of a block sparse matrix.
+pub fn operand(a: anytype) Operand(types.Numeric(@TypeOf(a))) {
+    const A: type = @TypeOf(a);
+
+    return .{
+        .rows = a.rows,
+        .cols = a.cols,
+        .bsize = a.bsize,
+        .ptr = a.ptr,
+        .idx = a.idx,
+        .data = a.data,
+        .rowwise = comptime types.layoutOf(A) == .row_major,
+        .block_rowwise = comptime A.block_layout == .row_major,
+    };
+}
+
+inline fn isNative(comptime TA: type, comptime TB: type, comptime TC: type) bool {
+    return TA == TC and TB == TC and (TC == f32 or TC == f64);
+}
+
+/// `y[0..bs] += blk * x[0..bs]` for one block. `size` is the block size when
+/// it is known at compile time.
+inline fn apply(
+    comptime TA: type,
+    comptime TB: type,
+    comptime TC: type,
+    comptime size: ?u32,
+    bs: usize,
+    blk: [*]const TA,
+    block_rowwise: bool,
+    x: [*]const TB,
+    y: [*]TC,
+) void {
+    if (comptime size != null and isNative(TA, TB, TC)) {
+        const s: usize = comptime size.?;
+        const V = @Vector(s, TC);
+
+        if (block_rowwise) {
+            const xv: V = x[0..s].*;
+            inline for (0..s) |i| {
+                const row: V = blk[i * s ..][0..s].*;
+                y[i] += @reduce(.Add, row * xv);
+            }
+        } else {
+            var acc: V = y[0..s].*;
+            inline for (0..s) |j| {
+                const col: V = blk[j * s ..][0..s].*;
+                acc += col * @as(V, @splat(x[j]));
+            }
+            y[0..s].* = acc;
+        }
+
+        return;
+    }
+
+    var i: usize = 0;
+    while (i < bs) : (i += 1) {
+        var j: usize = 0;
+        while (j < bs) : (j += 1) {
+            const e: TA = if (block_rowwise) blk[i * bs + j] else blk[i + j * bs];
+            if (comptime isNative(TA, TB, TC)) {
+                y[i] += e * x[j];
+            } else {
+                ops.add_(&y[i], y[i], ops.mul(e, x[j], .{}) catch unreachable, .{}) catch unreachable;
+            }
+        }
+    }
+}
+
+/// Applies the blocks of lines `l0..l1`.
+fn lineRange(
+    comptime TA: type,
+    comptime TB: type,
+    comptime TC: type,
+    comptime size: ?u32,
+    a: Operand(TA),
+    l0: u32,
+    l1: u32,
+    x: [*]const TB,
+    y: [*]TC,
+) void {
+    const bs: usize = if (comptime size) |s| s else a.bsize;
+    const bb: usize = bs * bs;
+
+    var l: u32 = l0;
+    while (l < l1) : (l += 1) {
+        var p: u32 = a.ptr[l];
+        while (p < a.ptr[l + 1]) : (p += 1) {
+            const src: usize = if (a.rowwise) a.idx[p] else l;
+            const dst: usize = if (a.rowwise) l else a.idx[p];
+            apply(TA, TB, TC, size, bs, a.data + p * bb, a.block_rowwise, x + src * bs, y + dst * bs);
+        }
+    }
+}
+
+/// Computes `y += op(A) * x` for contiguous `x` of length `a.cols` and `y` of
+/// length `a.rows`.
+pub fn multiply(comptime TA: type, comptime TB: type, comptime TC: type, a: Operand(TA), x: [*]const TB, y: [*]TC) void {
+    switch (a.bsize) {
+        inline 2, 3, 4, 8 => |s| multiplySized(TA, TB, TC, s, a, x, y),
+        else => multiplySized(TA, TB, TC, null, a, x, y),
+    }
+}
+
+/// `multiply` for blocks of comptime size `size`, or of runtime size if
+/// `null`.
+fn multiplySized(comptime TA: type, comptime TB: type, comptime TC: type, comptime size: ?u32, a: Operand(TA), x: [*]const TB, y: [*]TC) void {
+    const lines: u32 = a.lines();
+
+    const workers: ?*Pool = if (a.rowwise)
+        sparse.team(scast(u64, a.ptr[lines]) * a.bsize * a.bsize + lines)
+    else
+        null;
+
+    const p: *Pool = workers orelse {
+        lineRange(TA, TB, TC, size, a, 0, lines, x, y);
+        return;
+    };
+
+    const Job = struct {
+        a: Operand(TA),
+        x: [*]const TB,
+        y: [*]TC,
+        parts: usize,
+
+        fn run(job: @This(), _: usize, index: usize) void {
+            const l: u32 = job.a.lines();
+            lineRange(TA, TB, TC, size, job.a, sparse.split(job.a.ptr, l, index, job.parts), sparse.split(job.a.ptr, l, index + 1, job.parts), job.x, job.y);
+        }
+    };
+
+    const parts: usize = sparse.partCount(p, lines);
+    p.parallelFor(parts, Job{ .a = a, .x = x, .y = y, .parts = parts }, Job.run);
+}
+
+/// Computes `C = op(A) * B` column by column, where `B` is `a.cols × n` and
+/// `C` is `a.rows × n`. Every column goes through contiguous scratch space.
+pub fn multiplyColumns(
+    comptime TA: type,
+    comptime TB: type,
+    comptime TC: type,
+    allocator: std.mem.Allocator,
+    a: Operand(TA),
+    n: usize,
+    b: Strided([*]const TB),
+    c: Strided([*]TC),
+) !void {
+    const x: []TB = try allocator.alloc(TB, a.cols);
+    defer allocator.free(x);
+    const y: []TC = try allocator.alloc(TC, a.rows);
+    defer allocator.free(y);
+
+    var j: usize = 0;
+    while (j < n) : (j += 1) {
+        for (x, 0..) |*e, i| e.* = b.ptr[i * b.rs + j * b.cs];
+        for (y) |*e| e.* = constants.zero(TC, .{}) catch unreachable;
+
+        multiply(TA, TB, TC, a, x.ptr, y.ptr);
+
+        for (y, 0..) |e, i| c.ptr[i * c.rs + j * c.cs] = e;
+    }
+}
@@ -17,13 +17,15 @@ pub inline fn mm(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anyt
     const k: u32 = a.cols;
     const n: u32 = b.cols;
 
-    var result: matrix.dense.General(C, types.orderOf(A)) = try .init(allocator, m, n);
+    var result: matrix.general.Dense(C, types.layoutOf(A)) = try .init(allocator, m, n);
     errdefer result.deinit(allocator);
 
+    // blas.gemm forwards to the packed engine for f32, f64, cf32 and cf64
+    // once the product is large enough.
     try blas.gemm(
-        types.orderOf(A),
+        types.layoutOf(A),
         .no_trans,
-        if (comptime types.orderOf(A) == types.orderOf(B)) .no_trans else .trans,
+        if (comptime types.layoutOf(A) == types.layoutOf(B)) .no_trans else .trans,
         types.scast(i32, m),
         types.scast(i32, n),
         types.scast(i32, k),
@@ -0,0 +1,32 @@
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const MulCoerce = types.MulCoerce;
+
+const matrix = @import("../../matrix.zig");
+
+const sparse = @import("sparse.zig");
+
+pub inline fn mm(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anytype) !MulCoerce(@TypeOf(a), @TypeOf(b)) {
+    const A: type = @TypeOf(a);
+    const B: type = @TypeOf(b);
+    const C: type = types.Coerce(types.Numeric(A), types.Numeric(B));
+
+    // A * B = (B^T * A^T)^T
+    const op: sparse.Operand(types.Numeric(B)) = sparse.operand(b).transpose();
+
+    var result: matrix.general.Dense(C, types.layoutOf(A)) = try .full(allocator, a.rows, op.rows, 0, ctx);
+    errdefer result.deinit(allocator);
+
+    sparse.multiply(
+        types.Numeric(B),
+        types.Numeric(A),
+        C,
+        op,
+        a.rows,
+        sparse.view([*]const types.Numeric(A), a).transpose(),
+        sparse.view([*]C, result).transpose(),
+    );
+
+    return result;
+}
@@ -0,0 +1,35 @@
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const MulCoerce = types.MulCoerce;
+
+const vector = @import("../../vector.zig");
+
+const sparse = @import("sparse.zig");
+
+pub inline fn vm(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anytype) !MulCoerce(@TypeOf(a), @TypeOf(b)) {
+    const A: type = @TypeOf(a);
+    const B: type = @TypeOf(b);
+    const C: type = types.Coerce(types.Numeric(A), types.Numeric(B));
+
+    // x^T * B = (B^T * x)^T
+    const op: sparse.Operand(types.Numeric(B)) = sparse.operand(b).transpose();
+
+    var result: vector.Dense(C) = try .full(allocator, op.rows, 0, ctx);
+    errdefer result.deinit(allocator);
+
+    const x: []const types.Numeric(A) = try sparse.contiguous(allocator, a);
+    defer sparse.freeContiguous(allocator, a, x);
+
+    sparse.multiply(
+        types.Numeric(B),
+        types.Numeric(A),
+        C,
+        op,
+        1,
+        .{ .ptr = x.ptr, .rs = 1, .cs = 0 },
+        .{ .ptr = result.data, .rs = 1, .cs = 0 },
+    );
+
+    return result;
+}
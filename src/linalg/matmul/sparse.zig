@@ -0,0 +1,801 @@
+//! Kernels shared by the products involving a compressed sparse matrix
+//! (`matrix.{general,symmetric,hermitian,triangular}.Sparse`).
+//!
+//! The sparse operand is read through `Operand`: its compressed lines, whether
+//! those lines are rows (CSR) or columns (CSC), and how the rest of the matrix
+//! follows from what is stored. Symmetric and Hermitian matrices mirror the
+//! strict part of their stored triangle, and unit triangular matrices add an
+//! implicit identity, so every stored entry is read once or twice and the
+//! matrix is never expanded.
+//!
+//! Products with a dense operand accumulate `C += op(A) * B` one term at a
+//! time. When the lines of a term are the rows of the product ("gather"),
+//! every output row belongs to exactly one line, so the lines are split over
+//! the current pool (see `pool.current`) in ranges holding about the same
+//! number of entries. When they are columns ("scatter"), a line adds into
+//! arbitrary output rows, so the columns of `B` are split instead, and a
+//! single column runs serially.
+//!
+//! Sparse-sparse products use Gustavson's row-by-row algorithm on two general
+//! operands with the same orientation, obtained with `general`: a symbolic
+//! pass counts the entries of every output line, and a numeric pass fills
+//! them through a dense accumulator. Both passes run in parallel over ranges
+//! of output lines, each lane with its own accumulator.
+
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const scast = types.scast;
+const ops = @import("../../ops.zig");
+const constants = @import("../../constants.zig");
+
+const pool = @import("../../pool.zig");
+const Pool = pool.Pool;
+
+/// Minimum amount of work (stored entries plus lines, times the number of
+/// right-hand sides) for which a product is split over the pool.
+pub const parallel_threshold: u64 = 1 << 16;
+
+/// Number of parts per thread a parallel product is cut into, so threads that
+/// finish early can pick up more work.
+const parts_per_thread: usize = 4;
+
+/// How the unstored part of a sparse matrix is obtained from the stored
+/// triangle.
+pub const Mirror = enum {
+    /// Everything is stored.
+    none,
+    /// The strict part of the stored triangle is reflected (symmetric).
+    transpose,
+    /// The strict part of the stored triangle is reflected and conjugated
+    /// (Hermitian).
+    conj_transpose,
+};
+
+/// A compressed sparse matrix as seen by the product kernels.
+pub fn Operand(comptime T: type) type {
+    return struct {
+        rows: u32,
+        cols: u32,
+        ptr: [*]const u32,
+        idx: [*]const u32,
+        data: [*]const T,
+        /// Whether the compressed lines are rows (CSR) or columns (CSC).
+        rowwise: bool,
+        /// Whether the stored entries are in the upper triangle. Only
+        /// meaningful if `mirror` is not `none` or `unit` is set.
+        upper: bool = true,
+        mirror: Mirror = .none,
+        /// Whether an implicit unit diagonal is added to the stored entries.
+        unit: bool = false,
+
+        const Self = @This();
+
+        /// Number of compressed lines.
+        pub fn lines(self: Self) u32 {
+            return if (self.rowwise) self.rows else self.cols;
+        }
+
+        /// Number of stored entries.
+        pub fn nnz(self: Self) u32 {
+            return self.ptr[self.lines()];
+        }
+
+        /// The same storage read as the transpose of the matrix. Symmetric
+        /// and Hermitian matrices stay so, with the stored triangle moving to
+        /// the other side.
+        pub fn transpose(self: Self) Self {
+            var result: Self = self;
+            result.rows = self.cols;
+            result.cols = self.rows;
+            result.rowwise = !self.rowwise;
+            result.upper = !self.upper;
+            return result;
+        }
+    };
+}
+
+/// Returns the `Operand` view of a compressed sparse matrix.
+pub fn operand(a: anytype) Operand(types.Numeric(@TypeOf(a))) {
+    const A: type = @TypeOf(a);
+    const T: type = types.Numeric(A);
+
+    const rowwise: bool = comptime types.layoutOf(A) == .row_major;
+
+    switch (comptime types.matrixType(A)) {
+        .general_sparse => return .{
+            .rows = a.rows,
+            .cols = a.cols,
+            .ptr = a.ptr,
+            .idx = a.idx,
+            .data = a.data,
+            .rowwise = rowwise,
+        },
+        .symmetric_sparse => return .{
+            .rows = a.size,
+            .cols = a.size,
+            .ptr = a.ptr,
+            .idx = a.idx,
+            .data = a.data,
+            .rowwise = rowwise,
+            .upper = comptime types.uploOf(A) == .upper,
+            .mirror = .transpose,
+        },
+        .hermitian_sparse => return .{
+            .rows = a.size,
+            .cols = a.size,
+            .ptr = a.ptr,
+            .idx = a.idx,
+            .data = a.data,
+            .rowwise = rowwise,
+            .upper = comptime types.uploOf(A) == .upper,
+            // A real Hermitian matrix is just symmetric.
+            .mirror = if (comptime types.isComplexType(T)) .conj_transpose else .transpose,
+        },
+        .triangular_sparse => return .{
+            .rows = a.rows,
+            .cols = a.cols,
+            .ptr = a.ptr,
+            .idx = a.idx,
+            .data = a.data,
+            .rowwise = rowwise,
+            .upper = comptime types.uploOf(A) == .upper,
+            .unit = comptime types.diagOf(A) == .unit,
+        },
+        else => @compileError("sparse.operand: " ++ @typeName(A) ++ " is not a compressed sparse matrix"),
+    }
+}
+
+/// A dense operand given by a base pointer and the strides between
+/// consecutive rows and columns. `P` is the many-item pointer type.
+pub fn Strided(comptime P: type) type {
+    return struct {
+        ptr: P,
+        rs: usize,
+        cs: usize,
+
+        const Self = @This();
+
+        pub fn transpose(self: Self) Self {
+            return .{ .ptr = self.ptr, .rs = self.cs, .cs = self.rs };
+        }
+    };
+}
+
+/// Returns the strided view of a general dense matrix, with `P` the pointer
+/// type to read it through.
+pub fn view(comptime P: type, x: anytype) Strided(P) {
+    return if (comptime types.layoutOf(@TypeOf(x)) == .col_major)
+        .{ .ptr = x.data, .rs = 1, .cs = x.ld }
+    else
+        .{ .ptr = x.data, .rs = x.ld, .cs = 1 };
+}
+
+/// Returns the elements of a dense vector as a contiguous slice. Unless the
+/// increment is 1, they are copied into memory from `allocator`, which
+/// `freeContiguous` releases.
+pub fn contiguous(allocator: std.mem.Allocator, x: anytype) ![]const types.Numeric(@TypeOf(x)) {
+    const T: type = types.Numeric(@TypeOf(x));
+
+    if (x.inc == 1)
+        return x.data[0..x.len];
+
+    const result: []T = try allocator.alloc(T, x.len);
+
+    const step: usize = scast(usize, if (x.inc < 0) -x.inc else x.inc);
+    for (result, 0..) |*e, i| {
+        e.* = x.data[(if (x.inc < 0) x.len - 1 - i else i) * step];
+    }
+
+    return result;
+}
+
+/// Releases the memory returned by `contiguous`.
+pub fn freeContiguous(allocator: std.mem.Allocator, x: anytype, elements: []const types.Numeric(@TypeOf(x))) void {
+    if (x.inc != 1)
+        allocator.free(elements);
+}
+
+/// The parts of a product term.
+const Term = enum {
+    /// The stored entries.
+    stored,
+    /// The strict part of the stored entries, transposed.
+    transposed,
+    /// The strict part of the stored entries, conjugated and transposed.
+    conj_transposed,
+};
+
+/// Checks whether products of `TA` and `TB` accumulated into `TC` can use the
+/// native operators and `@Vector`.
+inline fn isNative(comptime TA: type, comptime TB: type, comptime TC: type) bool {
+    return TA == TC and TB == TC and (TC == f32 or TC == f64);
+}
+
+/// `acc += a * b`.
+inline fn fma(comptime TC: type, acc: *TC, a: anytype, b: anytype) void {
+    if (comptime isNative(@TypeOf(a), @TypeOf(b), TC)) {
+        acc.* += a * b;
+    } else {
+        ops.add_(acc, acc.*, ops.mul(a, b, .{}) catch unreachable, .{}) catch unreachable;
+    }
+}
+
+/// `y[0..len] += alpha * x[0..len]` on contiguous rows.
+fn axpy(comptime TA: type, comptime TB: type, comptime TC: type, len: usize, alpha: TA, x: [*]const TB, y: [*]TC) void {
+    var i: usize = 0;
+
+    if (comptime isNative(TA, TB, TC)) {
+        const vl: usize = comptime std.simd.suggestVectorLength(TC) orelse 16 / @sizeOf(TC);
+        const V = @Vector(vl, TC);
+        const av: V = @splat(alpha);
+
+        while (i + vl <= len) : (i += vl) {
+            const xv: V = x[i..][0..vl].*;
+            const yv: V = y[i..][0..vl].*;
+            y[i..][0..vl].* = yv + av * xv;
+        }
+    }
+
+    while (i < len) : (i += 1) {
+        fma(TC, &y[i], alpha, x[i]);
+    }
+}
+
+/// Value of stored entry `p` in a term.
+inline fn value(comptime T: type, comptime term: Term, data: [*]const T, p: u32) T {
+    return if (comptime term == .conj_transposed)
+        ops.conj(data[p], .{}) catch unreachable
+    else
+        data[p];
+}
+
+/// Whether the lines of a term are the rows of the term.
+inline fn rowsOf(comptime term: Term, rowwise: bool) bool {
+    return (term == .stored) == rowwise;
+}
+
+/// Accumulates lines `l0..l1` of a term into columns `j0..j1` of `C`.
+fn accumulate(
+    comptime TA: type,
+    comptime TB: type,
+    comptime TC: type,
+    comptime term: Term,
+    a: Operand(TA),
+    l0: u32,
+    l1: u32,
+    j0: usize,
+    j1: usize,
+    b: Strided([*]const TB),
+    c: Strided([*]TC),
+) void {
+    // Gather: line `l` is row `l` of the term, entry `p` reads row `idx[p]`
+    // of `B` and adds into row `l` of `C`. Scatter: the other way around.
+    const gather: bool = rowsOf(term, a.rowwise);
+    const strict: bool = comptime term != .stored;
+
+    if (j1 - j0 > 1 and b.cs == 1 and c.cs == 1) {
+        // Contiguous rows: every entry is an axpy along them.
+        var l: u32 = l0;
+        while (l < l1) : (l += 1) {
+            var p: u32 = a.ptr[l];
+            while (p < a.ptr[l + 1]) : (p += 1) {
+                const i: u32 = a.idx[p];
+                if (strict and i == l)
+                    continue;
+
+                const src: usize = if (gather) i else l;
+                const dst: usize = if (gather) l else i;
+                axpy(TA, TB, TC, j1 - j0, value(TA, term, a.data, p), b.ptr + src * b.rs + j0, c.ptr + dst * c.rs + j0);
+            }
+        }
+
+        return;
+    }
+
+    var j: usize = j0;
+    while (j < j1) : (j += 1) {
+        const x: [*]const TB = b.ptr + j * b.cs;
+        const y: [*]TC = c.ptr + j * c.cs;
+
+        var l: u32 = l0;
+        while (l < l1) : (l += 1) {
+            if (gather) {
+                var sum: TC = constants.zero(TC, .{}) catch unreachable;
+
+                var p: u32 = a.ptr[l];
+                while (p < a.ptr[l + 1]) : (p += 1) {
+                    const i: u32 = a.idx[p];
+                    if (strict and i == l)
+                        continue;
+
+                    fma(TC, &sum, value(TA, term, a.data, p), x[i * b.rs]);
+                }
+
+                ops.add_(&y[l * c.rs], y[l * c.rs], sum, .{}) catch unreachable;
+            } else {
+                const xl: TB = x[l * b.rs];
+
+                var p: u32 = a.ptr[l];
+                while (p < a.ptr[l + 1]) : (p += 1) {
+                    const i: u32 = a.idx[p];
+                    if (strict and i == l)
+                        continue;
+
+                    fma(TC, &y[i * c.rs], value(TA, term, a.data, p), xl);
+                }
+            }
+        }
+    }
+}
+
+/// Returns the first line of part `t` out of `parts`, cutting the `lines`
+/// compressed lines described by `ptr` so that every part holds about the
+/// same number of entries plus lines.
+pub fn split(ptr: [*]const u32, lines: u32, t: usize, parts: usize) u32 {
+    if (t == 0)
+        return 0;
+
+    if (t >= parts)
+        return lines;
+
+    const total: u64 = scast(u64, ptr[lines]) + lines;
+    const target: u64 = total * t / parts;
+
+    var lo: u32 = 0;
+    var hi: u32 = lines;
+    while (lo < hi) {
+        const mid: u32 = lo + (hi - lo) / 2;
+        if (scast(u64, ptr[mid]) + mid < target) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/// Returns the pool to split `work` over, or `null` to run serially.
+pub fn team(work: u64) ?*Pool {
+    if (work < parallel_threshold)
+        return null;
+
+    const current: *Pool = pool.current() orelse return null;
+    return if (current.size() > 1) current else null;
+}
+
+/// Number of parts to cut `len` independent items into on `workers`.
+pub fn partCount(workers: ?*Pool, len: usize) usize {
+    const threads: usize = if (workers) |p| p.size() else 1;
+    return @max(1, @min(len, threads * parts_per_thread));
+}
+
+/// Accumulates one term of `C += op(A) * B` over `n` columns.
+fn addTerm(
+    comptime TA: type,
+    comptime TB: type,
+    comptime TC: type,
+    comptime term: Term,
+    a: Operand(TA),
+    n: usize,
+    b: Strided([*]const TB),
+    c: Strided([*]TC),
+) void {
+    const Job = struct {
+        a: Operand(TA),
+        n: usize,
+        b: Strided([*]const TB),
+        c: Strided([*]TC),
+        parts: usize,
+        gather: bool,
+
+        fn run(job: @This(), _: usize, index: usize) void {
+            if (job.gather) {
+                // Output rows are owned by lines: split the lines.
+                const lines: u32 = job.a.lines();
+                accumulate(TA, TB, TC, term, job.a, split(job.a.ptr, lines, index, job.parts), split(job.a.ptr, lines, index + 1, job.parts), 0, job.n, job.b, job.c);
+            } else {
+                // Lines add into any output row: split the columns.
+                const chunk: usize = (job.n + job.parts - 1) / job.parts;
+                const j0: usize = @min(job.n, index * chunk);
+                accumulate(TA, TB, TC, term, job.a, 0, job.a.lines(), j0, @min(job.n, j0 + chunk), job.b, job.c);
+            }
+        }
+    };
+
+    const gather: bool = rowsOf(term, a.rowwise);
+    const workers: ?*Pool = team((scast(u64, a.nnz()) + a.lines()) * n);
+    const parts: usize = if (workers == null) 1 else partCount(workers, if (gather) a.lines() else n);
+
+    const job: Job = .{ .a = a, .n = n, .b = b, .c = c, .parts = parts, .gather = gather };
+
+    if (workers) |p| {
+        if (parts > 1) {
+            p.parallelFor(parts, job, Job.run);
+            return;
+        }
+    }
+
+    var t: usize = 0;
+    while (t < parts) : (t += 1) {
+        Job.run(job, 0, t);
+    }
+}
+
+/// Computes `C += op(A) * B`, where `B` is `a.cols × n` and `C` is
+/// `a.rows × n`. `C` must not overlap `B`.
+pub fn multiply(
+    comptime TA: type,
+    comptime TB: type,
+    comptime TC: type,
+    a: Operand(TA),
+    n: usize,
+    b: Strided([*]const TB),
+    c: Strided([*]TC),
+) void {
+    addTerm(TA, TB, TC, .stored, a, n, b, c);
+
+    switch (a.mirror) {
+        .none => {},
+        .transpose => addTerm(TA, TB, TC, .transposed, a, n, b, c),
+        .conj_transpose => if (comptime types.isComplexType(TA))
+            addTerm(TA, TB, TC, .conj_transposed, a, n, b, c)
+        else
+            addTerm(TA, TB, TC, .transposed, a, n, b, c),
+    }
+
+    if (a.unit) {
+        var i: usize = 0;
+        while (i < @min(a.rows, a.cols)) : (i += 1) {
+            var j: usize = 0;
+            while (j < n) : (j += 1) {
+                ops.add_(&c.ptr[i * c.rs + j * c.cs], c.ptr[i * c.rs + j * c.cs], b.ptr[i * b.rs + j * b.cs], .{}) catch unreachable;
+            }
+        }
+    }
+}
+
+/// A general compressed matrix, either borrowing the storage of an operand
+/// or owning a rebuilt copy.
+pub fn Compressed(comptime T: type) type {
+    return struct {
+        operand: Operand(T),
+        owned: bool,
+
+        const Self = @This();
+
+        pub fn deinit(self: *Self, allocator: std.mem.Allocator) void {
+            if (self.owned) {
+                const lines: u32 = self.operand.lines();
+                const nnz: u32 = self.operand.nnz();
+                allocator.free(@constCast(self.operand.data[0..nnz]));
+                allocator.free(@constCast(self.operand.idx[0..nnz]));
+                allocator.free(@constCast(self.operand.ptr[0 .. lines + 1]));
+            }
+
+            self.* = undefined;
+        }
+    };
+}
+
+/// Walks the entries of one term, either counting them per output line into
+/// `next[line + 1]` or storing them at `next[line]`.
+fn place(
+    comptime T: type,
+    comptime term: Term,
+    comptime fill: bool,
+    a: Operand(T),
+    rowwise: bool,
+    next: []u32,
+    idx: []u32,
+    data: []T,
+) void {
+    // Entries of a term whose lines have the requested orientation keep their
+    // line; the others move to the line given by their index.
+    const keep: bool = rowsOf(term, a.rowwise) == rowwise;
+
+    var l: u32 = 0;
+    while (l < a.lines()) : (l += 1) {
+        var p: u32 = a.ptr[l];
+        while (p < a.ptr[l + 1]) : (p += 1) {
+            const i: u32 = a.idx[p];
+            if (term != .stored and i == l)
+                continue;
+
+            const line: u32 = if (keep) l else i;
+            if (fill) {
+                idx[next[line]] = if (keep) i else l;
+                data[next[line]] = value(T, term, a.data, p);
+                next[line] += 1;
+            } else {
+                next[line + 1] += 1;
+            }
+        }
+    }
+}
+
+/// Walks the implicit unit diagonal like `place`.
+fn placeUnit(comptime T: type, comptime fill: bool, a: Operand(T), next: []u32, idx: []u32, data: []T) void {
+    var d: u32 = 0;
+    while (d < @min(a.rows, a.cols)) : (d += 1) {
+        if (fill) {
+            idx[next[d]] = d;
+            data[next[d]] = constants.one(T, .{}) catch unreachable;
+            next[d] += 1;
+        } else {
+            next[d + 1] += 1;
+        }
+    }
+}
+
+/// Walks every term of `a`. The terms are visited in the order their entries
+/// appear along an output line, so the indices of every line come out sorted
+/// without a separate sort.
+fn placeAll(comptime T: type, comptime fill: bool, a: Operand(T), rowwise: bool, next: []u32, idx: []u32, data: []T) void {
+    // Along an output line, the stored triangle lies after the diagonal when
+    // it is upper and the lines are rows, or lower and the lines are columns.
+    const stored_after: bool = a.upper == rowwise;
+
+    if (!stored_after)
+        place(T, .stored, fill, a, rowwise, next, idx, data);
+
+    switch (a.mirror) {
+        .none => {},
+        .transpose => place(T, .transposed, fill, a, rowwise, next, idx, data),
+        .conj_transpose => if (comptime types.isComplexType(T))
+            place(T, .conj_transposed, fill, a, rowwise, next, idx, data)
+        else
+            place(T, .transposed, fill, a, rowwise, next, idx, data),
+    }
+
+    if (a.unit)
+        placeUnit(T, fill, a, next, idx, data);
+
+    if (stored_after)
+        place(T, .stored, fill, a, rowwise, next, idx, data);
+}
+
+/// Returns `a` as a general compressed matrix with rows as lines if `rowwise`
+/// is set, or columns otherwise. The storage of `a` is borrowed when it already
+/// is one; otherwise it is rebuilt with a counting sort.
+pub fn general(comptime T: type, allocator: std.mem.Allocator, a: Operand(T), rowwise: bool) !Compressed(T) {
+    if (a.mirror == .none and !a.unit and a.rowwise == rowwise)
+        return .{ .operand = a, .owned = false };
+
+    const lines: u32 = if (rowwise) a.rows else a.cols;
+
+    const ptr: []u32 = try allocator.alloc(u32, lines + 1);
+    errdefer allocator.free(ptr);
+    @memset(ptr, 0);
+
+    placeAll(T, false, a, rowwise, ptr, &.{}, &.{});
+
+    var l: u32 = 0;
+    while (l < lines) : (l += 1) {
+        ptr[l + 1] += ptr[l];
+    }
+
+    const nnz: u32 = ptr[lines];
+
+    const idx: []u32 = try allocator.alloc(u32, nnz);
+    errdefer allocator.free(idx);
+    const data: []T = try allocator.alloc(T, nnz);
+    errdefer allocator.free(data);
+
+    const next: []u32 = try allocator.alloc(u32, lines + 1);
+    defer allocator.free(next);
+    @memcpy(next, ptr);
+
+    placeAll(T, true, a, rowwise, next, idx, data);
+
+    return .{
+        .operand = .{
+            .rows = a.rows,
+            .cols = a.cols,
+            .ptr = ptr.ptr,
+            .idx = idx.ptr,
+            .data = data.ptr,
+            .rowwise = rowwise,
+        },
+        .owned = true,
+    };
+}
+
+/// Per-lane scratch space of the sparse-sparse product.
+fn Accumulator(comptime T: type) type {
+    return struct {
+        /// `marker[j]` is the last line `j` was seen in, plus one.
+        marker: []u32,
+        /// Dense accumulator, valid where `marker` matches the current line.
+        sum: []T,
+        /// Indices touched in the current line.
+        list: []u32,
+    };
+}
+
+/// Storage of a compressed product, owned by the caller.
+pub fn Product(comptime T: type) type {
+    return struct {
+        ptr: []u32,
+        idx: []u32,
+        data: []T,
+    };
+}
+
+/// Computes the general compressed product `x * y` of two rowwise general
+/// operands. The result has `x.rows` lines with indices in `0..y.cols`,
+/// sorted within each line.
+pub fn gustavson(
+    comptime TX: type,
+    comptime TY: type,
+    comptime TC: type,
+    allocator: std.mem.Allocator,
+    x: Operand(TX),
+    y: Operand(TY),
+) !Product(TC) {
+    const lines: u32 = x.rows;
+    const width: u32 = y.cols;
+
+    const ptr: []u32 = try allocator.alloc(u32, lines + 1);
+    errdefer allocator.free(ptr);
+    @memset(ptr, 0);
+
+    // Work estimate: the number of multiplications.
+    var flops: u64 = 0;
+    {
+        var p: u32 = 0;
+        while (p < x.nnz()) : (p += 1) {
+            const k: u32 = x.idx[p];
+            flops += y.ptr[k + 1] - y.ptr[k];
+        }
+    }
+
+    const workers: ?*Pool = team(flops + lines);
+    const parts: usize = if (workers == null) 1 else partCount(workers, lines);
+    const lanes: usize = if (workers) |p| p.lanes(parts) else 1;
+
+    const accs: []Accumulator(TC) = try allocator.alloc(Accumulator(TC), lanes);
+    defer allocator.free(accs);
+
+    var ready: usize = 0;
+    defer for (accs[0..ready]) |acc| {
+        allocator.free(acc.marker);
+        allocator.free(acc.sum);
+        allocator.free(acc.list);
+    };
+
+    while (ready < lanes) : (ready += 1) {
+        const marker: []u32 = try allocator.alloc(u32, width);
+        errdefer allocator.free(marker);
+        const sum: []TC = try allocator.alloc(TC, width);
+        errdefer allocator.free(sum);
+        const list: []u32 = try allocator.alloc(u32, width);
+
+        accs[ready] = .{ .marker = marker, .sum = sum, .list = list };
+    }
+
+    const Job = struct {
+        x: Operand(TX),
+        y: Operand(TY),
+        accs: []Accumulator(TC),
+        parts: usize,
+        ptr: []u32,
+        idx: []u32,
+        data: []TC,
+
+        fn bounds(job: @This(), index: usize) [2]u32 {
+            return .{
+                split(job.x.ptr, job.x.rows, index, job.parts),
+                split(job.x.ptr, job.x.rows, index + 1, job.parts),
+            };
+        }
+
+        /// Counts the entries of lines in part `index` into `ptr[line + 1]`.
+        fn symbolic(job: @This(), lane: usize, index: usize) void {
+            const acc: Accumulator(TC) = job.accs[lane];
+            const range: [2]u32 = job.bounds(index);
+
+            // Lines are visited in order, so markers from earlier parts on
+            // this lane never match a line of this one.
+            var i: u32 = range[0];
+            while (i < range[1]) : (i += 1) {
+                var count: u32 = 0;
+
+                var p: u32 = job.x.ptr[i];
+                while (p < job.x.ptr[i + 1]) : (p += 1) {
+                    const k: u32 = job.x.idx[p];
+
+                    var q: u32 = job.y.ptr[k];
+                    while (q < job.y.ptr[k + 1]) : (q += 1) {
+                        const j: u32 = job.y.idx[q];
+                        if (acc.marker[j] != i + 1) {
+                            acc.marker[j] = i + 1;
+                            count += 1;
+                        }
+                    }
+                }
+
+                job.ptr[i + 1] = count;
+            }
+        }
+
+        /// Fills the entries of lines in part `index`.
+        fn numeric(job: @This(), lane: usize, index: usize) void {
+            const acc: Accumulator(TC) = job.accs[lane];
+            const range: [2]u32 = job.bounds(index);
+
+            var i: u32 = range[0];
+            while (i < range[1]) : (i += 1) {
+                var count: u32 = 0;
+
+                var p: u32 = job.x.ptr[i];
+                while (p < job.x.ptr[i + 1]) : (p += 1) {
+                    const k: u32 = job.x.idx[p];
+                    const xk: TX = job.x.data[p];
+
+                    var q: u32 = job.y.ptr[k];
+                    while (q < job.y.ptr[k + 1]) : (q += 1) {
+                        const j: u32 = job.y.idx[q];
+                        if (acc.marker[j] != i + 1) {
+                            acc.marker[j] = i + 1;
+                            acc.sum[j] = constants.zero(TC, .{}) catch unreachable;
+                            acc.list[count] = j;
+                            count += 1;
+                        }
+
+                        fma(TC, &acc.sum[j], xk, job.y.data[q]);
+                    }
+                }
+
+                std.mem.sort(u32, acc.list[0..count], {}, std.sort.asc(u32));
+
+                const start: u32 = job.ptr[i];
+                for (acc.list[0..count], 0..) |j, e| {
+                    job.idx[start + e] = j;
+                    job.data[start + e] = acc.sum[j];
+                }
+            }
+        }
+
+        fn reset(job: @This()) void {
+            for (job.accs) |acc| @memset(acc.marker, 0);
+        }
+    };
+
+    var job: Job = .{ .x = x, .y = y, .accs = accs, .parts = parts, .ptr = ptr, .idx = &.{}, .data = &.{} };
+
+    job.reset();
+    forEach(workers, parts, job, Job.symbolic);
+
+    var l: u32 = 0;
+    while (l < lines) : (l += 1) {
+        ptr[l + 1] += ptr[l];
+    }
+
+    const nnz: u32 = ptr[lines];
+
+    job.idx = try allocator.alloc(u32, nnz);
+    errdefer allocator.free(job.idx);
+    job.data = try allocator.alloc(TC, nnz);
+    errdefer allocator.free(job.data);
+
+    job.reset();
+    forEach(workers, parts, job, Job.numeric);
+
+    return .{ .ptr = ptr, .idx = job.idx, .data = job.data };
+}
+
+/// Calls `func(job, lane, index)` for every `index` in `0..count`, on
+/// `workers` if given.
+fn forEach(workers: ?*Pool, count: usize, job: anytype, comptime func: fn (@TypeOf(job), usize, usize) void) void {
+    if (workers) |p| {
+        p.parallelFor(count, job, func);
+        return;
+    }
+
+    var i: usize = 0;
+    while (i < count) : (i += 1) {
+        func(job, 0, i);
+    }
+}
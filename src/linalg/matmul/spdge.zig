@@ -0,0 +1,31 @@
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const MulCoerce = types.MulCoerce;
+
+const matrix = @import("../../matrix.zig");
+
+const sparse = @import("sparse.zig");
+
+pub inline fn mm(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anytype) !MulCoerce(@TypeOf(a), @TypeOf(b)) {
+    const A: type = @TypeOf(a);
+    const B: type = @TypeOf(b);
+    const C: type = types.Coerce(types.Numeric(A), types.Numeric(B));
+
+    const op: sparse.Operand(types.Numeric(A)) = sparse.operand(a);
+
+    var result: matrix.general.Dense(C, types.layoutOf(B)) = try .full(allocator, op.rows, b.cols, 0, ctx);
+    errdefer result.deinit(allocator);
+
+    sparse.multiply(
+        types.Numeric(A),
+        types.Numeric(B),
+        C,
+        op,
+        b.cols,
+        sparse.view([*]const types.Numeric(B), b),
+        sparse.view([*]C, result),
+    );
+
+    return result;
+}
@@ -0,0 +1,35 @@
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const MulCoerce = types.MulCoerce;
+
+const vector = @import("../../vector.zig");
+
+const sparse = @import("sparse.zig");
+
+pub inline fn mv(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anytype) !MulCoerce(@TypeOf(a), @TypeOf(b)) {
+    const A: type = @TypeOf(a);
+    const B: type = @TypeOf(b);
+    const C: type = types.Coerce(types.Numeric(A), types.Numeric(B));
+
+    const op: sparse.Operand(types.Numeric(A)) = sparse.operand(a);
+
+    var result: vector.Dense(C) = try .full(allocator, op.rows, 0, ctx);
+    errdefer result.deinit(allocator);
+
+    const x: []const types.Numeric(B) = try sparse.contiguous(allocator, b);
+    defer sparse.freeContiguous(allocator, b, x);
+
+    // Parallel over rows for CSR storage, serial for CSC.
+    sparse.multiply(
+        types.Numeric(A),
+        types.Numeric(B),
+        C,
+        op,
+        1,
+        .{ .ptr = x.ptr, .rs = 1, .cs = 0 },
+        .{ .ptr = result.data, .rs = 1, .cs = 0 },
+    );
+
+    return result;
+}
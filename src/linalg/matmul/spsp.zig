@@ -0,0 +1,40 @@
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const MulCoerce = types.MulCoerce;
+
+const sparse = @import("sparse.zig");
+
+pub inline fn mm(allocator: std.mem.Allocator, a: anytype, b: anytype, ctx: anytype) !MulCoerce(@TypeOf(a), @TypeOf(b)) {
+    _ = ctx;
+
+    const A: type = @TypeOf(a);
+    const B: type = @TypeOf(b);
+    const C: type = types.Coerce(types.Numeric(A), types.Numeric(B));
+    const R: type = MulCoerce(A, B);
+
+    // Both operands are brought to general storage with the orientation of
+    // the result: rows for CSR, columns for CSC.
+    const rowwise: bool = comptime types.layoutOf(R) == .row_major;
+
+    var x: sparse.Compressed(types.Numeric(A)) = try sparse.general(types.Numeric(A), allocator, sparse.operand(a), rowwise);
+    defer x.deinit(allocator);
+    var y: sparse.Compressed(types.Numeric(B)) = try sparse.general(types.Numeric(B), allocator, sparse.operand(b), rowwise);
+    defer y.deinit(allocator);
+
+    // The columns of A * B are the rows of B^T * A^T.
+    const product: sparse.Product(C) = if (comptime rowwise)
+        try sparse.gustavson(types.Numeric(A), types.Numeric(B), C, allocator, x.operand, y.operand)
+    else
+        try sparse.gustavson(types.Numeric(B), types.Numeric(A), C, allocator, y.operand.transpose(), x.operand.transpose());
+
+    return R{
+        .data = product.data.ptr,
+        .idx = product.idx.ptr,
+        .ptr = product.ptr.ptr,
+        .nnz = types.scast(u32, product.idx.len),
+        .rows = x.operand.rows,
+        .cols = y.operand.cols,
+        .flags = .{ .owns_data = true },
+    };
+}
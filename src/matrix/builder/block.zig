@@ -1,9 +1,12 @@
 //! Storage scheme:
 //!
-//! Block-COO (Coordinate List) format. Order chooses ordering of (row, col, data)
+//! Block-COO (Coordinate List) format. Layout chooses ordering of (row, col, data)
 //! arrays:
-//! - row_major: (row, col, data) sorted by row, then by col -> compiles to CSR
-//! - col_major: (col, row, data) sorted by col, then by row -> compiles to CSC
+//! - row_major: (row, col, data) sorted by row, then by col -> compiles to BSR
+//! - col_major: (col, row, data) sorted by col, then by row -> compiles to BSC
+//!
+//! Each block is stored densely in `border` layout. New blocks start out as
+//! zero, so setting a single element creates a block that is zero elsewhere.
 
 const std = @import("std");
 
@@ -12,7 +15,7 @@ const EnsureMatrix = types.EnsureMatrix;
 const Coerce = types.Coerce;
 const ReturnType2 = types.ReturnType2;
 const Numeric = types.Numeric;
-const Order = types.Order;
+const Layout = types.Layout;
 const Uplo = types.Uplo;
 const ops = @import("../../ops.zig");
 const constants = @import("../../constants.zig");
@@ -23,7 +26,7 @@ const Flags = matrix.Flags;
 
 const array = @import("../../array.zig");
 
-pub fn Block(T: type, border: Order, order: Order) type {
+pub fn Block(T: type, border: Layout, layout: Layout) type {
     if (!types.isNumeric(T))
         @compileError("T must be a numeric type");
 
@@ -40,7 +43,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
         _clen: u32, // allocated length of cols
         flags: Flags = .{},
 
-        pub const empty = Block(T, border, order){
+        pub const empty = Block(T, border, layout){
             .data = &.{},
             .row = &.{},
             .col = &.{},
@@ -54,7 +57,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
             .flags = .{ .owns_data = false },
         };
 
-        pub fn init(allocator: std.mem.Allocator, bsize: u32, rows: u32, cols: u32, nnzb: u32) !Block(T, border, order) {
+        pub fn init(allocator: std.mem.Allocator, bsize: u32, rows: u32, cols: u32, nnzb: u32) !Block(T, border, layout) {
             if (rows == 0 or cols == 0)
                 return matrix.Error.ZeroDimension;
 
@@ -82,7 +85,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
             };
         }
 
-        pub fn deinit(self: *Block(T, border, order), allocator: std.mem.Allocator) void {
+        pub fn deinit(self: *Block(T, border, layout), allocator: std.mem.Allocator) void {
             if (self.flags.owns_data) {
                 allocator.free(self.data[0..self._dlen]);
                 allocator.free(self.row[0..self._rlen]);
@@ -92,7 +95,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
             self.* = undefined;
         }
 
-        pub fn reserve(self: *Block(T, border, order), allocator: std.mem.Allocator, new_nnzb: u32) !void {
+        pub fn reserve(self: *Block(T, border, layout), allocator: std.mem.Allocator, new_nnzb: u32) !void {
             if (!self.flags.owns_data)
                 return;
 
@@ -118,7 +121,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
             }
         }
 
-        pub fn get(self: *const Block(T, border, order), r: u32, c: u32) !T {
+        pub fn get(self: *const Block(T, border, layout), r: u32, c: u32) !T {
             if (r >= self.rows or c >= self.cols)
                 return matrix.Error.PositionOutOfBounds;
 
@@ -132,7 +135,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
                 if (self.row[i] == br and self.col[i] == bc)
                     return self.data[i * self.bsize * self.bsize + if (comptime border == .col_major) ri + cj * self.bsize else ri * self.bsize + cj];
 
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     if (self.col[i] > bc or (self.col[i] == bc and self.row[i] > br))
                         break;
                 } else {
@@ -144,7 +147,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
             return constants.zero(T, .{}) catch unreachable;
         }
 
-        pub fn at(self: *Block(T, border, order), r: u32, c: u32) T {
+        pub fn at(self: *Block(T, border, layout), r: u32, c: u32) T {
             // Unchecked version of get. Assumes r and c are valid.
             const br: u32 = r / self.bsize;
             const bc: u32 = c / self.bsize;
@@ -156,7 +159,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
                 if (self.row[i] == br and self.col[i] == bc)
                     return self.data[i * self.bsize * self.bsize + if (comptime border == .col_major) ri + cj * self.bsize else ri * self.bsize + cj];
 
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     if (self.col[i] > bc or (self.col[i] == bc and self.row[i] > br))
                         break;
                 } else {
@@ -168,7 +171,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
             return constants.zero(T, .{}) catch unreachable;
         }
 
-        pub fn getBlock(self: *const Block(T, border, order), br: u32, bc: u32) !matrix.general.Dense(T, border) {
+        pub fn getBlock(self: *const Block(T, border, layout), br: u32, bc: u32) !matrix.general.Dense(T, border) {
             if (br >= self.rows / self.bsize or bc >= self.cols / self.bsize)
                 return matrix.Error.PositionOutOfBounds;
 
@@ -183,7 +186,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
                         .flags = .{ .owns_data = false },
                     };
 
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     if (self.col[i] > bc or (self.col[i] == bc and self.row[i] > br))
                         break;
                 } else {
@@ -195,7 +198,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
             return matrix.Error.PositionOutOfBounds;
         }
 
-        pub fn set(self: *Block(T, border, order), allocator: std.mem.Allocator, r: u32, c: u32, value: T) !void {
+        pub fn set(self: *Block(T, border, layout), allocator: std.mem.Allocator, r: u32, c: u32, value: T) !void {
             if (r >= self.rows or c >= self.cols)
                 return matrix.Error.PositionOutOfBounds;
 
@@ -211,7 +214,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
                     return;
                 }
 
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     if (self.col[i] > bc or (self.col[i] == bc and self.row[i] > br))
                         break;
                 } else {
@@ -246,13 +249,14 @@ pub fn Block(T: type, border: Order, order: Order) type {
                 self.col[j] = self.col[j - 1];
             }
 
+            self.zeroBlock(i);
             self.data[i * self.bsize * self.bsize + if (comptime border == .col_major) ri + cj * self.bsize else ri * self.bsize + cj] = value;
             self.row[i] = br;
             self.col[i] = bc;
             self.nnzb += 1;
         }
 
-        pub fn put(self: *Block(T, border, order), r: u32, c: u32, value: T) void {
+        pub fn put(self: *Block(T, border, layout), r: u32, c: u32, value: T) void {
             // Unchecked version of set. Assumes r and c are valid and there is space.
             const br: u32 = r / self.bsize;
             const bc: u32 = c / self.bsize;
@@ -266,7 +270,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
                     return;
                 }
 
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     if (self.col[i] > bc or (self.col[i] == bc and self.row[i] > br))
                         break;
                 } else {
@@ -288,13 +292,14 @@ pub fn Block(T: type, border: Order, order: Order) type {
                 self.col[j] = self.col[j - 1];
             }
 
+            self.zeroBlock(i);
             self.data[i * self.bsize * self.bsize + if (comptime border == .col_major) ri + cj * self.bsize else ri * self.bsize + cj] = value;
             self.row[i] = br;
             self.col[i] = bc;
             self.nnzb += 1;
         }
 
-        pub fn setBlock(self: *Block(T, border, order), allocator: std.mem.Allocator, br: u32, bc: u32, block: matrix.general.Dense(T, border)) !void {
+        pub fn setBlock(self: *Block(T, border, layout), allocator: std.mem.Allocator, br: u32, bc: u32, block: matrix.general.Dense(T, border)) !void {
             if (br >= self.rows / self.bsize or bc >= self.cols / self.bsize)
                 return matrix.Error.PositionOutOfBounds;
 
@@ -325,7 +330,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
                     return;
                 }
 
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     if (self.col[i] > bc or (self.col[i] == bc and self.row[i] > br))
                         break;
                 } else {
@@ -382,7 +387,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
             self.nnzb += 1;
         }
 
-        pub fn accumulate(self: *Block(T, border, order), allocator: std.mem.Allocator, r: u32, c: u32, value: anytype, ctx: anytype) !void {
+        pub fn accumulate(self: *Block(T, border, layout), allocator: std.mem.Allocator, r: u32, c: u32, value: anytype, ctx: anytype) !void {
             if (r >= self.rows or c >= self.cols)
                 return matrix.Error.PositionOutOfBounds;
 
@@ -404,7 +409,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
                     return;
                 }
 
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     if (self.col[i] > bc or (self.col[i] == bc and self.row[i] > br))
                         break;
                 } else {
@@ -439,13 +444,14 @@ pub fn Block(T: type, border: Order, order: Order) type {
                 self.col[j] = self.col[j - 1];
             }
 
+            self.zeroBlock(i);
             self.data[i * self.bsize * self.bsize + if (comptime border == .col_major) ri + cj * self.bsize else ri * self.bsize + cj] = value;
             self.row[i] = br;
             self.col[i] = bc;
             self.nnzb += 1;
         }
 
-        pub fn accumulateBlock(self: *Block(T, border, order), allocator: std.mem.Allocator, br: u32, bc: u32, block: matrix.general.Dense(T, border), ctx: anytype) !void {
+        pub fn accumulateBlock(self: *Block(T, border, layout), allocator: std.mem.Allocator, br: u32, bc: u32, block: matrix.general.Dense(T, border), ctx: anytype) !void {
             if (br >= self.rows / self.bsize or bc >= self.cols / self.bsize)
                 return matrix.Error.PositionOutOfBounds;
 
@@ -486,7 +492,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
                     return;
                 }
 
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     if (self.col[i] > bc or (self.col[i] == bc and self.row[i] > br))
                         break;
                 } else {
@@ -542,15 +548,25 @@ pub fn Block(T: type, border: Order, order: Order) type {
             self.nnzb += 1;
         }
 
-        pub fn compile(self: *Block(T, border, order), allocator: std.mem.Allocator) !matrix.general.Block(T, border, order) {
-            var ptr: []u32 = try allocator.alloc(u32, if (comptime order == .col_major) self.cols / self.bsize + 1 else self.rows / self.bsize + 1);
+        /// Fills block `i` with zeros.
+        fn zeroBlock(self: *Block(T, border, layout), i: u32) void {
+            const start: u32 = i * self.bsize * self.bsize;
+
+            var k: u32 = 0;
+            while (k < self.bsize * self.bsize) : (k += 1) {
+                self.data[start + k] = constants.zero(T, .{}) catch unreachable;
+            }
+        }
+
+        pub fn compile(self: *Block(T, border, layout), allocator: std.mem.Allocator) !matrix.general.Block(T, border, layout) {
+            var ptr: []u32 = try allocator.alloc(u32, if (comptime layout == .col_major) self.cols / self.bsize + 1 else self.rows / self.bsize + 1);
             errdefer allocator.free(ptr);
             ptr[0] = 0;
 
             var p: u32 = 0;
             var i: u32 = 0;
             while (p < ptr.len - 1) : (p += 1) {
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     while (i < self.nnzb and self.col[i] == p) : (i += 1) {}
                     ptr[p + 1] = i;
                 } else {
@@ -559,7 +575,7 @@ pub fn Block(T: type, border: Order, order: Order) type {
                 }
             }
 
-            if (comptime order == .col_major) {
+            if (comptime layout == .col_major) {
                 allocator.free(self.col[0..self._clen]);
 
                 if (self._dlen > self.nnzb * self.bsize * self.bsize)
@@ -577,9 +593,9 @@ pub fn Block(T: type, border: Order, order: Order) type {
                     self.col = (try allocator.realloc(self.col[0..self._clen], self.nnzb)).ptr;
             }
 
-            const result = matrix.general.Block(T, border, order){
+            const result = matrix.general.Block(T, border, layout){
                 .data = self.data,
-                .idx = if (comptime order == .col_major) self.row else self.col,
+                .idx = if (comptime layout == .col_major) self.row else self.col,
                 .ptr = ptr.ptr,
                 .nnzb = self.nnzb,
                 .bsize = self.bsize,
@@ -593,15 +609,15 @@ pub fn Block(T: type, border: Order, order: Order) type {
             return result;
         }
 
-        pub fn compileCopy(self: *Block(T, border, order), allocator: std.mem.Allocator, ctx: anytype) !matrix.general.Block(T, border, order) {
-            var ptr: []u32 = try allocator.alloc(u32, if (comptime order == .col_major) self.cols / self.bsize + 1 else self.rows / self.bsize + 1);
+        pub fn compileCopy(self: *Block(T, border, layout), allocator: std.mem.Allocator, ctx: anytype) !matrix.general.Block(T, border, layout) {
+            var ptr: []u32 = try allocator.alloc(u32, if (comptime layout == .col_major) self.cols / self.bsize + 1 else self.rows / self.bsize + 1);
             errdefer allocator.free(ptr);
             ptr[0] = 0;
 
             var p: u32 = 0;
             var i: u32 = 0;
             while (p < ptr.len - 1) : (p += 1) {
-                if (comptime order == .col_major) {
+                if (comptime layout == .col_major) {
                     while (i < self.nnzb and self.col[i] == p) : (i += 1) {}
                     ptr[p + 1] = i;
                 } else {
@@ -617,15 +633,15 @@ pub fn Block(T: type, border: Order, order: Order) type {
 
             i = 0;
             while (i < self.nnzb) : (i += 1) {
-                data[i] = try ops.copy(self.data[i], ctx);
-                idx[i] = if (comptime order == .col_major) self.row[i] else self.col[i];
+                idx[i] = if (comptime layout == .col_major) self.row[i] else self.col[i];
             }
 
+            i = 0;
             while (i < self.nnzb * self.bsize * self.bsize) : (i += 1) {
                 data[i] = try ops.copy(self.data[i], ctx);
             }
 
-            const result = matrix.general.Block(T, border, order){
+            const result = matrix.general.Block(T, border, layout){
                 .data = data.ptr,
                 .idx = idx.ptr,
                 .ptr = ptr.ptr,
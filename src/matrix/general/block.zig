@@ -0,0 +1,290 @@
+const std = @import("std");
+
+const types = @import("../../types.zig");
+const Layout = types.Layout;
+const ops = @import("../../ops.zig");
+const constants = @import("../../constants.zig");
+
+const matrix = @import("../../matrix.zig");
+const Flags = matrix.Flags;
+
+/// Block sparse general matrix type, represented in either BSC or BSR format,
+/// depending on if `layout` is column-major or row-major, respectively. The
+/// non-zero entries are dense `bsize × bsize` blocks, each stored contiguously
+/// in `border` order, and `idx` and `ptr` index blocks instead of elements.
+/// Matrices of this type are obtained by compiling a `matrix.builder.Block`.
+pub fn Block(T: type, border: Layout, layout: Layout) type {
+    if (!types.isNumeric(T))
+        @compileError("matrix.general.Block requires a numeric type, got " ++ @typeName(T));
+
+    return struct {
+        data: [*]T,
+        idx: [*]u32,
+        ptr: [*]u32,
+        nnzb: u32,
+        bsize: u32,
+        rows: u32,
+        cols: u32,
+        flags: Flags = .{},
+
+        /// Type signatures
+        pub const is_matrix = {};
+        pub const is_sparse = {};
+        pub const is_general = {};
+        pub const is_block = {};
+        pub const storage_layout = layout;
+        pub const storage_uplo = types.default_uplo;
+        pub const storage_diag = types.default_diag;
+        pub const block_layout = border;
+
+        /// Numeric type
+        pub const Numeric = T;
+
+        pub const empty = Block(T, border, layout){
+            .data = &.{},
+            .idx = &.{},
+            .ptr = &.{},
+            .nnzb = 0,
+            .bsize = 0,
+            .rows = 0,
+            .cols = 0,
+            .flags = .{ .owns_data = false },
+        };
+
+        /// Deinitializes the matrix, freeing any allocated memory and
+        /// invalidating it.
+        ///
+        /// Parameters
+        /// ----------
+        /// `self` (`*matrix.general.Block(T, border, layout)`):
+        /// A pointer to the matrix to deinitialize.
+        ///
+        /// `allocator` (`std.mem.Allocator`):
+        /// The allocator to use for memory deallocation. Must be the same
+        /// allocator used to compile `self`.
+        ///
+        /// Returns
+        /// -------
+        /// `void`
+        ///
+        /// Notes
+        /// -----
+        /// If the elements are of arbitrary precision type, `cleanup` must be
+        /// called before `deinit` to properly deinitialize the elements.
+        pub fn deinit(self: *Block(T, border, layout), allocator: std.mem.Allocator) void {
+            if (self.flags.owns_data) {
+                allocator.free(self.data[0 .. self.nnzb * self.bsize * self.bsize]);
+                allocator.free(self.idx[0..self.nnzb]);
+                allocator.free(self.ptr[0..(if (comptime layout == .col_major) self.cols / self.bsize + 1 else self.rows / self.bsize + 1)]);
+            }
+
+            self.* = undefined;
+        }
+
+        /// Gets the element at the specified position.
+        ///
+        /// Parameters
+        /// ----------
+        /// `self` (`*const matrix.general.Block(T, border, layout)`):
+        /// A pointer to the matrix to get the element from.
+        ///
+        /// `r` (`u32`):
+        /// The row index of the element to get.
+        ///
+        /// `c` (`u32`):
+        /// The column index of the element to get.
+        ///
+        /// Returns
+        /// -------
+        /// `T`:
+        /// The element at the specified position.
+        ///
+        /// Errors
+        /// ------
+        /// `matrix.Error.PositionOutOfBounds`:
+        /// If `r` or `c` is out of bounds.
+        pub fn get(self: *const Block(T, border, layout), r: u32, c: u32) !T {
+            if (r >= self.rows or c >= self.cols)
+                return matrix.Error.PositionOutOfBounds;
+
+            if (self.find(r / self.bsize, c / self.bsize)) |b|
+                return self.data[b * self.bsize * self.bsize + self.offset(r % self.bsize, c % self.bsize)];
+
+            return constants.zero(T, .{}) catch unreachable;
+        }
+
+        /// Gets the element at the specified position without bounds checking.
+        ///
+        /// Parameters
+        /// ----------
+        /// `self` (`*const matrix.general.Block(T, border, layout)`):
+        /// A pointer to the matrix to get the element from.
+        ///
+        /// `r` (`u32`):
+        /// The row index of the element to get. Assumed to be within bounds.
+        ///
+        /// `c` (`u32`):
+        /// The column index of the element to get. Assumed to be within bounds.
+        ///
+        /// Returns
+        /// -------
+        /// `T`:
+        /// The element at the specified position.
+        pub fn at(self: *const Block(T, border, layout), r: u32, c: u32) T {
+            if (self.find(r / self.bsize, c / self.bsize)) |b|
+                return self.data[b * self.bsize * self.bsize + self.offset(r % self.bsize, c % self.bsize)];
+
+            return constants.zero(T, .{}) catch unreachable;
+        }
+
+        /// Sets the element at the specified position.
+        ///
+        /// Parameters
+        /// ----------
+        /// `self` (`*matrix.general.Block(T, border, layout)`):
+        /// A pointer to the matrix to set the element in.
+        ///
+        /// `r` (`u32`):
+        /// The row index of the element to set.
+        ///
+        /// `c` (`u32`):
+        /// The column index of the element to set.
+        ///
+        /// `value` (`T`):
+        /// The value to set the element to.
+        ///
+        /// Returns
+        /// -------
+        /// `void`
+        ///
+        /// Errors
+        /// ------
+        /// `matrix.Error.PositionOutOfBounds`:
+        /// If `r` or `c` is out of bounds.
+        ///
+        /// `matrix.Error.BreaksStructure`:
+        /// If the position does not fall inside a stored block.
+        ///
+        /// Notes
+        /// -----
+        /// If the elements are of arbitrary precision type, the existing
+        /// element at the position is not deinitialized. The user must ensure
+        /// that no memory leaks occur. Additionally, the matrix takes ownership
+        /// of `value`.
+        pub fn set(self: *Block(T, border, layout), r: u32, c: u32, value: T) !void {
+            if (r >= self.rows or c >= self.cols)
+                return matrix.Error.PositionOutOfBounds;
+
+            if (self.find(r / self.bsize, c / self.bsize)) |b| {
+                self.data[b * self.bsize * self.bsize + self.offset(r % self.bsize, c % self.bsize)] = value;
+                return;
+            }
+
+            return matrix.Error.BreaksStructure;
+        }
+
+        /// Sets the element at the specified position without bounds checking.
+        ///
+        /// Parameters
+        /// ----------
+        /// `self` (`*matrix.general.Block(T, border, layout)`):
+        /// A pointer to the matrix to set the element in.
+        ///
+        /// `r` (`u32`):
+        /// The row index of the element to set. Assumed to be within bounds and
+        /// inside a stored block.
+        ///
+        /// `c` (`u32`):
+        /// The column index of the element to set. Assumed to be within bounds
+        /// and inside a stored block.
+        ///
+        /// `value` (`T`):
+        /// The value to set the element to.
+        ///
+        /// Returns
+        /// -------
+        /// `void`
+        ///
+        /// Notes
+        /// -----
+        /// If the elements are of arbitrary precision type, the existing
+        /// element at the position is not deinitialized. The user must ensure
+        /// that no memory leaks occur. Additionally, the matrix takes ownership
+        /// of `value`.
+        pub fn put(self: *Block(T, border, layout), r: u32, c: u32, value: T) void {
+            if (self.find(r / self.bsize, c / self.bsize)) |b|
+                self.data[b * self.bsize * self.bsize + self.offset(r % self.bsize, c % self.bsize)] = value;
+        }
+
+        /// Cleans up the elements of the matrix, deinitializing them if
+        /// necessary.
+        ///
+        /// Parameters
+        /// ----------
+        /// `self` (`*matrix.general.Block(T, border, layout)`):
+        /// A pointer to the matrix to clean up.
+        ///
+        /// `ctx` (`anytype`):
+        /// A context struct providing necessary resources and configuration for
+        /// the operation. The required fields depend on the type `T`. If the
+        /// context is missing required fields or contains unnecessary or
+        /// wrongly typed fields, the compiler will emit a detailed error
+        /// message describing the expected structure.
+        ///
+        /// Returns
+        /// -------
+        /// `void`
+        ///
+        /// Notes
+        /// -----
+        /// This function must be called before `deinit` if the elements are of
+        /// arbitrary precision type to properly deinitialize them.
+        pub fn cleanup(self: *Block(T, border, layout), ctx: anytype) void {
+            switch (comptime types.numericType(T)) {
+                .bool, .int, .float, .cfloat => {
+                    comptime types.validateContext(@TypeOf(ctx), .{});
+
+                    // No cleanup needed for fixed precision types.
+                },
+                .integer, .rational, .real, .complex => {
+                    comptime types.validateContext(
+                        @TypeOf(ctx),
+                        .{
+                            .element_allocator = .{ .type = std.mem.Allocator, .required = true },
+                        },
+                    );
+
+                    var i: u32 = 0;
+                    while (i < self.nnzb * self.bsize * self.bsize) : (i += 1) {
+                        ops.deinit(
+                            &self.data[i],
+                            types.renameStructFields(ctx, .{ .element_allocator = "allocator" }),
+                        );
+                    }
+                },
+            }
+        }
+
+        /// Returns the index of the stored block at block position `(br, bc)`,
+        /// or `null` if there is none.
+        fn find(self: *const Block(T, border, layout), br: u32, bc: u32) ?u32 {
+            const line: u32 = if (comptime layout == .col_major) bc else br;
+            const inner: u32 = if (comptime layout == .col_major) br else bc;
+
+            var b: u32 = self.ptr[line];
+            while (b < self.ptr[line + 1]) : (b += 1) {
+                if (self.idx[b] == inner)
+                    return b
+                else if (self.idx[b] > inner)
+                    break;
+            }
+
+            return null;
+        }
+
+        /// Offset of element `(ri, cj)` inside a block.
+        inline fn offset(self: *const Block(T, border, layout), ri: u32, cj: u32) u32 {
+            return if (comptime border == .col_major) ri + cj * self.bsize else ri * self.bsize + cj;
+        }
+    };
+}
@@ -87,7 +87,7 @@ pub fn Dense(T: type, layout: Layout) type {
                 return matrix.Error.ZeroDimension;
 
             return .{
-                .data = (try allocator.alloc(T, rows * cols)).ptr,
+                .data = (try allocator.alloc(T, @as(usize, rows) * cols)).ptr,
                 .rows = rows,
                 .cols = cols,
                 .ld = if (comptime layout == .col_major) rows else cols,
@@ -0,0 +1,551 @@
+//! Work-stealing thread pool shared by the parallel kernels.
+//!
+//! Parallel routines never spawn threads of their own: they look up the pool
+//! to use with `current`, split their work into tasks and push them onto it.
+//! While waiting for its tasks, the calling thread runs queued tasks itself.
+//! Worker threads resolve `current` to the pool they belong to, so a parallel
+//! routine called from inside a task (for instance the `gemm` updates of a
+//! parallel `getrf`) feeds the same workers instead of starting a second
+//! team, and nested calls never oversubscribe the machine.
+//!
+//! The pool used by a routine is, in order of preference:
+//! - the pool installed on the calling thread with `enter` (the `pool` field
+//!   of the `ctx` argument of the parallel routines does this),
+//! - the pool the calling thread is a worker of,
+//! - the global pool sized by the `threads` build option, created on first
+//!   use. With the default `threads = 1` there is no global pool, and the
+//!   routines run serially unless given a pool explicitly.
+//!
+//! The routines that run in parallel, such as the level 3 BLAS and the
+//! LAPACK factorizations, accept two optional fields in their `ctx` argument
+//! (`parallel_context`), installed with `enterContext` for the duration of
+//! the call:
+//! - `pool` (`?*Pool`): the pool to run on, instead of the current one,
+//! - `scratch` (`?*Arena`): the arena temporaries are allocated from,
+//!   instead of the current one (see `zml.scratch`). Without any, packing
+//!   buffers come from `zml.scratch.cache` and the rest from a general
+//!   purpose allocator.
+
+const std = @import("std");
+const options = @import("options");
+
+const types = @import("types.zig");
+const scratch = @import("scratch.zig");
+const Arena = scratch.Arena;
+
+/// Maximum number of threads that take part in a single `parallelFor`.
+pub const max_lanes: usize = 256;
+
+/// A unit of work. Tasks are owned by whoever submits them and must stay
+/// alive until their group is done.
+pub const Task = struct {
+    run: *const fn (data: *anyopaque) void,
+    data: *anyopaque,
+    group: *Group,
+};
+
+/// Counts the tasks of a batch that have not finished yet.
+pub const Group = struct {
+    pending: std.atomic.Value(usize) = .init(0),
+
+    pub fn done(self: *const Group) bool {
+        return self.pending.load(.acquire) == 0;
+    }
+};
+
+/// Task queue of a single thread. The owner pushes and pops at the tail,
+/// other threads steal from the head, so the owner keeps working on the
+/// most recent (cache-hot) tasks while thieves take the oldest (largest)
+/// ones.
+const Deque = struct {
+    mutex: std.Thread.Mutex = .{},
+    buffer: [capacity]*Task = undefined,
+    head: usize = 0,
+    tail: usize = 0,
+
+    const capacity: usize = 256;
+
+    fn push(self: *Deque, task: *Task) bool {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        if (self.tail - self.head == capacity)
+            return false;
+
+        self.buffer[self.tail % capacity] = task;
+        self.tail += 1;
+        return true;
+    }
+
+    fn pop(self: *Deque) ?*Task {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        if (self.tail == self.head)
+            return null;
+
+        self.tail -= 1;
+        return self.buffer[self.tail % capacity];
+    }
+
+    fn steal(self: *Deque) ?*Task {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        if (self.tail == self.head)
+            return null;
+
+        const task: *Task = self.buffer[self.head % capacity];
+        self.head += 1;
+        return task;
+    }
+};
+
+pub const Pool = struct {
+    allocator: std.mem.Allocator,
+    threads: []std.Thread,
+    /// One queue per worker, plus a shared one (the last) for threads that
+    /// do not belong to the pool.
+    queues: []Deque,
+    /// Number of tasks sitting in the queues.
+    queued: std.atomic.Value(usize),
+    mutex: std.Thread.Mutex,
+    cond: std.Thread.Condition,
+    shutdown: bool,
+
+    pub const Options = struct {
+        /// Number of threads that execute tasks, counting the thread that
+        /// waits on them. `null` uses one per logical CPU.
+        threads: ?usize = null,
+    };
+
+    /// Starts the worker threads. `allocator` is only used for the pool's
+    /// own bookkeeping.
+    pub fn init(self: *Pool, allocator: std.mem.Allocator, opts: Options) !void {
+        const total: usize = opts.threads orelse (std.Thread.getCpuCount() catch 1);
+        const workers: usize = @max(total, 1) - 1;
+
+        self.* = .{
+            .allocator = allocator,
+            .threads = &.{},
+            .queues = &.{},
+            .queued = .init(0),
+            .mutex = .{},
+            .cond = .{},
+            .shutdown = false,
+        };
+
+        self.queues = try allocator.alloc(Deque, workers + 1);
+        errdefer allocator.free(self.queues);
+        for (self.queues) |*queue| queue.* = .{};
+
+        const threads: []std.Thread = try allocator.alloc(std.Thread, workers);
+        errdefer allocator.free(threads);
+
+        self.threads = threads[0..0];
+        errdefer self.stop();
+
+        for (threads, 0..) |*thread, i| {
+            thread.* = try std.Thread.spawn(.{}, work, .{ self, i });
+            self.threads = threads[0 .. i + 1];
+        }
+    }
+
+    /// Stops and joins the worker threads. No task may be in flight.
+    pub fn deinit(self: *Pool) void {
+        self.stop();
+        self.allocator.free(self.threads);
+        self.allocator.free(self.queues);
+        self.* = undefined;
+    }
+
+    fn stop(self: *Pool) void {
+        self.mutex.lock();
+        self.shutdown = true;
+        self.cond.broadcast();
+        self.mutex.unlock();
+
+        for (self.threads) |thread| thread.join();
+    }
+
+    /// Number of threads that execute tasks, counting the waiting thread.
+    pub fn size(self: *const Pool) usize {
+        return self.threads.len + 1;
+    }
+
+    /// Number of lanes `parallelFor` uses for `count` iterations.
+    pub fn lanes(self: *const Pool, count: usize) usize {
+        return @min(self.size(), count, max_lanes);
+    }
+
+    fn work(self: *Pool, index: usize) void {
+        worker_pool = self;
+        worker_index = index;
+
+        while (true) {
+            if (self.take()) |task| {
+                self.execute(task);
+                continue;
+            }
+
+            self.mutex.lock();
+            while (!self.shutdown and self.queued.load(.acquire) == 0)
+                self.cond.wait(&self.mutex);
+
+            const shutdown: bool = self.shutdown;
+            self.mutex.unlock();
+
+            if (shutdown) {
+                // The blocks the tasks left in `scratch.cache` belong to
+                // this thread.
+                scratch.trim();
+                return;
+            }
+        }
+    }
+
+    fn ownQueue(self: *Pool) usize {
+        if (worker_pool) |p| {
+            if (p == self)
+                return worker_index;
+        }
+
+        return self.queues.len - 1;
+    }
+
+    fn take(self: *Pool) ?*Task {
+        if (self.queued.load(.acquire) == 0)
+            return null;
+
+        const own: usize = self.ownQueue();
+        if (self.queues[own].pop()) |task| {
+            _ = self.queued.fetchSub(1, .monotonic);
+            return task;
+        }
+
+        var offset: usize = 1;
+        while (offset < self.queues.len) : (offset += 1) {
+            if (self.queues[(own + offset) % self.queues.len].steal()) |task| {
+                _ = self.queued.fetchSub(1, .monotonic);
+                return task;
+            }
+        }
+
+        return null;
+    }
+
+    fn execute(self: *Pool, task: *Task) void {
+        const group: *Group = task.group;
+        task.run(task.data);
+        // The task may be freed as soon as its group is done.
+        if (group.pending.fetchSub(1, .acq_rel) == 1) {
+            // Wake the thread waiting on the group.
+            self.mutex.lock();
+            self.cond.broadcast();
+            self.mutex.unlock();
+        }
+    }
+
+    /// Queues `task`. Its group's counter must already account for it. If
+    /// the queue is full the task runs immediately on the calling thread.
+    pub fn submit(self: *Pool, task: *Task) void {
+        _ = self.queued.fetchAdd(1, .release);
+
+        if (!self.queues[self.ownQueue()].push(task)) {
+            _ = self.queued.fetchSub(1, .monotonic);
+            self.execute(task);
+            return;
+        }
+
+        self.mutex.lock();
+        self.cond.signal();
+        self.mutex.unlock();
+    }
+
+    /// Runs queued tasks until every task of `group` has finished, sleeping
+    /// while there is nothing to run.
+    pub fn wait(self: *Pool, group: *Group) void {
+        while (!group.done()) {
+            if (self.take()) |task| {
+                self.execute(task);
+                continue;
+            }
+
+            // Woken by `submit` and by the last task of a group.
+            self.mutex.lock();
+            while (!group.done() and self.queued.load(.acquire) == 0)
+                self.cond.wait(&self.mutex);
+            self.mutex.unlock();
+        }
+    }
+
+    /// Calls `func(context, lane, index)` for every `index` in `0..count`,
+    /// spreading the calls over the pool's threads, and returns when all of
+    /// them have finished. Indices are handed out dynamically, so uneven
+    /// iterations balance themselves. `lane` is in `0..lanes(count)` and is
+    /// never shared by two concurrent calls, so it can select per-thread
+    /// scratch space.
+    pub fn parallelFor(
+        self: *Pool,
+        count: usize,
+        context: anytype,
+        comptime func: fn (@TypeOf(context), usize, usize) void,
+    ) void {
+        const Context: type = @TypeOf(context);
+        const Batch = struct {
+            next: std.atomic.Value(usize),
+            lane: std.atomic.Value(usize),
+            count: usize,
+            context: Context,
+
+            fn run(data: *anyopaque) void {
+                const batch: *@This() = @ptrCast(@alignCast(data));
+                batch.drain(batch.lane.fetchAdd(1, .monotonic));
+            }
+
+            fn drain(batch: *@This(), lane: usize) void {
+                while (true) {
+                    const index: usize = batch.next.fetchAdd(1, .monotonic);
+                    if (index >= batch.count)
+                        return;
+
+                    func(batch.context, lane, index);
+                }
+            }
+        };
+
+        if (count == 0)
+            return;
+
+        var batch: Batch = .{
+            .next = .init(0),
+            .lane = .init(1),
+            .count = count,
+            .context = context,
+        };
+
+        const helpers: usize = self.lanes(count) - 1;
+        var group: Group = .{};
+        group.pending.store(helpers, .monotonic);
+
+        var tasks: [max_lanes]Task = undefined;
+        for (tasks[0..helpers]) |*task| {
+            task.* = .{ .run = Batch.run, .data = &batch, .group = &group };
+            self.submit(task);
+        }
+
+        batch.drain(0);
+        self.wait(&group);
+    }
+};
+
+/// Directed acyclic graph of tasks, identified by index. Running the graph
+/// calls `func(context, node)` for every node once all the nodes it depends
+/// on have finished, so independent nodes (for instance the trailing update
+/// of a factorization and the next panel) overlap.
+pub fn Graph(comptime Context: type, comptime func: fn (Context, u32) void) type {
+    return struct {
+        allocator: std.mem.Allocator,
+        nodes: []Node,
+        edges: std.ArrayListUnmanaged(Edge),
+        successors: []u32,
+        pool: *Pool,
+        context: Context,
+        group: Group,
+
+        const Self = @This();
+
+        const Node = struct {
+            task: Task,
+            graph: *Self,
+            id: u32,
+            pending: std.atomic.Value(u32),
+            start: u32,
+            end: u32,
+        };
+
+        const Edge = struct {
+            from: u32,
+            to: u32,
+        };
+
+        pub fn init(allocator: std.mem.Allocator, count: u32) !Self {
+            const nodes: []Node = try allocator.alloc(Node, count);
+            for (nodes, 0..) |*node, i| {
+                node.* = .{
+                    .task = undefined,
+                    .graph = undefined,
+                    .id = @intCast(i),
+                    .pending = .init(0),
+                    .start = 0,
+                    .end = 0,
+                };
+            }
+
+            return .{
+                .allocator = allocator,
+                .nodes = nodes,
+                .edges = .empty,
+                .successors = &.{},
+                .pool = undefined,
+                .context = undefined,
+                .group = .{},
+            };
+        }
+
+        pub fn deinit(self: *Self) void {
+            self.allocator.free(self.nodes);
+            self.edges.deinit(self.allocator);
+            self.allocator.free(self.successors);
+            self.* = undefined;
+        }
+
+        /// Makes `node` wait for `on`.
+        pub fn depend(self: *Self, node: u32, on: u32) !void {
+            try self.edges.append(self.allocator, .{ .from = on, .to = node });
+            self.nodes[node].pending.raw += 1;
+        }
+
+        fn lessThan(_: void, a: Edge, b: Edge) bool {
+            return a.from < b.from;
+        }
+
+        /// Executes the graph on `pool` and returns when every node has run.
+        /// The graph can only be run once.
+        pub fn run(self: *Self, pool: *Pool, context: Context) !void {
+            self.successors = try self.allocator.alloc(u32, self.edges.items.len);
+
+            std.mem.sort(Edge, self.edges.items, {}, lessThan);
+            var e: u32 = 0;
+            for (self.nodes) |*node| {
+                node.start = e;
+                while (e < self.edges.items.len and self.edges.items[e].from == node.id) : (e += 1) {
+                    self.successors[e] = self.edges.items[e].to;
+                }
+                node.end = e;
+            }
+
+            self.pool = pool;
+            self.context = context;
+            self.group.pending.store(self.nodes.len, .monotonic);
+
+            for (self.nodes) |*node| {
+                node.graph = self;
+                node.task = .{ .run = runNode, .data = node, .group = &self.group };
+            }
+
+            // Collect the roots before submitting any of them: once a node
+            // runs, the counters of its successors start moving.
+            var roots: std.ArrayListUnmanaged(u32) = .empty;
+            defer roots.deinit(self.allocator);
+            for (self.nodes) |*node| {
+                if (node.pending.raw == 0)
+                    try roots.append(self.allocator, node.id);
+            }
+
+            for (roots.items) |id| pool.submit(&self.nodes[id].task);
+
+            pool.wait(&self.group);
+        }
+
+        fn runNode(data: *anyopaque) void {
+            const node: *Node = @ptrCast(@alignCast(data));
+            const self: *Self = node.graph;
+
+            func(self.context, node.id);
+
+            for (self.successors[node.start..node.end]) |id| {
+                if (self.nodes[id].pending.fetchSub(1, .acq_rel) == 1)
+                    self.pool.submit(&self.nodes[id].task);
+            }
+        }
+    };
+}
+
+threadlocal var override: ?*Pool = null;
+threadlocal var worker_pool: ?*Pool = null;
+threadlocal var worker_index: usize = 0;
+
+var global: Pool = undefined;
+var global_ok: bool = false;
+var global_once = std.once(initGlobal);
+
+fn initGlobal() void {
+    global.init(std.heap.page_allocator, .{
+        .threads = if (options.threads == 0) null else options.threads,
+    }) catch return;
+
+    global_ok = true;
+}
+
+/// Returns the pool parallel routines called from this thread should use,
+/// or `null` if they should run serially.
+pub fn current() ?*Pool {
+    if (override) |pool|
+        return pool;
+
+    if (worker_pool) |pool|
+        return pool;
+
+    if (comptime options.threads != 1) {
+        global_once.call();
+        if (global_ok)
+            return &global;
+    }
+
+    return null;
+}
+
+/// Installs `pool` (if not `null`) as the current pool of the calling
+/// thread, returning the previous override to be restored with `leave`.
+pub fn enter(pool: ?*Pool) ?*Pool {
+    const previous: ?*Pool = override;
+    if (pool) |p|
+        override = p;
+
+    return previous;
+}
+
+/// Restores the override returned by `enter`.
+pub fn leave(previous: ?*Pool) void {
+    override = previous;
+}
+
+/// Context fields of the routines that run in parallel, for
+/// `types.validateContext`.
+pub const parallel_context = .{
+    .pool = .{
+        .type = ?*Pool,
+        .required = false,
+        .default = null,
+        .description = "The pool to run on. If not provided, the current pool is used (see `zml.pool.current`).",
+    },
+    .scratch = .{
+        .type = ?*Arena,
+        .required = false,
+        .default = null,
+        .description = "The arena temporaries are allocated from, released with `Arena.reset`. If not provided, the current arena is used (see `zml.scratch.current`).",
+    },
+};
+
+/// The pool and arena overrides replaced by `enterContext`.
+pub const Scope = struct {
+    pool: ?*Pool,
+    scratch: ?*Arena,
+
+    /// Restores the overrides.
+    pub fn leave(self: Scope) void {
+        scratch.leave(self.scratch);
+        override = self.pool;
+    }
+};
+
+/// Installs the `pool` and `scratch` fields of `ctx` (see
+/// `parallel_context`) on the calling thread, until `leave` is called on
+/// the result.
+pub fn enterContext(ctx: anytype) Scope {
+    return .{
+        .pool = enter(types.getFieldOrDefault(ctx, parallel_context, "pool")),
+        .scratch = scratch.enter(types.getFieldOrDefault(ctx, parallel_context, "scratch")),
+    };
+}
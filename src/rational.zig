@@ -13,6 +13,7 @@ const integer = @import("integer.zig");
 const Integer = integer.Integer;
 const complex = @import("complex.zig");
 const Complex = complex.Complex;
+const scratch = @import("scratch.zig");
 
 pub var default_accuracy: u32 = 50;
 pub var default_internal_accuracy: u32 = 60;
@@ -140,8 +141,15 @@ pub const Rational = struct {
         if (integer.eq(self.den, 0))
             return rational.Error.ZeroDenominator;
 
-        var g: Integer = try integer.gcd(allocator, self.num, self.den);
-        defer g.deinit(allocator);
+        const temporaries: std.mem.Allocator = scratch.allocator(allocator);
+
+        var buffer: [integer.small_limbs]u32 = undefined;
+        var g: Integer = .initBuffer(&buffer);
+        defer g.deinit(temporaries);
+        try integer.gcd_(temporaries, &g, self.num, self.den);
+
+        if (g.size == 1 and g.limbs[0] == 1)
+            return;
 
         try integer.div_(allocator, &self.num, self.num, g);
         try integer.div_(allocator, &self.den, self.den, g);
@@ -4,6 +4,7 @@ const types = @import("../types.zig");
 const integer = @import("../integer.zig");
 const rational = @import("../rational.zig");
 const Rational = rational.Rational;
+const scratch = @import("../scratch.zig");
 
 const ops = @import("../ops.zig");
 
@@ -101,11 +102,13 @@ pub fn add_(allocator: std.mem.Allocator, o: *Rational, x: anytype, y: anytype)
                     if (!o.den.flags.writable)
                         return integer.Error.NotWritable;
 
+                const temporaries: std.mem.Allocator = scratch.allocator(allocator);
+
                 // Aliasing checks
-                var tx: Rational = try check_aliasing_alloc(allocator, o, x);
-                defer tx.deinit(allocator);
-                var ty: Rational = try check_aliasing_alloc(allocator, o, y);
-                defer ty.deinit(allocator);
+                var tx: Rational = try check_aliasing_alloc(temporaries, o, x);
+                defer tx.deinit(temporaries);
+                var ty: Rational = try check_aliasing_alloc(temporaries, o, y);
+                defer ty.deinit(temporaries);
 
                 if (cmpxy == .eq) {
                     try integer.add_(allocator, &o.num, tx.num, ty.num);
@@ -119,8 +122,10 @@ pub fn add_(allocator: std.mem.Allocator, o: *Rational, x: anytype, y: anytype)
                 }
 
                 // a/b + c/d = (a*d + b*c) / (b*d)
-                var ad: integer.Integer = try integer.mul(allocator, tx.num, ty.den);
-                defer ad.deinit(allocator);
+                var buffer: [integer.small_limbs]u32 = undefined;
+                var ad: integer.Integer = .initBuffer(&buffer);
+                defer ad.deinit(temporaries);
+                try integer.mul_(temporaries, &ad, tx.num, ty.den);
 
                 try integer.mul_(allocator, &o.den, tx.den, ty.num);
                 try integer.add_(allocator, &o.den, ad, o.den);
@@ -5,13 +5,20 @@ const rational = @import("../rational.zig");
 
 const check_aliasing = @import("check_aliasing.zig").check_aliasing;
 
+/// Checks if `x` is aliased with `o`, and if so, returns a copy of `x`
+/// allocated with `allocator`. Otherwise, returns a view of `x` that does not
+/// own its data, so that the result can always be deinitialized.
 pub fn check_aliasing_alloc(allocator: std.mem.Allocator, o: *const rational.Rational, x: anytype) !@TypeOf(x) {
     switch (comptime types.numericType(@TypeOf(x))) {
         .bool, .int, .float, .cfloat => return x,
-        .integer, .rational => return if (check_aliasing(o, x))
-            x.copy(allocator)
-        else
-            x,
+        .integer, .rational => {
+            if (check_aliasing(o, x))
+                return x.copy(allocator);
+
+            var view: @TypeOf(x) = x;
+            view.flags.owns_data = false;
+            return view;
+        },
         else => unreachable,
     }
 }
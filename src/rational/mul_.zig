@@ -5,6 +5,7 @@ const constants = @import("../constants.zig");
 const integer = @import("../integer.zig");
 const rational = @import("../rational.zig");
 const Rational = rational.Rational;
+const scratch = @import("../scratch.zig");
 
 const check_aliasing_alloc = @import("check_aliasing_alloc.zig").check_aliasing_alloc;
 
@@ -75,15 +76,18 @@ pub fn mul_(allocator: std.mem.Allocator, o: *Rational, x: anytype, y: anytype)
                     return;
                 }
 
+                const temporaries: std.mem.Allocator = scratch.allocator(allocator);
+
                 // Aliasing checks
-                var tx: Rational = try check_aliasing_alloc(allocator, o, x);
-                defer tx.deinit(allocator);
-                var ty: Rational = try check_aliasing_alloc(allocator, o, y);
-                defer ty.deinit(allocator);
+                var tx: Rational = try check_aliasing_alloc(temporaries, o, x);
+                defer tx.deinit(temporaries);
+                var ty: Rational = try check_aliasing_alloc(temporaries, o, y);
+                defer ty.deinit(temporaries);
 
                 // a/b * c/d = (a*c)/(b*d)
-                var temp: integer.Integer = try .init(allocator, 0);
-                defer temp.deinit(allocator);
+                var buffer: [integer.small_limbs]u32 = undefined;
+                var temp: integer.Integer = .initBuffer(&buffer);
+                defer temp.deinit(temporaries);
 
                 if (integer.eq(tx.num, constants.one(integer.Integer, .{}) catch unreachable)) {
                     if (integer.ne(o.num, ty.num)) {
@@ -100,7 +104,7 @@ pub fn mul_(allocator: std.mem.Allocator, o: *Rational, x: anytype, y: anytype)
                         try o.num.set(allocator, tx.num);
                     }
                 } else {
-                    try integer.mul_(allocator, &temp, tx.num, ty.num);
+                    try integer.mul_(temporaries, &temp, tx.num, ty.num);
 
                     if (integer.ne(o.num, temp)) {
                         if (!o.num.flags.writable)
@@ -125,7 +129,7 @@ pub fn mul_(allocator: std.mem.Allocator, o: *Rational, x: anytype, y: anytype)
                         try o.den.set(allocator, tx.den);
                     }
                 } else {
-                    try integer.mul_(allocator, &temp, tx.den, ty.den);
+                    try integer.mul_(temporaries, &temp, tx.den, ty.den);
 
                     if (integer.ne(o.den, temp)) {
                         if (!o.den.flags.writable)
@@ -0,0 +1,215 @@
+//! Arena for the temporaries of the BLAS, LAPACK, array and arbitrary
+//! precision kernels.
+//!
+//! Temporaries are the packing buffers of the level 3 routines, the task
+//! graphs of the factorizations, and the intermediate integers of the
+//! `Integer` and `Rational` operations. By default each one is a call to a
+//! general purpose allocator. Installing an `Arena` with `enter` (the
+//! `scratch` field of the `ctx` argument of the routines that support it does
+//! this) turns them into bump allocations that are released in bulk with
+//! `Arena.reset`, or when the arena is deinitialized.
+//!
+//! Temporaries are freed in the reverse order they are allocated, so the
+//! arena gives the memory of the last allocation back on `free`, and keeps
+//! its footprint at the high-water mark of a single call.
+//!
+//! The arena is installed for the calling thread only: worker threads of a
+//! pool keep using the fallback allocator of each routine.
+//!
+//! Routines whose temporaries are large and of the same size from one call to
+//! the next, such as the packing buffers of the level 3 BLAS, fall back to
+//! `cache`, which keeps the last block freed on each thread for reuse instead
+//! of unmapping it.
+
+const std = @import("std");
+
+/// Thread-safe bump allocator over memory from a backing allocator.
+pub const Arena = struct {
+    arena: std.heap.ArenaAllocator,
+    mutex: std.Thread.Mutex = .{},
+    /// Number of allocations served, for profiling.
+    allocations: usize = 0,
+
+    pub fn init(backing: std.mem.Allocator) Arena {
+        return .{ .arena = .init(backing) };
+    }
+
+    /// Frees all the memory of the arena, invalidating it.
+    pub fn deinit(self: *Arena) void {
+        self.arena.deinit();
+        self.* = undefined;
+    }
+
+    /// Releases everything allocated from the arena at once, keeping the
+    /// memory for the next allocations.
+    pub fn reset(self: *Arena) void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        _ = self.arena.reset(.retain_capacity);
+    }
+
+    pub fn allocator(self: *Arena) std.mem.Allocator {
+        return .{
+            .ptr = self,
+            .vtable = &.{
+                .alloc = alloc,
+                .resize = resize,
+                .remap = remap,
+                .free = free,
+            },
+        };
+    }
+
+    fn alloc(context: *anyopaque, len: usize, alignment: std.mem.Alignment, ret_addr: usize) ?[*]u8 {
+        const self: *Arena = @ptrCast(@alignCast(context));
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        self.allocations += 1;
+        return self.arena.allocator().rawAlloc(len, alignment, ret_addr);
+    }
+
+    fn resize(context: *anyopaque, memory: []u8, alignment: std.mem.Alignment, new_len: usize, ret_addr: usize) bool {
+        const self: *Arena = @ptrCast(@alignCast(context));
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        return self.arena.allocator().rawResize(memory, alignment, new_len, ret_addr);
+    }
+
+    fn remap(context: *anyopaque, memory: []u8, alignment: std.mem.Alignment, new_len: usize, ret_addr: usize) ?[*]u8 {
+        const self: *Arena = @ptrCast(@alignCast(context));
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        return self.arena.allocator().rawRemap(memory, alignment, new_len, ret_addr);
+    }
+
+    fn free(context: *anyopaque, memory: []u8, alignment: std.mem.Alignment, ret_addr: usize) void {
+        const self: *Arena = @ptrCast(@alignCast(context));
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        self.arena.allocator().rawFree(memory, alignment, ret_addr);
+    }
+};
+
+threadlocal var override: ?*Arena = null;
+
+/// Returns the arena installed on the calling thread, if any.
+pub fn current() ?*Arena {
+    return override;
+}
+
+/// Returns the allocator temporaries should come from: the arena installed
+/// on the calling thread, or `fallback` if there is none.
+pub fn allocator(fallback: std.mem.Allocator) std.mem.Allocator {
+    return if (override) |arena| arena.allocator() else fallback;
+}
+
+/// Installs `arena` (if not `null`) as the scratch arena of the calling
+/// thread, returning the previous one to be restored with `leave`.
+pub fn enter(arena: ?*Arena) ?*Arena {
+    const previous: ?*Arena = override;
+    if (arena) |a|
+        override = a;
+
+    return previous;
+}
+
+/// Restores the arena returned by `enter`.
+pub fn leave(previous: ?*Arena) void {
+    override = previous;
+}
+
+/// Allocator that keeps, on each thread, the last freed block of every power
+/// of two size class, and serves the next allocation of that class from it.
+/// Blocks come from the page allocator, so a repeated call with the same
+/// temporaries does not map and unmap them each time.
+///
+/// The cached blocks of a thread are kept until `trim` is called on it.
+pub const cache: std.mem.Allocator = .{
+    .ptr = undefined,
+    .vtable = &Cache.vtable,
+};
+
+/// Returns the blocks cached by `cache` on the calling thread to the system.
+pub fn trim() void {
+    for (&Cache.blocks, 0..) |*block, c| {
+        if (block.*) |ptr| {
+            std.heap.page_allocator.rawFree(ptr[0..Cache.size(@intCast(c))], Cache.page, @returnAddress());
+            block.* = null;
+        }
+    }
+}
+
+const Cache = struct {
+    const Class = std.math.Log2Int(usize);
+    const page: std.mem.Alignment = .fromByteUnits(std.heap.page_size_min);
+
+    threadlocal var blocks: [@bitSizeOf(usize)]?[*]u8 = @splat(null);
+
+    const vtable: std.mem.Allocator.VTable = .{
+        .alloc = alloc,
+        .resize = resize,
+        .remap = remap,
+        .free = free,
+    };
+
+    inline fn size(c: Class) usize {
+        return @as(usize, 1) << c;
+    }
+
+    /// Size class of a block of `len` bytes, at least a page.
+    fn class(len: usize) ?Class {
+        const rounded: usize = std.math.ceilPowerOfTwo(usize, @max(len, std.heap.page_size_min)) catch return null;
+        return std.math.log2_int(usize, rounded);
+    }
+
+    /// Alignments above a page are passed through to the page allocator.
+    inline fn cached(alignment: std.mem.Alignment) bool {
+        return alignment.compare(.lte, page);
+    }
+
+    fn alloc(_: *anyopaque, len: usize, alignment: std.mem.Alignment, ret_addr: usize) ?[*]u8 {
+        if (!cached(alignment))
+            return std.heap.page_allocator.rawAlloc(len, alignment, ret_addr);
+
+        const c: Class = class(len) orelse return null;
+        if (blocks[c]) |ptr| {
+            blocks[c] = null;
+            return ptr;
+        }
+
+        return std.heap.page_allocator.rawAlloc(size(c), page, ret_addr);
+    }
+
+    fn resize(_: *anyopaque, memory: []u8, alignment: std.mem.Alignment, new_len: usize, ret_addr: usize) bool {
+        if (!cached(alignment))
+            return std.heap.page_allocator.rawResize(memory, alignment, new_len, ret_addr);
+
+        // The class is recomputed from the length on `free`, so it must not
+        // change.
+        return class(new_len) == class(memory.len);
+    }
+
+    fn remap(context: *anyopaque, memory: []u8, alignment: std.mem.Alignment, new_len: usize, ret_addr: usize) ?[*]u8 {
+        if (!cached(alignment))
+            return std.heap.page_allocator.rawRemap(memory, alignment, new_len, ret_addr);
+
+        return if (resize(context, memory, alignment, new_len, ret_addr)) memory.ptr else null;
+    }
+
+    fn free(_: *anyopaque, memory: []u8, alignment: std.mem.Alignment, ret_addr: usize) void {
+        if (!cached(alignment))
+            return std.heap.page_allocator.rawFree(memory, alignment, ret_addr);
+
+        const c: Class = class(memory.len).?;
+        if (blocks[c] == null) {
+            blocks[c] = memory.ptr;
+        } else {
+            std.heap.page_allocator.rawFree(memory.ptr[0..size(c)], page, ret_addr);
+        }
+    }
+};
@@ -586,6 +586,7 @@ pub const isHermitianMatrix = type_checks.isHermitianMatrix;
 pub const isTriangularMatrix = type_checks.isTriangularMatrix;
 pub const isDenseMatrix = type_checks.isDenseMatrix;
 pub const isSparseMatrix = type_checks.isSparseMatrix;
+pub const isBlockMatrix = type_checks.isBlockMatrix;
 pub const isCustomMatrix = type_checks.isCustomMatrix;
 pub const isArray = type_checks.isArray;
 pub const isDenseArray = type_checks.isDenseArray;
@@ -463,6 +463,21 @@ pub fn isSparseMatrix(comptime T: type) bool {
     }
 }
 
+/// Checks if the input type is a block sparse matrix, i.e., a sparse matrix
+/// whose entries are dense square blocks.
+///
+/// ## Arguments
+/// * `T` (`comptime type`): The type to check.
+///
+/// ## Returns
+/// `bool`: `true` if the type is a block sparse matrix, `false` otherwise.
+pub fn isBlockMatrix(comptime T: type) bool {
+    switch (comptime @typeInfo(T)) {
+        .@"struct" => return @hasDecl(T, "is_matrix") and T.is_matrix and @hasDecl(T, "is_block") and T.is_block,
+        else => return false,
+    }
+}
+
 /// Checks if the input type is an instance of a custom matrix.
 ///
 /// ## Arguments
@@ -183,6 +183,14 @@ pub const ceil_ = ops.ceil_;
 pub const set = ops.set;
 pub const deinit = ops.deinit;
 
+// Parallel execution
+pub const pool = @import("pool.zig");
+pub const Pool = pool.Pool;
+
+// Scratch memory
+pub const scratch = @import("scratch.zig");
+pub const Arena = scratch.Arena;
+
 // Domain namespaces
 pub const numeric = @import("numeric.zig");
 pub const vector = @import("vector.zig");
@@ -192,6 +200,9 @@ pub const array = @import("array.zig");
 pub const linalg = @import("linalg.zig");
 pub const autodiff = @import("autodiff.zig");
 
+// Reading and writing arrays and matrices
+pub const io = @import("io.zig");
+
 // Symbolic system.
 //pub const Expression = @import("expression/expression.zig").Expression;
 //pub const Symbol = @import("symbol.zig").Symbol;
@@ -0,0 +1,17 @@
+test {
+    const test_apply = true;
+    const test_lazy = true;
+    const test_reduce = true;
+
+    if (test_apply) {
+        _ = @import("array/apply.zig");
+    }
+
+    if (test_lazy) {
+        _ = @import("array/lazy.zig");
+    }
+
+    if (test_reduce) {
+        _ = @import("array/reduce.zig");
+    }
+}
@@ -0,0 +1,37 @@
+const std = @import("std");
+const zml = @import("zml");
+
+const array = zml.array;
+const Dense = array.Dense;
+
+/// Checks `apply1(x, float.exp)` against `float.exp` on each element, for a
+/// contiguous `x` of `len` elements in `[-10, 10]`.
+fn checkExp(comptime T: type, len: u32) !void {
+    const allocator = std.testing.allocator;
+
+    var x: Dense(T, .row_major) = try .init(allocator, &.{len});
+    defer x.deinit(allocator);
+    for (0..len) |i| {
+        x.data[i] = -10 + 20 * @as(T, @floatFromInt(i)) / @as(T, @floatFromInt(len));
+    }
+
+    var r = try array.apply1(allocator, x, zml.float.exp, .{});
+    defer r.deinit(allocator);
+
+    // The vector kernels and the scalar function are each within a few ULP
+    // of the correctly rounded result.
+    for (0..len) |i| {
+        try std.testing.expectApproxEqRel(zml.float.exp(x.data[i]), r.data[i], 4 * std.math.floatEps(T));
+    }
+}
+
+test "apply1 exp against the scalar function" {
+    inline for (.{ f32, f64 }) |T| {
+        const n: u32 = comptime std.simd.suggestVectorLength(T) orelse 1;
+
+        // Full vectors only, then a padded tail.
+        try checkExp(T, 16 * n);
+        try checkExp(T, 16 * n + n / 2 + 1);
+        try checkExp(T, 1);
+    }
+}
@@ -0,0 +1,145 @@
+const std = @import("std");
+const zml = @import("zml");
+
+const lazy = zml.array.lazy;
+const Dense = zml.array.Dense;
+
+test "lazy eval" {
+    const allocator = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(allocator, .{ .threads = 4 });
+    defer pool.deinit();
+
+    // Small, split over lines and split along a single line.
+    const shapes = [_][]const u32{ &.{ 3, 5 }, &.{ 300, 301 }, &.{100003} };
+    for (shapes) |shape| {
+        var a: Dense(f64, .row_major) = try .init(allocator, shape);
+        defer a.deinit(allocator);
+        var b: Dense(f64, .row_major) = try .init(allocator, shape);
+        defer b.deinit(allocator);
+        for (0..a.size) |i| {
+            a.data[i] = @floatFromInt(i % 7);
+            b.data[i] = @as(f64, @floatFromInt(i % 5)) - 2;
+        }
+
+        var r = try lazy.eval(allocator, lazy.sub(lazy.mul(a, b), lazy.neg(lazy.abs(b))), .{ .pool = &pool });
+        defer r.deinit(allocator);
+
+        try std.testing.expectEqualSlices(u32, shape, r.shape[0..r.ndim]);
+        for (0..a.size) |i| {
+            try std.testing.expectEqual(a.data[i] * b.data[i] + @abs(b.data[i]), r.data[i]);
+        }
+
+        // Not vectorized: integer elements.
+        var c: Dense(i32, .row_major) = try .init(allocator, shape);
+        defer c.deinit(allocator);
+        for (0..c.size) |i| {
+            c.data[i] = @as(i32, @intCast(i % 11)) - 5;
+        }
+
+        var s = try lazy.eval(allocator, lazy.max(lazy.mul(c, c), lazy.add(c, @as(i32, 20))), .{ .pool = &pool });
+        defer s.deinit(allocator);
+        for (0..c.size) |i| {
+            try std.testing.expectEqual(@max(c.data[i] * c.data[i], c.data[i] + 20), s.data[i]);
+        }
+    }
+}
+
+test "lazy broadcasting" {
+    const allocator = std.testing.allocator;
+
+    var a: Dense(f64, .row_major) = try .init(allocator, &.{ 3, 1 });
+    defer a.deinit(allocator);
+    var b: Dense(f64, .row_major) = try .init(allocator, &.{4});
+    defer b.deinit(allocator);
+    for (0..3) |i| {
+        a.data[i] = @floatFromInt(i + 1);
+    }
+    for (0..4) |j| {
+        b.data[j] = @floatFromInt(10 * j);
+    }
+
+    var r = try lazy.eval(allocator, lazy.add(lazy.mul(a, @as(f64, 2)), b), .{});
+    defer r.deinit(allocator);
+
+    try std.testing.expectEqualSlices(u32, &.{ 3, 4 }, r.shape[0..r.ndim]);
+    for (0..3) |i| {
+        for (0..4) |j| {
+            try std.testing.expectEqual(a.data[i] * 2 + b.data[j], try r.get(&.{ @intCast(i), @intCast(j) }));
+        }
+    }
+
+    // Into a transposed destination.
+    var o: Dense(f64, .row_major) = try .init(allocator, &.{ 4, 3 });
+    defer o.deinit(allocator);
+    var t = try o.transpose(null);
+    try lazy.eval_(&t, lazy.add(lazy.mul(a, @as(f64, 2)), b), .{});
+    for (0..3) |i| {
+        for (0..4) |j| {
+            try std.testing.expectEqual(a.data[i] * 2 + b.data[j], try o.get(&.{ @intCast(j), @intCast(i) }));
+        }
+    }
+
+    // The destination must have the broadcast shape.
+    var c: Dense(f64, .row_major) = try .init(allocator, &.{ 2, 4 });
+    defer c.deinit(allocator);
+    try std.testing.expectError(zml.array.Error.NotBroadcastable, lazy.eval_(&c, lazy.add(a, b), .{}));
+    try std.testing.expectError(zml.array.Error.NotBroadcastable, lazy.eval(allocator, lazy.add(a, c), .{}));
+}
+
+test "lazy in place" {
+    const allocator = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(allocator, .{ .threads = 4 });
+    defer pool.deinit();
+
+    for ([_]u32{ 37, 1 << 17 }) |n| {
+        var a: Dense(f64, .row_major) = try .init(allocator, &.{n});
+        defer a.deinit(allocator);
+        var b: Dense(f64, .row_major) = try .init(allocator, &.{n});
+        defer b.deinit(allocator);
+        for (0..n) |i| {
+            a.data[i] = @floatFromInt(i % 13);
+            b.data[i] = @floatFromInt(i % 3);
+        }
+
+        // a = a * a + b, with `a` both read and written.
+        try lazy.eval_(&a, lazy.add(lazy.mul(a, a), b), .{ .pool = &pool });
+        for (0..n) |i| {
+            const x: f64 = @floatFromInt(i % 13);
+            try std.testing.expectEqual(x * x + b.data[i], a.data[i]);
+        }
+    }
+}
+
+test "lazy errors" {
+    const allocator = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(allocator, .{ .threads = 4 });
+    defer pool.deinit();
+
+    for ([_]u32{ 10, 1 << 17 }) |n| {
+        var x: Dense(i64, .row_major) = try .init(allocator, &.{n});
+        defer x.deinit(allocator);
+        var y: Dense(i64, .row_major) = try .init(allocator, &.{n});
+        defer y.deinit(allocator);
+        for (0..n) |i| {
+            x.data[i] = @intCast(i % 4);
+            y.data[i] = @intCast(i % 3);
+        }
+
+        var r = try lazy.eval(allocator, lazy.pow(x, y), .{ .pool = &pool });
+        defer r.deinit(allocator);
+        for (0..n) |i| {
+            try std.testing.expectEqual(std.math.pow(i64, x.data[i], y.data[i]), r.data[i]);
+        }
+
+        // A single negative exponent, in a late part.
+        y.data[n - 3] = -1;
+        try std.testing.expectError(error.NegativeExponent, lazy.eval(allocator, lazy.pow(x, y), .{ .pool = &pool }));
+        try std.testing.expectError(error.NegativeExponent, lazy.eval_(&r, lazy.add(lazy.pow(x, y), x), .{ .pool = &pool }));
+    }
+}
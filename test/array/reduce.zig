@@ -0,0 +1,280 @@
+const std = @import("std");
+const zml = @import("zml");
+
+const array = zml.array;
+const Dense = array.Dense;
+
+const shape = [3]u32{ 4, 5, 6 };
+
+fn isReduced(axes: []const u32, d: usize) bool {
+    return std.mem.indexOfScalar(u32, axes, @intCast(d)) != null;
+}
+
+/// Checks `r`, the sum of the row-major `x` over `axes`, with the reduced axes
+/// removed or, with `keepdims`, of length 1.
+fn expectSums(x: *const Dense(f64, .row_major), axes: []const u32, r: anytype, keepdims: bool) !void {
+    // Indexed by the position with the reduced coordinates set to 0.
+    var expected: [shape[0] * shape[1] * shape[2]]f64 = @splat(0);
+    for (0..x.size) |p| {
+        const idx = [3]usize{ p / (shape[1] * shape[2]), p / shape[2] % shape[1], p % shape[2] };
+
+        var q: usize = 0;
+        for (0..3) |d| {
+            q = q * shape[d] + (if (isReduced(axes, d)) 0 else idx[d]);
+        }
+
+        expected[q] += x.data[p];
+    }
+
+    for (0..x.size) |p| {
+        const idx = [3]u32{ @intCast(p / (shape[1] * shape[2])), @intCast(p / shape[2] % shape[1]), @intCast(p % shape[2]) };
+
+        var pos: [3]u32 = .{ 0, 0, 0 };
+        var n: usize = 0;
+        var skip: bool = false;
+        for (0..3) |d| {
+            if (isReduced(axes, d)) {
+                skip = skip or idx[d] != 0;
+                if (!keepdims)
+                    continue;
+            }
+
+            pos[n] = idx[d];
+            n += 1;
+        }
+
+        if (skip)
+            continue;
+
+        try std.testing.expectEqual(expected[p], try r.get(pos[0..@max(n, 1)]));
+    }
+}
+
+test "sum over axes" {
+    const allocator = std.testing.allocator;
+
+    var x: Dense(f64, .row_major) = try .init(allocator, &shape);
+    defer x.deinit(allocator);
+    for (0..x.size) |p| {
+        x.data[p] = @floatFromInt((p * 31 + p / 7) % 11);
+    }
+
+    const subsets = [_][]const u32{ &.{0}, &.{1}, &.{2}, &.{ 0, 1 }, &.{ 2, 0 }, &.{ 1, 2 }, &.{ 0, 1, 2 } };
+    for (subsets) |axes| {
+        var r = try array.sumAxes(allocator, x, axes, .{});
+        defer r.deinit(allocator);
+        try std.testing.expectEqual(@max(3 - axes.len, 1), r.ndim);
+        try expectSums(&x, axes, r, false);
+
+        // keepdims
+        var kept: [3]u32 = shape;
+        for (axes) |d| {
+            kept[d] = 1;
+        }
+
+        var o: Dense(f64, .row_major) = try .init(allocator, &kept);
+        defer o.deinit(allocator);
+        try array.sumAxes_(&o, x, axes, .{});
+        try expectSums(&x, axes, o, true);
+    }
+
+    var total: f64 = 0;
+    for (x.data[0..x.size]) |e| {
+        total += e;
+    }
+    try std.testing.expectEqual(total, try array.sum(x, .{}));
+
+    // A transposed view, reduced over its first axis, is the array reduced
+    // over its last one.
+    const t = try x.transpose(null);
+    var rt = try array.sumAxes(allocator, t, &.{0}, .{});
+    defer rt.deinit(allocator);
+    var rx = try array.sumAxes(allocator, x, &.{2}, .{});
+    defer rx.deinit(allocator);
+    for (0..shape[1]) |j| {
+        for (0..shape[0]) |i| {
+            try std.testing.expectEqual(try rx.get(&.{ @intCast(i), @intCast(j) }), try rt.get(&.{ @intCast(j), @intCast(i) }));
+        }
+    }
+
+    // Invalid axes and output shapes.
+    try std.testing.expectError(array.Error.InvalidAxes, array.sumAxes(allocator, x, &.{ 1, 1 }, .{}));
+    try std.testing.expectError(array.Error.InvalidAxes, array.sumAxes(allocator, x, &.{3}, .{}));
+    var wrong: Dense(f64, .row_major) = try .init(allocator, &.{ 4, 6 });
+    defer wrong.deinit(allocator);
+    try std.testing.expectError(array.Error.DimensionMismatch, array.sumAxes_(&wrong, x, &.{2}, .{}));
+}
+
+test "argmin and argmax ties and NaN" {
+    const allocator = std.testing.allocator;
+    const nan = std.math.nan(f64);
+
+    var x: Dense(f64, .row_major) = try .init(allocator, &.{6});
+    defer x.deinit(allocator);
+
+    // The first extremum wins.
+    @memcpy(x.data[0..6], &[_]f64{ 3, 1, 5, 1, 5, 2 });
+    try std.testing.expectEqual(1, try array.argmin(x, .{}));
+    try std.testing.expectEqual(2, try array.argmax(x, .{}));
+
+    // The first NaN wins.
+    @memcpy(x.data[0..6], &[_]f64{ 3, 1, nan, 0, nan, 9 });
+    try std.testing.expectEqual(2, try array.argmin(x, .{}));
+    try std.testing.expectEqual(2, try array.argmax(x, .{}));
+    try std.testing.expect(std.math.isNan(try array.amin(x, .{})));
+    try std.testing.expect(std.math.isNan(try array.amax(x, .{})));
+
+    // Over axes 0 and 2 of a {2, 3, 4} array, the index is i * 4 + k. The
+    // maximum 7 is at (0, j, 3) and (1, j, 3), and (1, 2, 1) is NaN.
+    var y: Dense(f64, .row_major) = try .init(allocator, &.{ 2, 3, 4 });
+    defer y.deinit(allocator);
+    for (0..24) |p| {
+        y.data[p] = if (p % 4 == 3) 7 else @floatFromInt(p % 3);
+    }
+    y.data[1 * 12 + 2 * 4 + 1] = nan;
+
+    var amax = try array.argmaxAxes(allocator, y, &.{ 0, 2 }, .{});
+    defer amax.deinit(allocator);
+    var amin = try array.argminAxes(allocator, y, &.{ 0, 2 }, .{});
+    defer amin.deinit(allocator);
+    for (0..3) |j| {
+        try std.testing.expectEqual(@as(u64, if (j == 2) 5 else 3), try amax.get(&.{@intCast(j)}));
+
+        var first: u64 = 0;
+        for (0..8) |q| {
+            const p: usize = (q / 4) * 12 + j * 4 + q % 4;
+            const b: usize = (first / 4) * 12 + j * 4 + first % 4;
+            if (y.data[p] < y.data[b])
+                first = q;
+        }
+
+        try std.testing.expectEqual(@as(u64, if (j == 2) 5 else first), try amin.get(&.{@intCast(j)}));
+    }
+
+    // Split over a pool: the ties and NaN fall in different parts.
+    var pool: zml.Pool = undefined;
+    try pool.init(allocator, .{ .threads = 4 });
+    defer pool.deinit();
+
+    const n: u32 = 1 << 18;
+    var z: Dense(f64, .row_major) = try .init(allocator, &.{n});
+    defer z.deinit(allocator);
+    @memset(z.data[0..n], 0);
+    z.data[100_000] = 5;
+    z.data[200_000] = 5;
+    z.data[50_000] = -5;
+    z.data[250_000] = -5;
+    try std.testing.expectEqual(100_000, try array.argmax(z, .{ .pool = &pool }));
+    try std.testing.expectEqual(50_000, try array.argmin(z, .{ .pool = &pool }));
+
+    z.data[150_000] = nan;
+    z.data[240_000] = nan;
+    try std.testing.expectEqual(150_000, try array.argmax(z, .{ .pool = &pool }));
+    try std.testing.expectEqual(150_000, try array.argmin(z, .{ .pool = &pool }));
+}
+
+test "compensated sums" {
+    const allocator = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(allocator, .{ .threads = 4 });
+    defer pool.deinit();
+
+    // Sums of 2^20 f32 values, checked against f64 sums: a naive f32 sum is
+    // off by about 1%, far more than the tolerances. Kahan compensation is
+    // within a few ulps; the pairwise tree adds up to one rounding per leaf
+    // element and per level.
+    const n: u32 = 1 << 20;
+    const c: u32 = 3;
+
+    // Reduced axis outermost: tiles with Kahan compensation.
+    var x: Dense(f32, .row_major) = try .init(allocator, &.{ n, c });
+    defer x.deinit(allocator);
+    // Reduced axis innermost: pairwise tree.
+    var y: Dense(f32, .row_major) = try .init(allocator, &.{ c, n });
+    defer y.deinit(allocator);
+
+    var reference: [c]f64 = @splat(0);
+    for (0..n) |i| {
+        for (0..c) |j| {
+            const v: f32 = 0.1 + @as(f32, @floatFromInt((i * (j + 1)) % 1000)) * 1e-4;
+            x.data[i * c + j] = v;
+            y.data[j * n + i] = v;
+            reference[j] += v;
+        }
+    }
+
+    inline for (.{ .{}, .{ .pool = &pool } }) |ctx| {
+        var rx = try array.sumAxes(allocator, x, &.{0}, ctx);
+        defer rx.deinit(allocator);
+        var ry = try array.sumAxes(allocator, y, &.{1}, ctx);
+        defer ry.deinit(allocator);
+
+        const eps: f64 = std.math.floatEps(f32);
+        for (0..c) |j| {
+            try std.testing.expectApproxEqAbs(reference[j], @as(f64, try rx.get(&.{@intCast(j)})), 8 * eps * reference[j]);
+            try std.testing.expectApproxEqAbs(reference[j], @as(f64, try ry.get(&.{@intCast(j)})), 64 * eps * reference[j]);
+        }
+
+        const total: f64 = reference[0] + reference[1] + reference[2];
+        try std.testing.expectApproxEqAbs(total, @as(f64, try array.sum(x, ctx)), 64 * eps * total);
+    }
+}
+
+test "variance with ddof" {
+    const allocator = std.testing.allocator;
+
+    // Rows {1, 2, 3, 4} and {2, 4, 6, 8}: sums of squared deviations 5 and 20.
+    var x: Dense(i32, .row_major) = try .init(allocator, &.{ 2, 4 });
+    defer x.deinit(allocator);
+    @memcpy(x.data[0..8], &[_]i32{ 1, 2, 3, 4, 2, 4, 6, 8 });
+
+    var v0 = try array.varianceAxes(allocator, x, &.{1}, .{});
+    defer v0.deinit(allocator);
+    try std.testing.expectEqual(5.0 / 4.0, try v0.get(&.{0}));
+    try std.testing.expectEqual(20.0 / 4.0, try v0.get(&.{1}));
+
+    var v1 = try array.varianceAxes(allocator, x, &.{1}, .{ .ddof = 1 });
+    defer v1.deinit(allocator);
+    try std.testing.expectApproxEqAbs(5.0 / 3.0, try v1.get(&.{0}), 1e-15);
+    try std.testing.expectApproxEqAbs(20.0 / 3.0, try v1.get(&.{1}), 1e-15);
+
+    // Columns {1, 2}, {2, 4}, {3, 6}, {4, 8}: squared deviations j^2 / 2.
+    var c1 = try array.varianceAxes(allocator, x, &.{0}, .{ .ddof = 1 });
+    defer c1.deinit(allocator);
+    for (0..4) |j| {
+        const d: f64 = @floatFromInt(j + 1);
+        try std.testing.expectApproxEqAbs(d * d / 2, try c1.get(&.{@intCast(j)}), 1e-15);
+    }
+
+    // Mean 3.75, sum of squared deviations 41.5.
+    try std.testing.expectApproxEqAbs(41.5 / 8.0, try array.variance(x, .{}), 1e-15);
+    try std.testing.expectApproxEqAbs(41.5 / 7.0, try array.variance(x, .{ .ddof = 1 }), 1e-15);
+}
+
+test "dot" {
+    const allocator = std.testing.allocator;
+
+    var x: Dense(f64, .row_major) = try .init(allocator, &.{ 2, 3 });
+    defer x.deinit(allocator);
+    var y: Dense(f64, .row_major) = try .init(allocator, &.{ 2, 3 });
+    defer y.deinit(allocator);
+    @memcpy(x.data[0..6], &[_]f64{ 1, 2, 3, 4, 5, 6 });
+    @memcpy(y.data[0..6], &[_]f64{ 6, 5, 4, 3, 2, 1 });
+
+    try std.testing.expectEqual(56, try array.dot(x, y, .{}));
+
+    var r = try array.dotAxes(allocator, x, y, &.{1}, .{});
+    defer r.deinit(allocator);
+    try std.testing.expectEqual(28, try r.get(&.{0}));
+    try std.testing.expectEqual(28, try r.get(&.{1}));
+
+    // Shapes must match exactly, not broadcast.
+    var z: Dense(f64, .row_major) = try .init(allocator, &.{ 3, 2 });
+    defer z.deinit(allocator);
+    var w: Dense(f64, .row_major) = try .init(allocator, &.{ 1, 3 });
+    defer w.deinit(allocator);
+    try std.testing.expectError(array.Error.DimensionMismatch, array.dot(x, z, .{}));
+    try std.testing.expectError(array.Error.DimensionMismatch, array.dot(x, w, .{}));
+    try std.testing.expectError(array.Error.DimensionMismatch, array.dotAxes(allocator, x, z, &.{1}, .{}));
+}
@@ -171,6 +171,7 @@ test {
     const test_bessel = false;
     const test_nearest_integer = false;
     const test_floating_point = false;
+    const test_batch = true;
 
     if (test_basic) {
         //_ = @import("float/fmod.zig");
@@ -244,4 +245,8 @@ test {
         //_ = @import("float/nextafter.zig");
         //_ = @import("float/nexttoward.zig");
     }
+
+    if (test_batch) {
+        _ = @import("float/batch.zig");
+    }
 }
@@ -0,0 +1,170 @@
+const std = @import("std");
+const zml = @import("zml");
+const batch = zml.float.batch;
+const tzml = @import("../zml.zig");
+
+/// Documented error bound of `kernel` for `T`, in ULP.
+fn bound(comptime kernel: batch.Kernel, comptime T: type) f128 {
+    if (kernel == .sqrt)
+        return 0;
+
+    if (T == f32)
+        return 1;
+
+    return switch (kernel) {
+        .tanh, .erf => 3,
+        else => 2,
+    };
+}
+
+/// The scalar function one precision up, rounded to `T`, as an estimate of
+/// the correctly rounded result.
+fn reference(comptime kernel: batch.Kernel, comptime T: type, x: T) T {
+    const W: type = if (T == f32) f64 else f128;
+    const w: W = x;
+
+    return @floatCast(switch (kernel) {
+        .exp => zml.float.exp(w),
+        .exp2 => zml.float.exp2(w),
+        .log => zml.float.log(w),
+        .log2 => zml.float.log2(w),
+        .log10 => zml.float.log10(w),
+        .sqrt => zml.float.sqrt(w),
+        .sin => zml.float.sin(w),
+        .cos => zml.float.cos(w),
+        .tanh => zml.float.tanh(w),
+        .erf => zml.float.erf(w),
+    });
+}
+
+/// Runs `kernel` over `inputs` through `batch.map`, which also exercises the
+/// padded tail, and checks every result against `reference`.
+fn check(comptime kernel: batch.Kernel, comptime T: type, inputs: []const T) !void {
+    const results: []T = try std.testing.allocator.alloc(T, inputs.len);
+    defer std.testing.allocator.free(results);
+
+    batch.map(kernel, T, results.ptr, inputs.ptr, inputs.len);
+
+    for (inputs, results) |x, y| {
+        const expected: T = reference(kernel, T, x);
+
+        if (std.math.isNan(expected)) {
+            try std.testing.expect(std.math.isNan(y));
+            continue;
+        }
+
+        // Past the bound, fail on the element itself so that the report
+        // shows the expected and the computed values.
+        if (tzml.float.ulpDistance(y, expected) > bound(kernel, T))
+            try std.testing.expectEqual(expected, y);
+    }
+}
+
+/// Uniform samples in `[lo, hi]`, followed by the special values.
+fn uniform(comptime T: type, allocator: std.mem.Allocator, seed: u64, count: usize, lo: T, hi: T) ![]T {
+    var prng: std.Random.DefaultPrng = .init(seed);
+    const random = prng.random();
+
+    const specials = [_]T{ 0.0, -0.0, std.math.inf(T), -std.math.inf(T), std.math.nan(T), std.math.floatTrueMin(T), -std.math.floatTrueMin(T), std.math.floatMin(T), std.math.floatMax(T), -std.math.floatMax(T) };
+
+    const xs: []T = try allocator.alloc(T, count + specials.len);
+    for (xs[0..count]) |*x|
+        x.* = lo + (hi - lo) * random.float(T);
+
+    @memcpy(xs[count..], &specials);
+    return xs;
+}
+
+/// Positive samples spread over every binade, subnormals included.
+fn binades(comptime T: type, allocator: std.mem.Allocator, seed: u64, count: usize) ![]T {
+    var prng: std.Random.DefaultPrng = .init(seed);
+    const random = prng.random();
+
+    const U: type = std.meta.Int(.unsigned, @bitSizeOf(T));
+    const xs: []T = try allocator.alloc(T, count + 4);
+    for (xs[0..count]) |*x|
+        x.* = @bitCast(random.intRangeLessThan(U, 1, @as(U, @bitCast(std.math.inf(T)))));
+
+    xs[count] = 1.0;
+    xs[count + 1] = -1.0;
+    xs[count + 2] = 0.0;
+    xs[count + 3] = std.math.inf(T);
+    return xs;
+}
+
+fn checkUniform(comptime kernel: batch.Kernel, comptime T: type, lo: T, hi: T) !void {
+    const xs: []T = try uniform(T, std.testing.allocator, 0x5eed, 4099, lo, hi);
+    defer std.testing.allocator.free(xs);
+
+    try check(kernel, T, xs);
+}
+
+fn checkBinades(comptime kernel: batch.Kernel, comptime T: type) !void {
+    const xs: []T = try binades(T, std.testing.allocator, 0x5eed, 4099);
+    defer std.testing.allocator.free(xs);
+
+    try check(kernel, T, xs);
+}
+
+test "float.batch.exp" {
+    try checkUniform(.exp, f32, -104.0, 89.0);
+    try checkUniform(.exp, f64, -746.0, 710.0);
+    try checkUniform(.exp, f64, -1.0, 1.0);
+}
+
+test "float.batch.exp2" {
+    try checkUniform(.exp2, f32, -150.0, 128.0);
+    try checkUniform(.exp2, f64, -1076.0, 1024.0);
+    try checkUniform(.exp2, f64, -1.0, 1.0);
+}
+
+test "float.batch.log" {
+    try checkBinades(.log, f32);
+    try checkBinades(.log, f64);
+    try checkUniform(.log, f64, 0.5, 2.0);
+}
+
+test "float.batch.log2" {
+    try checkBinades(.log2, f32);
+    try checkBinades(.log2, f64);
+    try checkUniform(.log2, f64, 0.5, 2.0);
+}
+
+test "float.batch.log10" {
+    try checkBinades(.log10, f32);
+    try checkBinades(.log10, f64);
+    try checkUniform(.log10, f64, 0.5, 2.0);
+}
+
+test "float.batch.sqrt" {
+    try checkBinades(.sqrt, f32);
+    try checkBinades(.sqrt, f64);
+}
+
+test "float.batch.sin" {
+    try checkUniform(.sin, f32, -10.0, 10.0);
+    try checkUniform(.sin, f32, -0x1p22, 0x1p22);
+    try checkUniform(.sin, f64, -10.0, 10.0);
+    try checkUniform(.sin, f64, -0x1p22, 0x1p22);
+}
+
+test "float.batch.cos" {
+    try checkUniform(.cos, f32, -10.0, 10.0);
+    try checkUniform(.cos, f32, -0x1p22, 0x1p22);
+    try checkUniform(.cos, f64, -10.0, 10.0);
+    try checkUniform(.cos, f64, -0x1p22, 0x1p22);
+}
+
+test "float.batch.tanh" {
+    try checkUniform(.tanh, f32, -10.0, 10.0);
+    try checkUniform(.tanh, f64, -25.0, 25.0);
+    try checkUniform(.tanh, f64, -1.0, 1.0);
+    try checkUniform(.tanh, f64, -0x1p-20, 0x1p-20);
+}
+
+test "float.batch.erf" {
+    try checkUniform(.erf, f32, -7.0, 7.0);
+    try checkUniform(.erf, f64, -7.0, 7.0);
+    try checkUniform(.erf, f64, -1.5, 1.5);
+    try checkUniform(.erf, f64, -0x1p-20, 0x1p-20);
+}
@@ -0,0 +1,12 @@
+test {
+    const test_nat = true;
+    const test_storage = true;
+
+    if (test_nat) {
+        _ = @import("integer/nat.zig");
+    }
+
+    if (test_storage) {
+        _ = @import("integer/storage.zig");
+    }
+}
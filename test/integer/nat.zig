@@ -0,0 +1,288 @@
+const std = @import("std");
+
+const zml = @import("zml");
+const nat = zml.integer.nat;
+
+/// Small crossover points, so that every algorithm and their mixes are reached
+/// with operands of a few dozen limbs.
+const small: nat.Thresholds = .{ .karatsuba = 4, .toom3 = 12, .ntt = 48, .division = 6 };
+
+/// Only the basecase algorithms.
+const basecase: nat.Thresholds = .{
+    .karatsuba = std.math.maxInt(usize),
+    .toom3 = std.math.maxInt(usize),
+    .ntt = std.math.maxInt(usize),
+    .division = std.math.maxInt(usize),
+};
+
+/// Random limbs with a nonzero most significant one. One operand in four is
+/// made of all ones, to exercise the carries.
+fn random(allocator: std.mem.Allocator, rng: std.Random, n: usize) ![]u32 {
+    const limbs: []u32 = try allocator.alloc(u32, n);
+    if (rng.uintLessThan(u8, 4) == 0) {
+        @memset(limbs, std.math.maxInt(u32));
+    } else {
+        rng.bytes(std.mem.sliceAsBytes(limbs));
+        if (limbs[n - 1] == 0)
+            limbs[n - 1] = 1;
+    }
+
+    return limbs;
+}
+
+/// Checks `nat.mul` with `t` against `nat.mulBasecase` on random operands of
+/// `n` and `m` limbs, in both orders.
+fn expectMul(allocator: std.mem.Allocator, rng: std.Random, n: usize, m: usize, t: nat.Thresholds) !void {
+    const a: []u32 = try random(allocator, rng, n);
+    defer allocator.free(a);
+    const b: []u32 = try random(allocator, rng, m);
+    defer allocator.free(b);
+
+    const expected: []u32 = try allocator.alloc(u32, n + m);
+    defer allocator.free(expected);
+    const result: []u32 = try allocator.alloc(u32, n + m);
+    defer allocator.free(result);
+
+    nat.mulBasecase(expected, a, b);
+
+    try nat.mul(allocator, result, a, b, t);
+    try std.testing.expectEqualSlices(u32, expected, result);
+
+    try nat.mul(allocator, result, b, a, t);
+    try std.testing.expectEqualSlices(u32, expected, result);
+}
+
+/// Checks `nat.mul` with `t` around `threshold`, on balanced and unbalanced
+/// operands.
+fn expectMulAround(allocator: std.mem.Allocator, rng: std.Random, threshold: usize, t: nat.Thresholds) !void {
+    for ([_]usize{ threshold - 1, threshold, threshold + 1 }) |m| {
+        for ([_]usize{ m, m + 1, 2 * m - 1, 2 * m + 1, 3 * m + 5 }) |n|
+            try expectMul(allocator, rng, n, m, t);
+    }
+}
+
+/// Divides `b c + r` by `b`, with `b` of `n` limbs, `c` of `k` limbs and
+/// `r < b`, with `t` and with the basecase, and checks that `c` and `r` come
+/// back.
+fn expectDivRem(allocator: std.mem.Allocator, rng: std.Random, n: usize, k: usize, t: nat.Thresholds) !void {
+    const b: []u32 = try random(allocator, rng, n);
+    defer allocator.free(b);
+    const c: []u32 = try random(allocator, rng, k);
+    defer allocator.free(c);
+
+    // Either b - 1, the largest remainder, or a random one below b.
+    const r: []u32 = try allocator.alloc(u32, n);
+    defer allocator.free(r);
+    if (rng.boolean()) {
+        const one = [_]u32{1};
+        _ = nat.sub(r, b, &one);
+    } else {
+        rng.bytes(std.mem.sliceAsBytes(r));
+        r[n - 1] = rng.uintLessThan(u32, b[n - 1]);
+    }
+
+    const a: []u32 = try allocator.alloc(u32, n + k);
+    defer allocator.free(a);
+    nat.mulBasecase(a, b, c);
+    try std.testing.expectEqual(0, nat.add(a, a, r));
+
+    const q: []u32 = try allocator.alloc(u32, k + 1);
+    defer allocator.free(q);
+    const rem: []u32 = try allocator.alloc(u32, n);
+    defer allocator.free(rem);
+
+    for ([_]nat.Thresholds{ t, basecase }) |thresholds| {
+        @memset(q, 0xdeadbeef);
+        @memset(rem, 0xdeadbeef);
+        try nat.divRem(allocator, q, rem, a, b, thresholds);
+
+        try std.testing.expectEqualSlices(u32, c, q[0..k]);
+        try std.testing.expectEqual(0, q[k]);
+        try std.testing.expectEqualSlices(u32, r, rem);
+    }
+}
+
+/// Checks `nat.divRem` with `t` around `threshold` quotient limbs, on
+/// divisors shorter and longer than the quotient.
+fn expectDivRemAround(allocator: std.mem.Allocator, rng: std.Random, threshold: usize, t: nat.Thresholds) !void {
+    for ([_]usize{ threshold - 1, threshold, threshold + 1 }) |k| {
+        for ([_]usize{ 2, 3, k / 2 + 1, k, k + 1, 2 * k + 3 }) |n|
+            try expectDivRem(allocator, rng, n, k, t);
+
+        // Unbalanced, the quotient taken n limbs at a time.
+        try expectDivRem(allocator, rng, k, 3 * k + 2, t);
+    }
+}
+
+test "mul around small thresholds" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    try expectMulAround(allocator, rng, small.karatsuba, small);
+    try expectMulAround(allocator, rng, small.toom3, small);
+    try expectMulAround(allocator, rng, small.ntt, small);
+
+    for (0..200) |_| {
+        const m: usize = rng.intRangeAtMost(usize, 1, 100);
+        const n: usize = rng.intRangeAtMost(usize, m, 300);
+        try expectMul(allocator, rng, n, m, small);
+    }
+}
+
+test "mul around default thresholds" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    try expectMulAround(allocator, rng, nat.thresholds.karatsuba, nat.thresholds);
+    try expectMulAround(allocator, rng, nat.thresholds.toom3, nat.thresholds);
+
+    for ([_]usize{ nat.thresholds.ntt - 1, nat.thresholds.ntt }) |m| {
+        try expectMul(allocator, rng, m, m, nat.thresholds);
+        try expectMul(allocator, rng, m + 7, m, nat.thresholds);
+    }
+}
+
+test "mul zero" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    const a = [_]u32{ 1, 2, 3 };
+    var r = [_]u32{ 7, 7, 7 };
+    try nat.mul(allocator, &r, &a, &.{}, small);
+    try std.testing.expectEqualSlices(u32, &.{ 0, 0, 0 }, &r);
+}
+
+test "divRem around small thresholds" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    try expectDivRemAround(allocator, rng, small.division, small);
+    try expectDivRemAround(allocator, rng, 40, small);
+
+    for (0..200) |_| {
+        const n: usize = rng.intRangeAtMost(usize, 1, 80);
+        const k: usize = rng.intRangeAtMost(usize, 1, 200);
+        try expectDivRem(allocator, rng, n, k, small);
+    }
+}
+
+test "divRem around default thresholds" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    try expectDivRemAround(allocator, rng, nat.thresholds.division, nat.thresholds);
+}
+
+test "add and sub in place" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    for (0..50) |_| {
+        const n: usize = rng.intRangeAtMost(usize, 1, 40);
+        const m: usize = rng.intRangeAtMost(usize, 1, n);
+
+        const a: []u32 = try random(allocator, rng, n);
+        defer allocator.free(a);
+        const b: []u32 = try random(allocator, rng, m);
+        defer allocator.free(b);
+
+        const expected: []u32 = try allocator.alloc(u32, n);
+        defer allocator.free(expected);
+        const carry: u32 = nat.add(expected, a, b);
+
+        const r: []u32 = try allocator.dupe(u32, a);
+        defer allocator.free(r);
+        try std.testing.expectEqual(carry, nat.add(r, r, b));
+        try std.testing.expectEqualSlices(u32, expected, r);
+
+        try std.testing.expectEqual(carry, nat.sub(r, r, b));
+        try std.testing.expectEqualSlices(u32, a, r);
+    }
+}
+
+fn initLimbs(allocator: std.mem.Allocator, limbs: []const u32) !zml.Integer {
+    var x: zml.Integer = try .init(allocator, @intCast(limbs.len));
+    @memcpy(x.limbs[0..limbs.len], limbs);
+    x.size = @intCast(limbs.len);
+    x.truncate();
+
+    return x;
+}
+
+test "mul_ and div_ with aliased outputs" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    // Above the Karatsuba and division thresholds.
+    const n: usize = 2 * nat.thresholds.division + 5;
+    const m: usize = nat.thresholds.division + 3;
+
+    const a: []u32 = try random(allocator, rng, n);
+    defer allocator.free(a);
+    const b: []u32 = try random(allocator, rng, m);
+    defer allocator.free(b);
+
+    // x = x * x
+    {
+        const expected: []u32 = try allocator.alloc(u32, 2 * n);
+        defer allocator.free(expected);
+        nat.mulBasecase(expected, a, a);
+
+        var x: zml.Integer = try initLimbs(allocator, a);
+        defer x.deinit(allocator);
+        try zml.integer.mul_(allocator, &x, x, x);
+
+        try std.testing.expectEqualSlices(u32, expected[0..nat.normalizedLen(expected)], x.limbs[0..x.size]);
+    }
+
+    // x = x * y and y = x * y
+    {
+        const expected: []u32 = try allocator.alloc(u32, n + m);
+        defer allocator.free(expected);
+        nat.mulBasecase(expected, a, b);
+
+        var x: zml.Integer = try initLimbs(allocator, a);
+        defer x.deinit(allocator);
+        var y: zml.Integer = try initLimbs(allocator, b);
+        defer y.deinit(allocator);
+
+        try zml.integer.mul_(allocator, &x, x, y);
+        try std.testing.expectEqualSlices(u32, expected[0..nat.normalizedLen(expected)], x.limbs[0..x.size]);
+
+        var z: zml.Integer = try initLimbs(allocator, a);
+        defer z.deinit(allocator);
+        try zml.integer.mul_(allocator, &y, z, y);
+        try std.testing.expectEqualSlices(u32, expected[0..nat.normalizedLen(expected)], y.limbs[0..y.size]);
+    }
+
+    // x = x / y and y = x / y
+    {
+        const expected: []u32 = try allocator.alloc(u32, n - m + 1);
+        defer allocator.free(expected);
+        try nat.divRem(allocator, expected, null, a, b, basecase);
+
+        var x: zml.Integer = try initLimbs(allocator, a);
+        defer x.deinit(allocator);
+        var y: zml.Integer = try initLimbs(allocator, b);
+        defer y.deinit(allocator);
+
+        try zml.integer.div_(allocator, &x, x, y);
+        try std.testing.expectEqualSlices(u32, expected[0..nat.normalizedLen(expected)], x.limbs[0..x.size]);
+
+        var z: zml.Integer = try initLimbs(allocator, a);
+        defer z.deinit(allocator);
+        try zml.integer.div_(allocator, &y, z, y);
+        try std.testing.expectEqualSlices(u32, expected[0..nat.normalizedLen(expected)], y.limbs[0..y.size]);
+    }
+}
@@ -0,0 +1,206 @@
+const std = @import("std");
+
+const zml = @import("zml");
+const integer = zml.integer;
+const Integer = zml.Integer;
+const nat = integer.nat;
+
+fn initLimbs(allocator: std.mem.Allocator, limbs: []const u32) !Integer {
+    var x: Integer = try .init(allocator, @intCast(limbs.len));
+    @memcpy(x.limbs[0..limbs.len], limbs);
+    x.size = @intCast(limbs.len);
+    x.truncate();
+
+    return x;
+}
+
+fn expectLimbs(expected: []const u32, x: Integer) !void {
+    try std.testing.expectEqualSlices(u32, expected[0..nat.normalizedLen(expected)], x.limbs[0..x.size]);
+}
+
+test "initBuffer keeps small values inline" {
+    var buffer: [integer.small_limbs]u32 = undefined;
+    var x: Integer = .initBuffer(&buffer);
+
+    // No allocation up to the size of the buffer.
+    try x.set(std.testing.failing_allocator, std.math.maxInt(u64));
+    try std.testing.expect(x.flags.inline_data);
+    try std.testing.expectEqual(@as([*]u32, &buffer), x.limbs);
+    try std.testing.expectEqual(std.math.maxInt(u64), x.toInt(u64));
+
+    try x.reserve(std.testing.failing_allocator, integer.small_limbs);
+    try x.trim(std.testing.failing_allocator);
+    try std.testing.expect(x.flags.inline_data);
+
+    // Nothing to free.
+    x.deinit(std.testing.allocator);
+}
+
+test "initBuffer grows to the heap" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var buffer: [integer.small_limbs]u32 = undefined;
+    var x: Integer = .initBuffer(&buffer);
+    defer x.deinit(allocator);
+
+    try x.set(allocator, @as(u128, 0x0123456789abcdef_fedcba9876543210));
+    try std.testing.expect(x.flags.inline_data);
+
+    try x.reserve(allocator, 2 * integer.small_limbs);
+    try std.testing.expect(!x.flags.inline_data);
+    try std.testing.expect(x.limbs != @as([*]u32, &buffer));
+    try std.testing.expectEqual(0x0123456789abcdef_fedcba9876543210, x.toInt(u128));
+
+    // The buffer is no longer used.
+    @memset(&buffer, 0);
+    try std.testing.expectEqual(0x0123456789abcdef_fedcba9876543210, x.toInt(u128));
+
+    try x.reserve(allocator, 4 * integer.small_limbs);
+    try std.testing.expectEqual(0x0123456789abcdef_fedcba9876543210, x.toInt(u128));
+}
+
+test "inline output of mul_ past its buffer" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    for (1..2 * integer.small_limbs) |n| {
+        var a: [2 * integer.small_limbs]u32 = undefined;
+        var b: [2 * integer.small_limbs]u32 = undefined;
+        rng.bytes(std.mem.sliceAsBytes(a[0..n]));
+        rng.bytes(std.mem.sliceAsBytes(b[0..n]));
+        a[n - 1] |= 1;
+        b[n - 1] |= 1;
+
+        var expected: [4 * integer.small_limbs]u32 = undefined;
+        nat.mulBasecase(expected[0 .. 2 * n], a[0..n], b[0..n]);
+
+        var x: Integer = try initLimbs(allocator, a[0..n]);
+        defer x.deinit(allocator);
+        var y: Integer = try initLimbs(allocator, b[0..n]);
+        defer y.deinit(allocator);
+
+        var buffer: [integer.small_limbs]u32 = undefined;
+        var o: Integer = .initBuffer(&buffer);
+        defer o.deinit(allocator);
+
+        try integer.mul_(allocator, &o, x, y);
+        try expectLimbs(expected[0 .. 2 * n], o);
+        try std.testing.expectEqual(2 * n <= integer.small_limbs, o.flags.inline_data);
+    }
+}
+
+test "operands stay with their owner" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    const a = [_]u32{ 0xffffffff, 0x12345678, 0x9abcdef0, 0x00000007, 0xdeadbeef };
+    const b = [_]u32{ 0x87654321, 0xffffffff, 0x0000ffff };
+
+    var x: Integer = try initLimbs(allocator, &a);
+    defer x.deinit(allocator);
+    var y: Integer = try initLimbs(allocator, &b);
+    defer y.deinit(allocator);
+
+    var product: [a.len + b.len]u32 = undefined;
+    nat.mulBasecase(&product, &a, &b);
+    var sum: [a.len + 1]u32 = undefined;
+    sum[a.len] = nat.add(sum[0..a.len], &a, &b);
+
+    // Not aliased: the operands are used in place and must come back intact,
+    // and freed once, by the deferred deinits above.
+    var o: Integer = try .init(allocator, 0);
+    defer o.deinit(allocator);
+
+    try integer.mul_(allocator, &o, x, y);
+    try expectLimbs(&product, o);
+    try integer.add_(allocator, &o, x, y);
+    try expectLimbs(&sum, o);
+    try integer.gcd_(allocator, &o, x, y);
+
+    try expectLimbs(&a, x);
+    try expectLimbs(&b, y);
+
+    // Aliased: the operand is copied first, and the copy freed.
+    try integer.add_(allocator, &x, x, y);
+    try expectLimbs(&sum, x);
+
+    x.deinit(allocator);
+    x = try initLimbs(allocator, &a);
+    try integer.mul_(allocator, &x, x, y);
+    try expectLimbs(&product, x);
+    try expectLimbs(&b, y);
+}
+
+test "gcd_" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    // Operands of up to 64 bits.
+    for (0..100) |_| {
+        const u: u64 = rng.int(u64) >> rng.uintLessThan(u6, 63);
+        const v: u64 = rng.int(u64) >> rng.uintLessThan(u6, 63);
+
+        var x: Integer = try .initSet(allocator, u);
+        defer x.deinit(allocator);
+        x.positive = rng.boolean();
+        var y: Integer = try .initSet(allocator, v);
+        defer y.deinit(allocator);
+
+        var buffer: [integer.small_limbs]u32 = undefined;
+        var o: Integer = .initBuffer(&buffer);
+        defer o.deinit(allocator);
+
+        try integer.gcd_(allocator, &o, x, y);
+        try std.testing.expect(o.positive);
+        try std.testing.expectEqual(if (u == 0) v else if (v == 0) u else std.math.gcd(u, v), o.toInt(u64));
+    }
+
+    // g c and g (c + 1), whose gcd is g, with g past the inline buffer and
+    // carrying factors of two.
+    for (1..12) |n| {
+        var g: [14]u32 = undefined;
+        rng.bytes(std.mem.sliceAsBytes(g[0 .. n + 2]));
+        g[0] &= 0xfffffff0;
+        g[n + 1] |= 1;
+
+        var c: [4]u32 = undefined;
+        rng.bytes(std.mem.sliceAsBytes(&c));
+        c[3] = (c[3] >> 1) | 1;
+        var d: [4]u32 = c;
+        const one = [_]u32{1};
+        try std.testing.expectEqual(0, nat.add(&d, &d, &one));
+
+        var a: [18]u32 = undefined;
+        var b: [18]u32 = undefined;
+        nat.mulBasecase(a[0 .. n + 6], g[0 .. n + 2], &c);
+        nat.mulBasecase(b[0 .. n + 6], g[0 .. n + 2], &d);
+
+        var x: Integer = try initLimbs(allocator, a[0 .. n + 6]);
+        defer x.deinit(allocator);
+        x.positive = false;
+        var y: Integer = try initLimbs(allocator, b[0 .. n + 6]);
+        defer y.deinit(allocator);
+
+        var buffer: [integer.small_limbs]u32 = undefined;
+        var o: Integer = .initBuffer(&buffer);
+        defer o.deinit(allocator);
+
+        try integer.gcd_(allocator, &o, x, y);
+        try expectLimbs(g[0 .. n + 2], o);
+        try std.testing.expect(o.positive);
+
+        try integer.gcd_(allocator, &o, x, @as(i32, 0));
+        try expectLimbs(a[0 .. n + 6], o);
+        try std.testing.expect(o.positive);
+
+        // Aliased outputs.
+        try integer.gcd_(allocator, &y, x, y);
+        try expectLimbs(g[0 .. n + 2], y);
+
+        try integer.gcd_(allocator, &x, x, y);
+        try expectLimbs(g[0 .. n + 2], x);
+    }
+}
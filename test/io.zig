@@ -0,0 +1,17 @@
+test {
+    const test_npy = true;
+    const test_csr = true;
+    const test_matrix_market = true;
+
+    if (test_npy) {
+        _ = @import("io/npy.zig");
+    }
+
+    if (test_csr) {
+        _ = @import("io/csr.zig");
+    }
+
+    if (test_matrix_market) {
+        _ = @import("io/matrix_market.zig");
+    }
+}
@@ -0,0 +1,207 @@
+const std = @import("std");
+const zml = @import("zml");
+
+const csr = zml.io.csr;
+const Layout = zml.Layout;
+
+const layouts = [_]Layout{ .row_major, .col_major };
+
+/// A 4 x 6 matrix with an empty second line, as CSR when row major and as
+/// CSC when column major (then it is 6 x 4).
+fn matrix(comptime T: type, comptime layout: Layout, ptr: []u32, idx: []u32, data: []T) zml.matrix.general.Sparse(T, layout) {
+    @memcpy(ptr, &[_]u32{ 0, 2, 2, 5, 6 });
+    @memcpy(idx, &[_]u32{ 1, 4, 0, 2, 5, 3 });
+    for (data, 0..) |*v, k| v.* = @floatFromInt(k + 1);
+
+    return .{
+        .data = data.ptr,
+        .idx = idx.ptr,
+        .ptr = ptr.ptr,
+        .nnz = 6,
+        .rows = if (layout == .row_major) 4 else 6,
+        .cols = if (layout == .row_major) 6 else 4,
+        .flags = .{ .owns_data = false },
+    };
+}
+
+fn written(allocator: std.mem.Allocator, m: anytype) ![]u8 {
+    var out: std.Io.Writer.Allocating = .init(allocator);
+    errdefer out.deinit();
+
+    try csr.write(&out.writer, m);
+    return out.toOwnedSlice();
+}
+
+fn read(allocator: std.mem.Allocator, comptime M: type, bytes: []const u8) !M {
+    var reader: std.Io.Reader = .fixed(bytes);
+    return csr.read(allocator, M, &reader);
+}
+
+/// Maps `bytes` through a temporary file.
+fn map(comptime M: type, bytes: []const u8) !zml.io.Mapped(M) {
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    try tmp.dir.writeFile(.{ .sub_path = "m.csr", .data = bytes });
+    const f: std.fs.File = try tmp.dir.openFile("m.csr", .{});
+    defer f.close();
+
+    return csr.map(M, f);
+}
+
+fn expectSame(x: anytype, y: anytype) !void {
+    const major: u32 = if (@TypeOf(x).storage_layout == .row_major) x.rows else x.cols;
+
+    try std.testing.expectEqual(x.rows, y.rows);
+    try std.testing.expectEqual(x.cols, y.cols);
+    try std.testing.expectEqual(x.nnz, y.nnz);
+    try std.testing.expectEqualSlices(u32, x.ptr[0 .. major + 1], y.ptr[0 .. major + 1]);
+    try std.testing.expectEqualSlices(u32, x.idx[0..x.nnz], y.idx[0..y.nnz]);
+    try std.testing.expectEqualSlices(zml.types.Numeric(@TypeOf(x)), x.data[0..x.nnz], y.data[0..y.nnz]);
+}
+
+/// Offset of `idx` in the file of the test matrix: the header, then `ptr`
+/// padded to the alignment.
+const idx_offset: usize = 2 * csr.alignment;
+
+test "write, read and map" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    inline for (.{ f32, f64 }) |T| {
+        inline for (layouts) |layout| {
+            const M = zml.matrix.general.Sparse(T, layout);
+
+            var ptr: [5]u32 = undefined;
+            var idx: [6]u32 = undefined;
+            var data: [6]T = undefined;
+            const x: M = matrix(T, layout, &ptr, &idx, &data);
+
+            const bytes: []u8 = try written(allocator, x);
+            defer allocator.free(bytes);
+
+            // Header, then each array at a multiple of the alignment.
+            try std.testing.expectEqual(idx_offset + csr.alignment + 6 * @sizeOf(T), bytes.len);
+
+            var y: M = try read(allocator, M, bytes);
+            defer y.deinit(allocator);
+            try expectSame(x, y);
+
+            var mapped = try map(M, bytes);
+            defer mapped.unmap();
+            try std.testing.expect(!mapped.value.flags.owns_data);
+            try expectSame(x, mapped.value);
+
+            try std.testing.expectEqual(4, try mapped.value.get(2, 2));
+        }
+    }
+}
+
+test "empty matrix" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    const M = zml.matrix.general.Sparse(f64, .row_major);
+
+    var ptr: [4]u32 = .{ 0, 0, 0, 0 };
+    const x: M = .{
+        .data = &.{},
+        .idx = &.{},
+        .ptr = &ptr,
+        .nnz = 0,
+        .rows = 3,
+        .cols = 2,
+        .flags = .{ .owns_data = false },
+    };
+
+    const bytes: []u8 = try written(allocator, x);
+    defer allocator.free(bytes);
+
+    var y: M = try read(allocator, M, bytes);
+    defer y.deinit(allocator);
+    try expectSame(x, y);
+
+    var mapped = try map(M, bytes);
+    defer mapped.unmap();
+    try expectSame(x, mapped.value);
+}
+
+test "mismatched and corrupt files" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    const M = zml.matrix.general.Sparse(f64, .row_major);
+
+    var ptr: [5]u32 = undefined;
+    var idx: [6]u32 = undefined;
+    var data: [6]f64 = undefined;
+    const x: M = matrix(f64, .row_major, &ptr, &idx, &data);
+
+    const valid: []u8 = try written(allocator, x);
+    defer allocator.free(valid);
+
+    try std.testing.expectError(zml.io.Error.LayoutMismatch, read(allocator, zml.matrix.general.Sparse(f64, .col_major), valid));
+    try std.testing.expectError(zml.io.Error.TypeMismatch, read(allocator, zml.matrix.general.Sparse(f32, .row_major), valid));
+    try std.testing.expectError(zml.io.Error.LayoutMismatch, map(zml.matrix.general.Sparse(f64, .col_major), valid));
+    try std.testing.expectError(zml.io.Error.TypeMismatch, map(zml.matrix.general.Sparse(i64, .row_major), valid));
+
+    // Truncated.
+    try std.testing.expectError(error.EndOfStream, read(allocator, M, valid[0 .. valid.len - 1]));
+    try std.testing.expectError(zml.io.Error.InvalidFormat, map(M, valid[0 .. valid.len - 1]));
+    try std.testing.expectError(error.EndOfStream, read(allocator, M, valid[0..32]));
+    try std.testing.expectError(zml.io.Error.InvalidFormat, map(M, valid[0..32]));
+
+    // A header announcing far more than the file holds fails at the end of
+    // the data, without allocating what it announces.
+    {
+        var header: [csr.alignment]u8 = valid[0..csr.alignment].*;
+        std.mem.writeInt(u32, header[16..20], 0xfffffff0, .little);
+        std.mem.writeInt(u32, header[24..28], 0xfffffff0, .little);
+
+        var counting: std.testing.FailingAllocator = .init(allocator, .{});
+        try std.testing.expectError(error.EndOfStream, read(counting.allocator(), M, &header));
+        try std.testing.expect(counting.allocated_bytes < 1 << 20);
+    }
+
+    const bytes: []u8 = try allocator.dupe(u8, valid);
+    defer allocator.free(bytes);
+
+    // Magic string and version.
+    bytes[1] = 'X';
+    try std.testing.expectError(zml.io.Error.InvalidFormat, read(allocator, M, bytes));
+    try std.testing.expectError(zml.io.Error.InvalidFormat, map(M, bytes));
+    bytes[1] = valid[1];
+    bytes[6] = 2;
+    try std.testing.expectError(zml.io.Error.UnsupportedFormat, read(allocator, M, bytes));
+    bytes[6] = valid[6];
+
+    // Corrupt structure: `ptr` is at the alignment, `idx` right after it.
+    const Corruption = struct { offset: usize, value: u32 };
+    for ([_]Corruption{
+        // ptr[0] != 0
+        .{ .offset = csr.alignment, .value = 1 },
+        // ptr decreasing
+        .{ .offset = csr.alignment + 2 * 4, .value = 1 },
+        // ptr beyond nnz, then back
+        .{ .offset = csr.alignment + 3 * 4, .value = 7 },
+        // ptr[rows] != nnz
+        .{ .offset = csr.alignment + 4 * 4, .value = 5 },
+        // column out of range
+        .{ .offset = idx_offset + 1 * 4, .value = 6 },
+        // unsorted within the first row: 1, 0
+        .{ .offset = idx_offset + 1 * 4, .value = 0 },
+        // repeated within the third row: 0, 0, 5
+        .{ .offset = idx_offset + 3 * 4, .value = 0 },
+    }) |corruption| {
+        const slot: *[4]u8 = bytes[corruption.offset..][0..4];
+        const original: [4]u8 = slot.*;
+        defer slot.* = original;
+
+        std.mem.writeInt(u32, slot, corruption.value, .little);
+
+        try std.testing.expectError(zml.io.Error.InvalidFormat, read(allocator, M, bytes));
+        try std.testing.expectError(zml.io.Error.InvalidFormat, map(M, bytes));
+    }
+
+    // Restored, the bytes are valid again.
+    var y: M = try read(allocator, M, bytes);
+    defer y.deinit(allocator);
+    try expectSame(x, y);
+}
@@ -0,0 +1,274 @@
+const std = @import("std");
+const zml = @import("zml");
+
+const matrix_market = zml.io.matrix_market;
+const Layout = zml.Layout;
+
+const layouts = [_]Layout{ .row_major, .col_major };
+
+/// Reads `contents` through a temporary file.
+fn read(allocator: std.mem.Allocator, comptime M: type, contents: []const u8) !M {
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    try tmp.dir.writeFile(.{ .sub_path = "m.mtx", .data = contents });
+    const f: std.fs.File = try tmp.dir.openFile("m.mtx", .{});
+    defer f.close();
+
+    return matrix_market.read(allocator, M, f);
+}
+
+/// Checks that `m` holds `expected`, with sorted and distinct indices in each
+/// line.
+fn expectMatrix(comptime T: type, m: anytype, comptime rows: usize, comptime cols: usize, expected: [rows][cols]T) !void {
+    try std.testing.expectEqual(rows, m.rows);
+    try std.testing.expectEqual(cols, m.cols);
+
+    for (0..rows) |i| {
+        for (0..cols) |j|
+            try std.testing.expectEqual(expected[i][j], try m.get(@intCast(i), @intCast(j)));
+    }
+
+    const major: u32 = if (@TypeOf(m).storage_layout == .row_major) m.rows else m.cols;
+    try std.testing.expectEqual(0, m.ptr[0]);
+    try std.testing.expectEqual(m.nnz, m.ptr[major]);
+    for (0..major) |l| {
+        const line: []const u32 = m.idx[m.ptr[l]..m.ptr[l + 1]];
+        for (1..line.len) |k|
+            try std.testing.expect(line[k - 1] < line[k]);
+    }
+}
+
+test "general" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    // Out of order entries, comments, blank lines, a duplicate and a last line
+    // without a line ending.
+    const contents =
+        \\%%MatrixMarket matrix coordinate real general
+        \\% comment
+        \\
+        \\3 4 6
+        \\3 4 -1.5
+        \\1 2 2
+        \\  % another comment
+        \\2 1 3e0
+        \\1 1 1
+        \\1 2 0.25
+        \\3 1 7
+    ;
+
+    inline for (layouts) |layout| {
+        var m = try read(allocator, zml.matrix.general.Sparse(f64, layout), contents);
+        defer m.deinit(allocator);
+
+        try std.testing.expectEqual(5, m.nnz);
+        try expectMatrix(f64, m, 3, 4, .{
+            .{ 1, 2.25, 0, 0 },
+            .{ 3, 0, 0, 0 },
+            .{ 7, 0, 0, -1.5 },
+        });
+    }
+}
+
+test "symmetric, skew-symmetric and hermitian" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    inline for (layouts) |layout| {
+        {
+            var m = try read(allocator, zml.matrix.general.Sparse(f64, layout),
+                \\%%MatrixMarket matrix coordinate real symmetric
+                \\3 3 4
+                \\1 1 4
+                \\2 1 1
+                \\3 2 -2
+                \\3 3 5
+                \\
+            );
+            defer m.deinit(allocator);
+
+            // The diagonal is not mirrored.
+            try std.testing.expectEqual(6, m.nnz);
+            try expectMatrix(f64, m, 3, 3, .{
+                .{ 4, 1, 0 },
+                .{ 1, 0, -2 },
+                .{ 0, -2, 5 },
+            });
+        }
+
+        {
+            var m = try read(allocator, zml.matrix.general.Sparse(i32, layout),
+                \\%%MatrixMarket matrix coordinate integer skew-symmetric
+                \\3 3 2
+                \\2 1 3
+                \\3 1 -4
+                \\
+            );
+            defer m.deinit(allocator);
+
+            try expectMatrix(i32, m, 3, 3, .{
+                .{ 0, -3, 4 },
+                .{ 3, 0, 0 },
+                .{ -4, 0, 0 },
+            });
+        }
+
+        {
+            const c = zml.cf64.init;
+
+            var m = try read(allocator, zml.matrix.general.Sparse(zml.cf64, layout),
+                \\%%MatrixMarket matrix coordinate complex hermitian
+                \\2 2 3
+                \\1 1 2 0
+                \\2 1 1 -3
+                \\2 2 5 0
+                \\
+            );
+            defer m.deinit(allocator);
+
+            try expectMatrix(zml.cf64, m, 2, 2, .{
+                .{ c(2, 0), c(1, 3) },
+                .{ c(1, -3), c(5, 0) },
+            });
+        }
+    }
+}
+
+test "pattern and integer files" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    const pattern =
+        \\%%MatrixMarket matrix coordinate pattern general
+        \\2 3 3
+        \\1 3
+        \\2 1
+        \\1 3
+        \\
+    ;
+
+    // Duplicates of a pattern file add up like any other value.
+    var m = try read(allocator, zml.matrix.general.Sparse(f64, .row_major), pattern);
+    defer m.deinit(allocator);
+    try expectMatrix(f64, m, 2, 3, .{
+        .{ 0, 0, 2 },
+        .{ 1, 0, 0 },
+    });
+
+    var b = try read(allocator, zml.matrix.general.Sparse(bool, .col_major), pattern);
+    defer b.deinit(allocator);
+    try expectMatrix(bool, b, 2, 3, .{
+        .{ false, false, true },
+        .{ true, false, false },
+    });
+
+    var i = try read(allocator, zml.matrix.general.Sparse(i8, .row_major),
+        \\%%MatrixMarket matrix coordinate integer general
+        \\1 2 3
+        \\1 1 127
+        \\1 2 -100
+        \\1 2 -28
+        \\
+    );
+    defer i.deinit(allocator);
+    try expectMatrix(i8, i, 1, 2, .{.{ 127, -128 }});
+
+    var f = try read(allocator, zml.matrix.general.Sparse(f32, .row_major),
+        \\%%MatrixMarket matrix coordinate integer general
+        \\1 1 1
+        \\1 1 -7
+        \\
+    );
+    defer f.deinit(allocator);
+    try expectMatrix(f32, f, 1, 1, .{.{-7}});
+}
+
+test "values out of range of the element type" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    const TypeMismatch = zml.io.Error.TypeMismatch;
+
+    for ([_][]const u8{
+        // Out of range.
+        \\%%MatrixMarket matrix coordinate integer general
+        \\1 1 1
+        \\1 1 128
+        ,
+        // A sum out of range.
+        \\%%MatrixMarket matrix coordinate integer general
+        \\1 1 2
+        \\1 1 100
+        \\1 1 28
+        ,
+        // A negation out of range.
+        \\%%MatrixMarket matrix coordinate integer skew-symmetric
+        \\2 2 1
+        \\2 1 -128
+        ,
+        // Real values in an int matrix.
+        \\%%MatrixMarket matrix coordinate real general
+        \\1 1 1
+        \\1 1 1
+        ,
+    }) |contents|
+        try std.testing.expectError(TypeMismatch, read(allocator, zml.matrix.general.Sparse(i8, .row_major), contents));
+
+    try std.testing.expectError(TypeMismatch, read(allocator, zml.matrix.general.Sparse(bool, .row_major),
+        \\%%MatrixMarket matrix coordinate integer general
+        \\1 1 1
+        \\1 1 2
+    ));
+
+    try std.testing.expectError(TypeMismatch, read(allocator, zml.matrix.general.Sparse(u32, .row_major),
+        \\%%MatrixMarket matrix coordinate integer skew-symmetric
+        \\2 2 1
+        \\2 1 1
+    ));
+
+    try std.testing.expectError(TypeMismatch, read(allocator, zml.matrix.general.Sparse(f64, .row_major),
+        \\%%MatrixMarket matrix coordinate complex general
+        \\1 1 1
+        \\1 1 1 1
+    ));
+}
+
+test "corrupt and truncated files" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    const M = zml.matrix.general.Sparse(f64, .row_major);
+
+    for ([_][]const u8{
+        "",
+        "%%MatrixMarket matrix coordinate real general",
+        "%%MatrixMarket matrix coordinate real general\n",
+        "%%MatrixMarket vector coordinate real general\n1 1 0\n",
+        "%%NotMatrixMarket matrix coordinate real general\n1 1 0\n",
+        // Size line.
+        "%%MatrixMarket matrix coordinate real general\n2 2\n",
+        "%%MatrixMarket matrix coordinate real general\n2 x 1\n1 1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n-2 2 1\n1 1 1\n",
+        "%%MatrixMarket matrix coordinate real symmetric\n2 3 1\n1 1 1\n",
+        // Fewer entries than announced.
+        "%%MatrixMarket matrix coordinate real general\n2 2 3\n1 1 1\n2 2 1\n",
+        // Indices out of range, zero or malformed.
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 3 1\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n0 1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n1.5 1 1\n",
+        // Values missing or malformed.
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 one\n",
+    }) |contents|
+        try std.testing.expectError(zml.io.Error.InvalidFormat, read(allocator, M, contents));
+
+    for ([_][]const u8{
+        "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n",
+        "%%MatrixMarket matrix coordinate quaternion general\n1 1 0\n",
+        "%%MatrixMarket matrix coordinate real diagonal\n1 1 0\n",
+    }) |contents|
+        try std.testing.expectError(zml.io.Error.UnsupportedFormat, read(allocator, M, contents));
+
+    // A matrix with no entries is valid.
+    var m = try read(allocator, M, "%%MatrixMarket matrix coordinate real general\n2 3 0\n");
+    defer m.deinit(allocator);
+    try expectMatrix(f64, m, 2, 3, .{ .{ 0, 0, 0 }, .{ 0, 0, 0 } });
+}
@@ -0,0 +1,260 @@
+const std = @import("std");
+const zml = @import("zml");
+
+const npy = zml.io.npy;
+const Layout = zml.Layout;
+
+const layouts = [_]Layout{ .row_major, .col_major };
+
+/// Element `i` of the test data.
+fn element(comptime T: type, i: usize) T {
+    return switch (T) {
+        bool => i % 3 == 0,
+        zml.cf64 => .{ .re = @floatFromInt(i), .im = -@as(f64, @floatFromInt(i % 7)) },
+        f32, f64 => @as(T, @floatFromInt(i)) / 4,
+        else => @intCast(i % 100),
+    };
+}
+
+/// Writes `x` and returns the bytes of the file.
+fn written(allocator: std.mem.Allocator, x: anytype) ![]u8 {
+    var out: std.Io.Writer.Allocating = .init(allocator);
+    errdefer out.deinit();
+
+    try npy.write(&out.writer, x);
+    return out.toOwnedSlice();
+}
+
+/// An `.npy` file, version 1.0, with the header dictionary `dictionary`
+/// followed by `data`.
+fn file(allocator: std.mem.Allocator, dictionary: []const u8, data: []const u8) ![]u8 {
+    var out: std.Io.Writer.Allocating = .init(allocator);
+    errdefer out.deinit();
+
+    const len: usize = std.mem.alignForward(usize, 10 + dictionary.len + 1, npy.alignment) - 10;
+    try out.writer.writeAll("\x93NUMPY\x01\x00");
+    try out.writer.writeInt(u16, @intCast(len), .little);
+    try out.writer.writeAll(dictionary);
+    try out.writer.splatByteAll(' ', len - dictionary.len - 1);
+    try out.writer.writeByte('\n');
+    try out.writer.writeAll(data);
+
+    return out.toOwnedSlice();
+}
+
+fn read(allocator: std.mem.Allocator, comptime D: type, bytes: []const u8) !D {
+    var reader: std.Io.Reader = .fixed(bytes);
+    return npy.read(allocator, D, &reader);
+}
+
+/// Maps `bytes` through a temporary file.
+fn map(comptime D: type, bytes: []const u8) !zml.io.Mapped(D) {
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    try tmp.dir.writeFile(.{ .sub_path = "x.npy", .data = bytes });
+    const f: std.fs.File = try tmp.dir.openFile("x.npy", .{});
+    defer f.close();
+
+    return npy.map(D, f);
+}
+
+test "array write, read and map" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    inline for (.{ bool, i8, u16, i32, i64, f32, f64, zml.cf64 }) |T| {
+        inline for (layouts) |layout| {
+            const D = zml.array.Dense(T, layout);
+
+            for ([_][]const u32{ &.{7}, &.{ 3, 4 }, &.{ 2, 3, 5 } }) |shape| {
+                var x: D = try .init(allocator, shape);
+                defer x.deinit(allocator);
+                for (x.data[0..x.size], 0..) |*v, i| v.* = element(T, i);
+
+                const bytes: []u8 = try written(allocator, x);
+                defer allocator.free(bytes);
+
+                const header: npy.Header = try npy.parseHeader(bytes);
+                try std.testing.expectEqual(0, header.offset % npy.alignment);
+                try std.testing.expectEqualStrings(npy.descr(T), header.descr);
+                try std.testing.expectEqualSlices(u32, shape, header.shape[0..header.ndim]);
+                try std.testing.expectEqual(layout == .col_major, header.fortran_order);
+                try std.testing.expectEqual(x.size, try header.size());
+                try std.testing.expectEqual(bytes.len, header.offset + x.size * @sizeOf(T));
+
+                var y: D = try read(allocator, D, bytes);
+                defer y.deinit(allocator);
+                try std.testing.expectEqualSlices(u32, shape, y.shape[0..y.ndim]);
+                try std.testing.expectEqualSlices(T, x.data[0..x.size], y.data[0..y.size]);
+
+                var mapped = try map(D, bytes);
+                defer mapped.unmap();
+                try std.testing.expect(!mapped.value.flags.owns_data);
+                try std.testing.expectEqualSlices(u32, shape, mapped.value.shape[0..mapped.value.ndim]);
+                try std.testing.expectEqualSlices(u32, x.strides[0..x.ndim], mapped.value.strides[0..mapped.value.ndim]);
+                try std.testing.expectEqualSlices(T, x.data[0..x.size], mapped.value.data[0..mapped.value.size]);
+            }
+        }
+    }
+}
+
+test "vector in either order" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var x: zml.array.Dense(f64, .row_major) = try .init(allocator, &.{5});
+    defer x.deinit(allocator);
+    for (x.data[0..5], 0..) |*v, i| v.* = element(f64, i);
+
+    const bytes: []u8 = try written(allocator, x);
+    defer allocator.free(bytes);
+
+    var y: zml.array.Dense(f64, .col_major) = try read(allocator, zml.array.Dense(f64, .col_major), bytes);
+    defer y.deinit(allocator);
+    try std.testing.expectEqualSlices(f64, x.data[0..5], y.data[0..5]);
+}
+
+test "matrix write, read and map" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    inline for (layouts) |layout| {
+        const M = zml.matrix.general.Dense(f64, layout);
+
+        // A 3 x 4 matrix inside a larger buffer, so that its lines are not
+        // contiguous.
+        var buffer: [40]f64 = undefined;
+        for (&buffer, 0..) |*v, i| v.* = element(f64, i);
+        const x: M = .{
+            .data = &buffer,
+            .rows = 3,
+            .cols = 4,
+            .ld = if (layout == .row_major) 6 else 5,
+            .flags = .{ .owns_data = false },
+        };
+
+        const bytes: []u8 = try written(allocator, x);
+        defer allocator.free(bytes);
+
+        var y: M = try read(allocator, M, bytes);
+        defer y.deinit(allocator);
+
+        var mapped = try map(M, bytes);
+        defer mapped.unmap();
+
+        for ([_]M{ y, mapped.value }) |z| {
+            try std.testing.expectEqual(3, z.rows);
+            try std.testing.expectEqual(4, z.cols);
+            for (0..3) |i| {
+                for (0..4) |j|
+                    try std.testing.expectEqual(try x.get(@intCast(i), @intCast(j)), try z.get(@intCast(i), @intCast(j)));
+            }
+        }
+    }
+}
+
+test "mismatched files" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var x: zml.array.Dense(f64, .col_major) = try .init(allocator, &.{ 2, 3, 4 });
+    defer x.deinit(allocator);
+    @memset(x.data[0..x.size], 1);
+
+    const bytes: []u8 = try written(allocator, x);
+    defer allocator.free(bytes);
+
+    try std.testing.expectError(zml.io.Error.TypeMismatch, read(allocator, zml.array.Dense(f32, .col_major), bytes));
+    try std.testing.expectError(zml.io.Error.LayoutMismatch, read(allocator, zml.array.Dense(f64, .row_major), bytes));
+    try std.testing.expectError(zml.io.Error.DimensionMismatch, read(allocator, zml.matrix.general.Dense(f64, .col_major), bytes));
+    try std.testing.expectError(zml.io.Error.TypeMismatch, map(zml.array.Dense(i64, .col_major), bytes));
+    try std.testing.expectError(zml.io.Error.LayoutMismatch, map(zml.array.Dense(f64, .row_major), bytes));
+}
+
+test "corrupt and truncated files" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    const D = zml.array.Dense(f64, .row_major);
+    const M = zml.matrix.general.Dense(f64, .row_major);
+
+    const data: [6]f64 = .{ 1, 2, 3, 4, 5, 6 };
+    const valid: []u8 = try file(allocator, "{'descr': '<f8', 'fortran_order': False, 'shape': (2, 3), }", std.mem.sliceAsBytes(&data));
+    defer allocator.free(valid);
+
+    var y: D = try read(allocator, D, valid);
+    defer y.deinit(allocator);
+    try std.testing.expectEqual(6, try y.get(&.{ 1, 2 }));
+
+    // Truncated data.
+    try std.testing.expectError(error.EndOfStream, read(allocator, D, valid[0 .. valid.len - 1]));
+    try std.testing.expectError(zml.io.Error.InvalidFormat, map(D, valid[0 .. valid.len - 1]));
+
+    // Truncated header.
+    try std.testing.expectError(error.EndOfStream, read(allocator, D, valid[0..40]));
+    try std.testing.expectError(zml.io.Error.InvalidFormat, map(D, valid[0..40]));
+    try std.testing.expectError(zml.io.Error.InvalidFormat, npy.parseHeader(valid[0..8]));
+
+    // Magic string and version.
+    {
+        const bytes: []u8 = try allocator.dupe(u8, valid);
+        defer allocator.free(bytes);
+
+        bytes[1] = 'M';
+        try std.testing.expectError(zml.io.Error.InvalidFormat, read(allocator, D, bytes));
+        bytes[1] = 'N';
+        bytes[6] = 9;
+        try std.testing.expectError(zml.io.Error.UnsupportedFormat, read(allocator, D, bytes));
+    }
+
+    // Malformed dictionaries.
+    for ([_][]const u8{
+        "{'descr': '<f8', 'shape': (2, 3), }",
+        "{'descr': '<f8', 'fortran_order': Maybe, 'shape': (2, 3), }",
+        "{'descr': '<f8', 'fortran_order': False, 'shape': 2, }",
+        "{'descr': '<f8', 'fortran_order': False, 'shape': (2, x), }",
+        "{'descr': '<f8', 'fortran_order': False, 'shape': (2, 3, }",
+        "{'descr': <f8, 'fortran_order': False, 'shape': (2, 3), }",
+        "{'descr': '<f8', 'fortran_order': False, 'shape': (2, 99999999999), }",
+    }) |dictionary| {
+        const bytes: []u8 = try file(allocator, dictionary, std.mem.sliceAsBytes(&data));
+        defer allocator.free(bytes);
+
+        try std.testing.expectError(zml.io.Error.InvalidFormat, read(allocator, D, bytes));
+        try std.testing.expectError(zml.io.Error.InvalidFormat, map(D, bytes));
+    }
+
+    // Booleans other than 0 or 1.
+    {
+        const B = zml.array.Dense(bool, .row_major);
+
+        const bytes: []u8 = try file(allocator, "{'descr': '|b1', 'fortran_order': False, 'shape': (3,), }", &.{ 0, 2, 1 });
+        defer allocator.free(bytes);
+
+        try std.testing.expectError(zml.io.Error.InvalidFormat, read(allocator, B, bytes));
+        try std.testing.expectError(zml.io.Error.InvalidFormat, map(B, bytes));
+
+        bytes[bytes.len - 2] = 1;
+        var b: B = try read(allocator, B, bytes);
+        defer b.deinit(allocator);
+        try std.testing.expectEqualSlices(bool, &.{ false, true, true }, b.data[0..3]);
+    }
+
+    // Element counts that overflow, before anything is allocated or read.
+    {
+        const bytes: []u8 = try file(allocator, "{'descr': '<f8', 'fortran_order': False, 'shape': (4294967295, 4294967295, 4294967295), }", &.{});
+        defer allocator.free(bytes);
+
+        const header: npy.Header = try npy.parseHeader(bytes);
+        try std.testing.expectError(zml.io.Error.FileTooLarge, header.size());
+        try std.testing.expectError(zml.io.Error.FileTooLarge, read(allocator, D, bytes));
+        try std.testing.expectError(zml.io.Error.FileTooLarge, map(D, bytes));
+    }
+
+    {
+        // Fits in a u64, but not once multiplied by the element size.
+        const bytes: []u8 = try file(allocator, "{'descr': '<f8', 'fortran_order': False, 'shape': (4294967295, 4294967295), }", &.{});
+        defer allocator.free(bytes);
+
+        try std.testing.expectError(zml.io.Error.FileTooLarge, map(M, bytes));
+        // More elements than an array can index.
+        try std.testing.expectError(zml.io.Error.FileTooLarge, read(allocator, D, bytes));
+        try std.testing.expectError(zml.io.Error.FileTooLarge, map(D, bytes));
+    }
+}
@@ -1,7 +1,22 @@
 test {
     const test_blas = true;
+    const test_lapack = true;
+    const test_matmul = true;
+    const test_batched = true;
 
     if (test_blas) {
         _ = @import("linalg/blas.zig");
     }
+
+    if (test_lapack) {
+        _ = @import("linalg/lapack.zig");
+    }
+
+    if (test_matmul) {
+        _ = @import("linalg/matmul.zig");
+    }
+
+    if (test_batched) {
+        _ = @import("linalg/batched.zig");
+    }
 }
@@ -0,0 +1,547 @@
+const std = @import("std");
+const zml = @import("zml");
+const cf64 = zml.cf64;
+
+const batched = zml.linalg.batched;
+const blas = zml.linalg.blas;
+const lapack = zml.linalg.lapack;
+const Batch = batched.Batch;
+const Layout = zml.Layout;
+const Transpose = zml.linalg.Transpose;
+const Uplo = zml.types.Uplo;
+
+const layouts = [_]Layout{ .row_major, .col_major };
+const uplos = [_]Uplo{ .upper, .lower };
+const transposes = [_]Transpose{ .no_trans, .trans, .conj_trans, .conj_no_trans };
+
+/// Sizes with a specialized kernel, then one without.
+const sizes = [_]i32{ 1, 2, 3, 4, 5, 6, 7, 8, 11 };
+
+/// Matrices per batch: not a multiple of any vector length, so that
+/// interleaved batches end with matrices outside a full lane group.
+const count = 11;
+
+const nrhs = 3;
+
+const tolerance = 1e-10;
+
+const Kind = enum { strided, pointers, interleaved };
+
+const kinds = [_]Kind{ .strided, .pointers, .interleaved };
+
+/// Interleaved batches are real only.
+fn supported(comptime T: type, kind: Kind) bool {
+    return kind != .interleaved or T == f64;
+}
+
+fn scalar(comptime T: type, re: f64, im: f64) T {
+    return if (T == f64) re else T.init(re, im);
+}
+
+fn real(comptime T: type, x: T) f64 {
+    return if (T == f64) x else x.re;
+}
+
+fn add(comptime T: type, x: T, y: T) T {
+    return if (T == f64) x + y else x.add(y);
+}
+
+/// `conj(x) * y`.
+fn mulConj(comptime T: type, x: T, y: T) T {
+    return if (T == f64) x * y else x.conj().mul(y);
+}
+
+fn random(comptime T: type, rng: std.Random) T {
+    return scalar(T, 2 * rng.float(f64) - 1, 2 * rng.float(f64) - 1);
+}
+
+fn values(comptime T: type, allocator: std.mem.Allocator, rng: std.Random, len: usize) ![]T {
+    const result: []T = try allocator.alloc(T, len);
+    for (result) |*v| v.* = random(T, rng);
+
+    return result;
+}
+
+/// Leading dimension, one past the minimum, and number of elements of a
+/// matrix.
+const Extent = struct { ld: i32, len: usize };
+
+fn extent(order: Layout, rows: i32, cols: i32) Extent {
+    const ld: i32 = (if (order == .col_major) rows else cols) + 1;
+    return .{ .ld = ld, .len = @intCast(ld * (if (order == .col_major) cols else rows)) };
+}
+
+fn offset(order: Layout, ld: i32, r: usize, c: usize) usize {
+    const l: usize = @intCast(ld);
+    return if (order == .col_major) r + c * l else r * l + c;
+}
+
+/// `count` Hermitian positive definite `n × n` matrices `M^H * M + n * I`,
+/// with `M` random. The padding is random.
+fn positiveDefinite(comptime T: type, allocator: std.mem.Allocator, rng: std.Random, order: Layout, n: usize, e: Extent, len: usize) ![]T {
+    const result: []T = try values(T, allocator, rng, len * e.len);
+    errdefer allocator.free(result);
+
+    const m: []T = try allocator.alloc(T, n * n);
+    defer allocator.free(m);
+
+    for (0..len) |i| {
+        for (m) |*v| v.* = random(T, rng);
+
+        for (0..n) |r| {
+            for (0..n) |c| {
+                var s: T = scalar(T, 0, 0);
+                for (0..n) |l|
+                    s = add(T, s, mulConj(T, m[l * n + r], m[l * n + c]));
+
+                if (r == c)
+                    s = scalar(T, real(T, s) + @as(f64, @floatFromInt(n)), 0);
+
+                result[i * e.len + offset(order, e.ld, r, c)] = s;
+            }
+        }
+    }
+
+    return result;
+}
+
+/// `len` matrices (or vectors) of `size` elements stored as `kind`: strided
+/// with a gap between them, through pointers in reverse order, or
+/// interleaved with a stride past `len`.
+fn Storage(comptime T: type) type {
+    return struct {
+        kind: Kind,
+        len: usize,
+        size: usize,
+        data: []T,
+        pointers: [][*]T,
+
+        const gap = 3;
+
+        fn init(allocator: std.mem.Allocator, kind: Kind, size: usize, from: []const T) !@This() {
+            const len: usize = from.len / size;
+
+            const data: []T = try allocator.alloc(T, (len + gap) * (size + gap));
+            errdefer allocator.free(data);
+            @memset(data, std.mem.zeroes(T));
+
+            const pointers: [][*]T = try allocator.alloc([*]T, len);
+            for (pointers, 0..) |*p, i|
+                p.* = data.ptr + (len - 1 - i) * size;
+
+            const result: @This() = .{ .kind = kind, .len = len, .size = size, .data = data, .pointers = pointers };
+            for (0..len) |i| {
+                for (0..size) |k|
+                    result.at(i, k).* = from[i * size + k];
+            }
+
+            return result;
+        }
+
+        fn deinit(self: @This(), allocator: std.mem.Allocator) void {
+            allocator.free(self.pointers);
+            allocator.free(self.data);
+        }
+
+        fn stride(self: @This()) usize {
+            return switch (self.kind) {
+                .strided => self.size + gap,
+                .pointers => unreachable,
+                .interleaved => self.len + gap,
+            };
+        }
+
+        /// Element `k` of matrix `i`.
+        fn at(self: @This(), i: usize, k: usize) *T {
+            return switch (self.kind) {
+                .strided => &self.data[i * self.stride() + k],
+                .pointers => &self.pointers[i][k],
+                .interleaved => &self.data[k * self.stride() + i],
+            };
+        }
+
+        fn batch(self: @This()) Batch([*]T) {
+            return switch (self.kind) {
+                .strided => .{ .strided = .{ .data = self.data.ptr, .stride = self.stride() } },
+                .pointers => .{ .pointers = self.pointers.ptr },
+                .interleaved => .{ .interleaved = .{ .data = self.data.ptr, .stride = self.stride() } },
+            };
+        }
+
+        fn constBatch(self: @This()) Batch([*]const T) {
+            return switch (self.kind) {
+                .strided => .{ .strided = .{ .data = self.data.ptr, .stride = self.stride() } },
+                .pointers => .{ .pointers = @ptrCast(self.pointers.ptr) },
+                .interleaved => .{ .interleaved = .{ .data = self.data.ptr, .stride = self.stride() } },
+            };
+        }
+    };
+}
+
+/// Checks `actual` against `expected`, relative to `scale` for the
+/// elements smaller than it.
+fn expectClose(comptime T: type, expected: T, actual: T, scale: f64) !void {
+    switch (T) {
+        i32 => try std.testing.expectEqual(expected, actual),
+        f64 => try std.testing.expectApproxEqAbs(expected, actual, tolerance * @max(scale, @abs(expected))),
+        else => {
+            try expectClose(f64, expected.re, actual.re, scale);
+            try expectClose(f64, expected.im, actual.im, scale);
+        },
+    }
+}
+
+/// Checks matrix `i` of `storage` against `expected`, all the matrices
+/// stored one after the other.
+fn expectMatrix(comptime T: type, expected: []const T, storage: Storage(T), i: usize, scale: f64) !void {
+    for (0..storage.size) |k|
+        try expectClose(T, expected[i * storage.size + k], storage.at(i, k).*, scale);
+}
+
+fn expectBatch(comptime T: type, expected: []const T, storage: Storage(T)) !void {
+    for (0..storage.len) |i|
+        try expectMatrix(T, expected, storage, i, 1);
+}
+
+fn checkGemm(comptime T: type, allocator: std.mem.Allocator, rng: std.Random, kind: Kind, order: Layout, transa: Transpose, transb: Transpose, m: i32, n: i32, k: i32, beta: T, len: usize, ctx: anytype) !void {
+    const nota: bool = transa == .no_trans or transa == .conj_no_trans;
+    const notb: bool = transb == .no_trans or transb == .conj_no_trans;
+    const ea: Extent = extent(order, if (nota) m else k, if (nota) k else m);
+    const eb: Extent = extent(order, if (notb) k else n, if (notb) n else k);
+    const ec: Extent = extent(order, m, n);
+    const alpha: T = scalar(T, 2, -1);
+
+    const a: []T = try values(T, allocator, rng, len * ea.len);
+    defer allocator.free(a);
+    const b: []T = try values(T, allocator, rng, len * eb.len);
+    defer allocator.free(b);
+    const c: []T = try values(T, allocator, rng, len * ec.len);
+    defer allocator.free(c);
+
+    const sa: Storage(T) = try .init(allocator, kind, ea.len, a);
+    defer sa.deinit(allocator);
+    const sb: Storage(T) = try .init(allocator, kind, eb.len, b);
+    defer sb.deinit(allocator);
+    const sc: Storage(T) = try .init(allocator, kind, ec.len, c);
+    defer sc.deinit(allocator);
+
+    try batched.gemm(T, order, transa, transb, m, n, k, alpha, sa.constBatch(), ea.ld, sb.constBatch(), eb.ld, beta, sc.batch(), ec.ld, len, ctx);
+
+    for (0..len) |i|
+        try blas.gemm(order, transa, transb, m, n, k, alpha, a[i * ea.len ..].ptr, ea.ld, b[i * eb.len ..].ptr, eb.ld, beta, c[i * ec.len ..].ptr, ec.ld, .{});
+
+    try expectBatch(T, c, sc);
+}
+
+fn checkLu(comptime T: type, allocator: std.mem.Allocator, rng: std.Random, kind: Kind, order: Layout, n: i32, len: usize, ctx: anytype) !void {
+    const e: Extent = extent(order, n, n);
+    const size: usize = @intCast(n);
+
+    const a: []T = try values(T, allocator, rng, len * e.len);
+    defer allocator.free(a);
+    const ipiv: []i32 = try allocator.alloc(i32, len * size);
+    defer allocator.free(ipiv);
+    @memset(ipiv, 0);
+    const info: []i32 = try allocator.alloc(i32, len);
+    defer allocator.free(info);
+
+    const sa: Storage(T) = try .init(allocator, kind, e.len, a);
+    defer sa.deinit(allocator);
+    const sp: Storage(i32) = try .init(allocator, kind, size, ipiv);
+    defer sp.deinit(allocator);
+
+    try batched.getrf(T, order, n, sa.batch(), e.ld, sp.batch(), info.ptr, len, ctx);
+
+    for (0..len) |i|
+        try std.testing.expectEqual(try lapack.getrf(order, n, n, a[i * e.len ..].ptr, e.ld, ipiv[i * size ..].ptr, .{}), info[i]);
+
+    try expectBatch(T, a, sa);
+    try expectBatch(i32, ipiv, sp);
+
+    for ([_]Transpose{ .no_trans, .trans, .conj_trans }) |trans| {
+        const eb: Extent = extent(order, n, nrhs);
+
+        const b: []T = try values(T, allocator, rng, len * eb.len);
+        defer allocator.free(b);
+
+        const sb: Storage(T) = try .init(allocator, kind, eb.len, b);
+        defer sb.deinit(allocator);
+
+        try batched.getrs(T, order, trans, n, nrhs, sa.constBatch(), e.ld, sp.constBatch(), sb.batch(), eb.ld, len, ctx);
+
+        for (0..len) |i|
+            try lapack.getrs(order, trans, n, nrhs, a[i * e.len ..].ptr, e.ld, ipiv[i * size ..].ptr, b[i * eb.len ..].ptr, eb.ld, .{});
+
+        try expectBatch(T, b, sb);
+    }
+}
+
+fn checkCholesky(comptime T: type, allocator: std.mem.Allocator, rng: std.Random, kind: Kind, order: Layout, uplo: Uplo, n: i32, len: usize, ctx: anytype) !void {
+    const e: Extent = extent(order, n, n);
+    const eb: Extent = extent(order, n, nrhs);
+
+    const a: []T = try positiveDefinite(T, allocator, rng, order, @intCast(n), e, len);
+    defer allocator.free(a);
+    const b: []T = try values(T, allocator, rng, len * eb.len);
+    defer allocator.free(b);
+    const info: []i32 = try allocator.alloc(i32, len);
+    defer allocator.free(info);
+
+    const sa: Storage(T) = try .init(allocator, kind, e.len, a);
+    defer sa.deinit(allocator);
+    const sb: Storage(T) = try .init(allocator, kind, eb.len, b);
+    defer sb.deinit(allocator);
+
+    try batched.potrf(T, order, uplo, n, sa.batch(), e.ld, info.ptr, len, ctx);
+
+    for (0..len) |i|
+        try std.testing.expectEqual(try lapack.potrf(order, uplo, n, a[i * e.len ..].ptr, e.ld, .{}), info[i]);
+
+    try std.testing.expect(std.mem.allEqual(i32, info, 0));
+    try expectBatch(T, a, sa);
+
+    try batched.potrs(T, order, uplo, n, nrhs, sa.constBatch(), e.ld, sb.batch(), eb.ld, len, ctx);
+
+    for (0..len) |i|
+        try lapack.potrs(order, uplo, n, nrhs, a[i * e.len ..].ptr, e.ld, b[i * eb.len ..].ptr, eb.ld, .{});
+
+    try expectBatch(T, b, sb);
+}
+
+/// With `tiny`, the even matrices of the batch are scaled by it, and
+/// compared relative to it.
+fn checkQr(comptime T: type, allocator: std.mem.Allocator, rng: std.Random, kind: Kind, order: Layout, m: i32, n: i32, len: usize, tiny: ?f64, ctx: anytype) !void {
+    const e: Extent = extent(order, m, n);
+    const k: usize = @intCast(@min(m, n));
+
+    const a: []T = try values(T, allocator, rng, len * e.len);
+    defer allocator.free(a);
+    const tau: []T = try values(T, allocator, rng, len * k);
+    defer allocator.free(tau);
+    const work: []T = try allocator.alloc(T, @intCast(@max(1, n)));
+    defer allocator.free(work);
+
+    if (tiny) |factor| {
+        for (0..len) |i| {
+            if (i % 2 == 0) {
+                for (a[i * e.len ..][0..e.len]) |*v|
+                    v.* = if (T == f64) v.* * factor else scalar(T, v.re * factor, v.im * factor);
+            }
+        }
+    }
+
+    const sa: Storage(T) = try .init(allocator, kind, e.len, a);
+    defer sa.deinit(allocator);
+    const st: Storage(T) = try .init(allocator, kind, k, tau);
+    defer st.deinit(allocator);
+
+    try batched.geqrf(T, order, m, n, sa.batch(), e.ld, st.batch(), len, ctx);
+
+    for (0..len) |i| {
+        try lapack.geqrf(order, m, n, a[i * e.len ..].ptr, e.ld, tau[i * k ..].ptr, work.ptr, @intCast(work.len), .{});
+
+        const scale: f64 = if (tiny != null and i % 2 == 0) tiny.? else 1;
+        try expectMatrix(T, a, sa, i, scale);
+        try expectMatrix(T, tau, st, i, 1);
+    }
+}
+
+test "gemm" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(1);
+    const rng: std.Random = prng.random();
+
+    inline for (.{ f64, cf64 }) |T| {
+        for (kinds) |kind| {
+            if (!supported(T, kind))
+                continue;
+
+            for (layouts) |order| {
+                for (transposes) |transa| {
+                    for (transposes) |transb| {
+                        for ([_]T{ scalar(T, 0, 0), scalar(T, 0.5, 1) }) |beta| {
+                            for (sizes) |n|
+                                try checkGemm(T, allocator, rng, kind, order, transa, transb, n, n, n, beta, count, .{});
+
+                            try checkGemm(T, allocator, rng, kind, order, transa, transb, 3, 5, 2, beta, count, .{});
+                            try checkGemm(T, allocator, rng, kind, order, transa, transb, 9, 4, 11, beta, count, .{});
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+test "getrf and getrs" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(2);
+    const rng: std.Random = prng.random();
+
+    inline for (.{ f64, cf64 }) |T| {
+        for (kinds) |kind| {
+            if (!supported(T, kind))
+                continue;
+
+            for (layouts) |order| {
+                for (sizes) |n|
+                    try checkLu(T, allocator, rng, kind, order, n, count, .{});
+            }
+        }
+    }
+}
+
+test "potrf and potrs" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(3);
+    const rng: std.Random = prng.random();
+
+    inline for (.{ f64, cf64 }) |T| {
+        for (kinds) |kind| {
+            if (!supported(T, kind))
+                continue;
+
+            for (layouts) |order| {
+                for (uplos) |uplo| {
+                    for (sizes) |n|
+                        try checkCholesky(T, allocator, rng, kind, order, uplo, n, count, .{});
+                }
+            }
+        }
+    }
+}
+
+test "geqrf" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(4);
+    const rng: std.Random = prng.random();
+
+    inline for (.{ f64, cf64 }) |T| {
+        for (kinds) |kind| {
+            if (!supported(T, kind))
+                continue;
+
+            for (layouts) |order| {
+                for (sizes) |n|
+                    try checkQr(T, allocator, rng, kind, order, n, n, count, null, .{});
+
+                try checkQr(T, allocator, rng, kind, order, 9, 6, count, null, .{});
+                try checkQr(T, allocator, rng, kind, order, 4, 7, count, null, .{});
+
+                // Subnormal columns: 1 / (alpha - beta) overflows unless the
+                // reflectors are rescaled first.
+                try checkQr(T, allocator, rng, kind, order, 4, 4, count, 1e-310, .{});
+                try checkQr(T, allocator, rng, kind, order, 10, 7, count, 1e-310, .{});
+            }
+        }
+    }
+}
+
+test "singular and indefinite matrices in an interleaved batch" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(5);
+    const rng: std.Random = prng.random();
+
+    const len = 13;
+
+    for (layouts) |order| {
+        for ([_]i32{ 3, 10 }) |n| {
+            const e: Extent = extent(order, n, n);
+            const size: usize = @intCast(n);
+
+            // Every third matrix has a zero column j, so that U[j, j] is
+            // exactly zero.
+            {
+                const a: []f64 = try values(f64, allocator, rng, len * e.len);
+                defer allocator.free(a);
+                for (0..len) |i| {
+                    if (i % 3 == 1) {
+                        for (0..size) |r|
+                            a[i * e.len + offset(order, e.ld, r, i % size)] = 0;
+                    }
+                }
+
+                const ipiv: []i32 = try allocator.alloc(i32, len * size);
+                defer allocator.free(ipiv);
+                @memset(ipiv, 0);
+                var info: [len]i32 = undefined;
+
+                const sa: Storage(f64) = try .init(allocator, .interleaved, e.len, a);
+                defer sa.deinit(allocator);
+                const sp: Storage(i32) = try .init(allocator, .interleaved, size, ipiv);
+                defer sp.deinit(allocator);
+
+                try batched.getrf(f64, order, n, sa.batch(), e.ld, sp.batch(), &info, len, .{});
+
+                for (0..len) |i| {
+                    const expected: i32 = try lapack.getrf(order, n, n, a[i * e.len ..].ptr, e.ld, ipiv[i * size ..].ptr, .{});
+                    try std.testing.expectEqual(if (i % 3 == 1) @as(i32, @intCast(i % size + 1)) else 0, expected);
+                    try std.testing.expectEqual(expected, info[i]);
+                }
+
+                // The factorization goes on past a zero pivot.
+                try expectBatch(f64, a, sa);
+                try expectBatch(i32, ipiv, sp);
+            }
+
+            // Every third matrix has a negative diagonal element j, so that
+            // step j fails.
+            for (uplos) |uplo| {
+                const a: []f64 = try positiveDefinite(f64, allocator, rng, order, size, e, len);
+                defer allocator.free(a);
+                for (0..len) |i| {
+                    if (i % 3 == 2)
+                        a[i * e.len + offset(order, e.ld, i % size, i % size)] = -1;
+                }
+
+                var info: [len]i32 = undefined;
+
+                const sa: Storage(f64) = try .init(allocator, .interleaved, e.len, a);
+                defer sa.deinit(allocator);
+
+                try batched.potrf(f64, order, uplo, n, sa.batch(), e.ld, &info, len, .{});
+
+                for (0..len) |i| {
+                    const expected: i32 = try lapack.potrf(order, uplo, n, a[i * e.len ..].ptr, e.ld, .{});
+                    try std.testing.expectEqual(if (i % 3 == 2) @as(i32, @intCast(i % size + 1)) else 0, expected);
+                    try std.testing.expectEqual(expected, info[i]);
+
+                    // The factors of the failed matrices are left unspecified.
+                    if (expected == 0)
+                        try expectMatrix(f64, a, sa, i, 1);
+                }
+            }
+        }
+    }
+}
+
+test "batches split over a pool" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(allocator, .{ .threads = 4 });
+    defer pool.deinit();
+
+    var prng: std.Random.DefaultPrng = .init(6);
+    const rng: std.Random = prng.random();
+
+    // Enough matrices for the flops of each call to pass the parallel
+    // threshold, in chunks that do not divide the batch.
+    const len = 1031;
+
+    for (layouts) |order| {
+        try checkGemm(f64, allocator, rng, .interleaved, order, .trans, .no_trans, 8, 8, 8, 0.5, len, .{ .pool = &pool });
+        try checkGemm(cf64, allocator, rng, .strided, order, .no_trans, .conj_trans, 8, 8, 8, scalar(cf64, 0.5, 1), len, .{ .pool = &pool });
+        try checkLu(f64, allocator, rng, .interleaved, order, 12, len, .{ .pool = &pool });
+        try checkLu(cf64, allocator, rng, .pointers, order, 12, len, .{ .pool = &pool });
+        try checkCholesky(f64, allocator, rng, .interleaved, order, .lower, 16, len, .{ .pool = &pool });
+        try checkCholesky(cf64, allocator, rng, .strided, order, .upper, 16, len, .{ .pool = &pool });
+        try checkQr(f64, allocator, rng, .interleaved, order, 12, 12, len, null, .{ .pool = &pool });
+        try checkQr(cf64, allocator, rng, .pointers, order, 12, 12, len, null, .{ .pool = &pool });
+    }
+}
@@ -1767,3 +1767,186 @@ test gemm {
     try std.testing.expectEqual(49172656, F[19].re);
     try std.testing.expectEqual(-8100208, F[19].im);
 }
+
+test "gemm blocked" {
+    const a = std.testing.allocator;
+
+    // Large enough to go through the packed engine, and not a multiple of
+    // any microtile size so every edge path is exercised.
+    const m = 77;
+    const n = 69;
+    const k = 301;
+
+    const A = try a.alloc(f64, m * k);
+    defer a.free(A);
+    const B = try a.alloc(f64, k * n);
+    defer a.free(B);
+    const C = try a.alloc(f64, m * n);
+    defer a.free(C);
+    const R = try a.alloc(f64, m * n);
+    defer a.free(R);
+
+    for (A, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i * 7 % 13)) - 6);
+    for (B, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i * 5 % 11)) - 5);
+    for (C, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i % 3)) - 1);
+    @memcpy(R, C);
+
+    // C = 2 * A^T(stored k × m) * B + 3 * C, column-major.
+    gemm(.col_major, .trans, .no_trans, m, n, k, 2, A.ptr, k, B.ptr, k, 3, C.ptr, m, .{}) catch unreachable;
+
+    for (0..n) |j| {
+        for (0..m) |i| {
+            var s: f64 = 0;
+            for (0..k) |l| {
+                s += A[l + i * k] * B[l + j * k];
+            }
+
+            try std.testing.expectEqual(2 * s + 3 * R[i + j * m], C[i + j * m]);
+        }
+    }
+
+    const D = try a.alloc(cf64, m * k);
+    defer a.free(D);
+    const E = try a.alloc(cf64, n * k);
+    defer a.free(E);
+    const F = try a.alloc(cf64, m * n);
+    defer a.free(F);
+    const G = try a.alloc(cf64, m * n);
+    defer a.free(G);
+
+    for (D, 0..) |*v, i| v.* = cf64.init(@floatFromInt(i % 5), @floatFromInt(i % 3));
+    for (E, 0..) |*v, i| v.* = cf64.init(@floatFromInt(i % 7), -@as(f64, @floatFromInt(i % 4)));
+    for (F, 0..) |*v, i| v.* = cf64.init(@floatFromInt(i % 2), 1);
+    @memcpy(G, F);
+
+    const alpha = cf64.init(1, 2);
+    const beta = cf64.init(2, -1);
+
+    // F = alpha * D * E^H + beta * F, column-major.
+    gemm(.col_major, .no_trans, .conj_trans, m, n, k, alpha, D.ptr, m, E.ptr, n, beta, F.ptr, m, .{}) catch unreachable;
+
+    for (0..n) |j| {
+        for (0..m) |i| {
+            var s = cf64.init(0, 0);
+            for (0..k) |l| {
+                s = s.add(D[i + l * m].mul(E[j + l * n].conj()));
+            }
+
+            const expected = alpha.mul(s).add(beta.mul(G[i + j * m]));
+            try std.testing.expectEqual(expected.re, F[i + j * m].re);
+            try std.testing.expectEqual(expected.im, F[i + j * m].im);
+        }
+    }
+}
+
+test "gemm parallel" {
+    const a = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(a, .{ .threads = 4 });
+    defer pool.deinit();
+
+    // Above the parallel threshold, so C is split into tiles over the pool.
+    const m = 163;
+    const n = 157;
+    const k = 170;
+
+    const A = try a.alloc(f64, m * k);
+    defer a.free(A);
+    const B = try a.alloc(f64, k * n);
+    defer a.free(B);
+    const C = try a.alloc(f64, m * n);
+    defer a.free(C);
+    const R = try a.alloc(f64, m * n);
+    defer a.free(R);
+
+    for (A, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i * 7 % 13)) - 6);
+    for (B, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i * 5 % 11)) - 5);
+    for (C, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i % 3)) - 1);
+    @memcpy(R, C);
+
+    // C = A * B^T(stored n × k) - C, row-major.
+    gemm(.row_major, .no_trans, .trans, m, n, k, 1, A.ptr, k, B.ptr, k, -1, C.ptr, n, .{ .pool = &pool }) catch unreachable;
+
+    for (0..m) |i| {
+        for (0..n) |j| {
+            var s: f64 = 0;
+            for (0..k) |l| {
+                s += A[i * k + l] * B[j * k + l];
+            }
+
+            try std.testing.expectEqual(s - R[i * n + j], C[i * n + j]);
+        }
+    }
+}
+
+test "gemm blocked f32 and cf32" {
+    const a = std.testing.allocator;
+    const cf32 = zml.cf32;
+
+    // The single precision engine has its own blocking and microtile sizes.
+    const m = 91;
+    const n = 67;
+    const k = 113;
+
+    const A = try a.alloc(f32, m * k);
+    defer a.free(A);
+    const B = try a.alloc(f32, k * n);
+    defer a.free(B);
+    const C = try a.alloc(f32, m * n);
+    defer a.free(C);
+    const R = try a.alloc(f32, m * n);
+    defer a.free(R);
+
+    for (A, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i * 7 % 13)) - 6);
+    for (B, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i * 5 % 11)) - 5);
+    for (C, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i % 3)) - 1);
+    @memcpy(R, C);
+
+    // C = 2 * A * B^T(stored n × k) + 3 * C, column-major.
+    gemm(.col_major, .no_trans, .trans, m, n, k, @as(f32, 2), A.ptr, m, B.ptr, n, @as(f32, 3), C.ptr, m, .{}) catch unreachable;
+
+    for (0..n) |j| {
+        for (0..m) |i| {
+            var s: f32 = 0;
+            for (0..k) |l| {
+                s += A[i + l * m] * B[j + l * n];
+            }
+
+            try std.testing.expectEqual(2 * s + 3 * R[i + j * m], C[i + j * m]);
+        }
+    }
+
+    const D = try a.alloc(cf32, k * m);
+    defer a.free(D);
+    const E = try a.alloc(cf32, k * n);
+    defer a.free(E);
+    const F = try a.alloc(cf32, m * n);
+    defer a.free(F);
+    const G = try a.alloc(cf32, m * n);
+    defer a.free(G);
+
+    for (D, 0..) |*v, i| v.* = cf32.init(@floatFromInt(i % 5), @floatFromInt(i % 3));
+    for (E, 0..) |*v, i| v.* = cf32.init(@floatFromInt(i % 7), -@as(f32, @floatFromInt(i % 4)));
+    for (F, 0..) |*v, i| v.* = cf32.init(@floatFromInt(i % 2), 1);
+    @memcpy(G, F);
+
+    const alpha = cf32.init(1, 2);
+    const beta = cf32.init(2, -1);
+
+    // F = alpha * D^H(stored k × m) * E(k × n) + beta * F, column-major.
+    gemm(.col_major, .conj_trans, .no_trans, m, n, k, alpha, D.ptr, k, E.ptr, k, beta, F.ptr, m, .{}) catch unreachable;
+
+    for (0..n) |j| {
+        for (0..m) |i| {
+            var s = cf32.init(0, 0);
+            for (0..k) |l| {
+                s = s.add(D[l + i * k].conj().mul(E[l + j * k]));
+            }
+
+            const expected = alpha.mul(s).add(beta.mul(G[i + j * m]));
+            try std.testing.expectEqual(expected.re, F[i + j * m].re);
+            try std.testing.expectEqual(expected.im, F[i + j * m].im);
+        }
+    }
+}
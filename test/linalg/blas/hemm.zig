@@ -454,3 +454,69 @@ test hemm {
     try std.testing.expectEqual(93777264, D[19].re);
     try std.testing.expectEqual(4067936, D[19].im);
 }
+
+test "hemm blocked" {
+    const a = std.testing.allocator;
+    const cf32 = zml.cf32;
+
+    // Large enough to go through the packed engine on both sides, in cf32.
+    const m = 61;
+    const n = 53;
+
+    const A = try a.alloc(cf32, m * m);
+    defer a.free(A);
+    const B = try a.alloc(cf32, m * n);
+    defer a.free(B);
+    const C = try a.alloc(cf32, m * n);
+    defer a.free(C);
+    const R = try a.alloc(cf32, m * n);
+    defer a.free(R);
+
+    for (B, 0..) |*v, i| v.* = cf32.init(@floatFromInt(@as(i64, @intCast(i * 5 % 11)) - 5), @floatFromInt(@as(i64, @intCast(i % 4)) - 2));
+    for (R, 0..) |*v, i| v.* = cf32.init(@floatFromInt(i % 2), 1);
+
+    const alpha = cf32.init(1, 2);
+    const beta = cf32.init(2, -1);
+
+    for ([_]zml.linalg.Side{ .left, .right }) |side| {
+        for ([_]zml.types.Uplo{ .upper, .lower }) |uplo| {
+            const ka: usize = if (side == .left) m else n;
+            const upper: bool = uplo == .upper;
+
+            // Only the `uplo` triangle is set, with a real diagonal; the
+            // other one must never be read.
+            for (0..ka) |j| {
+                for (0..ka) |i| {
+                    A[i + j * ka] = if (i == j)
+                        cf32.init(@floatFromInt(i % 7), 0)
+                    else if ((i < j) == upper)
+                        cf32.init(@floatFromInt(@as(i64, @intCast((i * 7 + j * 3) % 13)) - 6), @floatFromInt(@as(i64, @intCast((i + 2 * j) % 5)) - 2))
+                    else
+                        cf32.init(std.math.nan(f32), std.math.nan(f32));
+                }
+            }
+            @memcpy(C, R);
+
+            // C = alpha * A * B + beta * C or C = alpha * B * A + beta * C,
+            // column-major.
+            hemm(.col_major, side, uplo, m, n, alpha, A.ptr, @intCast(ka), B.ptr, m, beta, C.ptr, m, .{}) catch unreachable;
+
+            for (0..n) |j| {
+                for (0..m) |i| {
+                    var s = cf32.init(0, 0);
+                    for (0..ka) |l| {
+                        const r: usize = if (side == .left) i else l;
+                        const c: usize = if (side == .left) l else j;
+                        const h: cf32 = if (r == c or (r < c) == upper) A[r + c * ka] else A[c + r * ka].conj();
+
+                        s = s.add(if (side == .left) h.mul(B[l + j * m]) else B[i + l * m].mul(h));
+                    }
+
+                    const expected = alpha.mul(s).add(beta.mul(R[i + j * m]));
+                    try std.testing.expectEqual(expected.re, C[i + j * m].re);
+                    try std.testing.expectEqual(expected.im, C[i + j * m].im);
+                }
+            }
+        }
+    }
+}
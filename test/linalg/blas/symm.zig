@@ -740,3 +740,64 @@ test symm {
     try std.testing.expectEqual(33907504, H[19].re);
     try std.testing.expectEqual(109540304, H[19].im);
 }
+
+test "symm blocked" {
+    const a = std.testing.allocator;
+
+    // Large enough to go through the packed engine on both sides, in f32.
+    const m = 67;
+    const n = 59;
+
+    const A = try a.alloc(f32, m * m);
+    defer a.free(A);
+    const B = try a.alloc(f32, m * n);
+    defer a.free(B);
+    const C = try a.alloc(f32, m * n);
+    defer a.free(C);
+    const R = try a.alloc(f32, m * n);
+    defer a.free(R);
+
+    for (B, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i * 5 % 11)) - 5);
+    for (R, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i % 3)) - 1);
+
+    for ([_]zml.linalg.Side{ .left, .right }) |side| {
+        for ([_]zml.types.Uplo{ .upper, .lower }) |uplo| {
+            const ka: usize = if (side == .left) m else n;
+            const upper: bool = uplo == .upper;
+
+            // Only the `uplo` triangle is set; the other one must never be
+            // read.
+            for (0..ka) |j| {
+                for (0..ka) |i| {
+                    A[i + j * ka] = if (i == j or (i < j) == upper)
+                        @floatFromInt(@as(i64, @intCast((i * 7 + j * 3) % 13)) - 6)
+                    else
+                        std.math.nan(f32);
+                }
+            }
+            @memcpy(C, R);
+
+            // C = 2 * A * B + 3 * C or C = 2 * B * A + 3 * C, column-major.
+            symm(.col_major, side, uplo, m, n, 2, A.ptr, @intCast(ka), B.ptr, m, 3, C.ptr, m, .{}) catch unreachable;
+
+            for (0..n) |j| {
+                for (0..m) |i| {
+                    var s: f32 = 0;
+                    for (0..ka) |l| {
+                        if (side == .left) {
+                            const r: usize = @min(i, l);
+                            const c: usize = @max(i, l);
+                            s += (if (upper) A[r + c * ka] else A[c + r * ka]) * B[l + j * m];
+                        } else {
+                            const r: usize = @min(l, j);
+                            const c: usize = @max(l, j);
+                            s += B[i + l * m] * (if (upper) A[r + c * ka] else A[c + r * ka]);
+                        }
+                    }
+
+                    try std.testing.expectEqual(2 * s + 3 * R[i + j * m], C[i + j * m]);
+                }
+            }
+        }
+    }
+}
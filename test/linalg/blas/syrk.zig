@@ -762,3 +762,52 @@ test syrk {
     try std.testing.expectEqual(14239480, D[24].re);
     try std.testing.expectEqual(92327960, D[24].im);
 }
+
+test "syrk blocked" {
+    const a = std.testing.allocator;
+
+    // Large enough to go through the packed engine, and spanning several
+    // diagonal blocks with a partial last one.
+    const n = 150;
+    const k = 61;
+
+    const A = try a.alloc(f64, n * k);
+    defer a.free(A);
+    const C = try a.alloc(f64, n * n);
+    defer a.free(C);
+    const R = try a.alloc(f64, n * n);
+    defer a.free(R);
+
+    for (A, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i * 7 % 13)) - 6);
+    for (R, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i % 5)) - 2);
+
+    for ([_]zml.types.Uplo{ .upper, .lower }) |uplo| {
+        for ([_]zml.linalg.Transpose{ .no_trans, .trans }) |trans| {
+            @memcpy(C, R);
+
+            // C = 2 * op(A) * op(A)^T + 3 * C, with op(A) n × k, column-major.
+            const lda: i32 = if (trans == .no_trans) n else k;
+            syrk(.col_major, uplo, trans, n, k, 2, A.ptr, lda, 3, C.ptr, n, .{}) catch unreachable;
+
+            for (0..n) |j| {
+                for (0..n) |i| {
+                    // The opposite triangle is never written.
+                    if ((uplo == .upper and i > j) or (uplo == .lower and i < j)) {
+                        try std.testing.expectEqual(R[i + j * n], C[i + j * n]);
+                        continue;
+                    }
+
+                    var s: f64 = 0;
+                    for (0..k) |l| {
+                        s += if (trans == .no_trans)
+                            A[i + l * n] * A[j + l * n]
+                        else
+                            A[l + i * k] * A[l + j * k];
+                    }
+
+                    try std.testing.expectEqual(2 * s + 3 * R[i + j * n], C[i + j * n]);
+                }
+            }
+        }
+    }
+}
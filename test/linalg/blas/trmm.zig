@@ -3880,3 +3880,72 @@ test trmm {
     try std.testing.expectEqual(2478868993998848, F[19].re);
     try std.testing.expectEqual(49204941153042430, F[19].im);
 }
+
+test "trmm blocked" {
+    const a = std.testing.allocator;
+
+    // Large enough to go through the packed engine on both sides, and
+    // spanning several diagonal blocks.
+    const m = 83;
+    const n = 71;
+
+    const A = try a.alloc(f64, m * m);
+    defer a.free(A);
+    const B = try a.alloc(f64, m * n);
+    defer a.free(B);
+    const R = try a.alloc(f64, m * n);
+    defer a.free(R);
+
+    for (R, 0..) |*v, i| v.* = @floatFromInt(@as(i64, @intCast(i * 5 % 11)) - 5);
+
+    for ([_]zml.linalg.Side{ .left, .right }) |side| {
+        for ([_]zml.types.Uplo{ .upper, .lower }) |uplo| {
+            for ([_]zml.linalg.Transpose{ .no_trans, .trans }) |transa| {
+                for ([_]zml.types.Diag{ .non_unit, .unit }) |diag| {
+                    const ka: usize = if (side == .left) m else n;
+                    const upper: bool = uplo == .upper;
+                    const unit: bool = diag == .unit;
+
+                    // Only the `uplo` triangle is set, without the diagonal
+                    // if it is unit; the rest must never be read.
+                    for (0..ka) |j| {
+                        for (0..ka) |i| {
+                            A[i + j * ka] = if ((i == j and !unit) or (i != j and (i < j) == upper))
+                                @floatFromInt(@as(i64, @intCast((i * 7 + j * 3) % 13)) - 6)
+                            else
+                                std.math.nan(f64);
+                        }
+                    }
+                    @memcpy(B, R);
+
+                    // B = 2 * op(A) * B or B = 2 * B * op(A), column-major.
+                    trmm(.col_major, side, uplo, transa, diag, m, n, 2, A.ptr, @intCast(ka), B.ptr, m, .{}) catch unreachable;
+
+                    for (0..n) |j| {
+                        for (0..m) |i| {
+                            var s: f64 = 0;
+                            for (0..ka) |l| {
+                                // Element (r, c) of op(A).
+                                var r: usize = if (side == .left) i else l;
+                                var c: usize = if (side == .left) l else j;
+                                if (transa == .trans)
+                                    std.mem.swap(usize, &r, &c);
+
+                                const t: f64 = if (r == c)
+                                    (if (unit) 1 else A[r + c * ka])
+                                else if ((r < c) == upper)
+                                    A[r + c * ka]
+                                else
+                                    0;
+
+                                s += if (side == .left) t * R[l + j * m] else R[i + l * m] * t;
+                            }
+
+                            try std.testing.expectEqual(2 * s, B[i + j * m]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
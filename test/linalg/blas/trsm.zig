@@ -3880,3 +3880,66 @@ test trsm {
     try std.testing.expectApproxEqRel(-62411485979271.42, F[19].re, 0.0000001);
     try std.testing.expectApproxEqRel(-53034282373263.8, F[19].im, 0.0000001);
 }
+
+test "trsm blocked" {
+    const a = std.testing.allocator;
+
+    // Spans several diagonal blocks of the packed engine.
+    const m = 150;
+    const n = 70;
+
+    const A = try a.alloc(f64, m * m);
+    defer a.free(A);
+    const X = try a.alloc(f64, m * n);
+    defer a.free(X);
+    const B = try a.alloc(f64, m * n);
+    defer a.free(B);
+
+    // Diagonally dominant upper triangle, garbage in the lower one that must
+    // never be read.
+    for (0..m) |j| {
+        for (0..m) |i| {
+            A[i + j * m] = if (i == j)
+                @as(f64, m)
+            else if (i < j)
+                @as(f64, @floatFromInt((i + 2 * j) % 5)) - 2
+            else
+                std.math.nan(f64);
+        }
+    }
+    for (X, 0..) |*v, i| v.* = @as(f64, @floatFromInt(i % 9)) - 4;
+
+    // B = A * X
+    for (0..n) |j| {
+        for (0..m) |i| {
+            var s: f64 = 0;
+            for (i..m) |l| {
+                s += A[i + l * m] * X[l + j * m];
+            }
+            B[i + j * m] = s;
+        }
+    }
+
+    trsm(.col_major, .left, .upper, .no_trans, .non_unit, m, n, 1, A.ptr, m, B.ptr, m, .{}) catch unreachable;
+
+    for (0..m * n) |i| {
+        try std.testing.expectApproxEqAbs(X[i], B[i], 1e-10);
+    }
+
+    // B = X * A^T, with X now n × m.
+    for (0..m) |j| {
+        for (0..n) |i| {
+            var s: f64 = 0;
+            for (j..m) |l| {
+                s += X[i + l * n] * A[j + l * m];
+            }
+            B[i + j * n] = s;
+        }
+    }
+
+    trsm(.col_major, .right, .upper, .trans, .non_unit, n, m, 1, A.ptr, m, B.ptr, n, .{}) catch unreachable;
+
+    for (0..m * n) |i| {
+        try std.testing.expectApproxEqAbs(X[i], B[i], 1e-10);
+    }
+}
@@ -0,0 +1,5 @@
+test {
+    _ = @import("lapack/getrf.zig");
+    _ = @import("lapack/potrf.zig");
+    _ = @import("lapack/geqrf.zig");
+}
@@ -0,0 +1,45 @@
+const std = @import("std");
+const zml = @import("zml");
+const geqrf = zml.linalg.lapack.geqrf;
+
+test "geqrf parallel" {
+    const a = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(a, .{ .threads = 4 });
+    defer pool.deinit();
+
+    var serial: zml.Pool = undefined;
+    try serial.init(a, .{ .threads = 1 });
+    defer serial.deinit();
+
+    // Past the crossover to blocked code (128) and at least four blocks of
+    // 32, taller than wide.
+    const m = 211;
+    const n = 173;
+    const nb = 32;
+
+    const A = try a.alloc(f64, m * n);
+    defer a.free(A);
+    const R = try a.alloc(f64, m * n);
+    defer a.free(R);
+    var tau: [n]f64 = undefined;
+    var rtau: [n]f64 = undefined;
+    const work = try a.alloc(f64, m * nb);
+    defer a.free(work);
+
+    var prng: std.Random.DefaultPrng = .init(13);
+    const random = prng.random();
+
+    for ([_]zml.Layout{ .col_major, .row_major }) |order| {
+        for (R) |*v| v.* = 2 * random.float(f64) - 1;
+        @memcpy(A, R);
+
+        const lda: i32 = if (order == .col_major) m else n;
+        try geqrf(order, m, n, R.ptr, lda, @as([*]f64, &rtau), work.ptr, @intCast(work.len), .{ .pool = &serial });
+        try geqrf(order, m, n, A.ptr, lda, @as([*]f64, &tau), work.ptr, @intCast(work.len), .{ .pool = &pool });
+
+        for (rtau, tau) |r, v| try std.testing.expectApproxEqAbs(r, v, 1e-12);
+        for (R, A) |r, v| try std.testing.expectApproxEqAbs(r, v, 1e-10);
+    }
+}
@@ -0,0 +1,54 @@
+const std = @import("std");
+const zml = @import("zml");
+const getrf = zml.linalg.lapack.getrf;
+
+test "getrf parallel" {
+    const a = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(a, .{ .threads = 4 });
+    defer pool.deinit();
+
+    var serial: zml.Pool = undefined;
+    try serial.init(a, .{ .threads = 1 });
+    defer serial.deinit();
+
+    // Large enough for the task graph (at least four blocks of 64), not a
+    // multiple of the block size, and wider than tall.
+    const m = 270;
+    const n = 301;
+
+    const A = try a.alloc(f64, m * n);
+    defer a.free(A);
+    const R = try a.alloc(f64, m * n);
+    defer a.free(R);
+    var ipiv: [m]i32 = undefined;
+    var ripiv: [m]i32 = undefined;
+
+    var prng: std.Random.DefaultPrng = .init(7);
+    const random = prng.random();
+
+    for ([_]zml.Layout{ .col_major, .row_major }) |order| {
+        for ([_]bool{ false, true }) |singular| {
+            for (R) |*v| v.* = 2 * random.float(f64) - 1;
+
+            // An exactly zero column makes U[j, j] zero, whatever the
+            // pivots.
+            if (singular) {
+                for (0..m) |i| {
+                    R[if (order == .col_major) i + 200 * m else i * n + 200] = 0;
+                }
+            }
+            @memcpy(A, R);
+
+            const lda: i32 = if (order == .col_major) m else n;
+            const expected: i32 = try getrf(order, m, n, R.ptr, lda, &ripiv, .{ .pool = &serial });
+            const info: i32 = try getrf(order, m, n, A.ptr, lda, &ipiv, .{ .pool = &pool });
+
+            try std.testing.expectEqual(if (singular) 201 else 0, expected);
+            try std.testing.expectEqual(expected, info);
+            try std.testing.expectEqualSlices(i32, &ripiv, &ipiv);
+            for (R, A) |r, v| try std.testing.expectApproxEqAbs(r, v, 1e-9);
+        }
+    }
+}
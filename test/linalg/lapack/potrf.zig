@@ -0,0 +1,67 @@
+const std = @import("std");
+const zml = @import("zml");
+const potrf = zml.linalg.lapack.potrf;
+
+test "potrf parallel" {
+    const a = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(a, .{ .threads = 4 });
+    defer pool.deinit();
+
+    var serial: zml.Pool = undefined;
+    try serial.init(a, .{ .threads = 1 });
+    defer serial.deinit();
+
+    // Large enough for the task graph (at least four blocks of 64), and not
+    // a multiple of the block size.
+    const n = 290;
+
+    const B = try a.alloc(f64, n * n);
+    defer a.free(B);
+    const S = try a.alloc(f64, n * n);
+    defer a.free(S);
+    const A = try a.alloc(f64, n * n);
+    defer a.free(A);
+    const R = try a.alloc(f64, n * n);
+    defer a.free(R);
+
+    var prng: std.Random.DefaultPrng = .init(11);
+    const random = prng.random();
+
+    // S = B * B^T + n * I, symmetric positive definite.
+    for (B) |*v| v.* = 2 * random.float(f64) - 1;
+    for (0..n) |j| {
+        for (0..n) |i| {
+            var s: f64 = if (i == j) n else 0;
+            for (0..n) |l| s += B[i + l * n] * B[j + l * n];
+            S[i + j * n] = s;
+        }
+    }
+
+    for ([_]zml.Layout{ .col_major, .row_major }) |order| {
+        for ([_]zml.types.Uplo{ .upper, .lower }) |uplo| {
+            for ([_]bool{ false, true }) |indefinite| {
+                @memcpy(R, S);
+
+                // A negative diagonal element makes the leading minor of
+                // order 231 indefinite.
+                if (indefinite)
+                    R[230 + 230 * n] = -1;
+                @memcpy(A, R);
+
+                const expected: i32 = try potrf(order, uplo, n, R.ptr, n, .{ .pool = &serial });
+                const info: i32 = try potrf(order, uplo, n, A.ptr, n, .{ .pool = &pool });
+
+                try std.testing.expectEqual(if (indefinite) 231 else 0, expected);
+                try std.testing.expectEqual(expected, info);
+
+                // Only the factored triangle is meaningful once the
+                // factorization fails.
+                if (!indefinite) {
+                    for (R, A) |r, v| try std.testing.expectApproxEqAbs(r, v, 1e-9);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,403 @@
+const std = @import("std");
+const zml = @import("zml");
+
+const matmul = zml.linalg.matmul;
+const Layout = zml.Layout;
+const Uplo = zml.types.Uplo;
+const Diag = zml.types.Diag;
+
+const layouts = [_]Layout{ .row_major, .col_major };
+const uplos = [_]Uplo{ .upper, .lower };
+const diags = [_]Diag{ .non_unit, .unit };
+
+fn zero(comptime T: type) T {
+    return if (T == f64) 0 else T.init(0, 0);
+}
+
+fn isZero(comptime T: type, x: T) bool {
+    return if (T == f64) x == 0 else x.re == 0 and x.im == 0;
+}
+
+/// `acc + x * y`.
+fn fma(comptime T: type, acc: T, x: T, y: T) T {
+    return if (T == f64) acc + x * y else acc.add(x.mul(y));
+}
+
+/// Element `(i, j)` of the test matrices: small integers, so every product is
+/// exact. With `holes`, row 1, column 0 and a third of the remaining entries
+/// are zero.
+fn entry(comptime T: type, i: usize, j: usize, holes: bool) T {
+    if (holes and (i == 1 or j == 0 or (i + j) % 3 == 0))
+        return zero(T);
+
+    const re: f64 = @floatFromInt(@as(i64, @intCast((i * 7 + j * 3) % 5)) - 2);
+    if (T == f64)
+        return re;
+
+    return T.init(re, @floatFromInt(@as(i64, @intCast((i + 2 * j) % 3)) - 1));
+}
+
+/// Returns a row-major `rows × cols` array filled by `entry`.
+fn fill(comptime T: type, allocator: std.mem.Allocator, rows: usize, cols: usize, holes: bool) ![]T {
+    const result: []T = try allocator.alloc(T, rows * cols);
+    for (0..rows) |i| {
+        for (0..cols) |j| {
+            result[i * cols + j] = entry(T, i, j, holes);
+        }
+    }
+
+    return result;
+}
+
+/// Returns a builder holding the non-zero elements of the row-major `full`.
+fn builder(comptime T: type, comptime layout: Layout, allocator: std.mem.Allocator, rows: u32, cols: u32, full: []const T) !zml.matrix.builder.Sparse(T, layout) {
+    var result: zml.matrix.builder.Sparse(T, layout) = try .init(allocator, rows, cols, rows * cols);
+    errdefer result.deinit(allocator);
+
+    for (0..rows) |i| {
+        for (0..cols) |j| {
+            if (!isZero(T, full[i * cols + j]))
+                try result.set(allocator, @intCast(i), @intCast(j), full[i * cols + j]);
+        }
+    }
+
+    return result;
+}
+
+fn sparse(comptime T: type, comptime layout: Layout, allocator: std.mem.Allocator, rows: u32, cols: u32, full: []const T) !zml.matrix.general.Sparse(T, layout) {
+    var b = try builder(T, layout, allocator, rows, cols, full);
+    return b.compile(allocator);
+}
+
+fn dense(comptime T: type, comptime layout: Layout, allocator: std.mem.Allocator, rows: u32, cols: u32, full: []const T) !zml.matrix.general.Dense(T, layout) {
+    var result: zml.matrix.general.Dense(T, layout) = try .init(allocator, rows, cols);
+    for (0..rows) |i| {
+        for (0..cols) |j| {
+            result.put(@intCast(i), @intCast(j), full[i * cols + j]);
+        }
+    }
+
+    return result;
+}
+
+fn vector(comptime T: type, allocator: std.mem.Allocator, full: []const T) !zml.vector.Dense(T) {
+    var result: zml.vector.Dense(T) = try .init(allocator, @intCast(full.len));
+    @memcpy(result.data[0..full.len], full);
+
+    return result;
+}
+
+/// Checks `result` against the product of the row-major `m × k` array `a`
+/// and `k × n` array `b`. A vector result is a single row or column.
+fn expectProduct(comptime T: type, allocator: std.mem.Allocator, a: []const T, b: []const T, m: usize, k: usize, n: usize, result: anytype) !void {
+    const expected: []T = try allocator.alloc(T, m * n);
+    defer allocator.free(expected);
+
+    for (0..m) |i| {
+        for (0..n) |j| {
+            var sum: T = zero(T);
+            for (0..k) |l| {
+                sum = fma(T, sum, a[i * k + l], b[l * n + j]);
+            }
+
+            expected[i * n + j] = sum;
+        }
+    }
+
+    if (comptime zml.types.isVector(@TypeOf(result))) {
+        try std.testing.expectEqual(m * n, result.len);
+        for (expected, 0..) |e, i| {
+            try std.testing.expectEqual(e, try result.get(@intCast(i)));
+        }
+    } else {
+        try std.testing.expectEqual(m, result.rows);
+        try std.testing.expectEqual(n, result.cols);
+        for (0..m) |i| {
+            for (0..n) |j| {
+                try std.testing.expectEqual(expected[i * n + j], try result.get(@intCast(i), @intCast(j)));
+            }
+        }
+    }
+}
+
+/// Checks every product of the sparse matrix `s`, whose elements are the
+/// row-major `full`, with dense vectors, dense matrices and, unless it is a
+/// block matrix, general sparse matrices of both layouts. The matrix operands
+/// have `n` columns on the right and `n` rows on the left.
+fn expectProducts(comptime T: type, allocator: std.mem.Allocator, s: anytype, full: []const T, rows: u32, cols: u32, n: u32, ctx: anytype) !void {
+    // s * x and x^T * s, with unit and non-unit increments.
+    {
+        const xf: []T = try fill(T, allocator, cols, 1, false);
+        defer allocator.free(xf);
+        var x = try vector(T, allocator, xf);
+        defer x.deinit(allocator);
+
+        var y = try matmul(allocator, s, x, ctx);
+        defer y.deinit(allocator);
+        try expectProduct(T, allocator, full, xf, rows, cols, 1, y);
+
+        const buffer: []T = try allocator.alloc(T, 2 * cols);
+        defer allocator.free(buffer);
+        for (xf, 0..) |e, i| {
+            buffer[2 * i] = e;
+            buffer[2 * i + 1] = zero(T);
+        }
+
+        const strided: zml.vector.Dense(T) = .{ .data = buffer.ptr, .len = cols, .inc = 2, .flags = .{ .owns_data = false } };
+        var z = try matmul(allocator, s, strided, ctx);
+        defer z.deinit(allocator);
+        try expectProduct(T, allocator, full, xf, rows, cols, 1, z);
+
+        const vf: []T = try fill(T, allocator, 1, rows, false);
+        defer allocator.free(vf);
+        var v = try vector(T, allocator, vf);
+        defer v.deinit(allocator);
+
+        var w = try matmul(allocator, v, s, ctx);
+        defer w.deinit(allocator);
+        try expectProduct(T, allocator, vf, full, 1, rows, cols, w);
+    }
+
+    // s * B and B * s, for a dense and a general sparse B.
+    const bf: []T = try fill(T, allocator, cols, n, true);
+    defer allocator.free(bf);
+    const df: []T = try fill(T, allocator, n, rows, true);
+    defer allocator.free(df);
+
+    inline for (layouts) |layout| {
+        var b = try dense(T, layout, allocator, cols, n, bf);
+        defer b.deinit(allocator);
+        var sb = try matmul(allocator, s, b, ctx);
+        defer sb.deinit(allocator);
+        try expectProduct(T, allocator, full, bf, rows, cols, n, sb);
+
+        var d = try dense(T, layout, allocator, n, rows, df);
+        defer d.deinit(allocator);
+        var ds = try matmul(allocator, d, s, ctx);
+        defer ds.deinit(allocator);
+        try expectProduct(T, allocator, df, full, n, rows, cols, ds);
+
+        if (comptime !zml.types.isBlockMatrix(@TypeOf(s))) {
+            var c = try sparse(T, layout, allocator, cols, n, bf);
+            defer c.deinit(allocator);
+            var sc = try matmul(allocator, s, c, ctx);
+            defer sc.deinit(allocator);
+            try expectProduct(T, allocator, full, bf, rows, cols, n, sc);
+
+            var e = try sparse(T, layout, allocator, n, rows, df);
+            defer e.deinit(allocator);
+            var es = try matmul(allocator, e, s, ctx);
+            defer es.deinit(allocator);
+            try expectProduct(T, allocator, df, full, n, rows, cols, es);
+        }
+    }
+}
+
+test "general sparse products" {
+    const allocator = std.testing.allocator;
+
+    // Row 1 and column 0 are empty.
+    const full: []f64 = try fill(f64, allocator, 7, 5, true);
+    defer allocator.free(full);
+
+    inline for (layouts) |layout| {
+        var s = try sparse(f64, layout, allocator, 7, 5, full);
+        defer s.deinit(allocator);
+
+        try expectProducts(f64, allocator, s, full, 7, 5, 3, .{});
+    }
+}
+
+test "general sparse products with empty lines only" {
+    const allocator = std.testing.allocator;
+
+    // A single entry: every other row and column is empty.
+    var full: [4 * 6]f64 = @splat(0);
+    full[2 * 6 + 3] = 5;
+
+    inline for (layouts) |layout| {
+        var s = try sparse(f64, layout, allocator, 4, 6, &full);
+        defer s.deinit(allocator);
+
+        try expectProducts(f64, allocator, s, &full, 4, 6, 2, .{});
+    }
+}
+
+test "symmetric sparse products" {
+    const allocator = std.testing.allocator;
+
+    const size = 6;
+    const full: []f64 = try fill(f64, allocator, size, size, true);
+    defer allocator.free(full);
+    const expected: []f64 = try allocator.alloc(f64, size * size);
+    defer allocator.free(expected);
+
+    inline for (layouts) |layout| {
+        inline for (uplos) |uplo| {
+            // Only the `uplo` triangle of `full` is kept, and mirrored.
+            for (0..size) |i| {
+                for (0..size) |j| {
+                    expected[i * size + j] = if ((uplo == .upper) == (i <= j)) full[i * size + j] else full[j * size + i];
+                }
+            }
+
+            var s = blk: {
+                var b = try builder(f64, layout, allocator, size, size, full);
+                break :blk try b.compileSymmetric(allocator, uplo, .{});
+            };
+            defer s.deinit(allocator);
+
+            try expectProducts(f64, allocator, s, expected, size, size, 3, .{});
+        }
+    }
+}
+
+test "hermitian sparse products" {
+    const allocator = std.testing.allocator;
+
+    const size = 6;
+    const full: []zml.cf64 = try fill(zml.cf64, allocator, size, size, true);
+    defer allocator.free(full);
+    for (0..size) |i| {
+        full[i * size + i].im = 0;
+    }
+
+    const expected: []zml.cf64 = try allocator.alloc(zml.cf64, size * size);
+    defer allocator.free(expected);
+
+    inline for (layouts) |layout| {
+        inline for (uplos) |uplo| {
+            // Only the `uplo` triangle of `full` is kept, and mirrored
+            // conjugated.
+            for (0..size) |i| {
+                for (0..size) |j| {
+                    expected[i * size + j] = if ((uplo == .upper) == (i <= j)) full[i * size + j] else full[j * size + i].conj();
+                }
+            }
+
+            var s = blk: {
+                var b = try builder(zml.cf64, layout, allocator, size, size, full);
+                break :blk try b.compileHermitian(allocator, uplo, .{});
+            };
+            defer s.deinit(allocator);
+
+            try expectProducts(zml.cf64, allocator, s, expected, size, size, 3, .{});
+        }
+    }
+}
+
+test "triangular sparse products" {
+    const allocator = std.testing.allocator;
+
+    const size = 6;
+    const full: []f64 = try fill(f64, allocator, size, size, true);
+    defer allocator.free(full);
+    const expected: []f64 = try allocator.alloc(f64, size * size);
+    defer allocator.free(expected);
+
+    inline for (layouts) |layout| {
+        inline for (uplos) |uplo| {
+            inline for (diags) |diag| {
+                // The other triangle is zero. A unit diagonal replaces the
+                // stored one, and is the only entry of the empty row 1.
+                for (0..size) |i| {
+                    for (0..size) |j| {
+                        expected[i * size + j] = if (i == j and diag == .unit)
+                            1
+                        else if (i == j or (uplo == .upper) == (i < j))
+                            full[i * size + j]
+                        else
+                            0;
+                    }
+                }
+
+                var s = blk: {
+                    var b = try builder(f64, layout, allocator, size, size, full);
+                    break :blk try b.compileTriangular(allocator, uplo, diag, .{});
+                };
+                defer s.deinit(allocator);
+
+                try expectProducts(f64, allocator, s, expected, size, size, 3, .{});
+            }
+        }
+    }
+}
+
+test "block sparse products" {
+    const allocator = std.testing.allocator;
+
+    const bsize = 2;
+    const rows = 6;
+    const cols = 8;
+
+    // Block row 1 and block column 2 are empty.
+    const full: []f64 = try fill(f64, allocator, rows, cols, false);
+    defer allocator.free(full);
+    for (0..rows) |i| {
+        for (0..cols) |j| {
+            if (i / bsize == 1 or j / bsize == 2)
+                full[i * cols + j] = 0;
+        }
+    }
+
+    inline for (layouts) |border| {
+        inline for (layouts) |layout| {
+            var s = blk: {
+                var b: zml.matrix.builder.Block(f64, border, layout) = try .init(allocator, bsize, rows, cols, (rows / bsize) * (cols / bsize));
+                errdefer b.deinit(allocator);
+                for (0..rows) |i| {
+                    for (0..cols) |j| {
+                        if (full[i * cols + j] != 0)
+                            try b.set(allocator, @intCast(i), @intCast(j), full[i * cols + j]);
+                    }
+                }
+
+                break :blk try b.compile(allocator);
+            };
+            defer s.deinit(allocator);
+
+            try expectProducts(f64, allocator, s, full, rows, cols, 3, .{});
+        }
+    }
+}
+
+test "sparse products on a pool" {
+    const allocator = std.testing.allocator;
+
+    var pool: zml.Pool = undefined;
+    try pool.init(allocator, .{ .threads = 4 });
+    defer pool.deinit();
+
+    // Large enough for every kernel to be split over the pool.
+    const rows = 120;
+    const cols = 100;
+    const full: []f64 = try fill(f64, allocator, rows, cols, true);
+    defer allocator.free(full);
+
+    inline for (layouts) |layout| {
+        var s = try sparse(f64, layout, allocator, rows, cols, full);
+        defer s.deinit(allocator);
+
+        try expectProducts(f64, allocator, s, full, rows, cols, 64, .{ .pool = &pool });
+    }
+
+    const square: []f64 = try fill(f64, allocator, rows, rows, true);
+    defer allocator.free(square);
+    const expected: []f64 = try allocator.alloc(f64, rows * rows);
+    defer allocator.free(expected);
+    for (0..rows) |i| {
+        for (0..rows) |j| {
+            expected[i * rows + j] = if (i <= j) square[i * rows + j] else square[j * rows + i];
+        }
+    }
+
+    inline for (layouts) |layout| {
+        var s = blk: {
+            var b = try builder(f64, layout, allocator, rows, rows, square);
+            break :blk try b.compileSymmetric(allocator, .upper, .{});
+        };
+        defer s.deinit(allocator);
+
+        try expectProducts(f64, allocator, s, expected, rows, rows, 64, .{ .pool = &pool });
+    }
+}
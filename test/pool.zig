@@ -0,0 +1,147 @@
+const std = @import("std");
+const zml = @import("zml");
+
+const Pool = zml.Pool;
+
+test "parallelFor" {
+    const a = std.testing.allocator;
+
+    for ([_]usize{ 1, 4 }) |threads| {
+        var pool: Pool = undefined;
+        try pool.init(a, .{ .threads = threads });
+        defer pool.deinit();
+
+        const count = 1000;
+        var hits: [count]std.atomic.Value(u32) = undefined;
+        for (&hits) |*h| h.* = .init(0);
+        var busy: [zml.pool.max_lanes]std.atomic.Value(bool) = undefined;
+        for (&busy) |*b| b.* = .init(false);
+        var shared: std.atomic.Value(bool) = .init(false);
+
+        const Context = struct {
+            hits: []std.atomic.Value(u32),
+            busy: []std.atomic.Value(bool),
+            shared: *std.atomic.Value(bool),
+
+            fn run(ctx: @This(), lane: usize, index: usize) void {
+                // A lane is never used by two calls at the same time.
+                if (ctx.busy[lane].swap(true, .acq_rel))
+                    ctx.shared.store(true, .monotonic);
+
+                _ = ctx.hits[index].fetchAdd(1, .monotonic);
+                ctx.busy[lane].store(false, .release);
+            }
+        };
+
+        pool.parallelFor(count, Context{ .hits = &hits, .busy = busy[0..pool.lanes(count)], .shared = &shared }, Context.run);
+
+        for (&hits) |*h| try std.testing.expectEqual(1, h.load(.monotonic));
+        try std.testing.expect(!shared.load(.monotonic));
+    }
+}
+
+test "parallelFor nested" {
+    const a = std.testing.allocator;
+
+    var pool: Pool = undefined;
+    try pool.init(a, .{ .threads = 4 });
+    defer pool.deinit();
+
+    // Inner loops run on the pool of the thread they are called from: the
+    // workers' own, or the one installed on the calling thread.
+    const previous: ?*Pool = zml.pool.enter(&pool);
+    defer zml.pool.leave(previous);
+
+    var total: std.atomic.Value(usize) = .init(0);
+
+    const Inner = struct {
+        fn run(counter: *std.atomic.Value(usize), _: usize, index: usize) void {
+            _ = counter.fetchAdd(index + 1, .monotonic);
+        }
+    };
+
+    const Outer = struct {
+        fn run(counter: *std.atomic.Value(usize), _: usize, _: usize) void {
+            zml.pool.current().?.parallelFor(100, counter, Inner.run);
+        }
+    };
+
+    pool.parallelFor(50, &total, Outer.run);
+
+    try std.testing.expectEqual(50 * 5050, total.load(.monotonic));
+}
+
+test "submit and wait" {
+    const a = std.testing.allocator;
+
+    var pool: Pool = undefined;
+    try pool.init(a, .{ .threads = 3 });
+    defer pool.deinit();
+
+    var values: [16]usize = @splat(0);
+    var tasks: [16]zml.pool.Task = undefined;
+    var group: zml.pool.Group = .{};
+
+    const Task = struct {
+        fn run(data: *anyopaque) void {
+            const value: *usize = @ptrCast(@alignCast(data));
+            value.* = 42;
+        }
+    };
+
+    group.pending.store(tasks.len, .monotonic);
+    for (&tasks, &values) |*task, *value| {
+        task.* = .{ .run = Task.run, .data = value, .group = &group };
+        pool.submit(task);
+    }
+    pool.wait(&group);
+
+    try std.testing.expect(group.done());
+    for (values) |value| try std.testing.expectEqual(42, value);
+}
+
+test "Graph" {
+    const a = std.testing.allocator;
+
+    var pool: Pool = undefined;
+    try pool.init(a, .{ .threads = 4 });
+    defer pool.deinit();
+
+    // Node (i, j) of an 8 × 8 grid depends on (i - 1, j) and (i, j - 1), as
+    // the tasks of a blocked factorization do.
+    const side = 8;
+
+    const Context = struct {
+        clock: *std.atomic.Value(u32),
+        stamps: []u32,
+
+        fn run(ctx: @This(), node: u32) void {
+            ctx.stamps[node] = ctx.clock.fetchAdd(1, .acq_rel) + 1;
+        }
+    };
+
+    var graph: zml.pool.Graph(Context, Context.run) = try .init(a, side * side);
+    defer graph.deinit();
+
+    for (0..side) |i| {
+        for (0..side) |j| {
+            const id: u32 = @intCast(i * side + j);
+            if (i > 0) try graph.depend(id, id - side);
+            if (j > 0) try graph.depend(id, id - 1);
+        }
+    }
+
+    var clock: std.atomic.Value(u32) = .init(0);
+    var stamps: [side * side]u32 = @splat(0);
+    try graph.run(&pool, .{ .clock = &clock, .stamps = &stamps });
+
+    try std.testing.expectEqual(side * side, clock.load(.monotonic));
+    for (0..side) |i| {
+        for (0..side) |j| {
+            const id: usize = i * side + j;
+            try std.testing.expect(stamps[id] != 0);
+            if (i > 0) try std.testing.expect(stamps[id] > stamps[id - side]);
+            if (j > 0) try std.testing.expect(stamps[id] > stamps[id - 1]);
+        }
+    }
+}
@@ -0,0 +1,7 @@
+test {
+    const test_storage = true;
+
+    if (test_storage) {
+        _ = @import("rational/storage.zig");
+    }
+}
@@ -0,0 +1,144 @@
+const std = @import("std");
+
+const zml = @import("zml");
+const integer = zml.integer;
+const Integer = zml.Integer;
+const rational = zml.rational;
+const Rational = zml.Rational;
+
+/// Random reduced fraction with a numerator and denominator of `n` and `m`
+/// limbs before reduction, and a random sign.
+fn random(allocator: std.mem.Allocator, rng: std.Random, n: usize, m: usize) !Rational {
+    var r: Rational = try .init(allocator, @intCast(n), @intCast(m));
+    errdefer r.deinit(allocator);
+
+    for ([_]*Integer{ &r.num, &r.den }, [_]usize{ n, m }) |x, len| {
+        rng.bytes(std.mem.sliceAsBytes(x.limbs[0..len]));
+        x.limbs[len - 1] |= 1;
+        x.size = @intCast(len);
+    }
+
+    r.num.positive = rng.boolean();
+    try r.reduce(allocator);
+
+    return r;
+}
+
+/// Checks that `o` is `n / d` in lowest terms, with a positive denominator.
+fn expectValue(allocator: std.mem.Allocator, o: Rational, n: Integer, d: Integer) !void {
+    var lhs: Integer = try integer.mul(allocator, o.num, d);
+    defer lhs.deinit(allocator);
+    var rhs: Integer = try integer.mul(allocator, n, o.den);
+    defer rhs.deinit(allocator);
+    try std.testing.expect(integer.eq(lhs, rhs));
+
+    var g: Integer = try integer.gcd(allocator, o.num, o.den);
+    defer g.deinit(allocator);
+    try std.testing.expect(integer.eq(g, 1));
+    try std.testing.expect(o.den.positive);
+}
+
+const Op = enum { add, mul, div };
+
+fn apply(allocator: std.mem.Allocator, op: Op, o: *Rational, x: Rational, y: Rational) !void {
+    switch (op) {
+        .add => try rational.add_(allocator, o, x, y),
+        .mul => try rational.mul_(allocator, o, x, y),
+        .div => try rational.div_(allocator, o, x, y),
+    }
+}
+
+/// Unreduced `x op y`, as a numerator and a denominator.
+fn expected(allocator: std.mem.Allocator, op: Op, x: Rational, y: Rational) !struct { Integer, Integer } {
+    switch (op) {
+        .add => {
+            var ad: Integer = try integer.mul(allocator, x.num, y.den);
+            defer ad.deinit(allocator);
+            var bc: Integer = try integer.mul(allocator, x.den, y.num);
+            defer bc.deinit(allocator);
+
+            var n: Integer = try integer.add(allocator, ad, bc);
+            errdefer n.deinit(allocator);
+            return .{ n, try integer.mul(allocator, x.den, y.den) };
+        },
+        .mul => {
+            var n: Integer = try integer.mul(allocator, x.num, y.num);
+            errdefer n.deinit(allocator);
+            return .{ n, try integer.mul(allocator, x.den, y.den) };
+        },
+        .div => {
+            var n: Integer = try integer.mul(allocator, x.num, y.den);
+            errdefer n.deinit(allocator);
+            return .{ n, try integer.mul(allocator, x.den, y.num) };
+        },
+    }
+}
+
+test "small values need no allocation" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var x: Rational = try .initSet(allocator, @as(i32, -6), @as(i32, 35));
+    defer x.deinit(allocator);
+    var y: Rational = try .initSet(allocator, @as(i32, 7), @as(i32, 4));
+    defer y.deinit(allocator);
+
+    var o: Rational = try .init(allocator, integer.small_limbs, integer.small_limbs);
+    defer o.deinit(allocator);
+
+    // The products and the gcd stay in the stack buffers.
+    try rational.mul_(std.testing.failing_allocator, &o, x, y);
+    try std.testing.expectEqual(-3, o.num.toInt(i64));
+    try std.testing.expectEqual(10, o.den.toInt(i64));
+}
+
+test "add_, mul_ and div_ across the inline buffers" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var prng: std.Random.DefaultPrng = .init(0x5eed);
+    const rng: std.Random = prng.random();
+
+    // Products from one limb to well past `integer.small_limbs`.
+    const sizes = [_]usize{ 1, 2, 3, 5 };
+
+    for ([_]Op{ .add, .mul, .div }) |op| {
+        for (sizes) |n| {
+            for (sizes) |m| {
+                var x: Rational = try random(allocator, rng, n, m);
+                defer x.deinit(allocator);
+                var y: Rational = try random(allocator, rng, m, n);
+                defer y.deinit(allocator);
+
+                var num: Integer, var den: Integer = try expected(allocator, op, x, y);
+                defer num.deinit(allocator);
+                defer den.deinit(allocator);
+
+                var o: Rational = try .init(allocator, 0, 0);
+                defer o.deinit(allocator);
+                try apply(allocator, op, &o, x, y);
+                try expectValue(allocator, o, num, den);
+
+                // Aliased outputs.
+                var x1: Rational = try x.copy(allocator);
+                defer x1.deinit(allocator);
+                try apply(allocator, op, &x1, x1, y);
+                try expectValue(allocator, x1, num, den);
+
+                var y1: Rational = try y.copy(allocator);
+                defer y1.deinit(allocator);
+                try apply(allocator, op, &y1, x, y1);
+                try expectValue(allocator, y1, num, den);
+            }
+        }
+
+        // x op x, aliased.
+        var x: Rational = try random(allocator, rng, 5, 3);
+        defer x.deinit(allocator);
+
+        var num: Integer, var den: Integer = try expected(allocator, op, x, x);
+        defer num.deinit(allocator);
+        defer den.deinit(allocator);
+
+        try apply(allocator, op, &x, x, x);
+        try expectValue(allocator, x, num, den);
+    }
+}
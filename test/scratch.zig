@@ -0,0 +1,182 @@
+const std = @import("std");
+const zml = @import("zml");
+
+const scratch = zml.scratch;
+const Arena = zml.Arena;
+
+test "reset keeps the memory for reuse" {
+    var backing: std.testing.FailingAllocator = .init(std.testing.allocator, .{});
+
+    var arena: Arena = .init(backing.allocator());
+    defer arena.deinit();
+    const a: std.mem.Allocator = arena.allocator();
+
+    for (0..3) |round| {
+        const before: usize = backing.allocations;
+
+        for (1..20) |i| {
+            const block: []u32 = try a.alloc(u32, 100 * i);
+            @memset(block, @intCast(i));
+        }
+
+        try std.testing.expectEqual(19 * (round + 1), arena.allocations);
+
+        // After the first round the memory retained by `reset` is enough.
+        if (round > 0)
+            try std.testing.expectEqual(before, backing.allocations);
+
+        arena.reset();
+    }
+}
+
+test "last allocation is given back on free" {
+    var arena: Arena = .init(std.testing.allocator);
+    defer arena.deinit();
+    const a: std.mem.Allocator = arena.allocator();
+
+    // One block large enough for everything below, so that it all comes from
+    // the same buffer.
+    _ = try a.alloc(u8, 4096);
+    arena.reset();
+
+    // Temporaries freed in the reverse order they are allocated, as the
+    // kernels do, leave the arena where it started.
+    const outer: []u32 = try a.alloc(u32, 64);
+    const first: []u32 = try a.alloc(u32, 32);
+    {
+        const inner: []u32 = try a.alloc(u32, 16);
+        const innermost: []u32 = try a.alloc(u32, 8);
+        a.free(innermost);
+        a.free(inner);
+    }
+    a.free(first);
+
+    const again: []u32 = try a.alloc(u32, 32);
+    try std.testing.expectEqual(first.ptr, again.ptr);
+    a.free(again);
+    a.free(outer);
+
+    const last: []u32 = try a.alloc(u32, 64);
+    try std.testing.expectEqual(outer.ptr, last.ptr);
+}
+
+test "enter and leave nest" {
+    var first: Arena = .init(std.testing.allocator);
+    defer first.deinit();
+    var second: Arena = .init(std.testing.allocator);
+    defer second.deinit();
+
+    const fallback: std.mem.Allocator = std.testing.allocator;
+
+    try std.testing.expectEqual(null, scratch.current());
+    try std.testing.expectEqual(fallback.ptr, scratch.allocator(fallback).ptr);
+
+    const outer: ?*Arena = scratch.enter(&first);
+    try std.testing.expectEqual(&first, scratch.current().?);
+    try std.testing.expectEqual(@as(*anyopaque, &first), scratch.allocator(fallback).ptr);
+
+    {
+        const inner: ?*Arena = scratch.enter(&second);
+        defer scratch.leave(inner);
+        try std.testing.expectEqual(&second, scratch.current().?);
+
+        // No arena keeps the current one.
+        const none: ?*Arena = scratch.enter(null);
+        try std.testing.expectEqual(&second, scratch.current().?);
+        scratch.leave(none);
+        try std.testing.expectEqual(&second, scratch.current().?);
+    }
+
+    try std.testing.expectEqual(&first, scratch.current().?);
+
+    scratch.leave(outer);
+    try std.testing.expectEqual(null, scratch.current());
+}
+
+test "integer temporaries come from the arena" {
+    const allocator: std.mem.Allocator = std.testing.allocator;
+
+    var arena: Arena = .init(allocator);
+    defer arena.deinit();
+
+    var x: zml.Integer = try .init(allocator, 40);
+    defer x.deinit(allocator);
+    @memset(x.limbs[0..40], 0xffffffff);
+    x.size = 40;
+
+    var o: zml.Integer = try .init(allocator, 0);
+    defer o.deinit(allocator);
+
+    const previous: ?*Arena = scratch.enter(&arena);
+    defer scratch.leave(previous);
+
+    for (0..3) |_| {
+        // x * x, aliased so that x is copied to the arena, then Karatsuba's
+        // temporaries.
+        try zml.integer.mul_(allocator, &x, x, x);
+        try std.testing.expect(arena.allocations > 0);
+        arena.reset();
+
+        try zml.integer.mul_(allocator, &o, x, x);
+        try std.testing.expectEqual(2 * x.size, o.size);
+    }
+}
+
+test "arena is shared between threads" {
+    var arena: Arena = .init(std.testing.allocator);
+    defer arena.deinit();
+
+    const threads = 4;
+    const blocks = 1000;
+
+    const Worker = struct {
+        fn run(a: *Arena, id: u32, ok: *bool) void {
+            const allocator: std.mem.Allocator = a.allocator();
+
+            var list: [blocks][]u32 = undefined;
+            for (&list, 0..) |*block, i| {
+                block.* = allocator.alloc(u32, 1 + i % 7) catch {
+                    ok.* = false;
+                    return;
+                };
+                @memset(block.*, id);
+            }
+
+            // No block was handed to another thread.
+            for (list) |block| {
+                for (block) |v| {
+                    if (v != id) ok.* = false;
+                }
+            }
+        }
+    };
+
+    var ok: [threads]bool = @splat(true);
+    var handles: [threads]std.Thread = undefined;
+    for (&handles, 0..) |*h, id|
+        h.* = try std.Thread.spawn(.{}, Worker.run, .{ &arena, @as(u32, @intCast(id)), &ok[id] });
+    for (handles) |h| h.join();
+
+    for (ok) |v| try std.testing.expect(v);
+    try std.testing.expectEqual(threads * blocks, arena.allocations);
+}
+
+test "cache reuses the last freed block" {
+    defer scratch.trim();
+
+    const a: std.mem.Allocator = scratch.cache;
+
+    const first: []u8 = try a.alloc(u8, 100_000);
+    a.free(first);
+
+    // Same size class.
+    const second: []u8 = try a.alloc(u8, 120_000);
+    try std.testing.expectEqual(first.ptr, second.ptr);
+
+    // Another class is not served from it.
+    const third: []u8 = try a.alloc(u8, 1_000_000);
+    try std.testing.expect(third.ptr != second.ptr);
+
+    a.free(third);
+    a.free(second);
+}
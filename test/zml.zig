@@ -32,18 +32,18 @@ test {
     const test_ops = false;
     const test_linalg = false;
     const test_autodiff = false;
+    const test_pool = false;
+    const test_scratch = false;
+    const test_io = false;
 
     _ = test_int;
     _ = test_dyadic;
-    _ = test_integer;
-    _ = test_rational;
     _ = test_real;
     _ = test_complex;
     _ = test_constants;
     _ = test_numeric;
     _ = test_vector;
     _ = test_matrix;
-    _ = test_array;
     _ = test_ops;
     _ = test_autodiff;
 
@@ -56,6 +56,24 @@ test {
     if (test_all or test_cfloat)
         _ = @import("cfloat.zig");
 
+    if (test_all or test_integer)
+        _ = @import("integer.zig");
+
+    if (test_all or test_rational)
+        _ = @import("rational.zig");
+
+    if (test_all or test_array)
+        _ = @import("array.zig");
+
     if (test_all or test_linalg)
         _ = @import("linalg.zig");
+
+    if (test_all or test_pool)
+        _ = @import("pool.zig");
+
+    if (test_all or test_scratch)
+        _ = @import("scratch.zig");
+
+    if (test_all or test_io)
+        _ = @import("io.zig");
 }